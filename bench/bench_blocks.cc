@@ -0,0 +1,551 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Throughput of every receive and transmit block, one work() call per
+ * iteration.
+ *
+ *   ethernet_bench --benchmark_out=results.json --benchmark_out_format=json
+ *
+ * Inputs are either synthetic (see synthetic_signal.h) or derived from the
+ * bundled 100BASE-TX acquisitions: those are run once through the example
+ * front end (multiply_const + symbol_sync) and every intermediate stream is
+ * kept, so each block is measured on the real output of the stage before it.
+ */
+
+#include "synthetic_signal.h"
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/message_debug.h>
+#include <gnuradio/blocks/multiply_const.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/digital/symbol_sync_ff.h>
+#include <gnuradio/ethernet/capture_source.h>
+#include <gnuradio/ethernet/ethernet_10baset_decoder.h>
+#include <gnuradio/ethernet/ethernet_framer.h>
+#include <gnuradio/ethernet/fastethernet_4b5b_encoder.h>
+#include <gnuradio/ethernet/fastethernet_descrambler.h>
+#include <gnuradio/ethernet/fastethernet_frame_decoder.h>
+#include <gnuradio/ethernet/fastethernet_scrambler.h>
+#include <gnuradio/ethernet/line_impairments.h>
+#include <gnuradio/ethernet/manchester_encoder.h>
+#include <gnuradio/ethernet/mlt3_encoder.h>
+#include <gnuradio/ethernet/mlt3_to_scrambled.h>
+#include <gnuradio/ethernet/slicer3.h>
+#include <gnuradio/top_block.h>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <new>
+#include <sstream>
+
+#ifndef ETHERNET_CAPTURE_DIR
+#define ETHERNET_CAPTURE_DIR "examples/100BASE-TX/Acquisitions100Mbps"
+#endif
+
+// Heap allocations of the whole process, for the allocs_per_frame counters
+static std::atomic<uint64_t> g_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+const int BUFFER_SIZES[] = { 256, 4096, 32768 };
+
+// The decoders print every frame; keep std::cout for the reporter.
+class cout_silencer
+{
+public:
+    cout_silencer() : d_saved(std::cout.rdbuf(d_sink.rdbuf())) {}
+    ~cout_silencer() { std::cout.rdbuf(d_saved); }
+
+private:
+    std::ostringstream d_sink;
+    std::streambuf* d_saved;
+};
+
+struct dataset {
+    std::string name;
+    std::vector<float> symbols;       // slicer3 input
+    std::vector<float> levels;        // mlt3_to_scrambled input
+    std::vector<uint8_t> scrambled;   // fastethernet_descrambler input
+    std::vector<uint8_t> descrambled; // fastethernet_frame_decoder input
+};
+
+std::vector<std::vector<uint8_t>> synthetic_frames(int count)
+{
+    static const size_t payloads[] = { 18, 200, 1000, 64, 1472 };
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < count; i++) {
+        frames.push_back(bench::make_udp_frame(payloads[i % 5], i));
+    }
+    return frames;
+}
+
+dataset make_synthetic_100basetx()
+{
+    dataset ds;
+    ds.name = "synthetic";
+    ds.descrambled = bench::make_5b_stream(synthetic_frames(64), 24);
+    // IDLE up to a multiple of the 2047-bit scrambler period, so the
+    // scrambled stream stays continuous when the benchmark wraps around.
+    ds.descrambled.resize((ds.descrambled.size() / 2047 + 1) * 2047, 1);
+    ds.scrambled = bench::scramble(ds.descrambled, 0x5A5);
+    ds.symbols = bench::mlt3_levels(ds.scrambled, 0.08f);
+    ds.levels = bench::mlt3_levels(ds.scrambled, 0.0f);
+    return ds;
+}
+
+bool file_exists(const std::string& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    return f.good();
+}
+
+// Runs a capture through the decode_100BASETX front end and keeps every stage.
+bool make_capture_dataset(dataset& ds,
+                          const std::string& file,
+                          double samp_rate,
+                          float gain)
+{
+    std::string path = std::string(ETHERNET_CAPTURE_DIR) + "/" + file;
+    if (!file_exists(path)) {
+        std::cerr << "[bench] capture not found, skipping: " << path << std::endl;
+        return false;
+    }
+
+    auto tb = gr::make_top_block("bench_capture");
+    auto src = gr::blocks::file_source::make(sizeof(float), path.c_str(), false);
+    auto gain_blk = gr::blocks::multiply_const_ff::make(gain);
+    auto sync = gr::digital::symbol_sync_ff::make(gr::digital::TED_GARDNER,
+                                                  samp_rate / 125e6,
+                                                  0.063,
+                                                  1.0,
+                                                  1.0,
+                                                  1.0,
+                                                  1,
+                                                  gr::digital::constellation_bpsk::make()->base(),
+                                                  gr::digital::IR_MMSE_8TAP,
+                                                  128);
+    auto slicer = gr::ethernet::slicer3::make(0.25f);
+    auto mlt3 = gr::ethernet::mlt3_to_scrambled::make();
+    auto descrambler = gr::ethernet::fastethernet_descrambler::make(100, 40, 100, 20000, false);
+    auto sym_sink = gr::blocks::vector_sink_f::make();
+    auto lvl_sink = gr::blocks::vector_sink_f::make();
+    auto scr_sink = gr::blocks::vector_sink_b::make();
+    auto desc_sink = gr::blocks::vector_sink_b::make();
+
+    tb->connect(src, 0, gain_blk, 0);
+    tb->connect(gain_blk, 0, sync, 0);
+    tb->connect(sync, 0, sym_sink, 0);
+    tb->connect(sync, 0, slicer, 0);
+    tb->connect(slicer, 0, lvl_sink, 0);
+    tb->connect(slicer, 0, mlt3, 0);
+    tb->connect(mlt3, 0, scr_sink, 0);
+    tb->connect(mlt3, 0, descrambler, 0);
+    tb->connect(descrambler, 0, desc_sink, 0);
+    tb->run();
+
+    ds.name = file;
+    ds.symbols = sym_sink->data();
+    ds.levels = lvl_sink->data();
+    ds.scrambled = scr_sink->data();
+    ds.descrambled = desc_sink->data();
+    return !ds.symbols.empty();
+}
+
+void set_rate_counters(benchmark::State& state, int items_per_iteration)
+{
+    int64_t items = state.iterations() * items_per_iteration;
+    state.SetItemsProcessed(items);
+    state.counters["time_per_item"] = benchmark::Counter(
+        (double)items, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+/*
+ * One work() call per iteration on consecutive windows of the input. The
+ * input is treated as circular so the block sees one continuous stream.
+ */
+template <typename IN_T, typename OUT_T>
+void run_work(benchmark::State& state,
+              gr::sync_block& blk,
+              const std::vector<IN_T>& input,
+              bool has_output)
+{
+    const int n = state.range(0);
+    // n items past the end, plus the history of blocks that look back.
+    const int extra = n + blk.history() - 1;
+    if ((int)input.size() < extra) {
+        state.SkipWithError("input shorter than buffer size");
+        return;
+    }
+    std::vector<IN_T> circular(input);
+    circular.insert(circular.end(), input.begin(), input.begin() + extra);
+    std::vector<OUT_T> output(n);
+    gr_vector_const_void_star in_items(1);
+    gr_vector_void_star out_items;
+    if (has_output) out_items.push_back(output.data());
+
+    cout_silencer quiet;
+    size_t pos = 0;
+    for (auto _ : state) {
+        in_items[0] = circular.data() + pos;
+        benchmark::DoNotOptimize(blk.work(n, in_items, out_items));
+        pos = (pos + n) % input.size();
+    }
+    benchmark::ClobberMemory();
+    set_rate_counters(state, n);
+}
+
+void bm_slicer3(benchmark::State& state, const dataset* ds)
+{
+    auto blk = gr::ethernet::slicer3::make(0.25f);
+    run_work<float, float>(state, *blk, ds->symbols, true);
+}
+
+// Same symbols as int16 digitizer codes, the scale folded into the threshold
+void bm_slicer3_s(benchmark::State& state, const dataset* ds)
+{
+    const float scale = 8192.0f;
+    std::vector<int16_t> codes(ds->symbols.size());
+    for (size_t i = 0; i < codes.size(); i++) {
+        codes[i] = std::max(-32768.0f, std::min(32767.0f, std::round(ds->symbols[i] * scale)));
+    }
+    auto blk = gr::ethernet::slicer3_s::make(0.25f, 1.0f / scale);
+    run_work<int16_t, float>(state, *blk, codes, true);
+}
+
+// Capture playback into the first receive stage: the mapped source with the
+// gain as its scale, against File Source + Multiply Const.
+void bm_capture_source(benchmark::State& state, const std::string* path, float gain, bool mapped)
+{
+    const int n = state.range(0);
+    std::vector<float> raw(n), output(n);
+    gr_vector_const_void_star no_input;
+    gr_vector_const_void_star raw_in(1, raw.data());
+    gr_vector_void_star raw_out(1, raw.data());
+    gr_vector_void_star out(1, output.data());
+
+    if (mapped) {
+        auto src = gr::ethernet::capture_source::make(*path, "float32", 0, gain, 0, true);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(src->work(n, no_input, out));
+        }
+    } else {
+        auto src = gr::blocks::file_source::make(sizeof(float), path->c_str(), true);
+        auto mul = gr::blocks::multiply_const_ff::make(gain);
+        for (auto _ : state) {
+            src->work(n, no_input, raw_out);
+            benchmark::DoNotOptimize(mul->work(n, raw_in, out));
+        }
+    }
+    benchmark::ClobberMemory();
+    set_rate_counters(state, n);
+}
+
+void bm_mlt3_to_scrambled(benchmark::State& state, const dataset* ds)
+{
+    auto blk = gr::ethernet::mlt3_to_scrambled::make();
+    run_work<float, uint8_t>(state, *blk, ds->levels, true);
+}
+
+/*
+ * With lock set, the timed work() calls only see a descrambler that has the
+ * scrambler state: the block is fed, untimed, until it locks before the
+ * timing starts, and again whenever it loses lock or the input runs out
+ * (a new block then starts over from the beginning of the input, since
+ * going back to it breaks the scrambler sequence). The untimed lock-ups
+ * are counted in "relocks". Without lock set, the block runs on the input
+ * as it comes: on random bits it never locks, which times the seed search.
+ */
+void bm_descrambler(benchmark::State& state, const std::vector<uint8_t>* bits, bool lock)
+{
+    const int n = state.range(0);
+    if ((int)bits->size() < n) {
+        state.SkipWithError("input shorter than buffer size");
+        return;
+    }
+    std::vector<uint8_t> output(n);
+    gr_vector_const_void_star in_items(1);
+    gr_vector_void_star out_items(1, output.data());
+
+    cout_silencer quiet;
+    gr::ethernet::fastethernet_descrambler::sptr blk;
+    size_t pos = 0;
+    // One work() call on the next len bits of the input
+    auto feed = [&](int len) {
+        if (!blk || pos + len > bits->size()) {
+            blk = gr::ethernet::fastethernet_descrambler::make(100, 40, 100, 20000, false);
+            pos = 0;
+        }
+        in_items[0] = bits->data() + pos;
+        pos += len;
+        return blk->work(len, in_items, out_items);
+    };
+    auto ready = [&]() { return blk && blk->locked() && pos + n <= bits->size(); };
+    auto relock = [&]() {
+        for (size_t fed = 0; !ready(); fed += n) {
+            if (fed > 2 * bits->size()) return false;
+            feed(n);
+        }
+        return true;
+    };
+
+    int64_t relocks = 0;
+    if (lock && !relock()) {
+        state.SkipWithError("no lock on this input");
+        return;
+    }
+    for (auto _ : state) {
+        if (lock && !ready()) {
+            state.PauseTiming();
+            bool ok = relock();
+            state.ResumeTiming();
+            if (!ok) {
+                state.SkipWithError("no lock on this input");
+                break;
+            }
+            relocks++;
+        }
+        benchmark::DoNotOptimize(feed(n));
+    }
+    if (lock) state.counters["relocks"] = relocks;
+    benchmark::ClobberMemory();
+    set_rate_counters(state, n);
+}
+
+// Outputs of the frame decoder connected in its benchmark
+enum frame_output { DECODED, RECORDS, STREAM };
+
+/*
+ * The decoder is a general block (its byte output has its own rate), so
+ * like the 10BASE-T decoder it is measured inside a minimal flowgraph
+ * decoding the whole dataset; graph construction is excluded from the
+ * timing. DECODED connects no output: the dicts are built anyway.
+ *
+ * allocs_per_frame is the number of heap allocations per decoded frame
+ * over the runs, the scheduler's included. With "records" as the only
+ * output, frames are batched 64 to a message and decoding itself
+ * allocates nothing: what is left is the batch messages. With the byte
+ * output alone (into a Null Sink) no message is built; the tags of each
+ * frame are what is left.
+ */
+void bm_frame_decoder(benchmark::State& state,
+                      const dataset* ds,
+                      bool trace_latency,
+                      frame_output output)
+{
+    const int n = state.range(0);
+    cout_silencer quiet;
+    uint64_t frames = 0;
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tb = gr::make_top_block("bench_frame_decoder");
+        auto src = gr::blocks::vector_source_b::make(ds->descrambled, false);
+        auto blk = gr::ethernet::fastethernet_frame_decoder::make(
+            0, trace_latency, "", output == RECORDS ? 64 : 1);
+        auto sink = gr::blocks::message_debug::make();
+        auto bytes = gr::blocks::null_sink::make(sizeof(uint8_t));
+        tb->connect(src, 0, blk, 0);
+        if (output == RECORDS) tb->msg_connect(blk, "records", sink, "store");
+        if (output == STREAM) tb->connect(blk, 0, bytes, 0);
+        uint64_t before = g_allocations.load();
+        state.ResumeTiming();
+
+        tb->run(n);
+
+        state.PauseTiming();
+        allocations += g_allocations.load() - before;
+        frames += blk->frames_decoded();
+        state.ResumeTiming();
+    }
+    state.counters["allocs_per_frame"] = frames ? (double)allocations / frames : 0.0;
+    set_rate_counters(state, ds->descrambled.size());
+}
+
+/*
+ * The 10BASE-T decoder reads its "packet" tags from the scheduler, so it
+ * is measured inside a minimal flowgraph. The buffer size is passed as
+ * max_noutput_items; graph construction is excluded from the timing.
+ */
+void bm_10baset_decoder(benchmark::State& state,
+                        const std::vector<uint8_t>* samples,
+                        const std::vector<gr::tag_t>* tags)
+{
+    const int n = state.range(0);
+    cout_silencer quiet;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tb = gr::make_top_block("bench_10baset");
+        auto src = gr::blocks::vector_source_b::make(*samples, false, 1, *tags);
+        auto dec = gr::ethernet::ethernet_10baset_decoder::make("packet");
+        tb->connect(src, 0, dec, 0);
+        state.ResumeTiming();
+
+        tb->run(n);
+    }
+    set_rate_counters(state, samples->size());
+}
+
+void bm_scrambler(benchmark::State& state, const dataset* ds)
+{
+    auto blk = gr::ethernet::fastethernet_scrambler::make(0x5A5);
+    run_work<uint8_t, uint8_t>(state, *blk, ds->descrambled, true);
+}
+
+void bm_mlt3_encoder(benchmark::State& state, const dataset* ds)
+{
+    auto blk = gr::ethernet::mlt3_encoder::make(1.0f);
+    run_work<uint8_t, float>(state, *blk, ds->scrambled, true);
+}
+
+void bm_line_impairments(benchmark::State& state, const dataset* ds)
+{
+    auto blk = gr::ethernet::line_impairments::make(0.08f, 0.05f, 1e-5f, 1);
+    run_work<float, float>(state, *blk, ds->levels, true);
+}
+
+/*
+ * Whole transmit chains, framer in repeat mode so the source never runs
+ * dry. Counted in output samples, which is what loads the receive side.
+ */
+pmt::pmt_t make_pdu(const std::vector<uint8_t>& frame)
+{
+    // The framer adds the FCS itself.
+    std::vector<uint8_t> body(frame.begin(), frame.end() - 4);
+    return pmt::cons(pmt::PMT_NIL, pmt::init_u8vector(body.size(), body));
+}
+
+void bm_tx_chain(benchmark::State& state, bool manchester)
+{
+    const int n = state.range(0);
+    const uint64_t samples = 1 << 22;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tb = gr::make_top_block("bench_tx");
+        auto framer = gr::ethernet::ethernet_framer::make(true);
+        for (const auto& frame : synthetic_frames(64)) {
+            framer->_post(pmt::mp("pdus"), make_pdu(frame));
+        }
+        auto head = gr::blocks::head::make(sizeof(float), samples);
+        auto sink = gr::blocks::null_sink::make(sizeof(float));
+        if (manchester) {
+            auto enc = gr::ethernet::manchester_encoder::make(2.0, 96);
+            tb->connect(framer, 0, enc, 0);
+            tb->connect(enc, 0, head, 0);
+        } else {
+            auto enc = gr::ethernet::fastethernet_4b5b_encoder::make(24);
+            auto scrambler = gr::ethernet::fastethernet_scrambler::make(0x5A5);
+            auto mlt3 = gr::ethernet::mlt3_encoder::make(1.0f);
+            tb->connect(framer, 0, enc, 0);
+            tb->connect(enc, 0, scrambler, 0);
+            tb->connect(scrambler, 0, mlt3, 0);
+            tb->connect(mlt3, 0, head, 0);
+        }
+        tb->connect(head, 0, sink, 0);
+        state.ResumeTiming();
+
+        tb->run(n);
+    }
+    set_rate_counters(state, samples);
+}
+
+template <typename F, typename... ARGS>
+void register_sizes(const std::string& name, F fn, ARGS... args)
+{
+    auto* b = benchmark::RegisterBenchmark(name.c_str(), fn, args...);
+    b->ArgName("items");
+    for (int n : BUFFER_SIZES) b->Arg(n);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    // std::list keeps addresses stable for the registered pointers.
+    std::list<dataset> datasets;
+    datasets.push_back(make_synthetic_100basetx());
+
+    struct capture {
+        const char* file;
+        double samp_rate;
+        float gain;
+    };
+    const capture captures[] = {
+        { "output.bin", 625e6, 3.5f },
+        { "output2.bin", 625e6, 3.5f },
+        { "CUT_RefCurve_2025-04-10_1_132807.Wfm.bin", 500e6, 3.0f },
+    };
+    static std::list<std::string> capture_paths;
+    for (const auto& c : captures) {
+        std::string path = std::string(ETHERNET_CAPTURE_DIR) + "/" + c.file;
+        if (file_exists(path)) {
+            capture_paths.push_back(path);
+            register_sizes(std::string("capture_source/") + c.file,
+                           bm_capture_source, &capture_paths.back(), c.gain, true);
+            register_sizes(std::string("file_source+multiply_const/") + c.file,
+                           bm_capture_source, &capture_paths.back(), c.gain, false);
+        }
+        dataset ds;
+        cout_silencer quiet;
+        if (make_capture_dataset(ds, c.file, c.samp_rate, c.gain)) {
+            datasets.push_back(std::move(ds));
+        }
+    }
+
+    static const std::vector<uint8_t> noise_bits = bench::random_bits(1 << 20, 7);
+
+    for (const auto& ds : datasets) {
+        register_sizes("slicer3/" + ds.name, bm_slicer3, &ds);
+        register_sizes("slicer3_s/" + ds.name, bm_slicer3_s, &ds);
+        register_sizes("mlt3_to_scrambled/" + ds.name, bm_mlt3_to_scrambled, &ds);
+        register_sizes("fastethernet_descrambler/locked/" + ds.name,
+                       bm_descrambler,
+                       &ds.scrambled,
+                       true);
+        register_sizes("fastethernet_frame_decoder/" + ds.name, bm_frame_decoder, &ds, false, DECODED);
+        register_sizes("fastethernet_frame_decoder/traced/" + ds.name, bm_frame_decoder, &ds, true, DECODED);
+        register_sizes("fastethernet_frame_decoder/records/" + ds.name, bm_frame_decoder, &ds, false, RECORDS);
+        register_sizes("fastethernet_frame_decoder/stream/" + ds.name, bm_frame_decoder, &ds, false, STREAM);
+    }
+
+    const dataset& synthetic = datasets.front();
+    register_sizes("fastethernet_scrambler/synthetic", bm_scrambler, &synthetic);
+    register_sizes("mlt3_encoder/synthetic", bm_mlt3_encoder, &synthetic);
+    register_sizes("line_impairments/synthetic", bm_line_impairments, &synthetic);
+    register_sizes("tx_chain/100basetx", bm_tx_chain, false);
+    register_sizes("tx_chain/10baset", bm_tx_chain, true);
+    register_sizes("fastethernet_descrambler/seed_search/random", bm_descrambler, &noise_bits, false);
+
+    static std::vector<gr::tag_t> tags;
+    static const std::vector<uint8_t> manchester =
+        bench::make_manchester_stream(synthetic_frames(64), 2000, "packet", tags);
+    register_sizes("ethernet_10baset_decoder/synthetic", bm_10baset_decoder, &manchester, &tags);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
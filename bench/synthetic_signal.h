@@ -0,0 +1,161 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_BENCH_SYNTHETIC_SIGNAL_H
+#define INCLUDED_ETHERNET_BENCH_SYNTHETIC_SIGNAL_H
+
+#include <gnuradio/ethernet/line_coding.h>
+#include <gnuradio/tags.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/*
+ * Minimal transmit-side models used to feed the receive blocks with
+ * deterministic input. Each stage produces exactly what the matching
+ * receive block expects on its input port. They share line_coding.h with
+ * the TX blocks, so both generate the same bits for the same frames.
+ */
+
+// Ethernet II / IPv4 / UDP frame with FCS, without preamble.
+inline std::vector<uint8_t> make_udp_frame(size_t payload_len, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> f = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, // dst
+        0x02, 0x00, 0x5e, 0x10, 0x20, 0x30, // src
+        0x08, 0x00,                         // IPv4
+    };
+    size_t ip_len = 20 + 8 + payload_len;
+    uint8_t ip[20] = { 0x45, 0x00, (uint8_t)(ip_len >> 8), (uint8_t)ip_len,
+                       0x00, 0x01, 0x40, 0x00, 64, 17, 0x00, 0x00,
+                       192, 168, 1, 10, 192, 168, 1, 20 };
+    f.insert(f.end(), ip, ip + 20);
+    uint16_t sport = 1024 + (rng() % 60000);
+    uint16_t dport = 502;
+    size_t udp_len = 8 + payload_len;
+    uint8_t udp[8] = { (uint8_t)(sport >> 8), (uint8_t)sport,
+                       (uint8_t)(dport >> 8), (uint8_t)dport,
+                       (uint8_t)(udp_len >> 8), (uint8_t)udp_len, 0, 0 };
+    f.insert(f.end(), udp, udp + 8);
+    for (size_t i = 0; i < payload_len; i++) f.push_back(rng() & 0xFF);
+    while (f.size() < 60) f.push_back(0);
+
+    uint32_t fcs = gr::ethernet::crc32(f.data(), f.size());
+    for (int i = 0; i < 4; i++) f.push_back((fcs >> (8 * i)) & 0xFF);
+    return f;
+}
+
+// One 5-bit code-group, MSB first as in the frame decoder table.
+inline void push_code(std::vector<uint8_t>& bits, uint8_t code)
+{
+    for (int b = 4; b >= 0; b--) bits.push_back((code >> b) & 1);
+}
+
+/*
+ * Descrambled 5B bit stream: IDLE, /J/K/, preamble + SFD, frame nibbles
+ * (low nibble first), /T/R/, IDLE. This is the frame decoder input.
+ */
+inline std::vector<uint8_t> make_5b_stream(const std::vector<std::vector<uint8_t>>& frames,
+                                           int idle_symbols)
+{
+    using namespace gr::ethernet;
+    std::vector<uint8_t> bits;
+    for (const auto& frame : frames) {
+        for (int i = 0; i < idle_symbols; i++) push_code(bits, FIVEB_IDLE);
+        push_code(bits, FIVEB_J);
+        push_code(bits, FIVEB_K);
+        std::vector<uint8_t> bytes(6, 0x55);
+        bytes.push_back(0xD5);
+        bytes.insert(bytes.end(), frame.begin(), frame.end());
+        for (uint8_t b : bytes) {
+            push_code(bits, FIVEB_CODES[b & 0xF]);
+            push_code(bits, FIVEB_CODES[b >> 4]);
+        }
+        push_code(bits, FIVEB_T);
+        push_code(bits, FIVEB_R);
+    }
+    for (int i = 0; i < idle_symbols; i++) push_code(bits, FIVEB_IDLE);
+    return bits;
+}
+
+// x^11 + x^9 + 1 side-stream scrambler, same LFSR as the descrambler.
+inline std::vector<uint8_t> scramble(const std::vector<uint8_t>& bits, unsigned seed)
+{
+    gr::ethernet::scrambler_lfsr lfsr(seed);
+    std::vector<uint8_t> out(bits.size());
+    for (size_t i = 0; i < bits.size(); i++) {
+        out[i] = (bits[i] & 1) ^ lfsr.next();
+    }
+    return out;
+}
+
+// MLT-3 levels at one sample per symbol, with additive gaussian noise.
+inline std::vector<float> mlt3_levels(const std::vector<uint8_t>& bits, float noise_rms)
+{
+    static const float cycle[4] = { 0.0f, 1.0f, 0.0f, -1.0f };
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, noise_rms);
+    std::vector<float> out(bits.size());
+    int phase = 0;
+    for (size_t i = 0; i < bits.size(); i++) {
+        if (bits[i] & 1) phase = (phase + 1) & 3;
+        out[i] = cycle[phase] + (noise_rms > 0 ? noise(rng) : 0.0f);
+    }
+    return out;
+}
+
+// Uniformly random bits: the descrambler never finds a seed on this.
+inline std::vector<uint8_t> random_bits(size_t n, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> out(n);
+    for (auto& b : out) b = rng() & 1;
+    return out;
+}
+
+/*
+ * 10BASE-T half-bit samples as produced by threshold_ff + float_to_uchar
+ * (01 = 1, 10 = 0), with the tag that correlate_access_code_tag_bb puts
+ * right after the SFD.
+ */
+inline std::vector<uint8_t> make_manchester_stream(const std::vector<std::vector<uint8_t>>& frames,
+                                                   int idle_samples,
+                                                   const std::string& tag_name,
+                                                   std::vector<gr::tag_t>& tags)
+{
+    std::vector<uint8_t> samples;
+    auto push_bit = [&samples](int bit) {
+        samples.push_back(bit ? 0 : 1);
+        samples.push_back(bit ? 1 : 0);
+    };
+    tags.clear();
+    for (const auto& frame : frames) {
+        samples.insert(samples.end(), idle_samples, 0);
+        for (int i = 0; i < 7; i++)
+            for (int b = 0; b < 8; b++) push_bit((0x55 >> b) & 1);
+        for (int b = 0; b < 8; b++) push_bit((0xD5 >> b) & 1);
+
+        gr::tag_t tag;
+        tag.offset = samples.size();
+        tag.key = pmt::intern(tag_name);
+        tag.value = pmt::from_long(0);
+        tags.push_back(tag);
+
+        for (uint8_t byte : frame)
+            for (int b = 0; b < 8; b++) push_bit((byte >> b) & 1);
+    }
+    samples.insert(samples.end(), idle_samples, 0);
+    return samples;
+}
+
+} // namespace bench
+
+#endif /* INCLUDED_ETHERNET_BENCH_SYNTHETIC_SIGNAL_H */
@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_ACTIVITY_SQUELCH_H
+#define INCLUDED_ETHERNET_ACTIVITY_SQUELCH_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief 10BASE-T activity gate: forwards frame bursts, drops dead line time
+ * \ingroup ethernet
+ *
+ * A sample is active when its magnitude exceeds \p threshold (in input
+ * units, for float, int16 or int8 samples). A burst starts at an active
+ * sample and ends once the line has been quiet for \p post seconds; it is
+ * forwarded with \p pre seconds of the line before it and the \p post
+ * quiet seconds after it, and everything between bursts is dropped, so
+ * the resampler, Symbol Sync and correlator downstream only run on
+ * frames. The first sample of a burst gets a "burst_start" tag and its
+ * last one a "burst_end" tag, both holding the sample's offset in the
+ * input (uint64).
+ *
+ * Bursts with less than 1 us of activity are link pulses, not frames:
+ * they are not forwarded. Pulses less than 200 us apart form a train;
+ * a train of at least 9 pulses is a Fast Link Pulse burst (the 17 to 33
+ * pulses of an auto-negotiation code word), the others are Normal Link
+ * Pulses. Each NLP and FLP burst is published on the "link" port as a dict
+ * (see the README) with, for FLP, the 16-bit link code word when its
+ * clock and data pulses could be told apart.
+ */
+template <class T>
+class ETHERNET_API activity_squelch_blk : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<activity_squelch_blk<T>> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of ethernet::activity_squelch.
+     *
+     * \param samp_rate input sample rate
+     * \param threshold magnitude above which the line is active
+     * \param pre seconds of line forwarded before each burst
+     * \param post quiet seconds ending a burst, forwarded after it
+     */
+    static sptr make(double samp_rate,
+                     float threshold = 0.1f,
+                     double pre = 1e-6,
+                     double post = 1e-6);
+
+    virtual void set_threshold(float threshold) = 0;
+    virtual float threshold() const = 0;
+
+    //! Bursts forwarded.
+    virtual uint64_t bursts() const = 0;
+    //! Input samples dropped between bursts.
+    virtual uint64_t samples_dropped() const = 0;
+    //! Normal Link Pulses seen.
+    virtual uint64_t nlp_count() const = 0;
+    //! Fast Link Pulse bursts seen.
+    virtual uint64_t flp_count() const = 0;
+};
+
+typedef activity_squelch_blk<float> activity_squelch;
+typedef activity_squelch_blk<std::int16_t> activity_squelch_s;
+typedef activity_squelch_blk<std::int8_t> activity_squelch_b;
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_ACTIVITY_SQUELCH_H */
@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_BATCH_DECODE_H
+#define INCLUDED_ETHERNET_BATCH_DECODE_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/ethernet/frame_record.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Whole-capture decoding, without a flowgraph.
+ * \ingroup ethernet
+ *
+ * The same processing as the receive blocks, run once over a buffer
+ * already in memory (e.g. a NumPy array from Python). Bits are one per
+ * byte, as on the blocks' streams. Decoded frames are appended to a
+ * frame_record_writer; their sample_offset is the index in the input
+ * buffer, like the decoders' offsets in their input stream. The
+ * functions keep no state between calls.
+ *
+ * The functions that slice samples also take int16 and int8 samples, as
+ * read from a digitizer. Samples are compared as if multiplied by
+ * \p gain (positive, std::invalid_argument otherwise), which is folded
+ * into the threshold as in slicer3.
+ */
+
+/*!
+ * \brief Slicer3 followed by MLT-3 to Scrambled.
+ *
+ * Levels are sliced at +/- \p threshold, and bit i is 1 when level i
+ * differs from level i - 1 (the level before the buffer is 0).
+ */
+ETHERNET_API void mlt3_decode(
+    const float* symbols, size_t n, float threshold, uint8_t* bits, float gain = 1.0f);
+ETHERNET_API void mlt3_decode(
+    const int16_t* symbols, size_t n, float threshold, uint8_t* bits, float gain = 1.0f);
+ETHERNET_API void mlt3_decode(
+    const int8_t* symbols, size_t n, float threshold, uint8_t* bits, float gain = 1.0f);
+
+/*!
+ * \brief Descrambles a 100BASE-TX bit stream as fastethernet_descrambler
+ * does.
+ *
+ * The same acquisition and lock supervision as the block, with the same
+ * parameters and defaults: the seed search over IDLE, the fast relock on
+ * the predicted states for \p search_window bits after a loss of lock,
+ * and the \p max_idle_no_idle and \p max_in_frame_no_idle limits. Bits
+ * are copied unchanged while unlocked. \p out may be \p in.
+ *
+ * \return the number of times the scrambler state was acquired
+ */
+ETHERNET_API size_t descramble(const uint8_t* in,
+                               size_t n,
+                               uint8_t* out,
+                               int search_window = 50,
+                               int idle_run = 40,
+                               int max_idle_no_idle = 100,
+                               int max_in_frame_no_idle = 20000,
+                               int idle_errors = 0);
+
+/*!
+ * \brief Frames of a descrambled 100BASE-TX bit stream.
+ *
+ * Frames start at IDLE /J/K/ and end at /T/R/ IDLE, as in
+ * fastethernet_frame_decoder; invalid code-groups are skipped, a frame
+ * longer than 30000 bits is dropped. sample_offset is the index of the
+ * /J/.
+ *
+ * \return the number of frames added to \p out
+ */
+ETHERNET_API size_t decode_4b5b(const uint8_t* bits, size_t n, frame_record_writer& out);
+
+/*!
+ * \brief Manchester half-bit pairs to bits: 01 is 1, 10 is 0, other pairs
+ * are dropped.
+ *
+ * \p bits must hold n / 2 bytes.
+ * \return the number of bits written
+ */
+ETHERNET_API size_t manchester_decode(const uint8_t* halfbits, size_t n, uint8_t* bits);
+
+/*!
+ * \brief Frames of 100BASE-TX symbols (one float per symbol, e.g. the
+ * output of the example's Symbol Sync): mlt3_decode(), descramble() with
+ * its defaults but \p idle_run, and decode_4b5b().
+ *
+ * \return the number of frames added to \p out
+ */
+ETHERNET_API size_t decode_100basetx(const float* symbols,
+                                     size_t n,
+                                     frame_record_writer& out,
+                                     float threshold = 0.25f,
+                                     int idle_run = 40,
+                                     float gain = 1.0f);
+ETHERNET_API size_t decode_100basetx(const int16_t* symbols,
+                                     size_t n,
+                                     frame_record_writer& out,
+                                     float threshold = 0.25f,
+                                     int idle_run = 40,
+                                     float gain = 1.0f);
+ETHERNET_API size_t decode_100basetx(const int8_t* symbols,
+                                     size_t n,
+                                     frame_record_writer& out,
+                                     float threshold = 0.25f,
+                                     int idle_run = 40,
+                                     float gain = 1.0f);
+
+/*!
+ * \brief Frames of 10BASE-T half-bit samples (two floats per bit, e.g.
+ * the output of the example's Symbol Sync).
+ *
+ * Samples are sliced with hysteresis at +/- \p threshold, as the
+ * example's Threshold block does. A frame starts after the end of the
+ * preamble and SFD (the example's access code), ends when the line goes
+ * quiet or at the next SFD, and is decoded as in ethernet_10baset_decoder.
+ * A frame still open at the end of the buffer is decoded too.
+ * sample_offset is the index of the first sample after the SFD.
+ *
+ * \return the number of frames added to \p out
+ */
+ETHERNET_API size_t decode_10baset(const float* samples,
+                                   size_t n,
+                                   frame_record_writer& out,
+                                   float threshold = 0.1f,
+                                   float gain = 1.0f);
+ETHERNET_API size_t decode_10baset(const int16_t* samples,
+                                   size_t n,
+                                   frame_record_writer& out,
+                                   float threshold = 0.1f,
+                                   float gain = 1.0f);
+ETHERNET_API size_t decode_10baset(const int8_t* samples,
+                                   size_t n,
+                                   frame_record_writer& out,
+                                   float threshold = 0.1f,
+                                   float gain = 1.0f);
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_BATCH_DECODE_H */
@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_CAPTURE_SOURCE_H
+#define INCLUDED_ETHERNET_CAPTURE_SOURCE_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Oscilloscope capture file source, memory-mapped
+ * \ingroup ethernet
+ *
+ * Reads a waveform export and outputs float samples multiplied by \p scale.
+ * The file is mapped rather than read: samples are converted (VOLK) from
+ * the page cache straight into the output buffer, and the kernel is asked
+ * to read ahead of the current position. Formats:
+ *
+ * - "float32", "int16", "int8": raw little-endian values after
+ *   \p header_bytes bytes of header.
+ * - "rs_wfm": Rohde & Schwarz .Wfm.bin, whose 8-byte header gives the
+ *   bytes per value (1, 2 or 4: int8, int16 or float32) and the record
+ *   length. \p header_bytes is ignored.
+ *
+ * With \p samp_rate > 0, the first sample, and the first one of every
+ * pass over the file with \p repeat, get "rx_time" (uint64 seconds,
+ * double fraction, counted from the first sample output) and "rx_rate"
+ * (double) tags. Without \p repeat, the block is done at the end of the
+ * file.
+ */
+class ETHERNET_API capture_source : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<capture_source> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of ethernet::capture_source.
+     *
+     * Throws std::invalid_argument for an unknown format, and
+     * std::runtime_error when the file cannot be mapped or holds no sample.
+     */
+    static sptr make(const std::string& filename,
+                     const std::string& format = "float32",
+                     double samp_rate = 0,
+                     float scale = 1.0f,
+                     size_t header_bytes = 0,
+                     bool repeat = false);
+
+    //! Samples in one pass over the file.
+    virtual uint64_t nsamples() const = 0;
+    virtual double samp_rate() const = 0;
+    virtual void set_scale(float scale) = 0;
+    virtual float scale() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_CAPTURE_SOURCE_H */
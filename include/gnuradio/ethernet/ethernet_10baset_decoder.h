@@ -2,18 +2,69 @@
 #define INCLUDED_ETHERNET_ETHERNET_10BASET_DECODER_H
 
 #include <gnuradio/ethernet/api.h>
-#include <gnuradio/sync_block.h>
+#include <gnuradio/block.h>
 #include <string>
 
 namespace gr {
 namespace ethernet {
 
-class ETHERNET_API ethernet_10baset_decoder : virtual public gr::sync_block
+class ETHERNET_API ethernet_10baset_decoder : virtual public gr::block
 {
 public:
     typedef std::shared_ptr<ethernet_10baset_decoder> sptr;
     
-    static sptr make(const std::string& tag_name = "packet");
+    /*!
+     * \param tag_name tag placed after the SFD. A frame runs from the tag
+     *        until the line goes quiet (two half-bit pairs without a
+     *        transition), the next tag or 1530 bytes, and is decoded whole.
+     * \param stats_interval_ms period of the "stats" messages, 0 to disable
+     * \param trace_latency record per-frame latency histograms ("latency" in
+     *        the stats dict, "trace" in each decoded dict)
+     * \param filter BPF-like frame filter (see frame_filter), empty to keep
+     *        every frame. Also settable through the "filter" message port.
+     * \param batch_size frames per "decoded" message (a PMT vector of
+     *        dicts), <= 1 for one dict per frame
+     * \param batch_bytes frame bytes that trigger a batch, 0 for no limit
+     * \param batch_timeout_ms age of the oldest frame that triggers a batch,
+     *        0 for no limit
+     * \param len_tag_key key of the frame length tags of the byte output
+     *
+     * The "records" port carries the same frames as binary record batches
+     * (see frame_record.h); with only "records" connected, no dict is built.
+     * The same goes for the byte output below.
+     *
+     * The optional byte output carries the bytes of the same frames back to
+     * back, as a tagged stream: the first byte of a frame has a
+     * \p len_tag_key tag (its length) and sample_offset, fcs_ok and lane
+     * (0) tags. While the output is full, no input is consumed.
+     */
+    static sptr make(const std::string& tag_name = "packet",
+                     int stats_interval_ms = 0,
+                     bool trace_latency = false,
+                     const std::string& filter = "",
+                     int batch_size = 0,
+                     int batch_bytes = 0,
+                     int batch_timeout_ms = 0,
+                     const std::string& len_tag_key = "packet_len");
+    
+    virtual void set_stats_interval(int stats_interval_ms) = 0;
+    virtual int stats_interval() const = 0;
+    virtual void set_trace_latency(bool trace_latency) = 0;
+    virtual bool trace_latency() const = 0;
+    
+    //! Throws std::invalid_argument if \p filter does not compile.
+    virtual void set_filter(const std::string& filter) = 0;
+    virtual std::string filter() const = 0;
+    
+    //! Frames published on the "decoded" port
+    virtual uint64_t frames_decoded() const = 0;
+    //! Decoded frames whose FCS does not match
+    virtual uint64_t fcs_failures() const = 0;
+    //! Frames dropped by the filter
+    virtual uint64_t frames_filtered() const = 0;
+    //! Number of work() calls and the high_res_timer ticks spent in them
+    virtual uint64_t work_calls() const = 0;
+    virtual uint64_t work_ticks() const = 0;
 };
 
 } // namespace ethernet
@@ -0,0 +1,49 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_ETHERNET_FRAMER_H
+#define INCLUDED_ETHERNET_ETHERNET_FRAMER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Builds Ethernet frames from PDUs (preamble, SFD, padding and FCS)
+ * \ingroup ethernet
+ *
+ * Each PDU on the "pdus" port holds a frame from the destination MAC to
+ * the end of the payload. The frame is padded to 60 bytes, the FCS is
+ * appended, and 7 preamble bytes plus the SFD are prepended. Frames leave
+ * back-to-back as bytes; the first byte of each one carries a length tag
+ * for the line encoders.
+ *
+ * With \p repeat set, the frames received so far are replayed in a loop
+ * whenever no new PDU is pending, so a handful of messages can load the
+ * encoders continuously.
+ */
+class ETHERNET_API ethernet_framer : virtual public gr::sync_block {
+public:
+  typedef std::shared_ptr<ethernet_framer> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::ethernet_framer.
+   *
+   * \param repeat replay the received frames when no PDU is pending
+   * \param len_tag_key key of the tag holding each frame length in bytes
+   */
+  static sptr make(bool repeat = false,
+                   const std::string& len_tag_key = "packet_len");
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_ETHERNET_FRAMER_H */
@@ -0,0 +1,47 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FASTETHERNET_4B5B_ENCODER_H
+#define INCLUDED_ETHERNET_FASTETHERNET_4B5B_ENCODER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief 100BASE-TX 4B/5B encoder with /J/K/, /T/R/ and IDLE insertion
+ * \ingroup ethernet
+ *
+ * Input: ethernet_framer bytes, with a length tag on the first preamble
+ * byte of each frame. That byte is replaced by /J/K/, every following
+ * byte is sent as two code-groups (low nibble first) and /T/R/ closes the
+ * frame. \p idle_symbols IDLE code-groups are sent before the first frame
+ * and after every frame. Output: one unscrambled bit per byte, in the
+ * format fastethernet_frame_decoder expects.
+ */
+class ETHERNET_API fastethernet_4b5b_encoder : virtual public gr::block {
+public:
+  typedef std::shared_ptr<fastethernet_4b5b_encoder> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of
+   * ethernet::fastethernet_4b5b_encoder.
+   *
+   * \param idle_symbols IDLE code-groups between frames (24 = 96 bit times)
+   * \param len_tag_key key of the frame length tag set by the framer
+   */
+  static sptr make(int idle_symbols = 24,
+                   const std::string& len_tag_key = "packet_len");
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FASTETHERNET_4B5B_ENCODER_H */
@@ -18,6 +18,38 @@ namespace ethernet {
  * \brief <+description of block+>
  * \ingroup ethernet
  *
+ * Counters are available through the getters below, ControlPort, and the
+ * optional "stats" message port (a dict published every stats_interval_ms).
+ *
+ * While locked, descrambled IDLE is all ones, so a zero in an IDLE span is
+ * a bit error. The descrambled bits are packed in 64-bit words; a word of
+ * ones starts an IDLE span, and the words that follow count as IDLE, their
+ * zeros as errors, until a word holds two adjacent zeros (the /J/ of a
+ * frame, or a burst of errors) or more than 4 zeros. The bit error rate
+ * over the last \p ber_window IDLE bits is tagged "ber" (double) on the
+ * last bit of every second of line time (125 Mbit), and published with the
+ * error counts on the stats port. It is off by default (\p ber_window 0);
+ * a window of 1000000 bits gives a steady rate.
+ *
+ * The seed search checks every unlocked input bit against the scrambler
+ * recurrence (over IDLE, the key stream is the complement of the input):
+ * idle_run bits in a row that follow it are IDLE, and the lock is taken on
+ * the bit after them. Acquisition and lock supervision run bit by bit, so
+ * the output does not depend on how the input is split into work() calls.
+ *
+ * Lock is kept while every window of max_idle_no_idle bits (outside
+ * frames) holds an IDLE run: idle_run bits of ones, or with \p idle_errors
+ * > 0, idle_run bits with at most idle_errors zeros. In that tolerant mode,
+ * a window without IDLE only makes the lock suspect: it is lost when the
+ * next, independent window has no IDLE either, so isolated bit errors do
+ * not cost a seed search.
+ *
+ * After a loss of lock, the state the scrambler should have reached is
+ * still known, if the loss came from noise rather than a re-seed: the
+ * state at the loss, advanced by one bit per input bit. That state and its
+ * bit-slip neighbours (+/-1 to 3 bits) descramble every input bit while
+ * unlocked, and the first to give idle_run ones in a row is taken at once;
+ * the seed search only runs when none does within search_window bits.
  */
 class ETHERNET_API fastethernet_descrambler : virtual public gr::sync_block {
 public:
@@ -34,7 +66,35 @@ public:
    */
   static sptr make(int search_window = 50, int idle_run = 40,
                    int max_idle_no_idle = 100, int max_in_frame_no_idle = 20000,
-                   bool print_debug = false);
+                   bool print_debug = false, int stats_interval_ms = 0,
+                   int ber_window = 0, int idle_errors = 0);
+
+  virtual void set_stats_interval(int stats_interval_ms) = 0;
+  virtual int stats_interval() const = 0;
+
+  //! True while the scrambler state is known
+  virtual bool locked() const = 0;
+  //! Number of locks (including the first one) and losses of lock
+  virtual uint64_t resync_count() const = 0;
+  //! Bits between the last loss of lock (or start) and the lock that followed
+  virtual uint64_t last_lock_bits() const = 0;
+  //! Bits passed through while unlocked (not descrambled)
+  virtual uint64_t unlocked_bits() const = 0;
+  //! Locks taken from the predicted state, without a seed search
+  virtual uint64_t fast_relocks() const = 0;
+  //! Suspected losses of lock that the next IDLE window did not confirm
+  virtual uint64_t lock_holds() const = 0;
+  //! IDLE bits checked for errors, and the zeros found in them
+  virtual uint64_t idle_bits() const = 0;
+  virtual uint64_t idle_bit_errors() const = 0;
+  //! Bit error rate over the last ber_window IDLE bits
+  virtual double ber() const = 0;
+  //! Seconds of line time, and those with at least one IDLE bit error
+  virtual uint64_t line_seconds() const = 0;
+  virtual uint64_t errored_seconds() const = 0;
+  //! Number of work() calls and the high_res_timer ticks spent in them
+  virtual uint64_t work_calls() const = 0;
+  virtual uint64_t work_ticks() const = 0;
 };
 
 } // namespace ethernet
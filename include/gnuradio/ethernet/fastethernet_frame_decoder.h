@@ -9,7 +9,8 @@
 #define INCLUDED_ETHERNET_FASTETHERNET_FRAME_DECODER_H
 
 #include <gnuradio/ethernet/api.h>
-#include <gnuradio/sync_block.h>
+#include <gnuradio/block.h>
+#include <string>
 
 namespace gr {
 namespace ethernet {
@@ -18,8 +19,34 @@ namespace ethernet {
  * \brief <+description of block+>
  * \ingroup ethernet
  *
+ * Counters are available through the getters below, ControlPort, and the
+ * optional "stats" message port (a dict published every stats_interval_ms).
+ *
+ * With trace_latency, each decoded dict gets a "trace" entry (offsets and
+ * high_res_timer timestamps at SFD, end of frame and dissection), and the
+ * stats dict a "latency" entry with p50/p99/p999 per stage.
+ *
+ * Frames that do not match \p filter (see frame_filter) are dropped right
+ * after byte recovery, before dissection. The filter can be replaced at
+ * run time through the "filter" message port (a symbol holding the new
+ * expression, or a ("filter" . expression) pair).
+ *
+ * With batch_size > 1, the decoded dicts are published as one PMT vector
+ * per batch, sent when it holds batch_size frames, batch_bytes frame bytes
+ * or a frame older than batch_timeout_ms (0 disables the last two limits).
+ *
+ * The "records" port carries the same frames as binary record batches
+ * (see frame_record.h), flushed together with the dicts. Connecting only
+ * "records" skips building the dicts altogether.
+ *
+ * The optional byte output carries the bytes of the same frames back to
+ * back, from the destination MAC to the FCS, as a tagged stream for
+ * tagged_stream_blocks and file sinks: the first byte of a frame has a
+ * len_tag_key tag (its length) and sample_offset, fcs_ok and lane (0)
+ * tags. While the output is full, no input is consumed. Connecting only
+ * the byte output skips building the dicts too.
  */
-class ETHERNET_API fastethernet_frame_decoder : virtual public gr::sync_block {
+class ETHERNET_API fastethernet_frame_decoder : virtual public gr::block {
 public:
   typedef std::shared_ptr<fastethernet_frame_decoder> sptr;
 
@@ -31,8 +58,45 @@ public:
    * ethernet::fastethernet_frame_decoder's constructor is in a private
    * implementation class. ethernet::fastethernet_frame_decoder::make is the
    * public interface for creating new instances.
+   *
+   * \param stats_interval_ms period of the "stats" messages, 0 to disable
+   * \param trace_latency record per-frame latency histograms
+   * \param filter BPF-like frame filter, empty to keep every frame
+   * \param batch_size frames per "decoded" message, <= 1 for one dict per frame
+   * \param batch_bytes frame bytes that trigger a batch, 0 for no limit
+   * \param batch_timeout_ms age of the oldest frame that triggers a batch,
+   *        0 for no limit
+   * \param len_tag_key key of the frame length tags of the byte output
    */
-  static sptr make();
+  static sptr make(int stats_interval_ms = 0, bool trace_latency = false,
+                   const std::string& filter = "", int batch_size = 0,
+                   int batch_bytes = 0, int batch_timeout_ms = 0,
+                   const std::string& len_tag_key = "packet_len");
+
+  virtual void set_stats_interval(int stats_interval_ms) = 0;
+  virtual int stats_interval() const = 0;
+  virtual void set_trace_latency(bool trace_latency) = 0;
+  virtual bool trace_latency() const = 0;
+
+  //! Throws std::invalid_argument if \p filter does not compile.
+  virtual void set_filter(const std::string& filter) = 0;
+  virtual std::string filter() const = 0;
+
+  //! Frames published on the "decoded" port
+  virtual uint64_t frames_decoded() const = 0;
+  //! Frames abandoned because no /T/R/ came within the size limit
+  virtual uint64_t frames_timed_out() const = 0;
+  //! Frames found between /J/K/ and /T/R/ that could not be decoded
+  virtual uint64_t decode_errors() const = 0;
+  //! 5-bit groups that are not a valid data or control code
+  virtual uint64_t code_violations() const = 0;
+  //! Decoded frames whose FCS does not match
+  virtual uint64_t fcs_failures() const = 0;
+  //! Frames dropped by the filter
+  virtual uint64_t frames_filtered() const = 0;
+  //! Number of work() calls and the high_res_timer ticks spent in them
+  virtual uint64_t work_calls() const = 0;
+  virtual uint64_t work_ticks() const = 0;
 };
 
 } // namespace ethernet
@@ -0,0 +1,40 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FASTETHERNET_SCRAMBLER_H
+#define INCLUDED_ETHERNET_FASTETHERNET_SCRAMBLER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief 100BASE-TX side-stream scrambler (x^11 + x^9 + 1)
+ * \ingroup ethernet
+ *
+ * XORs every bit with the LFSR key stream. This is the exact inverse of
+ * fastethernet_descrambler once the latter has found the state.
+ */
+class ETHERNET_API fastethernet_scrambler : virtual public gr::sync_block {
+public:
+  typedef std::shared_ptr<fastethernet_scrambler> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of
+   * ethernet::fastethernet_scrambler.
+   *
+   * \param seed initial 11-bit LFSR state (must not be 0)
+   */
+  static sptr make(int seed = 0x7FF);
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FASTETHERNET_SCRAMBLER_H */
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FLOW_TABLE_H
+#define INCLUDED_ETHERNET_FLOW_TABLE_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Per-flow accounting of decoded frames
+ * \ingroup ethernet
+ *
+ * The "frames" port takes a decoder's "records" batches or "decoded"
+ * dicts. Frames are accounted per unidirectional flow, keyed on VLAN and
+ * 5-tuple (addresses, IP protocol, TCP/UDP ports) for IP, on VLAN, MACs
+ * and EtherType otherwise: packets, bytes, first and last sample offset
+ * and decoding time, and the TCP flags seen.
+ *
+ * The table holds at most max_flows flows in memory allocated once. A
+ * flow is reported on "flows" when it has been idle for idle_timeout_s,
+ * when it is evicted as the least recently seen to make room for a new
+ * one, and when the flowgraph stops. With report_interval_s > 0, active
+ * flows are also reported at that interval and their counters restart,
+ * so every report covers a disjoint period: packets, bytes, TCP flags
+ * and the first and last frame are those since the flow's previous
+ * report. A flow with no frame since then is removed without a report.
+ *
+ * Each "flows" message is a PMT vector of flow dicts (see the README),
+ * one message per sweep: the message rate follows the number of flows,
+ * not of frames.
+ */
+class ETHERNET_API flow_table : virtual public gr::block {
+public:
+  typedef std::shared_ptr<flow_table> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::flow_table.
+   *
+   * \param max_flows flows kept at most (about 150 bytes each)
+   * \param idle_timeout_s a flow without frames for this long is reported and removed
+   * \param report_interval_s active flows are reported at this interval, 0 for never
+   */
+  static sptr make(int max_flows = 65536,
+                   double idle_timeout_s = 30.0,
+                   double report_interval_s = 0.0);
+
+  //! Flows currently in the table.
+  virtual uint64_t active_flows() const = 0;
+  //! Flows removed after their idle timeout or at stop, reported or not.
+  virtual uint64_t flows_expired() const = 0;
+  //! Flows removed to make room for a new one.
+  virtual uint64_t flows_evicted() const = 0;
+  //! Frames accounted.
+  virtual uint64_t frames_received() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FLOW_TABLE_H */
@@ -0,0 +1,87 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FRAME_FILTER_H
+#define INCLUDED_ETHERNET_FRAME_FILTER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Frame filter with a BPF-like syntax, compiled once.
+ * \ingroup ethernet
+ *
+ * The expression is compiled into a predicate tree (stored flat) whose
+ * leaves compare raw frame bytes at offsets computed once per frame, so
+ * match() does no allocation and no string work. Frames start at the
+ * destination MAC (no preamble, FCS included).
+ *
+ * Primitives:
+ *   ether src|dst|host MAC     ether proto N     ip  ip6  arp
+ *   vlan [ID]                  [src|dst] host A.B.C.D
+ *   [src|dst] net A.B.C.D/LEN  ip proto N  (or: proto N)
+ *   tcp  udp  icmp             [tcp|udp] [src|dst] port N
+ *   [tcp|udp] [src|dst] portrange N-M
+ *   greater N  less N          (frame length, BPF semantics: >= and <=)
+ * combined with and/&&, or/||, not/! and parentheses. Numbers are decimal
+ * or 0x hex.
+ *
+ * Unlike BPF, L3/L4 primitives look through one 802.1Q/802.1ad tag
+ * whether or not "vlan" appears first, so "tcp port 502" also matches
+ * tagged frames and "vlan 10 and tcp port 502" works as expected.
+ */
+class ETHERNET_API frame_filter
+{
+public:
+    typedef std::shared_ptr<const frame_filter> sptr;
+
+    /*!
+     * Compiles \p expression; an empty expression matches every frame.
+     * Throws std::invalid_argument on a syntax error.
+     */
+    explicit frame_filter(const std::string& expression);
+
+    bool match(const uint8_t* frame, size_t len) const;
+
+    //! Match on the first \p caplen bytes of a frame of \p wire_len bytes.
+    bool match(const uint8_t* frame, size_t caplen, size_t wire_len) const;
+
+    const std::string& expression() const { return d_expression; }
+
+    //! Compiled tree, one node per line (for debugging).
+    std::string dump() const;
+
+    //! Shared instance, or nullptr for an empty expression.
+    static sptr compile(const std::string& expression);
+
+    //! Internal: one node of the compiled tree.
+    struct node {
+        uint8_t op;
+        uint8_t mac[6];
+        uint32_t a;
+        uint32_t b;
+        int32_t left;
+        int32_t right;
+    };
+
+private:
+    std::string d_expression;
+    std::vector<node> d_nodes;
+    int32_t d_root;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FRAME_FILTER_H */
@@ -0,0 +1,226 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FRAME_RECORD_H
+#define INCLUDED_ETHERNET_FRAME_RECORD_H
+
+#include <gnuradio/ethernet/api.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Binary frame records, as published on the decoders' "records" port.
+ * \ingroup ethernet
+ *
+ * One message is a u8vector holding a batch of records. Everything is
+ * little-endian, multi-byte fields are naturally aligned, addresses are
+ * raw bytes in network order.
+ *
+ * Batch header (FRAME_RECORD_BATCH_HEADER bytes):
+ * \code
+ *    0  u32  magic        FRAME_RECORD_MAGIC, "ETHR"
+ *    4  u16  version      FRAME_RECORD_VERSION
+ *    6  u16  record_size  size of one record header
+ *    8  u32  count        number of records
+ *   12  u32  data_offset  start of the frame bytes, from the start of the message
+ * \endcode
+ * followed by \c count record headers of \c record_size bytes, then the
+ * frame bytes of every record, concatenated.
+ *
+ * Record header, version 1 (FRAME_RECORD_SIZE bytes):
+ * \code
+ *    0  u64  frame_num      decoder frame counter
+ *    8  u64  sample_offset  input item of the start of frame
+ *   16  u64  time_ns        decoding time, ns since the Unix epoch
+ *   24  u32  data_offset    frame bytes, from data_offset of the batch
+ *   28  u16  frame_len      destination MAC to FCS
+ *   30  u16  flags          FRAME_RECORD_* bits
+ *   32  u16  ethertype      after the VLAN tag
+ *   34  u16  vlan_tci       0 when untagged
+ *   36  u16  l3_offset      in the frame, 0 when not IP
+ *   38  u16  l4_offset      in the frame, 0 when there is no usable L4 header
+ *   40  u16  src_port       TCP/UDP, 0 otherwise
+ *   42  u16  dst_port
+ *   44  u8   ip_proto       IPv4 protocol / IPv6 next header
+ *   45  u8   ip_ttl         TTL / hop limit
+ *   46  u8   tcp_flags
+ *   47  u8   icmp_type
+ *   48  u8   icmp_code
+ *   49  u8   lane           input of multilane_decoder, 0 otherwise
+ *   50  u8   reserved[2]
+ *   52  u8   mac_dst[6]
+ *   58  u8   mac_src[6]
+ *   64  u8   ip_src[16]     IPv4 addresses use the first 4 bytes
+ *   80  u8   ip_dst[16]
+ * \endcode
+ *
+ * Later versions only append fields to the record header: readers stride
+ * by record_size and ignore what they do not know.
+ */
+const uint32_t FRAME_RECORD_MAGIC = 0x52485445; // "ETHR"
+const uint16_t FRAME_RECORD_VERSION = 1;
+const size_t FRAME_RECORD_BATCH_HEADER = 16;
+const size_t FRAME_RECORD_SIZE = 96;
+
+enum frame_record_flags : uint16_t {
+    FRAME_RECORD_FCS_OK = 0x01,
+    FRAME_RECORD_VLAN = 0x02,
+    FRAME_RECORD_IPV4 = 0x04,
+    FRAME_RECORD_IPV6 = 0x08,
+    FRAME_RECORD_L4 = 0x10, // l4_offset and the L4 fields are valid
+};
+
+/*!
+ * \brief Named fields of one record header, read in place.
+ *
+ * The derived accessors (vlan_id(), ip_version(), has_ports(), ...) apply
+ * the flags, so readers do not use a field the decoder did not set.
+ */
+class frame_record_view
+{
+public:
+    explicit frame_record_view(const uint8_t* header) : d_h(header) {}
+
+    //! The raw header, FRAME_RECORD_SIZE bytes.
+    const uint8_t* data() const { return d_h; }
+
+    uint64_t frame_num() const { return get64(0); }
+    uint64_t sample_offset() const { return get64(8); }
+    uint64_t time_ns() const { return get64(16); }
+    uint32_t data_offset() const { return get32(24); }
+    uint16_t frame_len() const { return get16(28); }
+    uint16_t flags() const { return get16(30); }
+    uint16_t ethertype() const { return get16(32); }
+    uint16_t vlan_tci() const { return get16(34); }
+    uint16_t l3_offset() const { return get16(36); }
+    uint16_t l4_offset() const { return get16(38); }
+    uint16_t src_port() const { return get16(40); }
+    uint16_t dst_port() const { return get16(42); }
+    uint8_t ip_proto() const { return d_h[44]; }
+    uint8_t ip_ttl() const { return d_h[45]; }
+    uint8_t tcp_flags() const { return d_h[46]; }
+    uint8_t icmp_type() const { return d_h[47]; }
+    uint8_t icmp_code() const { return d_h[48]; }
+    uint8_t lane() const { return d_h[49]; }
+    const uint8_t* mac_dst() const { return d_h + 52; }
+    const uint8_t* mac_src() const { return d_h + 58; }
+    const uint8_t* ip_src() const { return d_h + 64; }
+    const uint8_t* ip_dst() const { return d_h + 80; }
+
+    bool fcs_ok() const { return flags() & FRAME_RECORD_FCS_OK; }
+    bool has_vlan() const { return flags() & FRAME_RECORD_VLAN; }
+    //! VLAN ID, -1 when untagged.
+    int vlan_id() const { return has_vlan() ? vlan_tci() & 0x0FFF : -1; }
+    //! 4, 6, or 0 when the frame is not IP.
+    int ip_version() const
+    {
+        return (flags() & FRAME_RECORD_IPV4) ? 4 : (flags() & FRAME_RECORD_IPV6) ? 6 : 0;
+    }
+    bool has_l4() const { return ip_version() && (flags() & FRAME_RECORD_L4); }
+    //! TCP or UDP with its header: src_port() and dst_port() are valid.
+    bool has_ports() const { return has_l4() && (ip_proto() == 6 || ip_proto() == 17); }
+    //! TCP with its header: tcp_flags() is valid.
+    bool is_tcp() const { return has_l4() && ip_proto() == 6; }
+    //! ICMP or ICMPv6: icmp_type() and icmp_code() are valid.
+    bool is_icmp() const { return has_l4() && (ip_proto() == 1 || ip_proto() == 58); }
+
+private:
+    const uint8_t* d_h;
+
+    uint32_t get16(size_t off) const { return d_h[off] | (d_h[off + 1] << 8); }
+    uint32_t get32(size_t off) const { return get16(off) | (get16(off + 2) << 16); }
+    uint64_t get64(size_t off) const { return get32(off) | ((uint64_t)get32(off + 4) << 32); }
+};
+
+//! The clock of time_ns: ns since the Unix epoch.
+ETHERNET_API uint64_t frame_record_time_ns();
+
+//! "aa:bb:cc:dd:ee:ff"
+ETHERNET_API std::string format_mac(const uint8_t* mac);
+
+//! An address in the record layout (IPv4 in the first 4 bytes) as text,
+//! empty when ip_version is neither 4 nor 6.
+ETHERNET_API std::string format_ip(int ip_version, const uint8_t* addr);
+
+//! TCP flags by name, e.g. "SYN ACK"; empty when none is set.
+ETHERNET_API std::string tcp_flags_string(uint8_t flags);
+
+/*!
+ * \brief Builds a record batch, one frame at a time.
+ *
+ * The buffer is reused from batch to batch, so a writer that is flushed
+ * regularly stops allocating once it has seen its largest batch.
+ */
+class ETHERNET_API frame_record_writer
+{
+public:
+    frame_record_writer();
+
+    //! Adds one frame (destination MAC to FCS) and its decoded header fields.
+    void add(const uint8_t* frame,
+             size_t len,
+             uint64_t frame_num,
+             uint64_t sample_offset,
+             bool fcs_ok,
+             uint8_t lane = 0);
+
+    size_t count() const { return d_headers.size() / FRAME_RECORD_SIZE; }
+    bool empty() const { return d_headers.empty(); }
+
+    //! The whole batch message; valid until the next add() or clear().
+    const std::vector<uint8_t>& finish();
+
+    void clear();
+
+private:
+    std::vector<uint8_t> d_headers;
+    std::vector<uint8_t> d_data;
+    std::vector<uint8_t> d_message;
+};
+
+/*!
+ * \brief Reads a record batch in place, checking its bounds.
+ */
+class ETHERNET_API frame_record_reader
+{
+public:
+    frame_record_reader();
+
+    //! False when msg is not a record batch of a known version.
+    bool open(const uint8_t* msg, size_t len);
+
+    size_t count() const { return d_count; }
+
+    //! Record header i (at least FRAME_RECORD_SIZE bytes).
+    const uint8_t* header(size_t i) const
+    {
+        return d_msg + FRAME_RECORD_BATCH_HEADER + i * d_record_size;
+    }
+
+    //! Fields of record i.
+    frame_record_view record(size_t i) const { return frame_record_view(header(i)); }
+
+    //! Frame bytes of record i, or null when they are out of the message.
+    const uint8_t* frame(size_t i, size_t& len) const;
+
+private:
+    const uint8_t* d_msg;
+    size_t d_count;
+    size_t d_record_size;
+    const uint8_t* d_data;
+    size_t d_data_len;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FRAME_RECORD_H */
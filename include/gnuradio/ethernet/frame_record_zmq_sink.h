@@ -0,0 +1,53 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FRAME_RECORD_ZMQ_SINK_H
+#define INCLUDED_ETHERNET_FRAME_RECORD_ZMQ_SINK_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Publishes binary frame record batches on a ZMQ PUB socket
+ * \ingroup ethernet
+ *
+ * Each u8vector received on the "records" port (see frame_record.h) is
+ * sent as one ZMQ message, bytes unchanged: no PMT serialization on the
+ * wire, so subscribers only need to parse the record layout. A PDU
+ * (meta . u8vector) is accepted too; its metadata is dropped.
+ *
+ * Sends never block: a batch the socket cannot queue (high water mark
+ * reached) is dropped and counted.
+ */
+class ETHERNET_API frame_record_zmq_sink : virtual public gr::block {
+public:
+  typedef std::shared_ptr<frame_record_zmq_sink> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::frame_record_zmq_sink.
+   *
+   * \param address ZMQ endpoint, e.g. "tcp://127.0.0.1:5556"
+   * \param bind bind the endpoint (true) or connect to it
+   * \param hwm send high water mark in messages, <= 0 keeps the libzmq default
+   */
+  static sptr make(const std::string& address = "tcp://127.0.0.1:5556",
+                   bool bind = true,
+                   int hwm = -1);
+
+  virtual uint64_t batches_sent() const = 0;
+  virtual uint64_t batches_dropped() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FRAME_RECORD_ZMQ_SINK_H */
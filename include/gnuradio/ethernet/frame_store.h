@@ -0,0 +1,126 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_FRAME_STORE_H
+#define INCLUDED_ETHERNET_FRAME_STORE_H
+
+#include <gnuradio/ethernet/api.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Indexed in-memory store of decoded frames
+ * \ingroup ethernet
+ *
+ * Frames (header fields plus all their bytes) are appended to columnar
+ * segments; each segment indexes its frames by MAC, IP address, TCP/UDP
+ * port, EtherType and VLAN. When the memory budget is exceeded the oldest
+ * segment is dropped with its indexes, so eviction is oldest first and
+ * costs nothing per frame. Frames are numbered from 1 in arrival order.
+ *
+ * One writer and any number of readers: add() and query() can be called
+ * from different threads. A query holds a shared lock for its duration
+ * (milliseconds over millions of frames when an indexed field is given,
+ * a column scan bounded by the time range otherwise).
+ */
+class ETHERNET_API frame_store
+{
+public:
+    typedef std::shared_ptr<frame_store> sptr;
+
+    //! Search criteria; unset fields match everything.
+    struct query {
+        std::string mac;      //!< source or destination, "aa:bb:cc:dd:ee:ff"
+        std::string ip;       //!< source or destination, IPv4 or IPv6
+        int port = -1;        //!< TCP/UDP source or destination port
+        int ethertype = -1;   //!< after the VLAN tag
+        int vlan = -1;        //!< VLAN ID
+        int ip_proto = -1;    //!< IPv4 protocol / IPv6 next header
+        int tcp_flags = 0;    //!< all of these bits set (TCP only)
+        double last_s = 0;    //!< decoded during the last last_s seconds
+        uint64_t since_id = 0; //!< frames with a larger id
+        size_t limit = 1000;  //!< newest matches returned at most
+
+        /*!
+         * Parses space- or '&'-separated key=value pairs: mac, ip, port,
+         * ethertype, vlan, proto (tcp, udp, icmp or a number), tcp_flags
+         * (names joined by ',' or '|', e.g. "SYN,ACK", or a number), last
+         * (seconds), since and limit. Throws std::invalid_argument.
+         */
+        static query parse(const std::string& text);
+    };
+
+    //! One stored frame, as returned by a query.
+    struct frame {
+        uint64_t id;
+        uint64_t time_ns; //!< decoding time, ns since the Unix epoch
+        uint64_t frame_num;
+        uint64_t sample_offset;
+        bool fcs_ok;
+        int ethertype;
+        int vlan;         //!< -1 when untagged
+        int ip_version;   //!< 4, 6 or 0
+        int ip_proto;     //!< -1 when not IP
+        int src_port;     //!< -1 when not TCP/UDP
+        int dst_port;
+        int tcp_flags;
+        std::string mac_src;
+        std::string mac_dst;
+        std::string ip_src;
+        std::string ip_dst;
+        std::vector<uint8_t> data; //!< destination MAC to FCS
+    };
+
+    //! \param budget_bytes memory kept at most (columns, indexes and bytes)
+    explicit frame_store(size_t budget_bytes);
+    ~frame_store();
+
+    //! Adds one frame (destination MAC to FCS).
+    void add(const uint8_t* frame,
+             size_t len,
+             uint64_t frame_num = 0,
+             uint64_t sample_offset = 0,
+             bool fcs_ok = true);
+
+    //! Adds a record batch (see frame_record.h); returns false if it is not one.
+    bool add_records(const uint8_t* batch, size_t len);
+
+    //! Newest matches (at most q.limit), oldest first.
+    std::vector<frame> find(const query& q) const;
+
+    size_t size() const;          //!< frames stored
+    uint64_t first_id() const;    //!< oldest stored id, last_id() + 1 when empty
+    uint64_t last_id() const;     //!< 0 before the first frame
+    size_t memory_used() const;   //!< bytes, approximate
+    size_t budget() const { return d_budget; }
+
+    struct segment;
+
+private:
+    size_t d_budget;
+    size_t d_segment_bytes; // a segment is sealed past this size
+    mutable std::shared_mutex d_mutex;
+    std::deque<std::unique_ptr<segment>> d_segments;
+    uint64_t d_next_id;
+    size_t d_memory;
+
+    void add_record(const uint8_t* header, const uint8_t* frame);
+    void evict();
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_FRAME_STORE_H */
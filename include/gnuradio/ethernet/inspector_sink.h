@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_INSPECTOR_SINK_H
+#define INCLUDED_ETHERNET_INSPECTOR_SINK_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <gnuradio/ethernet/frame_store.h>
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Keeps the decoded frames in memory and serves them over HTTP
+ * \ingroup ethernet
+ *
+ * The "frames" port takes the output of a decoder: binary record batches
+ * from its "records" port (see frame_record.h) or its "decoded" dicts,
+ * batched or not. Each frame is stored as a fixed-size record (header
+ * fields plus its first snap_len bytes) in a lock-free ring of \p depth
+ * entries, numbered from 1; readers never block the message thread.
+ * With a non-zero \p store_mb, every frame is also kept whole in an
+ * indexed frame_store of that budget, for queries by field over a longer
+ * history than the ring.
+ *
+ * An HTTP server on address:port (its own thread, for the lifetime of
+ * the block) serves:
+ *   - GET /                 the web inspector front end
+ *   - GET /api/frames       ?since=ID&limit=N&filter=EXPR: frames after ID
+ *                           (or the newest N) matching a frame_filter
+ *                           expression, oldest first
+ *   - GET /api/query        ?mac=..&ip=..&port=..&tcp_flags=RST&last=60...:
+ *                           stored frames by field (frame_store::query::parse
+ *                           keys), oldest first, without their bytes
+ *   - GET /api/status       ring depth, first and last ids
+ *   - GET /data             newest 500 frames, newest first (old front end)
+ *   - POST /clear           hides the frames received so far
+ *   - WebSocket /ws         ?since=ID&filter=EXPR: pushes new frames as
+ *                           they arrive
+ */
+class ETHERNET_API inspector_sink : virtual public gr::block {
+public:
+  typedef std::shared_ptr<inspector_sink> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::inspector_sink.
+   *
+   * \param depth number of frames kept
+   * \param snap_len frame bytes kept per frame (headers and payload preview)
+   * \param address listening address, "127.0.0.1" for local access only
+   * \param port listening TCP port
+   * \param store_mb memory budget of the frame store in MiB, 0 for none
+   */
+  static sptr make(int depth = 262144,
+                   int snap_len = 128,
+                   const std::string& address = "127.0.0.1",
+                   int port = 8080,
+                   int store_mb = 256);
+
+  //! Frames stored since the block was created.
+  virtual uint64_t frames_received() const = 0;
+  //! Messages on "frames" that were neither records nor decoded dicts.
+  virtual uint64_t messages_ignored() const = 0;
+  //! The frame store, null when store_mb is 0.
+  virtual frame_store::sptr store() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_INSPECTOR_SINK_H */
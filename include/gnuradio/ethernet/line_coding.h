@@ -0,0 +1,113 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_LINE_CODING_H
+#define INCLUDED_ETHERNET_LINE_CODING_H
+
+#include <gnuradio/ethernet/api.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief IEEE 802.3 frame check sequence (reflected CRC-32, 0x04C11DB7).
+ *
+ * The FCS is transmitted least significant byte first, so a valid frame
+ * ends with crc32(frame, len - 4) in little-endian order.
+ */
+ETHERNET_API uint32_t crc32(const uint8_t* data, size_t len);
+
+/*! True if the last 4 bytes of \p frame are its FCS. */
+ETHERNET_API bool check_fcs(const uint8_t* frame, size_t len);
+
+/*! 4B/5B data code-groups, indexed by nibble. Bit 4 is sent first. */
+static const uint8_t FIVEB_CODES[16] = { 0x1E, 0x09, 0x14, 0x15, 0x0A, 0x0B,
+                                         0x0E, 0x0F, 0x12, 0x13, 0x16, 0x17,
+                                         0x1A, 0x1B, 0x1C, 0x1D };
+
+/*! 4B/5B control code-groups */
+static const uint8_t FIVEB_IDLE = 0x1F;
+static const uint8_t FIVEB_J = 0x18;
+static const uint8_t FIVEB_K = 0x11;
+static const uint8_t FIVEB_T = 0x0D;
+static const uint8_t FIVEB_R = 0x07;
+
+/*!
+ * \brief Key stream of the 100BASE-TX side-stream scrambler (x^11 + x^9 + 1).
+ *
+ * Bit i of the state is d_lfsr[i] in fastethernet_descrambler, so the same
+ * state scrambles in the encoder and descrambles in the receiver.
+ */
+class scrambler_lfsr
+{
+public:
+    explicit scrambler_lfsr(unsigned state = 0x7FF) : d_state(state & 0x7FF) {}
+
+    uint8_t next()
+    {
+        unsigned key = ((d_state >> 8) ^ (d_state >> 10)) & 1;
+        d_state = ((d_state << 1) | key) & 0x7FF;
+        return key;
+    }
+
+    unsigned state() const { return d_state; }
+    void set_state(unsigned state) { d_state = state & 0x7FF; }
+
+private:
+    unsigned d_state;
+};
+
+/*!
+ * \brief Scrambler state recovery from IDLE.
+ *
+ * IDLE descrambles to ones, so over IDLE the key stream is the complement
+ * of the scrambled bits and follows the scrambler recurrence
+ * k[i] = k[i - 9] ^ k[i - 11]. Once \p run_len bits in a row are consistent
+ * with it (11 to seed the recurrence, the rest checked), they are taken as
+ * IDLE and the state is known: the one a search over the 2048 seeds would
+ * find for a run of run_len ones.
+ */
+class scrambler_sync
+{
+public:
+    explicit scrambler_sync(int run_len) : d_run_len(run_len), d_history(0), d_filled(0), d_run(0)
+    {
+    }
+
+    //! Takes the next scrambled bit; true while the last run_len bits fit IDLE.
+    bool push(uint8_t s)
+    {
+        s &= 1;
+        if (d_filled >= 11 && ((s ^ (d_history >> 8) ^ (d_history >> 10)) & 1)) {
+            d_run++;
+        } else {
+            d_run = 0;
+        }
+        d_history = ((d_history << 1) | s) & 0x7FF;
+        if (d_filled < 11) d_filled++;
+        return d_filled == 11 && d_run + 11 >= d_run_len;
+    }
+
+    //! State that descrambles the next bit, when push() returned true.
+    unsigned state() const { return ~d_history & 0x7FF; }
+
+    //! Forgets the current run (the history of the last 11 bits is kept).
+    void restart() { d_run = 0; }
+
+private:
+    const int d_run_len;
+    unsigned d_history; // last 11 scrambled bits, most recent in bit 0
+    int d_filled;
+    int d_run; // bits in a row that follow the recurrence
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_LINE_CODING_H */
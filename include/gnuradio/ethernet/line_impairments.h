@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_LINE_IMPAIRMENTS_H
+#define INCLUDED_ETHERNET_LINE_IMPAIRMENTS_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Cable impairments for synthetic line signals
+ * \ingroup ethernet
+ *
+ * Applied in order: timing jitter (random fractional delay, linearly
+ * interpolated), baseline wander (first-order AC coupling) and additive
+ * gaussian noise. With every parameter at 0 the input is copied through,
+ * delayed by one sample.
+ *
+ * Noise is drawn from a precomputed table, so the block stays much faster
+ * than the receive chain it feeds.
+ */
+class ETHERNET_API line_impairments : virtual public gr::sync_block {
+public:
+  typedef std::shared_ptr<line_impairments> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::line_impairments.
+   *
+   * \param noise_rms standard deviation of the additive noise
+   * \param jitter_rms timing jitter in samples (clamped to +/- 0.99)
+   * \param wander_cutoff AC coupling cutoff, as a fraction of the sample rate
+   * \param seed random seed (0 picks a fixed default)
+   */
+  static sptr make(float noise_rms = 0.0f,
+                   float jitter_rms = 0.0f,
+                   float wander_cutoff = 0.0f,
+                   int seed = 0);
+
+  virtual void set_noise_rms(float noise_rms) = 0;
+  virtual void set_jitter_rms(float jitter_rms) = 0;
+  virtual void set_wander_cutoff(float wander_cutoff) = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_LINE_IMPAIRMENTS_H */
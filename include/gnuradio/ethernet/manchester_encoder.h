@@ -0,0 +1,51 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_MANCHESTER_ENCODER_H
+#define INCLUDED_ETHERNET_MANCHESTER_ENCODER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief 10BASE-T Manchester line encoder
+ * \ingroup ethernet
+ *
+ * Input: ethernet_framer bytes, with a length tag on the first byte of
+ * each frame. Bits are sent LSB first, a 1 as low then high and a 0 as
+ * high then low (-1/+1 levels). Every frame ends with a TP_IDL pulse
+ * (2 bit times high) followed by \p idle_bits bit times at 0. Bytes that
+ * are not part of a tagged frame are dropped.
+ *
+ * \p samples_per_bit may be fractional (125 for 10 Mb/s at 1.25 GS/s);
+ * 2 gives the half-bit samples ethernet_10baset_decoder works on.
+ */
+class ETHERNET_API manchester_encoder : virtual public gr::block {
+public:
+  typedef std::shared_ptr<manchester_encoder> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of
+   * ethernet::manchester_encoder.
+   *
+   * \param samples_per_bit output samples per bit (>= 2)
+   * \param idle_bits silent bit times before the first frame and after each
+   * \param len_tag_key key of the frame length tag set by the framer
+   */
+  static sptr make(double samples_per_bit = 2.0,
+                   int idle_bits = 96,
+                   const std::string& len_tag_key = "packet_len");
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_MANCHESTER_ENCODER_H */
@@ -0,0 +1,42 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_MLT3_ENCODER_H
+#define INCLUDED_ETHERNET_MLT3_ENCODER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief MLT-3 line encoder, one sample per symbol
+ * \ingroup ethernet
+ *
+ * A 1 moves the output to the next level of the 0, +A, 0, -A cycle, a 0
+ * holds it. This is the inverse of slicer3 followed by mlt3_to_scrambled.
+ */
+class ETHERNET_API mlt3_encoder : virtual public gr::sync_block {
+public:
+  typedef std::shared_ptr<mlt3_encoder> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::mlt3_encoder.
+   *
+   * \param amplitude output level A
+   */
+  static sptr make(float amplitude = 1.0f);
+
+  virtual void set_amplitude(float amplitude) = 0;
+  virtual float amplitude() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_MLT3_ENCODER_H */
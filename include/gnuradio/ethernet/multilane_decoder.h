@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_MULTILANE_DECODER_H
+#define INCLUDED_ETHERNET_MULTILANE_DECODER_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Decodes several lines at once, e.g. both pairs of a tapped link
+ * \ingroup ethernet
+ *
+ * Each input is one lane, sampled like the input of decode_100basetx()
+ * (one sample per symbol) or decode_10baset() (two samples per bit), and
+ * goes through the same slicing and decoding, with its state kept from
+ * one work() call to the next. Lanes are decoded in parallel on \p threads
+ * worker threads; lane i always runs on worker i % threads, which is
+ * pinned to cpus[i % threads] when that entry is given and not negative.
+ *
+ * Frames of all lanes are merged in sample_offset order (then lane order)
+ * and published as record batches on the "records" port (see
+ * frame_record.h), with the input index in the record's lane field:
+ * on a tap, the lane is the direction of the frame. frame_num counts the
+ * merged frames. A frame is published once no lane can still produce an
+ * earlier one, so the merge holds back at most one frame length.
+ *
+ * The optional byte output carries the merged frames back to back, as a
+ * tagged stream: the first byte of a frame has a \p len_tag_key tag (its
+ * length) and sample_offset, fcs_ok and lane tags. While the output is
+ * full, no input is consumed. Frames still held when the flowgraph stops
+ * are only published as records.
+ */
+template <class T>
+class ETHERNET_API multilane_decoder_blk : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<multilane_decoder_blk<T>> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of ethernet::multilane_decoder.
+     *
+     * \param standard "100BASE-TX" or "10BASE-T"
+     * \param lanes number of inputs, 1 to 256
+     * \param threshold slicer threshold, in input units times \p gain
+     * \param gain positive scale applied to the samples before slicing
+     * \param threads worker threads, 0 to decode in the block's thread
+     * \param cpus CPU of each worker thread, -1 to leave one unpinned
+     * \param len_tag_key key of the frame length tags of the byte output
+     */
+    static sptr make(const std::string& standard = "100BASE-TX",
+                     int lanes = 2,
+                     float threshold = 0.25f,
+                     float gain = 1.0f,
+                     int threads = 2,
+                     const std::vector<int>& cpus = std::vector<int>(),
+                     const std::string& len_tag_key = "packet_len");
+
+    virtual int lanes() const = 0;
+    virtual int threads() const = 0;
+
+    //! Frames published, all lanes.
+    virtual uint64_t frames_decoded() const = 0;
+    //! Frames decoded on one lane.
+    virtual uint64_t lane_frames(int lane) const = 0;
+};
+
+typedef multilane_decoder_blk<float> multilane_decoder;
+typedef multilane_decoder_blk<std::int16_t> multilane_decoder_s;
+typedef multilane_decoder_blk<std::int8_t> multilane_decoder_b;
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_MULTILANE_DECODER_H */
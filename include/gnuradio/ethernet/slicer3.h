@@ -3,21 +3,55 @@
 
 #include <gnuradio/ethernet/api.h>
 #include <gnuradio/sync_block.h>
+#include <cstdint>
 
 namespace gr {
 namespace ethernet {
 
-class ETHERNET_API slicer3 : virtual public gr::sync_block
+/*!
+ * \brief 3-level slicer: +1.0 above threshold, -1.0 below -threshold, 0.0
+ * in between.
+ *
+ * The input is float, int16 (slicer3_s) or int8 (slicer3_b) samples.
+ * They are compared as if multiplied by \p gain, which is folded into the
+ * threshold once, so raw digitizer samples need no conversion or scaling
+ * block.
+ *
+ * With \p adaptive, the threshold follows the signal: every 1024 samples,
+ * the mean of the samples sliced to +1 and the mean magnitude of those
+ * sliced to -1 update the estimate of the MLT-3 level, and the threshold
+ * is set to \p fraction of it (a side with no sample halves its estimate,
+ * so a threshold set too high comes down). The given threshold is only
+ * the starting point, and \p gain only scales what threshold() reports.
+ * A "threshold" tag (double) is added on the first sample sliced with a
+ * new threshold, when it has moved by more than 1% since the last tag.
+ */
+template <class T>
+class ETHERNET_API slicer3_blk : virtual public gr::sync_block
 {
 public:
-    typedef std::shared_ptr<slicer3> sptr;
-    
-    static sptr make(float threshold = 0.33f);
-    
+    typedef std::shared_ptr<slicer3_blk<T>> sptr;
+
+    //! \p gain must be positive and \p fraction in (0, 1]; std::invalid_argument otherwise.
+    static sptr make(float threshold = 0.33f,
+                     float gain = 1.0f,
+                     bool adaptive = false,
+                     float fraction = 0.5f);
+
+    //! In adaptive mode, restarts the adaptation from \p threshold.
     virtual void set_threshold(float threshold) = 0;
+    //! Threshold in use, the adapted one in adaptive mode.
     virtual float threshold() const = 0;
+    virtual void set_gain(float gain) = 0;
+    virtual float gain() const = 0;
+    virtual bool adaptive() const = 0;
+    virtual float fraction() const = 0;
 };
 
+typedef slicer3_blk<float> slicer3;
+typedef slicer3_blk<std::int16_t> slicer3_s;
+typedef slicer3_blk<std::int8_t> slicer3_b;
+
 } // namespace ethernet
 } // namespace gr
 
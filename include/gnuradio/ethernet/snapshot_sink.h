@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_SNAPSHOT_SINK_H
+#define INCLUDED_ETHERNET_SNAPSHOT_SINK_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/sync_block.h>
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Writes the raw samples around errored frames to files
+ * \ingroup ethernet
+ *
+ * The input, raw line samples (float, int16 or int8), goes into a ring of
+ * the last \p ring_size samples; nothing else is done with it. A trigger
+ * asks for the \p pre samples before one sample and the \p post samples
+ * from it on. The window is written by a thread of the block, once the
+ * input has reached its end, to <prefix>_NNNNNN.raw (the raw values, as
+ * Capture Source reads them) with a JSON sidecar <prefix>_NNNNNN.json, so
+ * disk I/O follows the errors, not the line rate.
+ *
+ * Triggers come from the "trigger" port: a decoder's record batches or
+ * decoded dicts, where every frame that failed its FCS (a code violation
+ * ends a frame early, so it fails too) triggers at its sample_offset, or
+ * an explicit integer sample offset, or a dict with a "sample_offset".
+ * Those offsets count the decoder's input items: the raw sample is
+ * offset * \p samples_per_item + \p delay. Stream tags with key
+ * \p trigger_tag, when given, trigger at the tagged raw sample. A trigger
+ * falling in a window not written yet joins it instead of starting one.
+ *
+ * The ring is written without a lock; the writer thread checks after its
+ * copy that the window was not overwritten meanwhile, and drops it when
+ * it was, e.g. when the trigger came later than \p ring_size samples.
+ */
+template <class T>
+class ETHERNET_API snapshot_sink_blk : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<snapshot_sink_blk<T>> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of ethernet::snapshot_sink.
+     *
+     * \param prefix path of the files, without the _NNNNNN.raw suffix
+     * \param pre samples written before the trigger sample
+     * \param post samples written from the trigger sample on
+     * \param samples_per_item raw samples per input item of the decoder
+     * \param delay raw samples added to the mapped trigger offsets
+     * \param samp_rate sample rate, for the sidecar (0: unknown)
+     * \param ring_size samples kept, rounded up to a power of two, at
+     *        least pre + post
+     * \param max_snapshots snapshots written at most, 0 for no limit; a
+     *        snapshot that could not be written does not count
+     * \param trigger_tag key of the stream tags that trigger, "" for none
+     */
+    static sptr make(const std::string& prefix,
+                     int pre = 4096,
+                     int post = 4096,
+                     double samples_per_item = 1.0,
+                     int delay = 0,
+                     double samp_rate = 0,
+                     int ring_size = 1 << 22,
+                     int max_snapshots = 0,
+                     const std::string& trigger_tag = "");
+
+    //! Triggers received, written or not.
+    virtual uint64_t triggers() const = 0;
+    //! Snapshots written.
+    virtual uint64_t snapshots_written() const = 0;
+    //! Snapshots dropped: overwritten in the ring, over the limit or not written.
+    virtual uint64_t snapshots_dropped() const = 0;
+};
+
+typedef snapshot_sink_blk<float> snapshot_sink;
+typedef snapshot_sink_blk<std::int16_t> snapshot_sink_s;
+typedef snapshot_sink_blk<std::int8_t> snapshot_sink_b;
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_SNAPSHOT_SINK_H */
@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_ETHERNET_TRAFFIC_STATS_H
+#define INCLUDED_ETHERNET_TRAFFIC_STATS_H
+
+#include <gnuradio/ethernet/api.h>
+#include <gnuradio/block.h>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+/*!
+ * \brief Top talkers and distinct hosts over long periods, in fixed memory
+ * \ingroup ethernet
+ *
+ * The "frames" port takes a decoder's "records" batches or "decoded"
+ * dicts. Three dimensions are summarised: source MAC, source IP address
+ * and TCP/UDP destination port. For each, a Space-Saving summary keeps
+ * the top_k keys by packets and another by bytes, and Count-Min sketches
+ * give the other measure of each top key. HyperLogLog sketches estimate
+ * the number of distinct MACs and IP addresses (source or destination).
+ * Memory and per-frame cost do not depend on the traffic.
+ *
+ * A snapshot dict is published on "summary" every interval_s seconds
+ * (and when the flowgraph stops); see the README for its keys. Counts
+ * cover the time since start, or since the previous snapshot with
+ * \p reset.
+ */
+class ETHERNET_API traffic_stats : virtual public gr::block {
+public:
+  typedef std::shared_ptr<traffic_stats> sptr;
+
+  /*!
+   * \brief Return a shared_ptr to a new instance of ethernet::traffic_stats.
+   *
+   * \param top_k keys reported per dimension and measure (1 to 1024)
+   * \param interval_s snapshot period
+   * \param reset clear the sketches after each snapshot
+   */
+  static sptr make(int top_k = 10, double interval_s = 10.0, bool reset = false);
+
+  //! Frames accounted since start.
+  virtual uint64_t frames_received() const = 0;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif /* INCLUDED_ETHERNET_TRAFFIC_STATS_H */
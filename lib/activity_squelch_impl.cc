@@ -0,0 +1,303 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "activity_squelch_impl.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+// Samples checked at once for activity, without a branch per sample
+const size_t SCAN_BLOCK = 64;
+
+// Link pulses are 100 ns wide; the shortest frame has 6.4 us of preamble
+const double PULSE_MAX_S = 1e-6;
+// FLP pulses come every 62.5 us (125 us without a data pulse), NLPs every 16 ms
+const double TRAIN_GAP_S = 200e-6;
+const double FLP_HALF_PERIOD_S = 62.5e-6;
+const size_t FLP_MIN_PULSES = 9;
+const int FLP_CODE_BITS = 16;
+
+size_t samples(double seconds, double samp_rate)
+{
+    return (size_t)std::llround(std::max(seconds, 0.0) * samp_rate);
+}
+
+} // namespace
+
+template <class T>
+typename activity_squelch_blk<T>::sptr
+activity_squelch_blk<T>::make(double samp_rate, float threshold, double pre, double post)
+{
+    return gnuradio::make_block_sptr<activity_squelch_impl<T>>(samp_rate, threshold, pre, post);
+}
+
+template <class T>
+activity_squelch_impl<T>::activity_squelch_impl(double samp_rate,
+                                                float threshold,
+                                                double pre,
+                                                double post)
+    : gr::block("activity_squelch",
+                gr::io_signature::make(1, 1, sizeof(T)),
+                gr::io_signature::make(1, 1, sizeof(T))),
+      d_threshold(threshold),
+      d_slicer(threshold, 1.0f),
+      d_pre(samples(pre, samp_rate)),
+      d_post(std::max<size_t>(samples(post, samp_rate), 1)),
+      d_pulse_max(std::max<size_t>(samples(PULSE_MAX_S, samp_rate), 1)),
+      d_train_gap(samples(TRAIN_GAP_S, samp_rate)),
+      d_flp_half_period(FLP_HALF_PERIOD_S * samp_rate),
+      d_state(IDLE),
+      d_flushed(0),
+      d_start(0),
+      d_active_start(0),
+      d_last_active(0),
+      d_quiet(0),
+      d_start_key(pmt::intern("burst_start")),
+      d_end_key(pmt::intern("burst_end")),
+      d_link_port(pmt::intern("link"))
+{
+    if (!(samp_rate > 0)) {
+        throw std::invalid_argument("activity_squelch: samp_rate must be positive");
+    }
+    this->message_port_register_out(d_link_port);
+    // Output offsets no longer match the input ones
+    this->set_tag_propagation_policy(gr::block::TPP_DONT);
+}
+
+template <class T>
+activity_squelch_impl<T>::~activity_squelch_impl()
+{
+}
+
+template <class T>
+void activity_squelch_impl<T>::set_threshold(float threshold)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_slicer.set(threshold, 1.0f);
+    d_threshold = threshold;
+}
+
+template <class T>
+float activity_squelch_impl<T>::threshold() const
+{
+    return d_threshold;
+}
+
+// Index of the first active sample, or n.
+template <class T>
+size_t activity_squelch_impl<T>::find_active(const T* in, size_t n) const
+{
+    size_t i = 0;
+    while (i + SCAN_BLOCK <= n && !d_slicer.any_active(in + i, SCAN_BLOCK)) {
+        i += SCAN_BLOCK;
+    }
+    while (i < n && !d_slicer.active(in[i])) {
+        i++;
+    }
+    return i;
+}
+
+// Keeps the last d_pre idle samples, for the start of the next burst.
+template <class T>
+void activity_squelch_impl<T>::keep_history(const T* in, size_t n)
+{
+    size_t before = d_history.size();
+    if (n >= d_pre) {
+        d_history.assign(in + n - d_pre, in + n);
+    } else {
+        d_history.insert(d_history.end(), in, in + n);
+        if (d_history.size() > d_pre) {
+            d_history.erase(d_history.begin(), d_history.end() - d_pre);
+        }
+    }
+    d_dropped.add(before + n - d_history.size());
+}
+
+template <class T>
+void activity_squelch_impl<T>::link_pulse(uint64_t offset)
+{
+    if (!d_train.empty() && offset - d_train.back() > d_train_gap) {
+        end_train();
+    }
+    d_train.push_back(offset);
+}
+
+// Decodes the 16-bit link code word of the FLP burst in d_train: a clock
+// pulse every 125 us, and a data pulse half way for a 1. Returns -1 when
+// the pulses do not fit that pattern.
+template <class T>
+long activity_squelch_impl<T>::flp_code_word() const
+{
+    const double tolerance = d_flp_half_period * 0.12;
+    long word = 0;
+    int bits = 0;
+    size_t k = 0;
+    while (bits < FLP_CODE_BITS && k + 1 < d_train.size()) {
+        double gap = (double)(d_train[k + 1] - d_train[k]);
+        if (std::fabs(gap - d_flp_half_period) <= tolerance && k + 2 < d_train.size() &&
+            std::fabs(d_train[k + 2] - d_train[k + 1] - d_flp_half_period) <= tolerance) {
+            word |= 1L << bits;
+            k += 2;
+        } else if (std::fabs(gap - 2 * d_flp_half_period) <= 2 * tolerance) {
+            k += 1;
+        } else {
+            return -1;
+        }
+        bits++;
+    }
+    return bits == FLP_CODE_BITS ? word : -1;
+}
+
+template <class T>
+void activity_squelch_impl<T>::end_train()
+{
+    if (d_train.size() >= FLP_MIN_PULSES) {
+        d_flp.add();
+        pmt::pmt_t d = pmt::make_dict();
+        d = pmt::dict_add(d, pmt::intern("type"), pmt::intern("flp"));
+        d = pmt::dict_add(d, pmt::intern("offset"), pmt::from_uint64(d_train.front()));
+        d = pmt::dict_add(d, pmt::intern("pulses"), pmt::from_long(d_train.size()));
+        d = pmt::dict_add(d, pmt::intern("code_word"), pmt::from_long(flp_code_word()));
+        this->message_port_pub(d_link_port, d);
+    } else {
+        for (uint64_t offset : d_train) {
+            d_nlp.add();
+            pmt::pmt_t d = pmt::make_dict();
+            d = pmt::dict_add(d, pmt::intern("type"), pmt::intern("nlp"));
+            d = pmt::dict_add(d, pmt::intern("offset"), pmt::from_uint64(offset));
+            d = pmt::dict_add(d, pmt::intern("pulses"), pmt::from_long(1));
+            this->message_port_pub(d_link_port, d);
+        }
+    }
+    d_train.clear();
+}
+
+template <class T>
+int activity_squelch_impl<T>::general_work(int noutput_items,
+                                           gr_vector_int& ninput_items,
+                                           gr_vector_const_void_star& input_items,
+                                           gr_vector_void_star& output_items)
+{
+    const T* in = (const T*)input_items[0];
+    T* out = (T*)output_items[0];
+    const size_t n = ninput_items[0];
+    const size_t nout = noutput_items;
+    const uint64_t base = this->nitems_read(0);
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+
+    size_t i = 0;
+    size_t produced = 0;
+    while (i < n && produced < nout) {
+        if (d_state == IDLE) {
+            size_t a = i + find_active(in + i, n - i);
+            if (a == n) {
+                keep_history(in + i, n - i);
+                i = n;
+                break;
+            }
+            // The burst starts d_pre samples before its first active one
+            size_t k = std::min(d_pre, a - i);
+            size_t h = std::min(d_pre - k, d_history.size());
+            d_pending.assign(d_history.end() - h, d_history.end());
+            d_pending.insert(d_pending.end(), in + a - k, in + a);
+            d_dropped.add(d_history.size() - h + (a - k - i));
+            d_history.clear();
+            d_start = base + a - k - h;
+            d_active_start = base + a;
+            d_last_active = base + a;
+            d_quiet = 0;
+            d_state = PENDING;
+            i = a;
+        }
+
+        if (d_state == PENDING) {
+            // Held back until it is longer than a link pulse, or over
+            for (; i < n; i++) {
+                d_pending.push_back(in[i]);
+                if (d_slicer.active(in[i])) {
+                    d_last_active = base + i;
+                    d_quiet = 0;
+                    if (d_last_active - d_active_start >= d_pulse_max) {
+                        d_flushed = 0;
+                        d_state = BURST;
+                        i++;
+                        break;
+                    }
+                } else if (++d_quiet == d_post) {
+                    link_pulse(d_active_start);
+                    size_t keep = std::min(d_pre, d_pending.size());
+                    d_history.assign(d_pending.end() - keep, d_pending.end());
+                    d_dropped.add(d_pending.size() - keep);
+                    d_pending.clear();
+                    d_state = IDLE;
+                    i++;
+                    break;
+                }
+            }
+            continue;
+        }
+
+        // BURST: what was held back first
+        if (d_flushed < d_pending.size()) {
+            if (d_flushed == 0) {
+                this->add_item_tag(0, this->nitems_written(0) + produced, d_start_key,
+                                   pmt::from_uint64(d_start));
+                d_bursts.add();
+                // A frame ends any pulse train
+                if (!d_train.empty()) end_train();
+            }
+            size_t c = std::min(d_pending.size() - d_flushed, nout - produced);
+            std::memcpy(out + produced, d_pending.data() + d_flushed, c * sizeof(T));
+            d_flushed += c;
+            produced += c;
+            if (d_flushed < d_pending.size()) break;
+        }
+
+        // then the input, until d_post quiet samples
+        while (i < n && produced < nout) {
+            size_t c = std::min({ n - i, nout - produced, SCAN_BLOCK });
+            size_t last = c;
+            while (last > 0 && !d_slicer.active(in[i + last - 1])) {
+                last--;
+            }
+            size_t quiet = last ? c - last : d_quiet + c;
+            if (quiet >= d_post) {
+                size_t end = i + c - (quiet - d_post);
+                std::memcpy(out + produced, in + i, (end - i) * sizeof(T));
+                produced += end - i;
+                i = end;
+                this->add_item_tag(0, this->nitems_written(0) + produced - 1, d_end_key,
+                                   pmt::from_uint64(base + end - 1));
+                d_pending.clear();
+                d_state = IDLE;
+                break;
+            }
+            std::memcpy(out + produced, in + i, c * sizeof(T));
+            produced += c;
+            i += c;
+            d_quiet = quiet;
+        }
+    }
+
+    if (!d_train.empty() && base + i - d_train.back() > d_train_gap && d_state != PENDING) {
+        end_train();
+    }
+
+    this->consume_each(i);
+    return produced;
+}
+
+template class activity_squelch_blk<float>;
+template class activity_squelch_blk<std::int16_t>;
+template class activity_squelch_blk<std::int8_t>;
+
+} // namespace ethernet
+} // namespace gr
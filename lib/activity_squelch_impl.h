@@ -0,0 +1,82 @@
+#ifndef INCLUDED_ETHERNET_ACTIVITY_SQUELCH_IMPL_H
+#define INCLUDED_ETHERNET_ACTIVITY_SQUELCH_IMPL_H
+
+#include "block_stats.h"
+#include "level_slicer.h"
+#include <gnuradio/ethernet/activity_squelch.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+template <class T>
+class activity_squelch_impl : public activity_squelch_blk<T>
+{
+private:
+    enum state_t {
+        IDLE,    // dropping samples, looking for activity
+        PENDING, // activity held back until it is longer than a link pulse
+        BURST,   // forwarding a burst, pending samples first
+    };
+
+    std::mutex d_mutex; // set_threshold() against work()
+    std::atomic<float> d_threshold;
+    level_slicer<T> d_slicer;
+
+    // Durations in samples
+    const size_t d_pre;
+    const size_t d_post;
+    const uint64_t d_pulse_max;
+    const uint64_t d_train_gap;
+    const double d_flp_half_period;
+
+    state_t d_state;
+    std::vector<T> d_history; // last idle samples, up to d_pre
+    std::vector<T> d_pending; // burst start, pre samples included
+    size_t d_flushed;         // pending samples already forwarded
+    uint64_t d_start;         // input offset of the first forwarded sample
+    uint64_t d_active_start;  // input offset of the first active sample
+    uint64_t d_last_active;   // input offset of the last active sample
+    size_t d_quiet;           // quiet samples since the last active one
+
+    std::vector<uint64_t> d_train; // link pulse offsets, less than d_train_gap apart
+
+    stat_counter d_bursts;
+    stat_counter d_dropped;
+    stat_counter d_nlp;
+    stat_counter d_flp;
+
+    pmt::pmt_t d_start_key;
+    pmt::pmt_t d_end_key;
+    pmt::pmt_t d_link_port;
+
+    size_t find_active(const T* in, size_t n) const;
+    void keep_history(const T* in, size_t n);
+    void link_pulse(uint64_t offset);
+    void end_train();
+    long flp_code_word() const;
+
+public:
+    activity_squelch_impl(double samp_rate, float threshold, double pre, double post);
+    ~activity_squelch_impl();
+
+    void set_threshold(float threshold) override;
+    float threshold() const override;
+    uint64_t bursts() const override { return d_bursts.get(); }
+    uint64_t samples_dropped() const override { return d_dropped.get(); }
+    uint64_t nlp_count() const override { return d_nlp.get(); }
+    uint64_t flp_count() const override { return d_flp.get(); }
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,162 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "lane_decoder.h"
+#include "level_slicer.h"
+#include <gnuradio/ethernet/batch_decode.h>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+template <typename T>
+void mlt3_levels(const T* symbols, size_t n, float threshold, float gain, uint8_t* bits)
+{
+    level_slicer<T> slice(threshold, gain);
+    int prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        int level = slice(symbols[i]);
+        bits[i] = level != prev;
+        prev = level;
+    }
+}
+
+template <typename T>
+size_t decode_mlt3(const T* symbols,
+                   size_t n,
+                   frame_record_writer& out,
+                   float threshold,
+                   int idle_run,
+                   float gain)
+{
+    lane_100basetx<T> lane(threshold, gain, idle_run);
+    size_t frames = 0;
+    lane.process(symbols, n, [&](const uint8_t* frame, size_t len, uint64_t start) {
+        out.add(frame, len, ++frames, start, check_fcs(frame, len));
+    });
+    return frames;
+}
+
+template <typename T>
+size_t decode_manchester(
+    const T* samples, size_t n, frame_record_writer& out, float threshold, float gain)
+{
+    lane_10baset<T> lane(threshold, gain);
+    size_t frames = 0;
+    auto emit = [&](const uint8_t* frame, size_t len, uint64_t start) {
+        out.add(frame, len, ++frames, start, check_fcs(frame, len));
+    };
+    lane.process(samples, n, emit);
+    lane.flush(emit);
+    return frames;
+}
+
+} // namespace
+
+void mlt3_decode(const float* symbols, size_t n, float threshold, uint8_t* bits, float gain)
+{
+    mlt3_levels(symbols, n, threshold, gain, bits);
+}
+
+void mlt3_decode(const int16_t* symbols, size_t n, float threshold, uint8_t* bits, float gain)
+{
+    mlt3_levels(symbols, n, threshold, gain, bits);
+}
+
+void mlt3_decode(const int8_t* symbols, size_t n, float threshold, uint8_t* bits, float gain)
+{
+    mlt3_levels(symbols, n, threshold, gain, bits);
+}
+
+size_t descramble(const uint8_t* in,
+                  size_t n,
+                  uint8_t* out,
+                  int search_window,
+                  int idle_run,
+                  int max_idle_no_idle,
+                  int max_in_frame_no_idle,
+                  int idle_errors)
+{
+    if (idle_errors < 0 || idle_errors >= idle_run) {
+        throw std::invalid_argument("descramble: idle_errors must be in [0, idle_run)");
+    }
+    lane_descrambler descrambler(
+        search_window, idle_run, max_idle_no_idle, max_in_frame_no_idle, idle_errors);
+    descrambler.process(in, n, out);
+    return descrambler.locks();
+}
+
+size_t decode_4b5b(const uint8_t* bits, size_t n, frame_record_writer& out)
+{
+    lane_framer_4b5b framer;
+    size_t frames = 0;
+    framer.process(bits, n, [&](const uint8_t* frame, size_t len, uint64_t start) {
+        out.add(frame, len, ++frames, start, check_fcs(frame, len));
+    });
+    return frames;
+}
+
+size_t manchester_decode(const uint8_t* halfbits, size_t n, uint8_t* bits)
+{
+    size_t count = 0;
+    for (size_t i = 0; i + 1 < n; i += 2) {
+        uint8_t a = halfbits[i] & 1;
+        uint8_t b = halfbits[i + 1] & 1;
+        if (a != b) bits[count++] = b;
+    }
+    return count;
+}
+
+size_t decode_100basetx(const float* symbols,
+                        size_t n,
+                        frame_record_writer& out,
+                        float threshold,
+                        int idle_run,
+                        float gain)
+{
+    return decode_mlt3(symbols, n, out, threshold, idle_run, gain);
+}
+
+size_t decode_100basetx(const int16_t* symbols,
+                        size_t n,
+                        frame_record_writer& out,
+                        float threshold,
+                        int idle_run,
+                        float gain)
+{
+    return decode_mlt3(symbols, n, out, threshold, idle_run, gain);
+}
+
+size_t decode_100basetx(const int8_t* symbols,
+                        size_t n,
+                        frame_record_writer& out,
+                        float threshold,
+                        int idle_run,
+                        float gain)
+{
+    return decode_mlt3(symbols, n, out, threshold, idle_run, gain);
+}
+
+size_t decode_10baset(
+    const float* samples, size_t n, frame_record_writer& out, float threshold, float gain)
+{
+    return decode_manchester(samples, n, out, threshold, gain);
+}
+
+size_t decode_10baset(
+    const int16_t* samples, size_t n, frame_record_writer& out, float threshold, float gain)
+{
+    return decode_manchester(samples, n, out, threshold, gain);
+}
+
+size_t decode_10baset(
+    const int8_t* samples, size_t n, frame_record_writer& out, float threshold, float gain)
+{
+    return decode_manchester(samples, n, out, threshold, gain);
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,90 @@
+#ifndef INCLUDED_ETHERNET_BLOCK_STATS_H
+#define INCLUDED_ETHERNET_BLOCK_STATS_H
+
+#include <gnuradio/high_res_timer.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Counter written by the work() thread only and read from anywhere
+ * (getters, ControlPort). Relaxed load + store: a plain add on x86,
+ * no locked instruction on the hot path.
+ */
+class stat_counter
+{
+public:
+    void add(uint64_t n = 1)
+    {
+        d_value.store(d_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void set(uint64_t v) { d_value.store(v, std::memory_order_relaxed); }
+    uint64_t get() const { return d_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> d_value{ 0 };
+};
+
+/*
+ * work() timing shared by the instrumented blocks, and the clock of their
+ * "stats" message port. Costs two timer reads per work() call; the port is
+ * only published when the interval is > 0.
+ */
+class block_stats
+{
+public:
+    explicit block_stats(int interval_ms) : d_start(0), d_next(0)
+    {
+        set_interval(interval_ms);
+    }
+
+    void set_interval(int interval_ms) { d_interval_ms.store(interval_ms > 0 ? interval_ms : 0); }
+    int interval() const { return d_interval_ms.load(); }
+
+    void work_begin() { d_start = gr::high_res_timer_now(); }
+    gr::high_res_timer_type work_start() const { return d_start; }
+
+    // Returns true when a stats message is due.
+    bool work_end()
+    {
+        gr::high_res_timer_type now = gr::high_res_timer_now();
+        d_work_ticks.add(now - d_start);
+        d_work_calls.add();
+
+        int interval_ms = d_interval_ms.load(std::memory_order_relaxed);
+        if (interval_ms == 0 || now < d_next) return false;
+        d_next = now + gr::high_res_timer_tps() / 1000 * interval_ms;
+        return true;
+    }
+
+    uint64_t work_calls() const { return d_work_calls.get(); }
+    uint64_t work_ticks() const { return d_work_ticks.get(); }
+
+    // Common part of every stats message.
+    pmt::pmt_t make_dict(const std::string& block) const
+    {
+        pmt::pmt_t d = pmt::make_dict();
+        d = pmt::dict_add(d, pmt::intern("block"), pmt::intern(block));
+        d = pmt::dict_add(d, pmt::intern("work_calls"), pmt::from_uint64(work_calls()));
+        d = pmt::dict_add(d, pmt::intern("work_ticks"), pmt::from_uint64(work_ticks()));
+        d = pmt::dict_add(d, pmt::intern("ticks_per_sec"),
+                          pmt::from_uint64(gr::high_res_timer_tps()));
+        return d;
+    }
+
+private:
+    std::atomic<int> d_interval_ms;
+    gr::high_res_timer_type d_start;
+    gr::high_res_timer_type d_next;
+    stat_counter d_work_calls;
+    stat_counter d_work_ticks;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,212 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "capture_source_impl.h"
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+// Read-ahead requested past the current position
+const size_t READ_AHEAD_BYTES = 8 << 20;
+const size_t RS_WFM_HEADER_BYTES = 8;
+
+uint32_t read_le32(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+std::runtime_error file_error(const std::string& what, const std::string& filename)
+{
+    return std::runtime_error("capture_source: " + what + " " + filename + ": " +
+                              std::strerror(errno));
+}
+
+} // namespace
+
+capture_source::sptr capture_source::make(const std::string& filename,
+                                          const std::string& format,
+                                          double samp_rate,
+                                          float scale,
+                                          size_t header_bytes,
+                                          bool repeat)
+{
+    return gnuradio::make_block_sptr<capture_source_impl>(
+        filename, format, samp_rate, scale, header_bytes, repeat);
+}
+
+capture_source_impl::capture_source_impl(const std::string& filename,
+                                         const std::string& format,
+                                         double samp_rate,
+                                         float scale,
+                                         size_t header_bytes,
+                                         bool repeat)
+    : gr::sync_block("capture_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, sizeof(float))),
+      d_map(nullptr, unmapper{ 0 }),
+      d_map_size(0),
+      d_samp_rate(samp_rate),
+      d_scale(scale),
+      d_repeat(repeat),
+      d_pos(0),
+      d_advised_end(0),
+      d_time_key(pmt::intern("rx_time")),
+      d_rate_key(pmt::intern("rx_rate"))
+{
+    if (format != "float32" && format != "int16" && format != "int8" &&
+        format != "rs_wfm") {
+        throw std::invalid_argument("capture_source: unknown format " + format);
+    }
+    open(filename, format, header_bytes);
+}
+
+capture_source_impl::~capture_source_impl() {}
+
+void capture_source_impl::unmapper::operator()(const uint8_t* map) const
+{
+    munmap(const_cast<uint8_t*>(map), size);
+}
+
+void capture_source_impl::open(const std::string& filename,
+                               const std::string& format,
+                               size_t header_bytes)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw file_error("cannot open", filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        auto error = file_error("cannot stat", filename);
+        ::close(fd);
+        throw error;
+    }
+    d_map_size = st.st_size;
+    if (d_map_size > 0) {
+        void* map = mmap(nullptr, d_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            auto error = file_error("cannot map", filename);
+            ::close(fd);
+            throw error;
+        }
+        d_map.get_deleter().size = d_map_size;
+        d_map.reset((const uint8_t*)map);
+        // Doubles the kernel read-ahead and drops pages soon after use
+        madvise(map, d_map_size, MADV_SEQUENTIAL);
+    }
+    ::close(fd); // the mapping keeps the file
+
+    uint64_t count = UINT64_MAX;
+    if (format == "rs_wfm") {
+        if (d_map_size < RS_WFM_HEADER_BYTES) {
+            throw std::runtime_error("capture_source: no R&S waveform header in " + filename);
+        }
+        d_value_size = read_le32(d_map.get());
+        count = read_le32(d_map.get() + 4);
+        header_bytes = RS_WFM_HEADER_BYTES;
+        if (d_value_size != 1 && d_value_size != 2 && d_value_size != 4) {
+            throw std::runtime_error("capture_source: bad R&S waveform header in " +
+                                     filename + " (raw float32 file?)");
+        }
+        d_type = d_value_size == 4 ? FLOAT32 : d_value_size == 2 ? INT16 : INT8;
+    } else {
+        d_type = format == "float32" ? FLOAT32 : format == "int16" ? INT16 : INT8;
+        d_value_size = d_type == FLOAT32 ? 4 : d_type == INT16 ? 2 : 1;
+    }
+
+    // A truncated last value is ignored, as by file_source
+    uint64_t available = d_map_size > header_bytes ? (d_map_size - header_bytes) / d_value_size : 0;
+    d_count = std::min(count, available);
+    if (d_count == 0) {
+        throw std::runtime_error("capture_source: no samples in " + filename);
+    }
+    d_data = d_map.get() + header_bytes;
+}
+
+void capture_source_impl::read_ahead(size_t end)
+{
+    // MADV_SEQUENTIAL alone reads ahead in small steps; asking for the next
+    // few MB in one call keeps the page faults off the work() path.
+    if (end <= d_advised_end && d_advised_end - end >= READ_AHEAD_BYTES / 2) {
+        return;
+    }
+    static const size_t page = sysconf(_SC_PAGESIZE);
+    size_t from = std::max(end, d_advised_end) / page * page;
+    size_t to = std::min(end + READ_AHEAD_BYTES, d_map_size);
+    if (from < to) {
+        madvise(const_cast<uint8_t*>(d_map.get()) + from, to - from, MADV_WILLNEED);
+    }
+    d_advised_end = to;
+}
+
+void capture_source_impl::convert(float* out, uint64_t pos, size_t n, float scale) const
+{
+    const uint8_t* in = d_data + pos * d_value_size;
+    switch (d_type) {
+    case FLOAT32:
+        if (scale == 1.0f) {
+            std::memcpy(out, in, n * sizeof(float));
+        } else {
+            volk_32f_s32f_multiply_32f(out, (const float*)in, scale, n);
+        }
+        break;
+    case INT16:
+        // The VOLK kernels divide by the scalar
+        volk_16i_s32f_convert_32f(out, (const int16_t*)in, 1.0f / scale, n);
+        break;
+    case INT8:
+        volk_8i_s32f_convert_32f(out, (const int8_t*)in, 1.0f / scale, n);
+        break;
+    }
+}
+
+int capture_source_impl::work(int noutput_items,
+                              gr_vector_const_void_star& input_items,
+                              gr_vector_void_star& output_items)
+{
+    float* out = (float*)output_items[0];
+    const float scale = d_scale;
+
+    int produced = 0;
+    while (produced < noutput_items) {
+        if (d_pos == d_count) {
+            if (!d_repeat) break;
+            d_pos = 0;
+            d_advised_end = 0;
+        }
+        if (d_pos == 0 && d_samp_rate > 0) {
+            uint64_t offset = nitems_written(0) + produced;
+            double t = offset / d_samp_rate;
+            double secs = std::floor(t);
+            add_item_tag(0, offset, d_time_key,
+                         pmt::make_tuple(pmt::from_uint64((uint64_t)secs),
+                                         pmt::from_double(t - secs)));
+            add_item_tag(0, offset, d_rate_key, pmt::from_double(d_samp_rate));
+        }
+
+        size_t n = std::min<uint64_t>(noutput_items - produced, d_count - d_pos);
+        read_ahead((d_data - d_map.get()) + (d_pos + n) * d_value_size);
+        convert(out + produced, d_pos, n, scale);
+        d_pos += n;
+        produced += n;
+    }
+
+    return produced ? produced : WORK_DONE;
+}
+
+} // namespace ethernet
+} // namespace gr
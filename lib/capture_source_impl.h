@@ -0,0 +1,66 @@
+#ifndef INCLUDED_ETHERNET_CAPTURE_SOURCE_IMPL_H
+#define INCLUDED_ETHERNET_CAPTURE_SOURCE_IMPL_H
+
+#include <gnuradio/ethernet/capture_source.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <memory>
+
+namespace gr {
+namespace ethernet {
+
+class capture_source_impl : public capture_source
+{
+private:
+    enum value_type { FLOAT32, INT16, INT8 };
+
+    // munmap() of the whole file
+    struct unmapper {
+        size_t size;
+        void operator()(const uint8_t* map) const;
+    };
+
+    // Whole file; a member, so it is unmapped when the constructor throws
+    std::unique_ptr<const uint8_t, unmapper> d_map;
+    size_t d_map_size;
+    const uint8_t* d_data; // first value
+    value_type d_type;
+    size_t d_value_size;
+    uint64_t d_count;
+
+    const double d_samp_rate;
+    std::atomic<float> d_scale;
+    const bool d_repeat;
+
+    uint64_t d_pos;       // next sample of the pass
+    size_t d_advised_end; // file offset up to which read-ahead was requested
+    pmt::pmt_t d_time_key;
+    pmt::pmt_t d_rate_key;
+
+    void open(const std::string& filename, const std::string& format, size_t header_bytes);
+    void read_ahead(size_t end);
+    void convert(float* out, uint64_t pos, size_t n, float scale) const;
+
+public:
+    capture_source_impl(const std::string& filename,
+                        const std::string& format,
+                        double samp_rate,
+                        float scale,
+                        size_t header_bytes,
+                        bool repeat);
+    ~capture_source_impl();
+
+    uint64_t nsamples() const override { return d_count; }
+    double samp_rate() const override { return d_samp_rate; }
+    void set_scale(float scale) override { d_scale = scale; }
+    float scale() const override { return d_scale; }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef INCLUDED_ETHERNET_DESCRAMBLER_CORE_H
+#define INCLUDED_ETHERNET_DESCRAMBLER_CORE_H
+
+#include <gnuradio/ethernet/line_coding.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * fastethernet_descrambler's acquisition and lock supervision, bit by bit,
+ * shared with descramble() and the lanes: the same bits give the same
+ * output and the same locks everywhere. The block keeps its counters, BER
+ * and debug output, from the events returned.
+ */
+class descrambler_core
+{
+public:
+    enum event {
+        NONE,
+        LOCKED,         // state found by the seed search
+        RELOCKED,       // predicted state confirmed, slip() bits slipped
+        FRAME_START,    // /J/K/ after IDLE: the in-frame limit applies
+        SUSPECT,        // first window without IDLE (idle_errors > 0)
+        HOLD,           // IDLE again after SUSPECT
+        FRAME_TOO_LONG, // lock lost in a frame
+        LOST,           // lock lost between frames
+    };
+
+    descrambler_core(int search_window,
+                     int idle_run,
+                     int max_idle_no_idle,
+                     int max_in_frame_no_idle,
+                     int idle_errors)
+        : d_search_window(search_window),
+          d_idle_run(idle_run),
+          d_max_idle_no_idle(max_idle_no_idle),
+          d_max_in_frame_no_idle(max_in_frame_no_idle),
+          d_idle_errors(idle_errors),
+          d_locked(false),
+          d_sync(idle_run),
+          d_run_bits(std::max(idle_run, 1), 1),
+          d_run_pos(0),
+          d_run_zeros(0),
+          d_recent(~0u),
+          d_in_frame(false),
+          d_no_idle_bits(0),
+          d_suspect(false),
+          d_predict(false),
+          d_predicted_bits(0),
+          d_predicted(NUM_SLIPS),
+          d_predicted_run(NUM_SLIPS, 0),
+          d_slip(0)
+    {
+    }
+
+    bool locked() const { return d_locked; }
+
+    // Unlocked: the bit goes out unchanged. LOCKED or RELOCKED when the
+    // state that descrambles the next bit was found on this one.
+    event search(int bit)
+    {
+        bool idle = d_sync.push(bit);
+        if (d_predict) {
+            d_predicted_bits++;
+            if (predict_bit(bit)) return RELOCKED;
+        }
+        // The prediction gets search_window bits before the search takes over
+        if (idle && (!d_predict || d_predicted_bits >= (uint64_t)d_search_window)) {
+            lock(d_sync.state());
+            return LOCKED;
+        }
+        return NONE;
+    }
+
+    // Locked: the descrambled bit. The lock is lost on FRAME_TOO_LONG and
+    // LOST, from the next bit on.
+    int descramble(int bit, event& ev)
+    {
+        int b = bit ^ d_lfsr.next();
+        d_sync.push(bit);
+        ev = check(b);
+        if (ev == FRAME_TOO_LONG || ev == LOST) {
+            d_locked = false;
+            start_prediction();
+            d_sync.restart();
+        }
+        return b;
+    }
+
+    // Slip of the last RELOCKED, in bits
+    int slip() const { return d_slip; }
+    // Bits without IDLE, since the frame start in a frame
+    int no_idle_bits() const { return d_no_idle_bits; }
+
+private:
+    // Bit slips tried by the fast relock, in order
+    static constexpr int SLIPS[] = { 0, 1, -1, 2, -2, 3, -3 };
+    static constexpr size_t NUM_SLIPS = sizeof(SLIPS) / sizeof(SLIPS[0]);
+
+    const int d_search_window;
+    const int d_idle_run;
+    const int d_max_idle_no_idle;
+    const int d_max_in_frame_no_idle;
+    const int d_idle_errors;
+
+    bool d_locked;
+    scrambler_lfsr d_lfsr;
+    scrambler_sync d_sync; // the search: IDLE runs in the scrambled bits
+
+    // Lock supervision: zeros among the last idle_run descrambled bits, the
+    // last 30 bits for frame starts, and the bits since the last IDLE
+    // (since the frame start in a frame)
+    std::vector<uint8_t> d_run_bits;
+    size_t d_run_pos;
+    int d_run_zeros;
+    uint32_t d_recent;
+    bool d_in_frame;
+    int d_no_idle_bits;
+    bool d_suspect; // tolerant mode: the last window had no IDLE
+
+    // Fast relock: predicted scrambler states for slips of 0, +1, -1 ...
+    // +3, -3 bits, and their current runs of descrambled ones
+    bool d_predict;
+    uint64_t d_predicted_bits; // bits fed to predict_bit() since start_prediction()
+    std::vector<scrambler_lfsr> d_predicted;
+    std::vector<int> d_predicted_run;
+    int d_slip;
+
+    // Scrambler state one bit earlier: x^11 + x^9 + 1 run backwards
+    static unsigned lfsr_previous(unsigned state)
+    {
+        unsigned bit10 = (state ^ (state >> 9)) & 1;
+        return (state >> 1) | (bit10 << 10);
+    }
+
+    // Takes the state that descrambles the next bit. The bits before were
+    // IDLE, which the supervision starts from.
+    void lock(unsigned state)
+    {
+        d_lfsr.set_state(state);
+        d_locked = true;
+        d_predict = false;
+        std::fill(d_run_bits.begin(), d_run_bits.end(), 1);
+        d_run_zeros = 0;
+        d_recent = ~0u;
+        d_in_frame = false;
+        d_no_idle_bits = 0;
+        d_suspect = false;
+    }
+
+    // /J/K/ after IDLE: mostly ones, then at least 3 zeros in the last 10 bits
+    bool detect_frame_start() const
+    {
+        int idle_count = __builtin_popcount((d_recent >> 10) & 0xFFFFF);
+        int non_idle_count = 10 - __builtin_popcount(d_recent & 0x3FF);
+        return idle_count >= 18 && non_idle_count >= 3;
+    }
+
+    // Called on every locked bit.
+    event check(int bit)
+    {
+        uint8_t& oldest = d_run_bits[d_run_pos];
+        d_run_zeros += (bit == 0) - (oldest == 0);
+        oldest = bit;
+        if (++d_run_pos == d_run_bits.size()) d_run_pos = 0;
+        d_recent = (d_recent << 1) | bit;
+
+        if (d_run_zeros <= d_idle_errors) {
+            d_in_frame = false;
+            d_no_idle_bits = 0;
+            if (d_suspect) {
+                d_suspect = false;
+                return HOLD;
+            }
+            return NONE;
+        }
+        d_no_idle_bits++;
+
+        if (!d_in_frame && detect_frame_start()) {
+            d_in_frame = true;
+            d_no_idle_bits = 0;
+            return FRAME_START;
+        }
+
+        int max_check = d_in_frame ? d_max_in_frame_no_idle : d_max_idle_no_idle;
+        if (d_no_idle_bits <= max_check) return NONE;
+        if (d_in_frame) return FRAME_TOO_LONG;
+
+        if (d_idle_errors > 0 && !d_suspect) {
+            // One window without IDLE can be noise: confirm on the next one,
+            // made of bits not seen yet
+            d_suspect = true;
+            d_no_idle_bits = 0;
+            return SUSPECT;
+        }
+        return LOST;
+    }
+
+    // Called at a loss of lock: d_lfsr is the state for the next input bit.
+    void start_prediction()
+    {
+        unsigned state = d_lfsr.state();
+        for (size_t c = 0; c < NUM_SLIPS; c++) {
+            // SLIPS[c] bits lost by the receiver: the input is that many bits ahead
+            unsigned s = state;
+            for (int k = 0; k > SLIPS[c]; k--) s = lfsr_previous(s);
+            scrambler_lfsr lfsr(s);
+            for (int k = 0; k < SLIPS[c]; k++) lfsr.next();
+            d_predicted[c] = lfsr;
+            d_predicted_run[c] = 0;
+        }
+        d_predict = true;
+        d_predicted_bits = 0;
+    }
+
+    // Descrambles one unlocked bit with every predicted state; locks on the
+    // first that completes an IDLE run.
+    bool predict_bit(int bit)
+    {
+        for (size_t c = 0; c < NUM_SLIPS; c++) {
+            int b = bit ^ d_predicted[c].next();
+            d_predicted_run[c] = b ? d_predicted_run[c] + 1 : 0;
+            if (d_predicted_run[c] < d_idle_run) continue;
+            d_slip = SLIPS[c];
+            lock(d_predicted[c].state());
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -3,101 +3,201 @@
 #endif
 
 #include "ethernet_10baset_decoder_impl.h"
+#include <gnuradio/ethernet/line_coding.h>
 #include <gnuradio/io_signature.h>
+#ifdef GR_CTRLPORT
+#include <gnuradio/rpcregisterhelpers.h>
+#endif
+#include <algorithm>
 #include <iostream>
-#include <sstream>
 #include <iomanip>
+#include <memory>
+#include <cstdio>
 
 namespace gr {
 namespace ethernet {
 
-ethernet_10baset_decoder::sptr ethernet_10baset_decoder::make(const std::string& tag_name)
+static_assert(framer_manchester::MAX_FRAME_BYTES <= FRAME_SLOT_BYTES,
+              "frames must fit a frame_slot");
+
+// Payload bytes shown in payload_preview
+static const size_t PREVIEW_BYTES = 64;
+
+static void format_mac(const uint8_t* mac, char* out)
+{
+    snprintf(out, 18, "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+ethernet_10baset_decoder::sptr ethernet_10baset_decoder::make(const std::string& tag_name,
+                                                              int stats_interval_ms,
+                                                              bool trace_latency,
+                                                              const std::string& filter,
+                                                              int batch_size,
+                                                              int batch_bytes,
+                                                              int batch_timeout_ms,
+                                                              const std::string& len_tag_key)
 {
-    return gnuradio::make_block_sptr<ethernet_10baset_decoder_impl>(tag_name);
+    return gnuradio::make_block_sptr<ethernet_10baset_decoder_impl>(tag_name,
+                                                                    stats_interval_ms,
+                                                                    trace_latency,
+                                                                    filter,
+                                                                    batch_size,
+                                                                    batch_bytes,
+                                                                    batch_timeout_ms,
+                                                                    len_tag_key);
 }
 
-ethernet_10baset_decoder_impl::ethernet_10baset_decoder_impl(const std::string& tag_name)
-    : gr::sync_block("ethernet_10baset_decoder",
-                     gr::io_signature::make(1, 1, sizeof(uint8_t)),
-                     gr::io_signature::make(0, 0, 0)),
-      d_state("IDLE"),
-      d_header_bytes(128),
-      d_header_samples(128 * 8 * 2)
+ethernet_10baset_decoder_impl::ethernet_10baset_decoder_impl(const std::string& tag_name,
+                                                             int stats_interval_ms,
+                                                             bool trace_latency,
+                                                             const std::string& filter,
+                                                             int batch_size,
+                                                             int batch_bytes,
+                                                             int batch_timeout_ms,
+                                                             const std::string& len_tag_key)
+    : gr::block("ethernet_10baset_decoder",
+                gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                gr::io_signature::make(0, 1, sizeof(uint8_t))),
+      d_stats(stats_interval_ms),
+      d_trace(trace_latency),
+      d_filter(frame_filter::compile(filter)),
+      d_batch(batch_size, batch_bytes, batch_timeout_ms),
+      d_emit_dicts(true),
+      d_emit_records(false),
+      d_emit_stream(false),
+      d_decoded_connected(false),
+      d_stream(len_tag_key)
 {
     d_tag_key = pmt::intern(tag_name);
     d_out_port = pmt::intern("decoded");
     message_port_register_out(d_out_port);
+    d_stats_port = pmt::intern("stats");
+    message_port_register_out(d_stats_port);
+    d_records_port = pmt::intern("records");
+    message_port_register_out(d_records_port);
+    d_filter_port = pmt::intern("filter");
+    message_port_register_in(d_filter_port);
+    set_msg_handler(d_filter_port, [this](const pmt::pmt_t& msg) { handle_filter(msg); });
+    
+    // Byte output: at most one byte per 16 samples, offsets unrelated to the input's
+    set_relative_rate(1, 16);
+    set_tag_propagation_policy(TPP_DONT);
     
     std::cout << "[10BASE-T Decoder] Initialized" << std::endl;
 }
 
 ethernet_10baset_decoder_impl::~ethernet_10baset_decoder_impl() {}
 
-std::string ethernet_10baset_decoder_impl::decode_manchester(const std::vector<uint8_t>& samples)
+void ethernet_10baset_decoder_impl::set_stats_interval(int stats_interval_ms)
 {
-    std::string bits;
-    for (size_t i = 0; i < samples.size() - 1; i += 2) {
-        uint8_t a = samples[i];
-        uint8_t b = samples[i + 1];
-        if (a == 0 && b == 1) {
-            bits += "1";
-        } else if (a == 1 && b == 0) {
-            bits += "0";
-        }
-    }
-    return bits;
+    d_stats.set_interval(stats_interval_ms);
 }
 
-std::vector<uint8_t> ethernet_10baset_decoder_impl::extract_bytes(
-    const std::string& bits, int start_bit, int length_bytes)
+void ethernet_10baset_decoder_impl::set_trace_latency(bool trace_latency)
 {
-    std::vector<uint8_t> result;
-    for (int i = 0; i < length_bytes; i++) {
-        int bit_pos = start_bit + i * 8;
-        if (bit_pos + 8 > (int)bits.length()) {
-            return std::vector<uint8_t>();
-        }
-        std::string byte_bin = bits.substr(bit_pos, 8);
-        std::reverse(byte_bin.begin(), byte_bin.end());
-        try {
-            uint8_t v = std::stoi(byte_bin, nullptr, 2);
-            result.push_back(v);
-        } catch (...) {
-            return std::vector<uint8_t>();
-        }
-    }
-    return result;
+    d_trace.set_enabled(trace_latency);
+}
+
+void ethernet_10baset_decoder_impl::set_filter(const std::string& filter)
+{
+    std::atomic_store(&d_filter, frame_filter::compile(filter));
+}
+
+std::string ethernet_10baset_decoder_impl::filter() const
+{
+    frame_filter::sptr f = std::atomic_load(&d_filter);
+    return f ? f->expression() : "";
 }
 
-std::string ethernet_10baset_decoder_impl::fmt_mac(const std::vector<uint8_t>& bytes)
+void ethernet_10baset_decoder_impl::handle_filter(const pmt::pmt_t& msg)
 {
-    std::ostringstream oss;
-    for (size_t i = 0; i < bytes.size(); i++) {
-        if (i > 0) oss << ":";
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)bytes[i];
+    pmt::pmt_t expr = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    if (!pmt::is_symbol(expr)) {
+        std::cout << "[10BASE-T Decoder] filter: expected a symbol" << std::endl;
+        return;
+    }
+    try {
+        set_filter(pmt::symbol_to_string(expr));
+        std::cout << "[10BASE-T Decoder] filter: '" << filter() << "'" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "[10BASE-T Decoder] " << e.what() << ", filter unchanged" << std::endl;
     }
-    return oss.str();
 }
 
-std::string ethernet_10baset_decoder_impl::fmt_ipv4(const std::vector<uint8_t>& bytes)
+int ethernet_10baset_decoder_impl::stats_interval() const { return d_stats.interval(); }
+bool ethernet_10baset_decoder_impl::trace_latency() const { return d_trace.enabled(); }
+uint64_t ethernet_10baset_decoder_impl::frames_decoded() const { return d_frames.get(); }
+uint64_t ethernet_10baset_decoder_impl::fcs_failures() const { return d_fcs_failures.get(); }
+uint64_t ethernet_10baset_decoder_impl::frames_filtered() const { return d_filtered.get(); }
+uint64_t ethernet_10baset_decoder_impl::work_calls() const { return d_stats.work_calls(); }
+uint64_t ethernet_10baset_decoder_impl::work_ticks() const { return d_stats.work_ticks(); }
+
+void ethernet_10baset_decoder_impl::setup_rpc()
 {
-    std::ostringstream oss;
-    for (size_t i = 0; i < bytes.size(); i++) {
-        if (i > 0) oss << ".";
-        oss << (int)bytes[i];
+#ifdef GR_CTRLPORT
+    typedef ethernet_10baset_decoder B;
+    const struct {
+        const char* name;
+        uint64_t (B::*getter)() const;
+        const char* desc;
+    } counters[] = {
+        { "frames_decoded", &B::frames_decoded, "Frames decoded" },
+        { "fcs_failures", &B::fcs_failures, "Frames with a bad FCS" },
+        { "frames_filtered", &B::frames_filtered, "Frames dropped by the filter" },
+        { "work_calls", &B::work_calls, "work() calls" },
+        { "work_ticks", &B::work_ticks, "Time spent in work()" },
+    };
+    for (const auto& c : counters) {
+        add_rpc_variable(rpcbasic_sptr(new rpcbasic_register_get<B, uint64_t>(
+            alias(), c.name, c.getter, pmt::from_uint64(0), pmt::from_uint64(UINT64_MAX),
+            pmt::from_uint64(0), "", c.desc, RPC_PRIVLVL_MIN, DISPTIME | DISPOPTSTRIP)));
     }
-    return oss.str();
+#endif
 }
 
-std::string ethernet_10baset_decoder_impl::fmt_ipv6(const std::vector<uint8_t>& bytes)
+bool ethernet_10baset_decoder_impl::start()
 {
-    std::ostringstream oss;
-    for (size_t i = 0; i < bytes.size(); i += 2) {
-        if (i > 0) oss << ":";
-        oss << std::hex << std::setw(4) << std::setfill('0') 
-            << ((bytes[i] << 8) | bytes[i + 1]);
+    // Only build what is consumed: no dicts unless "decoded" is connected
+    // or nothing else is; the byte output is checked in general_work()
+    d_emit_records = !pmt::is_null(message_subscribers(d_records_port));
+    d_decoded_connected = !pmt::is_null(message_subscribers(d_out_port));
+    d_emit_dicts = d_decoded_connected || !d_emit_records;
+    return true;
+}
+
+bool ethernet_10baset_decoder_impl::stop()
+{
+    flush_batch();
+    return true;
+}
+
+// frame is PMT_NIL when only binary records are emitted.
+void ethernet_10baset_decoder_impl::publish(const pmt::pmt_t& frame, size_t bytes)
+{
+    if (!d_batch.enabled()) {
+        if (d_emit_dicts) message_port_pub(d_out_port, frame);
+        flush_records();
+        d_trace.published();
+    } else if (d_batch.add(frame, bytes, d_trace.take())) {
+        flush_batch();
     }
-    return oss.str();
+}
+
+void ethernet_10baset_decoder_impl::flush_batch()
+{
+    if (d_batch.empty()) return;
+    pmt::pmt_t frames = d_batch.take(d_batch_stamps);
+    if (d_emit_dicts) message_port_pub(d_out_port, frames);
+    flush_records();
+    for (const auto& s : d_batch_stamps) d_trace.published(s);
+}
+
+void ethernet_10baset_decoder_impl::flush_records()
+{
+    if (d_records.empty()) return;
+    const std::vector<uint8_t>& m = d_records.finish();
+    message_port_pub(d_records_port, pmt::init_u8vector(m.size(), m.data()));
+    d_records.clear();
 }
 
 std::string ethernet_10baset_decoder_impl::ethertype_name(int val)
@@ -111,9 +211,9 @@ std::string ethernet_10baset_decoder_impl::ethertype_name(int val)
         case 0x8847: return "MPLS unicast";
         case 0x8848: return "MPLS multicast";
         default: {
-            std::ostringstream oss;
-            oss << "0x" << std::hex << std::setw(4) << std::setfill('0') << val;
-            return oss.str();
+            char buf[16];
+            snprintf(buf, sizeof(buf), "0x%04x", val);
+            return buf;
         }
     }
 }
@@ -128,81 +228,70 @@ std::string ethernet_10baset_decoder_impl::l4_name(int proto)
     }
 }
 
-std::string ethernet_10baset_decoder_impl::tcp_flags_str(uint8_t flags)
+// Hex bytes separated by spaces, PREVIEW_BYTES at most, then the length
+// when the payload is longer.
+std::string ethernet_10baset_decoder_impl::payload_preview(const uint8_t* payload, size_t len)
 {
-    std::vector<std::string> flag_names;
-    if (flags & 0x02) flag_names.push_back("SYN");
-    if (flags & 0x10) flag_names.push_back("ACK");
-    if (flags & 0x01) flag_names.push_back("FIN");
-    if (flags & 0x04) flag_names.push_back("RST");
-    if (flags & 0x08) flag_names.push_back("PSH");
-    if (flags & 0x20) flag_names.push_back("URG");
-    
-    std::string result;
-    for (size_t i = 0; i < flag_names.size(); i++) {
-        if (i > 0) result += " ";
-        result += flag_names[i];
+    char buf[3 * PREVIEW_BYTES + 32];
+    char* p = buf;
+    char* end = buf + sizeof(buf);
+    buf[0] = '\0';
+    for (size_t i = 0; i < std::min(len, PREVIEW_BYTES); i++) {
+        p += snprintf(p, end - p, i ? " %02x" : "%02x", payload[i]);
     }
-    return result;
+    if (len > PREVIEW_BYTES) snprintf(p, end - p, " ... (%zu octets total)", len);
+    return buf;
 }
 
-std::string ethernet_10baset_decoder_impl::payload_preview(
-    const std::vector<uint8_t>& payload_bytes, int max_bytes)
+void ethernet_10baset_decoder_impl::process_frame()
 {
-    if (payload_bytes.empty()) return "";
-    
-    std::ostringstream oss;
-    size_t preview_len = std::min((size_t)max_bytes, payload_bytes.size());
-    
-    for (size_t i = 0; i < preview_len; i++) {
-        if (i > 0) oss << " ";
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)payload_bytes[i];
-    }
+    frame_arena::handle frame = d_arena.acquire();
+    frame->len = d_framer.finish(frame->data);
+    const uint8_t* octets = frame->data;
+    size_t len = frame->len;
+    if (len == 0) return;
     
-    if (payload_bytes.size() > (size_t)max_bytes) {
-        oss << " ... (" << payload_bytes.size() << " octets total)";
+    frame_filter::sptr filter = std::atomic_load(&d_filter);
+    if (filter && !filter->match(octets, len)) {
+        d_filtered.add();
+        return;
     }
     
-    return oss.str();
-}
-
-void ethernet_10baset_decoder_impl::process_header()
-{
-    if (d_buffer.size() < (size_t)(14 * 8 * 2)) return;
-    
-    std::vector<uint8_t> samples(d_buffer.begin(), 
-                                  d_buffer.begin() + std::min((size_t)d_header_samples, d_buffer.size()));
-    std::string bits = decode_manchester(samples);
-    
-    if (bits.length() < 112) return;
+    int frame_length = len;
+    frame->fcs_ok = check_fcs(octets, len);
+    if (!frame->fcs_ok) d_fcs_failures.add();
+    frame->sample_offset = d_framer.start();
     
-    int frame_length = bits.length() / 8;
-    
-    auto mac_dst_bytes = extract_bytes(bits, 0, 6);
-    auto mac_src_bytes = extract_bytes(bits, 48, 6);
-    auto type_bytes = extract_bytes(bits, 96, 2);
-    
-    if (mac_dst_bytes.empty() || mac_src_bytes.empty() || type_bytes.empty()) return;
-    
-    std::string mac_dst = fmt_mac(mac_dst_bytes);
-    std::string mac_src = fmt_mac(mac_src_bytes);
-    int ethertype = (type_bytes[0] << 8) | type_bytes[1];
+    char mac_dst[18], mac_src[18];
+    format_mac(octets, mac_dst);
+    format_mac(octets + 6, mac_src);
+    int ethertype = (octets[12] << 8) | octets[13];
     int ethertype_outer = ethertype;
     int ethertype_final = ethertype;
     std::string type_name_outer = ethertype_name(ethertype);
     
     // Affichage console
-    static int frame_count = 0;
-    frame_count++;
+    d_frames.add();
+    frame->frame_num = d_frames.get();
     
     std::cout << "\n======================================================================" << std::endl;
-    std::cout << "Frame #" << frame_count << " - " << frame_length << " bytes" << std::endl;
+    std::cout << "Frame #" << frame->frame_num << " - " << frame_length << " bytes" << std::endl;
     std::cout << "======================================================================" << std::endl;
     std::cout << "DEST MAC:   " << mac_dst << std::endl;
     std::cout << "SRC MAC:    " << mac_src << std::endl;
     std::cout << "EtherType:  0x" << std::hex << std::setw(4) << std::setfill('0') 
               << ethertype << " (" << type_name_outer << ")" << std::dec << std::endl;
     
+    if (d_emit_records) {
+        d_records.add(octets, len, frame->frame_num, frame->sample_offset, frame->fcs_ok);
+    }
+    if (d_emit_stream) d_stream.add(octets, len, frame->sample_offset, frame->fcs_ok);
+    if (!d_emit_dicts) {
+        d_trace.dissected();
+        publish(pmt::PMT_NIL, len);
+        return;
+    }
+    
     pmt::pmt_t d = pmt::make_dict();
     d = pmt::dict_add(d, pmt::intern("mac_dst"), pmt::intern(mac_dst));
     d = pmt::dict_add(d, pmt::intern("mac_src"), pmt::intern(mac_src));
@@ -214,21 +303,17 @@ void ethernet_10baset_decoder_impl::process_header()
     int vlan_id = -1;
     int vlan_pcp = 0;
     int vlan_dei = 0;
-    int ip_offset_bytes = 14;
+    size_t ip_off = 14;
     
-    if (ethertype == 0x8100 && bits.length() >= (14 + 4) * 8) {
+    if (ethertype == 0x8100 && len >= 14 + 4) {
         has_vlan = true;
-        auto tci_bytes = extract_bytes(bits, 112, 2);
-        auto inner_type_bytes = extract_bytes(bits, 128, 2);
-        if (!tci_bytes.empty() && !inner_type_bytes.empty()) {
-            int tci = (tci_bytes[0] << 8) | tci_bytes[1];
-            vlan_pcp = (tci >> 13) & 0x7;
-            vlan_dei = (tci >> 12) & 0x1;
-            vlan_id = tci & 0x0FFF;
-            ethertype_final = (inner_type_bytes[0] << 8) | inner_type_bytes[1];
-            ip_offset_bytes = 18;
-            std::cout << "VLAN:       ID=" << vlan_id << " PCP=" << vlan_pcp << " DEI=" << vlan_dei << std::endl;
-        }
+        int tci = (octets[14] << 8) | octets[15];
+        vlan_pcp = (tci >> 13) & 0x7;
+        vlan_dei = (tci >> 12) & 0x1;
+        vlan_id = tci & 0x0FFF;
+        ethertype_final = (octets[16] << 8) | octets[17];
+        ip_off = 18;
+        std::cout << "VLAN:       ID=" << vlan_id << " PCP=" << vlan_pcp << " DEI=" << vlan_dei << std::endl;
     }
     
     d = pmt::dict_add(d, pmt::intern("has_vlan"), pmt::from_bool(has_vlan));
@@ -252,113 +337,85 @@ void ethernet_10baset_decoder_impl::process_header()
     std::string info = "";
     std::string payload_str = "";
     
-    int ip_bit_off = ip_offset_bytes * 8;
-    
-    if (ethertype_final == 0x0800 && bits.length() >= (size_t)(ip_bit_off + 20 * 8)) {
-        auto ip_header = extract_bytes(bits, ip_bit_off, 20);
-        if (!ip_header.empty()) {
-            uint8_t ver_ihl = ip_header[0];
-            ip_version = ver_ihl >> 4;
-            int ihl = ver_ihl & 0x0F;
-            int ip_header_len = ihl * 4;
-            ip_ttl = ip_header[8];
-            int proto = ip_header[9];
-            l4_proto = proto;
-            l4_name_str = l4_name(proto);
-            
-            std::vector<uint8_t> src_bytes(ip_header.begin() + 12, ip_header.begin() + 16);
-            std::vector<uint8_t> dst_bytes(ip_header.begin() + 16, ip_header.begin() + 20);
-            ip_src = fmt_ipv4(src_bytes);
-            ip_dst = fmt_ipv4(dst_bytes);
-            
-            std::cout << "Protocol:   " << l4_name_str << std::endl;
-            std::cout << "IP Source:  " << ip_src << std::endl;
-            std::cout << "IP Dest:    " << ip_dst << std::endl;
-            std::cout << "TTL:        " << ip_ttl << std::endl;
+    if (ethertype_final == 0x0800 && len >= ip_off + 20) {
+        const uint8_t* ip_header = octets + ip_off;
+        uint8_t ver_ihl = ip_header[0];
+        ip_version = ver_ihl >> 4;
+        int ihl = ver_ihl & 0x0F;
+        int ip_header_len = ihl * 4;
+        ip_ttl = ip_header[8];
+        int proto = ip_header[9];
+        l4_proto = proto;
+        l4_name_str = l4_name(proto);
+        
+        ip_src = format_ip(4, ip_header + 12);
+        ip_dst = format_ip(4, ip_header + 16);
+        
+        std::cout << "Protocol:   " << l4_name_str << std::endl;
+        std::cout << "IP Source:  " << ip_src << std::endl;
+        std::cout << "IP Dest:    " << ip_dst << std::endl;
+        std::cout << "TTL:        " << ip_ttl << std::endl;
+        
+        size_t l4_off = ip_off + ip_header_len;
+        const uint8_t* l4 = octets + l4_off;
+        
+        if ((proto == 6 || proto == 17) && len >= l4_off + 4) {
+            src_port = (l4[0] << 8) | l4[1];
+            dst_port = (l4[2] << 8) | l4[3];
             
-            int l4_off_bytes = ip_offset_bytes + ip_header_len;
-            int l4_off_bits = l4_off_bytes * 8;
+            std::cout << "Ports:      " << src_port << " -> " << dst_port << std::endl;
             
-            if ((proto == 6 || proto == 17) && bits.length() >= (size_t)(l4_off_bits + 4 * 8)) {
-                auto ports = extract_bytes(bits, l4_off_bits, 4);
-                if (!ports.empty()) {
-                    src_port = (ports[0] << 8) | ports[1];
-                    dst_port = (ports[2] << 8) | ports[3];
-                    
-                    std::cout << "Ports:      " << src_port << " -> " << dst_port << std::endl;
-                    
-                    if (proto == 6 && bits.length() >= (size_t)(l4_off_bits + 14 * 8)) {
-                        auto tcp_hdr = extract_bytes(bits, l4_off_bits, 14);
-                        if (!tcp_hdr.empty()) {
-                            uint8_t flags_byte = tcp_hdr[13];
-                            tcp_flags = tcp_flags_str(flags_byte);
-                            if (!tcp_flags.empty()) {
-                                std::cout << "TCP Flags:  " << tcp_flags << std::endl;
-                            }
-                        }
-                    }
-                    
-                    info = ip_src + ":" + std::to_string(src_port) + " -> " + 
-                           ip_dst + ":" + std::to_string(dst_port) + " (" + l4_name_str + ")";
-                    
-                    int payload_off_bytes = l4_off_bytes + 20;
-                    int payload_off_bits = payload_off_bytes * 8;
-                    if (bits.length() >= (size_t)(payload_off_bits + 8)) {
-                        int remaining = frame_length - payload_off_bytes;
-                        if (remaining > 0 && remaining < 1500) {
-                            auto payload_data = extract_bytes(bits, payload_off_bits, std::min(remaining, 64));
-                            if (!payload_data.empty()) {
-                                payload_str = payload_preview(payload_data, 64);
-                            }
-                        }
-                    }
+            if (proto == 6 && len >= l4_off + 14) {
+                tcp_flags = tcp_flags_string(l4[13]);
+                if (!tcp_flags.empty()) {
+                    std::cout << "TCP Flags:  " << tcp_flags << std::endl;
                 }
-            } else if (proto == 1 && bits.length() >= (size_t)(l4_off_bits + 2 * 8)) {
-                auto icmp_hdr = extract_bytes(bits, l4_off_bits, 2);
-                if (!icmp_hdr.empty()) {
-                    icmp_type = icmp_hdr[0];
-                    icmp_code = icmp_hdr[1];
-                    info = "ICMP type " + std::to_string(icmp_type) + ", code " + 
-                           std::to_string(icmp_code) + " " + ip_src + " -> " + ip_dst;
-                    std::cout << "ICMP:       Type=" << icmp_type << " Code=" << icmp_code << std::endl;
-                }
-            } else {
-                info = "IPv4 " + l4_name_str + " " + ip_src + " -> " + ip_dst;
             }
-        }
-    } else if (ethertype_final == 0x86DD && bits.length() >= (size_t)(ip_bit_off + 40 * 8)) {
-        auto ip6_header = extract_bytes(bits, ip_bit_off, 40);
-        if (!ip6_header.empty()) {
-            int ver = ip6_header[0] >> 4;
-            ip_version = ver;
-            int next_header = ip6_header[6];
-            l4_proto = next_header;
-            l4_name_str = l4_name(next_header);
             
-            std::vector<uint8_t> src_bytes(ip6_header.begin() + 8, ip6_header.begin() + 24);
-            std::vector<uint8_t> dst_bytes(ip6_header.begin() + 24, ip6_header.begin() + 40);
-            ip_src = fmt_ipv6(src_bytes);
-            ip_dst = fmt_ipv6(dst_bytes);
+            info = ip_src + ":" + std::to_string(src_port) + " -> " + 
+                   ip_dst + ":" + std::to_string(dst_port) + " (" + l4_name_str + ")";
             
-            std::cout << "Protocol:   " << l4_name_str << " (IPv6)" << std::endl;
-            std::cout << "IP6 Source: " << ip_src << std::endl;
-            std::cout << "IP6 Dest:   " << ip_dst << std::endl;
-            
-            int l4_off_bytes = ip_offset_bytes + 40;
-            int l4_off_bits = l4_off_bytes * 8;
-            
-            if ((next_header == 6 || next_header == 17) && bits.length() >= (size_t)(l4_off_bits + 4 * 8)) {
-                auto ports = extract_bytes(bits, l4_off_bits, 4);
-                if (!ports.empty()) {
-                    src_port = (ports[0] << 8) | ports[1];
-                    dst_port = (ports[2] << 8) | ports[3];
-                    info = ip_src + ":" + std::to_string(src_port) + " -> " + 
-                           ip_dst + ":" + std::to_string(dst_port) + " (" + l4_name_str + ")";
-                    std::cout << "Ports:      " << src_port << " -> " << dst_port << std::endl;
+            size_t payload_off = l4_off + 20;
+            if (len > payload_off) {
+                int remaining = frame_length - (int)payload_off;
+                if (remaining < 1500) {
+                    payload_str = payload_preview(octets + payload_off, std::min(remaining, 64));
                 }
-            } else {
-                info = "IPv6 " + l4_name_str + " " + ip_src + " -> " + ip_dst;
             }
+        } else if (proto == 1 && len >= l4_off + 2) {
+            icmp_type = l4[0];
+            icmp_code = l4[1];
+            info = "ICMP type " + std::to_string(icmp_type) + ", code " + 
+                   std::to_string(icmp_code) + " " + ip_src + " -> " + ip_dst;
+            std::cout << "ICMP:       Type=" << icmp_type << " Code=" << icmp_code << std::endl;
+        } else {
+            info = "IPv4 " + l4_name_str + " " + ip_src + " -> " + ip_dst;
+        }
+    } else if (ethertype_final == 0x86DD && len >= ip_off + 40) {
+        const uint8_t* ip6_header = octets + ip_off;
+        ip_version = ip6_header[0] >> 4;
+        int next_header = ip6_header[6];
+        l4_proto = next_header;
+        l4_name_str = l4_name(next_header);
+        
+        ip_src = format_ip(6, ip6_header + 8);
+        ip_dst = format_ip(6, ip6_header + 24);
+        
+        std::cout << "Protocol:   " << l4_name_str << " (IPv6)" << std::endl;
+        std::cout << "IP6 Source: " << ip_src << std::endl;
+        std::cout << "IP6 Dest:   " << ip_dst << std::endl;
+        
+        size_t l4_off = ip_off + 40;
+        const uint8_t* l4 = octets + l4_off;
+        
+        if ((next_header == 6 || next_header == 17) && len >= l4_off + 4) {
+            src_port = (l4[0] << 8) | l4[1];
+            dst_port = (l4[2] << 8) | l4[3];
+            info = ip_src + ":" + std::to_string(src_port) + " -> " + 
+                   ip_dst + ":" + std::to_string(dst_port) + " (" + l4_name_str + ")";
+            std::cout << "Ports:      " << src_port << " -> " << dst_port << std::endl;
+        } else {
+            info = "IPv6 " + l4_name_str + " " + ip_src + " -> " + ip_dst;
         }
     } else if (ethertype_final == 0x0806) {
         info = "ARP";
@@ -381,46 +438,101 @@ void ethernet_10baset_decoder_impl::process_header()
     d = pmt::dict_add(d, pmt::intern("payload_preview"), pmt::intern(payload_str));
     d = pmt::dict_add(d, pmt::intern("info"), pmt::intern(info));
     
-    message_port_pub(d_out_port, d);
+    // Decoded bytes (destination MAC to FCS) and where they start in the input
+    d = pmt::dict_add(d, pmt::intern("sample_offset"), pmt::from_uint64(frame->sample_offset));
+    d = pmt::dict_add(d, pmt::intern("frame"), pmt::init_u8vector(len, octets));
+    d = pmt::dict_add(d, pmt::intern("fcs_ok"), pmt::from_bool(frame->fcs_ok));
+    d = d_trace.dissected(d);
+    
+    publish(d, len);
+}
+
+void ethernet_10baset_decoder_impl::finish_frame(uint64_t end_offset)
+{
+    d_trace.eof(end_offset, d_stats.work_start());
+    try {
+        process_frame();
+    } catch (...) {
+    }
+}
+
+// Writes queued frame bytes after the produced ones; returns the new total.
+int ethernet_10baset_decoder_impl::write_stream(uint8_t* out, int produced, int noutput_items)
+{
+    return produced + d_stream.write(out + produced,
+                                     noutput_items - produced,
+                                     nitems_written(0) + produced,
+                                     [this](uint64_t offset, const pmt::pmt_t& key, const pmt::pmt_t& value) {
+                                         add_item_tag(0, offset, key, value);
+                                     });
 }
 
-int ethernet_10baset_decoder_impl::work(int noutput_items,
-                                         gr_vector_const_void_star& input_items,
-                                         gr_vector_void_star& output_items)
+void ethernet_10baset_decoder_impl::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    // Queued frame bytes are written without new input
+    ninput_items_required[0] = d_stream.empty() ? 1 : 0;
+}
+
+int ethernet_10baset_decoder_impl::general_work(int noutput_items,
+                                                 gr_vector_int& ninput_items,
+                                                 gr_vector_const_void_star& input_items,
+                                                 gr_vector_void_star& output_items)
 {
     const uint8_t* in = (const uint8_t*)input_items[0];
+    const int ninput = ninput_items[0];
+    uint8_t* out = output_items.empty() ? nullptr : (uint8_t*)output_items[0];
+    d_emit_stream = out != nullptr;
+    d_emit_dicts = d_decoded_connected || (!d_emit_records && !d_emit_stream);
+    
+    // Frames of the previous calls go first; the input waits until they fit
+    int produced = 0;
+    if (d_emit_stream) {
+        produced = write_stream(out, 0, noutput_items);
+        if (!d_stream.empty()) return produced;
+    }
     
-    std::vector<gr::tag_t> tags;
-    get_tags_in_window(tags, 0, 0, noutput_items, d_tag_key);
+    d_stats.work_begin();
+    
+    std::vector<gr::tag_t>& tags = d_tags;
+    get_tags_in_window(tags, 0, 0, ninput, d_tag_key);
     uint64_t nread = nitems_read(0);
+    size_t tag_idx = 0;
     
-    if (!tags.empty()) {
-        gr::tag_t tag = tags[0];
-        int local_offset = (int)(tag.offset - nread);
-        d_state = "ACCUMULATING_HEADER";
-        d_buffer.clear();
+    int i = 0;
+    while (i < ninput) {
+        int next_tag = (tag_idx < tags.size()) ? (int)(tags[tag_idx].offset - nread) : ninput;
         
-        if (local_offset >= 0 && local_offset < noutput_items) {
-            for (int i = local_offset; i < noutput_items; i++) {
-                d_buffer.push_back(in[i]);
-            }
+        if (d_framer.in_frame()) {
+            bool done = false;
+            for (; i < next_tag && !done; i++) done = d_framer.push(in[i]);
+            if (done) finish_frame(nread + i - 1);
+        } else {
+            i = next_tag;
         }
-    } else if (d_state == "ACCUMULATING_HEADER") {
-        for (int i = 0; i < noutput_items; i++) {
-            d_buffer.push_back(in[i]);
+        
+        if (i == next_tag && tag_idx < tags.size()) {
+            // A new SFD before the end of the previous frame
+            if (d_framer.in_frame()) finish_frame(tags[tag_idx].offset);
+            d_framer.begin(tags[tag_idx].offset);
+            d_trace.sfd(tags[tag_idx].offset);
+            tag_idx++;
         }
     }
     
-    if (d_state == "ACCUMULATING_HEADER" && (int)d_buffer.size() >= d_header_samples) {
-        try {
-            process_header();
-        } catch (...) {
-        }
-        d_state = "IDLE";
-        d_buffer.clear();
+    if (d_batch.expired()) flush_batch();
+    
+    if (d_stats.work_end()) {
+        pmt::pmt_t st = d_stats.make_dict(alias());
+        st = pmt::dict_add(st, pmt::intern("frames_decoded"), pmt::from_uint64(frames_decoded()));
+        st = pmt::dict_add(st, pmt::intern("fcs_failures"), pmt::from_uint64(fcs_failures()));
+        st = pmt::dict_add(st, pmt::intern("frames_filtered"), pmt::from_uint64(frames_filtered()));
+        st = d_trace.add_to_stats(st);
+        message_port_pub(d_stats_port, st);
     }
     
-    return noutput_items;
+    consume_each(ninput);
+    if (d_emit_stream) produced = write_stream(out, produced, noutput_items);
+    return produced;
 }
 
 } // namespace ethernet
@@ -1,7 +1,15 @@
 #ifndef INCLUDED_ETHERNET_ETHERNET_10BASET_DECODER_IMPL_H
 #define INCLUDED_ETHERNET_ETHERNET_10BASET_DECODER_IMPL_H
 
+#include "block_stats.h"
+#include "frame_arena.h"
+#include "frame_batcher.h"
+#include "frame_stream.h"
+#include "framer_manchester.h"
+#include "latency_trace.h"
 #include <gnuradio/ethernet/ethernet_10baset_decoder.h>
+#include <gnuradio/ethernet/frame_filter.h>
+#include <gnuradio/ethernet/frame_record.h>
 #include <pmt/pmt.h>
 #include <vector>
 #include <string>
@@ -14,31 +22,72 @@ class ethernet_10baset_decoder_impl : public ethernet_10baset_decoder
 private:
     pmt::pmt_t d_tag_key;
     pmt::pmt_t d_out_port;
+    pmt::pmt_t d_stats_port;
+    pmt::pmt_t d_filter_port;
+    pmt::pmt_t d_records_port;
     
-    std::string d_state;
-    std::vector<uint8_t> d_buffer;
+    framer_manchester d_framer;
     
-    int d_header_bytes;
-    int d_header_samples;
+    stat_counter d_frames;
+    stat_counter d_fcs_failures;
+    stat_counter d_filtered;
+    block_stats d_stats;
+    frame_trace d_trace;
+    frame_filter::sptr d_filter; // nullptr: no filter; std::atomic_load/store only
+    frame_batcher d_batch;
+    frame_record_writer d_records;
+    std::vector<frame_trace::stamps> d_batch_stamps;
+    std::vector<gr::tag_t> d_tags;
+    frame_arena d_arena;
+    bool d_emit_dicts;         // "decoded" is connected, or nothing else is
+    bool d_emit_records;       // "records" is connected
+    bool d_emit_stream;        // the byte output is connected
+    bool d_decoded_connected;
+    frame_stream d_stream;
     
-    std::string decode_manchester(const std::vector<uint8_t>& samples);
-    std::vector<uint8_t> extract_bytes(const std::string& bits, int start_bit, int length_bytes);
-    std::string fmt_mac(const std::vector<uint8_t>& bytes);
-    std::string fmt_ipv4(const std::vector<uint8_t>& bytes);
-    std::string fmt_ipv6(const std::vector<uint8_t>& bytes);
     std::string ethertype_name(int val);
     std::string l4_name(int proto);
-    std::string tcp_flags_str(uint8_t flags);
-    std::string payload_preview(const std::vector<uint8_t>& payload_bytes, int max_bytes);
-    void process_header();
+    std::string payload_preview(const uint8_t* payload, size_t len);
+    void finish_frame(uint64_t end_offset);
+    void process_frame();
+    void handle_filter(const pmt::pmt_t& msg);
+    void publish(const pmt::pmt_t& frame, size_t bytes);
+    void flush_batch();
+    void flush_records();
+    int write_stream(uint8_t* out, int produced, int noutput_items);
 
 public:
-    ethernet_10baset_decoder_impl(const std::string& tag_name);
+    ethernet_10baset_decoder_impl(const std::string& tag_name,
+                                  int stats_interval_ms,
+                                  bool trace_latency,
+                                  const std::string& filter,
+                                  int batch_size,
+                                  int batch_bytes,
+                                  int batch_timeout_ms,
+                                  const std::string& len_tag_key);
     ~ethernet_10baset_decoder_impl();
     
-    int work(int noutput_items,
-             gr_vector_const_void_star& input_items,
-             gr_vector_void_star& output_items) override;
+    void set_stats_interval(int stats_interval_ms) override;
+    int stats_interval() const override;
+    void set_trace_latency(bool trace_latency) override;
+    bool trace_latency() const override;
+    void set_filter(const std::string& filter) override;
+    std::string filter() const override;
+    uint64_t frames_decoded() const override;
+    uint64_t fcs_failures() const override;
+    uint64_t frames_filtered() const override;
+    uint64_t work_calls() const override;
+    uint64_t work_ticks() const override;
+    
+    void setup_rpc() override;
+    bool start() override;
+    bool stop() override;
+    
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
 };
 
 } // namespace ethernet
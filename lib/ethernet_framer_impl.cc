@@ -0,0 +1,126 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "ethernet_framer_impl.h"
+#include <gnuradio/ethernet/line_coding.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace gr {
+namespace ethernet {
+
+ethernet_framer::sptr ethernet_framer::make(bool repeat, const std::string& len_tag_key)
+{
+    return gnuradio::make_block_sptr<ethernet_framer_impl>(repeat, len_tag_key);
+}
+
+ethernet_framer_impl::ethernet_framer_impl(bool repeat, const std::string& len_tag_key)
+    : gr::sync_block("ethernet_framer",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, sizeof(uint8_t))),
+      d_len_tag_key(pmt::intern(len_tag_key)),
+      d_repeat(repeat),
+      d_next(0),
+      d_current(nullptr),
+      d_pos(0)
+{
+    // No handler: PDUs are pulled from the queue in work(), like
+    // pdu_to_tagged_stream, so a frame is only built when there is room.
+    d_in_port = pmt::intern("pdus");
+    message_port_register_in(d_in_port);
+}
+
+ethernet_framer_impl::~ethernet_framer_impl() {}
+
+bool ethernet_framer_impl::build_frame(const pmt::pmt_t& pdu, std::vector<uint8_t>& frame)
+{
+    if (!pmt::is_pair(pdu) || !pmt::is_u8vector(pmt::cdr(pdu))) {
+        std::cout << "[Ethernet Framer] Ignoring message: not a u8vector PDU" << std::endl;
+        return false;
+    }
+
+    size_t len = 0;
+    const uint8_t* data = pmt::u8vector_elements(pmt::cdr(pdu), len);
+    if (len < 14) {
+        std::cout << "[Ethernet Framer] Ignoring PDU shorter than an Ethernet header ("
+                  << len << " bytes)" << std::endl;
+        return false;
+    }
+
+    size_t body = std::max(len, (size_t)60);
+    frame.assign(8 + body + 4, 0);
+    std::fill(frame.begin(), frame.begin() + 7, 0x55);
+    frame[7] = 0xD5;
+    memcpy(frame.data() + 8, data, len);
+
+    uint32_t fcs = crc32(frame.data() + 8, body);
+    for (int i = 0; i < 4; i++) {
+        frame[8 + body + i] = (fcs >> (8 * i)) & 0xFF;
+    }
+    return true;
+}
+
+bool ethernet_framer_impl::next_frame()
+{
+    pmt::pmt_t msg;
+    while ((msg = delete_head_nowait(d_in_port)).get() != nullptr) {
+        std::vector<uint8_t> frame;
+        if (!build_frame(msg, frame)) continue;
+
+        if (!d_repeat) {
+            d_frames.assign(1, std::move(frame));
+            d_next = 0;
+        } else if (d_frames.size() < MAX_REPEAT_FRAMES) {
+            d_frames.push_back(std::move(frame));
+            d_next = d_frames.size() - 1;
+        } else {
+            // Loop is full: the new frame takes the slot due next.
+            d_frames[d_next] = std::move(frame);
+        }
+        d_current = &d_frames[d_next];
+        d_next = (d_next + 1) % d_frames.size();
+        d_pos = 0;
+        return true;
+    }
+
+    if (d_repeat && !d_frames.empty()) {
+        d_current = &d_frames[d_next];
+        d_next = (d_next + 1) % d_frames.size();
+        d_pos = 0;
+        return true;
+    }
+
+    d_current = nullptr;
+    return false;
+}
+
+int ethernet_framer_impl::work(int noutput_items,
+                               gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items)
+{
+    uint8_t* out = (uint8_t*)output_items[0];
+    int produced = 0;
+
+    while (produced < noutput_items) {
+        if (d_current == nullptr || d_pos == d_current->size()) {
+            if (!next_frame()) break;
+            add_item_tag(0,
+                         nitems_written(0) + produced,
+                         d_len_tag_key,
+                         pmt::from_long(d_current->size()));
+        }
+
+        size_t n = std::min((size_t)(noutput_items - produced), d_current->size() - d_pos);
+        memcpy(out + produced, d_current->data() + d_pos, n);
+        d_pos += n;
+        produced += n;
+    }
+
+    return produced;
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,40 @@
+#ifndef INCLUDED_ETHERNET_ETHERNET_FRAMER_IMPL_H
+#define INCLUDED_ETHERNET_ETHERNET_FRAMER_IMPL_H
+
+#include <gnuradio/ethernet/ethernet_framer.h>
+#include <pmt/pmt.h>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+class ethernet_framer_impl : public ethernet_framer
+{
+private:
+    static const size_t MAX_REPEAT_FRAMES = 4096;
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_len_tag_key;
+    bool d_repeat;
+
+    std::vector<std::vector<uint8_t>> d_frames;
+    size_t d_next;
+    const std::vector<uint8_t>* d_current;
+    size_t d_pos;
+
+    bool build_frame(const pmt::pmt_t& pdu, std::vector<uint8_t>& frame);
+    bool next_frame();
+
+public:
+    ethernet_framer_impl(bool repeat, const std::string& len_tag_key);
+    ~ethernet_framer_impl();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,160 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "fastethernet_4b5b_encoder_impl.h"
+#include <gnuradio/ethernet/line_coding.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+namespace ethernet {
+
+fastethernet_4b5b_encoder::sptr
+fastethernet_4b5b_encoder::make(int idle_symbols, const std::string& len_tag_key)
+{
+    return gnuradio::make_block_sptr<fastethernet_4b5b_encoder_impl>(idle_symbols,
+                                                                     len_tag_key);
+}
+
+fastethernet_4b5b_encoder_impl::fastethernet_4b5b_encoder_impl(
+    int idle_symbols, const std::string& len_tag_key)
+    : gr::block("fastethernet_4b5b_encoder",
+                gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                gr::io_signature::make(1, 1, sizeof(uint8_t))),
+      d_idle_symbols(std::max(idle_symbols, 1)),
+      d_len_tag_key(pmt::intern(len_tag_key)),
+      d_started(false),
+      d_remaining(0),
+      d_pending_pos(0)
+{
+    // Both code-groups of a byte, low nibble first, as one 10-bit word.
+    for (int b = 0; b < 256; b++) {
+        d_byte_codes[b] = (FIVEB_CODES[b & 0xF] << 5) | FIVEB_CODES[b >> 4];
+    }
+
+    set_relative_rate(10.0);
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+fastethernet_4b5b_encoder_impl::~fastethernet_4b5b_encoder_impl() {}
+
+void fastethernet_4b5b_encoder_impl::forecast(int noutput_items,
+                                              gr_vector_int& ninput_items_required)
+{
+    // Code-groups left over (the end of the last frame) need no input
+    ninput_items_required[0] =
+        d_pending_pos < d_pending.size() ? 0 : std::max(1, noutput_items / 10);
+}
+
+void fastethernet_4b5b_encoder_impl::push_code(uint8_t code)
+{
+    for (int b = 4; b >= 0; b--) {
+        d_pending.push_back((code >> b) & 1);
+    }
+}
+
+void fastethernet_4b5b_encoder_impl::push_idle()
+{
+    for (int i = 0; i < d_idle_symbols; i++) {
+        push_code(FIVEB_IDLE);
+    }
+}
+
+void fastethernet_4b5b_encoder_impl::end_frame()
+{
+    push_code(FIVEB_T);
+    push_code(FIVEB_R);
+    push_idle();
+    d_remaining = 0;
+}
+
+int fastethernet_4b5b_encoder_impl::general_work(int noutput_items,
+                                                 gr_vector_int& ninput_items,
+                                                 gr_vector_const_void_star& input_items,
+                                                 gr_vector_void_star& output_items)
+{
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    uint8_t* out = (uint8_t*)output_items[0];
+    const int ninput = ninput_items[0];
+
+    std::vector<gr::tag_t> tags;
+    get_tags_in_window(tags, 0, 0, ninput, d_len_tag_key);
+    const uint64_t nread = nitems_read(0);
+    size_t tag_idx = 0;
+
+    int consumed = 0;
+    int produced = 0;
+
+    while (true) {
+        // Control code-groups, or a byte that did not fit, go first.
+        if (d_pending_pos < d_pending.size()) {
+            size_t n = std::min((size_t)(noutput_items - produced),
+                                d_pending.size() - d_pending_pos);
+            memcpy(out + produced, d_pending.data() + d_pending_pos, n);
+            produced += n;
+            d_pending_pos += n;
+            if (d_pending_pos < d_pending.size()) break;
+            d_pending.clear();
+            d_pending_pos = 0;
+        }
+        if (consumed >= ninput) break;
+
+        while (tag_idx < tags.size() && tags[tag_idx].offset < nread + consumed) {
+            tag_idx++;
+        }
+        int next_tag = (tag_idx < tags.size()) ? (int)(tags[tag_idx].offset - nread) : ninput;
+
+        if (next_tag == consumed) {
+            if (d_remaining > 0) end_frame(); // truncated frame
+            if (!d_started) push_idle();
+            d_started = true;
+
+            // The first preamble byte goes out as /J/K/.
+            d_remaining = pmt::to_long(tags[tag_idx].value) - 1;
+            push_code(FIVEB_J);
+            push_code(FIVEB_K);
+            consumed++;
+            tag_idx++;
+            if (d_remaining <= 0) end_frame();
+            continue;
+        }
+
+        if (d_remaining == 0) {
+            // Not part of any tagged frame: dropped.
+            consumed = next_tag;
+            continue;
+        }
+
+        int n = std::min({ next_tag - consumed,
+                           (int)d_remaining,
+                           (noutput_items - produced) / 10 });
+        uint8_t* o = out + produced;
+        for (int i = 0; i < n; i++) {
+            uint16_t code = d_byte_codes[in[consumed + i]];
+            for (int b = 9; b >= 0; b--) {
+                *o++ = (code >> b) & 1;
+            }
+        }
+        produced += 10 * n;
+        consumed += n;
+        d_remaining -= n;
+
+        if (d_remaining == 0) {
+            end_frame();
+        } else if (n == 0 && consumed < next_tag) {
+            // Less than 10 free output items: finish the byte next call.
+            push_code(FIVEB_CODES[in[consumed] & 0xF]);
+            push_code(FIVEB_CODES[in[consumed] >> 4]);
+            consumed++;
+            if (--d_remaining == 0) end_frame();
+        }
+    }
+
+    consume_each(consumed);
+    return produced;
+}
+
+} // namespace ethernet
+} // namespace gr
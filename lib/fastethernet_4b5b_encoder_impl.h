@@ -0,0 +1,43 @@
+#ifndef INCLUDED_ETHERNET_FASTETHERNET_4B5B_ENCODER_IMPL_H
+#define INCLUDED_ETHERNET_FASTETHERNET_4B5B_ENCODER_IMPL_H
+
+#include <gnuradio/ethernet/fastethernet_4b5b_encoder.h>
+#include <pmt/pmt.h>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+class fastethernet_4b5b_encoder_impl : public fastethernet_4b5b_encoder
+{
+private:
+    int d_idle_symbols;
+    pmt::pmt_t d_len_tag_key;
+
+    bool d_started;
+    long d_remaining;
+    uint16_t d_byte_codes[256];
+
+    std::vector<uint8_t> d_pending;
+    size_t d_pending_pos;
+
+    void push_code(uint8_t code);
+    void push_idle();
+    void end_frame();
+
+public:
+    fastethernet_4b5b_encoder_impl(int idle_symbols, const std::string& len_tag_key);
+    ~fastethernet_4b5b_encoder_impl();
+
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
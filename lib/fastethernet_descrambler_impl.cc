@@ -4,20 +4,39 @@
 
 #include "fastethernet_descrambler_impl.h"
 #include <gnuradio/io_signature.h>
+#ifdef GR_CTRLPORT
+#include <gnuradio/rpcregisterhelpers.h>
+#endif
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 namespace gr {
 namespace ethernet {
 
+namespace {
+
+// 100BASE-TX line rate, in bits per second of line time
+const uint64_t LINE_BITS_PER_SECOND = 125000000;
+const size_t BER_BUCKETS = 16;
+// More zeros than this in one word end an IDLE span
+const int MAX_WORD_ERRORS = 4;
+
+} // namespace
+
 fastethernet_descrambler::sptr 
 fastethernet_descrambler::make(int search_window,
                                 int idle_run,
                                 int max_idle_no_idle,
                                 int max_in_frame_no_idle,
-                                bool print_debug)
+                                bool print_debug,
+                                int stats_interval_ms,
+                                int ber_window,
+                                int idle_errors)
 {
     return gnuradio::make_block_sptr<fastethernet_descrambler_impl>(
-        search_window, idle_run, max_idle_no_idle, max_in_frame_no_idle, print_debug);
+        search_window, idle_run, max_idle_no_idle, max_in_frame_no_idle, print_debug,
+        stats_interval_ms, ber_window, idle_errors);
 }
 
 fastethernet_descrambler_impl::fastethernet_descrambler_impl(
@@ -25,187 +44,225 @@ fastethernet_descrambler_impl::fastethernet_descrambler_impl(
     int idle_run,
     int max_idle_no_idle,
     int max_in_frame_no_idle,
-    bool print_debug)
+    bool print_debug,
+    int stats_interval_ms,
+    int ber_window,
+    int idle_errors)
     : gr::sync_block("fastethernet_descrambler",
                      gr::io_signature::make(1, 1, sizeof(uint8_t)),
                      gr::io_signature::make(1, 1, sizeof(uint8_t))),
-      d_search_window(search_window),
-      d_idle_run(idle_run),
       d_max_idle_no_idle(max_idle_no_idle),
-      d_max_in_frame_no_idle(max_in_frame_no_idle),
       d_print_debug(print_debug),
+      d_core(search_window, idle_run, max_idle_no_idle, max_in_frame_no_idle, idle_errors),
       d_synced(false),
-      d_lfsr(11, 0),
-      d_in_frame(false),
-      d_bits_since_sfd(0),
       d_total_processed(0),
-      d_debug_count(0),
-      d_resync_count(0),
-      d_check_interval(50)
+      d_stats(stats_interval_ms),
+      d_unlocked_since(0),
+      d_ber_window(ber_window),
+      d_word(0),
+      d_word_bits(0),
+      d_prev_word(0),
+      d_prev_before(1),
+      d_have_prev(false),
+      d_idle(false),
+      d_bucket_bits(BER_BUCKETS, 0),
+      d_bucket_errors(BER_BUCKETS, 0),
+      d_bucket(0),
+      d_window_bits(0),
+      d_window_errors(0),
+      d_ber(0),
+      d_second_end(LINE_BITS_PER_SECOND),
+      d_second_errors(0),
+      d_ber_key(pmt::intern("ber"))
 {
+    if (ber_window < 0) {
+        throw std::invalid_argument("fastethernet_descrambler: ber_window must be >= 0");
+    }
+    if (idle_errors < 0 || idle_errors >= idle_run) {
+        throw std::invalid_argument("fastethernet_descrambler: idle_errors must be in [0, idle_run)");
+    }
+    d_stats_port = pmt::intern("stats");
+    message_port_register_out(d_stats_port);
 }
 
 fastethernet_descrambler_impl::~fastethernet_descrambler_impl() {}
 
-int fastethernet_descrambler_impl::descramble_bit(int bit_in)
+void fastethernet_descrambler_impl::set_stats_interval(int stats_interval_ms)
 {
-    int bi = bit_in & 1;
-    int ldd = d_lfsr[8] ^ d_lfsr[10];
-    int bout = bi ^ ldd;
-    
-    d_lfsr.insert(d_lfsr.begin(), ldd);
-    d_lfsr.pop_back();
-    
-    return bout;
+    d_stats.set_interval(stats_interval_ms);
 }
 
-void fastethernet_descrambler_impl::descramble_chunk(
-    const std::vector<int>& bits,
-    const std::vector<int>& initial_state,
-    std::vector<int>& out,
-    std::vector<int>& final_state)
-{
-    std::vector<int> lfsr = initial_state;
-    out.clear();
-    
-    for (size_t i = 0; i < bits.size(); i++) {
-        int bi = bits[i] & 1;
-        int ldd = lfsr[8] ^ lfsr[10];
-        int bout = bi ^ ldd;
-        out.push_back(bout);
-        
-        lfsr.insert(lfsr.begin(), ldd);
-        lfsr.pop_back();
-    }
-    
-    final_state = lfsr;
-}
+int fastethernet_descrambler_impl::stats_interval() const { return d_stats.interval(); }
+bool fastethernet_descrambler_impl::locked() const { return d_synced; }
+uint64_t fastethernet_descrambler_impl::resync_count() const { return d_resync_count.get(); }
+uint64_t fastethernet_descrambler_impl::last_lock_bits() const { return d_last_lock_bits.get(); }
+uint64_t fastethernet_descrambler_impl::unlocked_bits() const { return d_unlocked_bits.get(); }
+uint64_t fastethernet_descrambler_impl::fast_relocks() const { return d_fast_relocks.get(); }
+uint64_t fastethernet_descrambler_impl::lock_holds() const { return d_lock_holds.get(); }
+uint64_t fastethernet_descrambler_impl::idle_bits() const { return d_idle_bits.get(); }
+uint64_t fastethernet_descrambler_impl::idle_bit_errors() const { return d_idle_bit_errors.get(); }
+double fastethernet_descrambler_impl::ber() const { return d_ber; }
+uint64_t fastethernet_descrambler_impl::line_seconds() const { return d_line_seconds.get(); }
+uint64_t fastethernet_descrambler_impl::errored_seconds() const { return d_errored_seconds.get(); }
+uint64_t fastethernet_descrambler_impl::work_calls() const { return d_stats.work_calls(); }
+uint64_t fastethernet_descrambler_impl::work_ticks() const { return d_stats.work_ticks(); }
 
-bool fastethernet_descrambler_impl::has_run_of_ones(const std::vector<int>& bits, int run_len)
+void fastethernet_descrambler_impl::setup_rpc()
 {
-    int count = 0;
-    for (size_t i = 0; i < bits.size(); i++) {
-        if (bits[i] == 1) {
-            count++;
-            if (count >= run_len) return true;
-        } else {
-            count = 0;
-        }
+#ifdef GR_CTRLPORT
+    typedef fastethernet_descrambler B;
+    const struct {
+        const char* name;
+        uint64_t (B::*getter)() const;
+        const char* desc;
+    } counters[] = {
+        { "resync_count", &B::resync_count, "Locks and losses of lock" },
+        { "last_lock_bits", &B::last_lock_bits, "Bits needed for the last lock" },
+        { "unlocked_bits", &B::unlocked_bits, "Bits passed through unlocked" },
+        { "fast_relocks", &B::fast_relocks, "Locks on the predicted state" },
+        { "lock_holds", &B::lock_holds, "Suspected losses of lock not confirmed" },
+        { "idle_bits", &B::idle_bits, "IDLE bits checked for errors" },
+        { "idle_bit_errors", &B::idle_bit_errors, "Bit errors found in IDLE" },
+        { "line_seconds", &B::line_seconds, "Seconds of line time" },
+        { "errored_seconds", &B::errored_seconds, "Seconds with an IDLE bit error" },
+        { "work_calls", &B::work_calls, "work() calls" },
+        { "work_ticks", &B::work_ticks, "Time spent in work()" },
+    };
+    for (const auto& c : counters) {
+        add_rpc_variable(rpcbasic_sptr(new rpcbasic_register_get<B, uint64_t>(
+            alias(), c.name, c.getter, pmt::from_uint64(0), pmt::from_uint64(UINT64_MAX),
+            pmt::from_uint64(0), "", c.desc, RPC_PRIVLVL_MIN, DISPTIME | DISPOPTSTRIP)));
     }
-    return false;
+    add_rpc_variable(rpcbasic_sptr(new rpcbasic_register_get<B, bool>(
+        alias(), "locked", &B::locked, pmt::PMT_F, pmt::PMT_T, pmt::PMT_F, "",
+        "Scrambler state known", RPC_PRIVLVL_MIN, DISPNULL)));
+    add_rpc_variable(rpcbasic_sptr(new rpcbasic_register_get<B, double>(
+        alias(), "ber", &B::ber, pmt::from_double(0), pmt::from_double(1), pmt::from_double(0),
+        "", "Bit error rate in IDLE", RPC_PRIVLVL_MIN, DISPTIME | DISPOPTSTRIP)));
+#endif
 }
 
-bool fastethernet_descrambler_impl::detect_frame_start()
+// The state was found on the last bit.
+void fastethernet_descrambler_impl::lock()
 {
-    if (d_recent_bits.size() < 30) return false;
-    
-    std::vector<int> last_30(d_recent_bits.end() - 30, d_recent_bits.end());
-    
-    int idle_count = 0;
-    for (int i = 0; i < 20; i++) {
-        if (last_30[i] == 1) idle_count++;
-    }
-    
-    if (idle_count >= 18) {
-        int non_idle_count = 0;
-        for (int i = 20; i < 30; i++) {
-            if (last_30[i] == 0) non_idle_count++;
-        }
-        if (non_idle_count >= 3) return true;
-    }
-    
-    return false;
+    d_synced = true;
+    d_resync_count.add();
+    d_last_lock_bits.set(d_total_processed - d_unlocked_since);
 }
 
-bool fastethernet_descrambler_impl::check_sync_health()
+// Counts and reports what the lock supervision saw on a locked bit; false
+// when the lock is lost.
+bool fastethernet_descrambler_impl::report(descrambler_core::event ev)
 {
-    int max_check = d_in_frame ? d_max_in_frame_no_idle : d_max_idle_no_idle;
-    
-    if ((int)d_idle_check_buffer.size() < max_check) return true;
-    
-    std::vector<int> recent_bits(d_idle_check_buffer.end() - max_check, 
-                                  d_idle_check_buffer.end());
-    
-    if (has_run_of_ones(recent_bits, d_idle_run)) {
-        d_in_frame = false;
-        d_bits_since_sfd = 0;
+    switch (ev) {
+    case descrambler_core::HOLD:
+        d_lock_holds.add();
         return true;
-    }
-    
-    if (!d_in_frame && detect_frame_start()) {
-        d_in_frame = true;
-        d_bits_since_sfd = 0;
+    case descrambler_core::FRAME_START:
         if (d_print_debug) {
             std::cout << "[AutoReSync] Frame start detected at position " 
                       << d_total_processed << std::endl;
         }
         return true;
-    }
-    
-    if (d_in_frame) {
-        d_bits_since_sfd++;
-        if (d_bits_since_sfd > d_max_in_frame_no_idle) {
-            if (d_print_debug) {
-                std::cout << "[AutoReSync] Frame too long (" << d_bits_since_sfd 
-                          << " bits) - lost sync" << std::endl;
-            }
-            return false;
+    case descrambler_core::SUSPECT:
+        if (d_print_debug) {
+            std::cout << "[AutoReSync] No IDLE in last " << d_max_idle_no_idle
+                      << " bits - checking the next window" << std::endl;
         }
         return true;
+    case descrambler_core::FRAME_TOO_LONG:
+        if (d_print_debug) {
+            std::cout << "[AutoReSync] Frame too long (" << d_core.no_idle_bits()
+                      << " bits) - lost sync" << std::endl;
+        }
+        return false;
+    case descrambler_core::LOST:
+        if (d_print_debug) {
+            std::cout << "\n============================================================" << std::endl;
+            std::cout << "[AutoReSync] SYNC LOST!" << std::endl;
+            std::cout << "[AutoReSync] No IDLE in last " << d_max_idle_no_idle << " bits" << std::endl;
+            std::cout << "[AutoReSync] Position: " << d_total_processed << std::endl;
+            std::cout << "============================================================\n" << std::endl;
+        }
+        return false;
+    default:
+        return true;
     }
-    
-    if (d_print_debug) {
-        std::cout << "\n============================================================" << std::endl;
-        std::cout << "[AutoReSync] SYNC LOST!" << std::endl;
-        std::cout << "[AutoReSync] No IDLE in last " << max_check << " bits" << std::endl;
-        std::cout << "[AutoReSync] Position: " << d_total_processed << std::endl;
-        std::cout << "============================================================\n" << std::endl;
-    }
-    
-    return false;
 }
 
-bool fastethernet_descrambler_impl::search_initial_state()
+void fastethernet_descrambler_impl::lose_lock()
 {
-    if ((int)d_search_buffer.size() < d_search_window) return false;
-    
-    std::vector<int> window(d_search_buffer.end() - d_search_window, 
-                            d_search_buffer.end());
-    
-    for (int s = 0; s < 2048; s++) {
-        std::vector<int> state_bits(11);
-        for (int i = 0; i < 11; i++) {
-            state_bits[i] = (s >> (10 - i)) & 1;
-        }
-        
-        std::vector<int> descrambled;
-        std::vector<int> final_state;
-        descramble_chunk(window, state_bits, descrambled, final_state);
-        
-        if (has_run_of_ones(descrambled, d_idle_run)) {
-            d_lfsr = final_state;
-            d_synced = true;
-            d_idle_check_buffer.clear();
-            d_recent_bits.clear();
-            d_in_frame = false;
-            d_bits_since_sfd = 0;
-            
-            if (d_print_debug) {
-                std::string resync_msg = (d_resync_count > 0) ? 
-                    " (RE-SYNC #" + std::to_string(d_resync_count) + ")" : "";
-                    
-                std::cout << "\n============================================================" << std::endl;
-                std::cout << "[AutoReSync] State found" << resync_msg << std::endl;
-                std::cout << "[AutoReSync] Initial state: " << s << std::endl;
-                std::cout << "[AutoReSync] Position: " << d_total_processed << " bits" << std::endl;
-                std::cout << "============================================================\n" << std::endl;
+    d_synced = false;
+    d_resync_count.add();
+    d_unlocked_since = d_total_processed;
+    ber_reset();
+}
+
+// Classifies the previous word, now that the bit after it is known.
+void fastethernet_descrambler_impl::ber_word(uint64_t word)
+{
+    if (d_have_prev) {
+        uint64_t p = d_prev_word;
+        uint64_t zeros = ~p;
+        if (!zeros) {
+            d_idle = true;
+            ber_count(64, 0);
+        } else if (d_idle) {
+            // Bits are MSB first: the bit before bit i is bit i + 1
+            uint64_t before = (p >> 1) | ((uint64_t)d_prev_before << 63);
+            uint64_t after = (p << 1) | (word >> 63);
+            int errors = __builtin_popcountll(zeros);
+            if ((zeros & before & after) == zeros && errors <= MAX_WORD_ERRORS) {
+                ber_count(64, errors);
+            } else {
+                d_idle = false;
             }
-            
-            return true;
         }
+        d_prev_before = p & 1;
+    }
+    d_prev_word = word;
+    d_have_prev = true;
+}
+
+void fastethernet_descrambler_impl::ber_count(uint64_t bits, uint64_t errors)
+{
+    d_idle_bits.add(bits);
+    if (errors) d_idle_bit_errors.add(errors);
+    d_second_errors += errors;
+
+    d_bucket_bits[d_bucket] += bits;
+    d_bucket_errors[d_bucket] += errors;
+    d_window_bits += bits;
+    d_window_errors += errors;
+    if (d_bucket_bits[d_bucket] >= std::max<uint64_t>(64, d_ber_window / BER_BUCKETS)) {
+        // The oldest bucket leaves the window
+        d_bucket = (d_bucket + 1) % BER_BUCKETS;
+        d_window_bits -= d_bucket_bits[d_bucket];
+        d_window_errors -= d_bucket_errors[d_bucket];
+        d_bucket_bits[d_bucket] = 0;
+        d_bucket_errors[d_bucket] = 0;
+    }
+}
+
+// A word cut by a loss of lock is dropped, and IDLE must be seen again.
+void fastethernet_descrambler_impl::ber_reset()
+{
+    d_word_bits = 0;
+    d_have_prev = false;
+    d_idle = false;
+}
+
+// Ends the seconds of line time that are over, with a tag on their last bit.
+void fastethernet_descrambler_impl::ber_seconds()
+{
+    d_ber = d_window_bits ? (double)d_window_errors / d_window_bits : 0.0;
+    while (d_total_processed >= d_second_end) {
+        d_line_seconds.add();
+        if (d_second_errors) d_errored_seconds.add();
+        d_second_errors = 0;
+        add_item_tag(0, d_second_end - 1, d_ber_key, pmt::from_double(d_ber));
+        d_second_end += LINE_BITS_PER_SECOND;
     }
-    
-    return false;
 }
 
 int fastethernet_descrambler_impl::work(int noutput_items,
@@ -215,57 +272,79 @@ int fastethernet_descrambler_impl::work(int noutput_items,
     const uint8_t* in = (const uint8_t*)input_items[0];
     uint8_t* out = (uint8_t*)output_items[0];
     
-    if (!d_synced) {
-        for (int i = 0; i < noutput_items; i++) {
-            int bit = in[i] & 1;
-            d_search_buffer.push_back(bit);
-            d_total_processed++;
-            
-            if ((int)d_search_buffer.size() > d_search_window + 100) {
-                d_search_buffer.pop_front();
-            }
-            
-            out[i] = in[i];
-        }
-        
-        if ((int)d_search_buffer.size() >= d_search_window) {
-            if (search_initial_state()) {
-                d_resync_count++;
+    d_stats.work_begin();
+    
+    int i = 0;
+    while (i < noutput_items) {
+        if (!d_core.locked()) {
+            int start = i;
+            while (i < noutput_items) {
+                int bit = in[i] & 1;
+                d_total_processed++;
+                out[i] = in[i];
+                i++;
+
+                descrambler_core::event ev = d_core.search(bit);
+                if (ev == descrambler_core::NONE) continue;
+                lock();
+                if (ev == descrambler_core::RELOCKED) {
+                    d_fast_relocks.add();
+                    if (d_print_debug) {
+                        std::cout << "[AutoReSync] Predicted state confirmed (slip " << d_core.slip()
+                                  << ") at position " << d_total_processed << std::endl;
+                    }
+                } else if (d_print_debug) {
+                    std::cout << "[AutoReSync] State found (resync_count " << d_resync_count.get()
+                              << ") at position " << d_total_processed << std::endl;
+                }
+                break;
             }
+            d_unlocked_bits.add(i - start);
+            continue;
         }
-        
-        return noutput_items;
-    } else {
-        for (int i = 0; i < noutput_items; i++) {
-            int descrambled_bit = descramble_bit(in[i]);
+
+        for (; i < noutput_items; i++) {
+            descrambler_core::event ev;
+            int descrambled_bit = d_core.descramble(in[i] & 1, ev);
             out[i] = descrambled_bit;
             d_total_processed++;
-            
-            d_idle_check_buffer.push_back(descrambled_bit);
-            d_recent_bits.push_back(descrambled_bit);
-            
-            if ((int)d_idle_check_buffer.size() > d_max_in_frame_no_idle + 500) {
-                d_idle_check_buffer.pop_front();
+
+            if (d_ber_window) {
+                d_word = (d_word << 1) | descrambled_bit;
+                if (++d_word_bits == 64) {
+                    ber_word(d_word);
+                    d_word_bits = 0;
+                }
             }
-            if ((int)d_recent_bits.size() > 50) {
-                d_recent_bits.pop_front();
+
+            if (ev != descrambler_core::NONE && !report(ev)) {
+                lose_lock();
+                i++;
+                break;
             }
         }
-        
-        if (d_total_processed % d_check_interval == 0) {
-            if (!check_sync_health()) {
-                d_synced = false;
-                d_lfsr.assign(11, 0);
-                d_search_buffer.clear();
-                d_idle_check_buffer.clear();
-                d_recent_bits.clear();
-                d_in_frame = false;
-                d_resync_count++;
-            }
+    }
+    if (d_ber_window) ber_seconds();
+    
+    if (d_stats.work_end()) {
+        pmt::pmt_t st = d_stats.make_dict(alias());
+        st = pmt::dict_add(st, pmt::intern("locked"), pmt::from_bool(d_synced));
+        st = pmt::dict_add(st, pmt::intern("resync_count"), pmt::from_uint64(resync_count()));
+        st = pmt::dict_add(st, pmt::intern("last_lock_bits"), pmt::from_uint64(last_lock_bits()));
+        st = pmt::dict_add(st, pmt::intern("unlocked_bits"), pmt::from_uint64(unlocked_bits()));
+        st = pmt::dict_add(st, pmt::intern("fast_relocks"), pmt::from_uint64(fast_relocks()));
+        st = pmt::dict_add(st, pmt::intern("lock_holds"), pmt::from_uint64(lock_holds()));
+        if (d_ber_window) {
+            st = pmt::dict_add(st, pmt::intern("idle_bits"), pmt::from_uint64(idle_bits()));
+            st = pmt::dict_add(st, pmt::intern("idle_bit_errors"), pmt::from_uint64(idle_bit_errors()));
+            st = pmt::dict_add(st, pmt::intern("ber"), pmt::from_double(ber()));
+            st = pmt::dict_add(st, pmt::intern("line_seconds"), pmt::from_uint64(line_seconds()));
+            st = pmt::dict_add(st, pmt::intern("errored_seconds"), pmt::from_uint64(errored_seconds()));
         }
-        
-        return noutput_items;
+        message_port_pub(d_stats_port, st);
     }
+    
+    return noutput_items;
 }
 
 } // namespace ethernet
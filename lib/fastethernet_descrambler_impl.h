@@ -1,9 +1,10 @@
 #ifndef INCLUDED_ETHERNET_FASTETHERNET_DESCRAMBLER_IMPL_H
 #define INCLUDED_ETHERNET_FASTETHERNET_DESCRAMBLER_IMPL_H
 
+#include "block_stats.h"
+#include "descrambler_core.h"
 #include <gnuradio/ethernet/fastethernet_descrambler.h>
 #include <vector>
-#include <deque>
 
 namespace gr {
 namespace ethernet {
@@ -11,44 +12,83 @@ namespace ethernet {
 class fastethernet_descrambler_impl : public fastethernet_descrambler
 {
 private:
-    int d_search_window;
-    int d_idle_run;
-    int d_max_idle_no_idle;
-    int d_max_in_frame_no_idle;
+    const int d_max_idle_no_idle;
     bool d_print_debug;
     
-    bool d_synced;
-    std::vector<int> d_lfsr;
+    descrambler_core d_core;
+    std::atomic<bool> d_synced; // d_core.locked(), for the getters
+    uint64_t d_total_processed;
+    stat_counter d_resync_count;
+    stat_counter d_lock_holds;
+    stat_counter d_fast_relocks;
     
-    std::deque<int> d_search_buffer;
-    std::deque<int> d_idle_check_buffer;
-    std::deque<int> d_recent_bits;
-    
-    bool d_in_frame;
-    int d_bits_since_sfd;
-    int d_total_processed;
-    int d_debug_count;
-    int d_resync_count;
-    int d_check_interval;
+    pmt::pmt_t d_stats_port;
+    block_stats d_stats;
+    uint64_t d_unlocked_since;
+    stat_counter d_last_lock_bits;
+    stat_counter d_unlocked_bits;
+
+    // IDLE bit errors: descrambled bits packed MSB first, classified one
+    // word late so that a word's last bit sees the next word's first one
+    const int d_ber_window;
+    uint64_t d_word;
+    int d_word_bits;
+    uint64_t d_prev_word;
+    int d_prev_before; // bit before d_prev_word
+    bool d_have_prev;
+    bool d_idle;
+    // Sliding window: BER_BUCKETS buckets of d_ber_window / BER_BUCKETS bits
+    std::vector<uint64_t> d_bucket_bits;
+    std::vector<uint64_t> d_bucket_errors;
+    size_t d_bucket;
+    uint64_t d_window_bits;
+    uint64_t d_window_errors;
+    std::atomic<double> d_ber;
+    uint64_t d_second_end;    // first bit of the next second of line time
+    uint64_t d_second_errors;
+    stat_counter d_idle_bits;
+    stat_counter d_idle_bit_errors;
+    stat_counter d_line_seconds;
+    stat_counter d_errored_seconds;
+    pmt::pmt_t d_ber_key;
     
-    int descramble_bit(int bit_in);
-    void descramble_chunk(const std::vector<int>& bits, 
-                         const std::vector<int>& initial_state,
-                         std::vector<int>& out,
-                         std::vector<int>& final_state);
-    bool has_run_of_ones(const std::vector<int>& bits, int run_len);
-    bool detect_frame_start();
-    bool check_sync_health();
-    bool search_initial_state();
+    void lock();
+    bool report(descrambler_core::event ev);
+    void lose_lock();
+    void ber_word(uint64_t word);
+    void ber_count(uint64_t bits, uint64_t errors);
+    void ber_reset();
+    void ber_seconds();
 
 public:
     fastethernet_descrambler_impl(int search_window,
                                   int idle_run,
                                   int max_idle_no_idle,
                                   int max_in_frame_no_idle,
-                                  bool print_debug);
+                                  bool print_debug,
+                                  int stats_interval_ms,
+                                  int ber_window,
+                                  int idle_errors);
     ~fastethernet_descrambler_impl();
     
+    void set_stats_interval(int stats_interval_ms) override;
+    int stats_interval() const override;
+    bool locked() const override;
+    uint64_t resync_count() const override;
+    uint64_t last_lock_bits() const override;
+    uint64_t unlocked_bits() const override;
+    uint64_t fast_relocks() const override;
+    uint64_t lock_holds() const override;
+    uint64_t idle_bits() const override;
+    uint64_t idle_bit_errors() const override;
+    double ber() const override;
+    uint64_t line_seconds() const override;
+    uint64_t errored_seconds() const override;
+    uint64_t work_calls() const override;
+    uint64_t work_ticks() const override;
+    
+    void setup_rpc() override;
+    
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items) override;
@@ -3,187 +3,236 @@
 #endif
 
 #include "fastethernet_frame_decoder_impl.h"
+#include <gnuradio/ethernet/line_coding.h>
 #include <gnuradio/io_signature.h>
+#ifdef GR_CTRLPORT
+#include <gnuradio/rpcregisterhelpers.h>
+#endif
+#include <algorithm>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <memory>
+#include <string_view>
+#include <cstdio>
 
 namespace gr {
 namespace ethernet {
 
-fastethernet_frame_decoder::sptr fastethernet_frame_decoder::make()
+namespace {
+
+// Preamble and SFD bytes before the destination MAC
+const size_t PREAMBULE = 7;
+// Payload bytes shown in payload_preview
+const size_t PREVIEW_BYTES = 64;
+
+void format_mac(const uint8_t* mac, char* out)
+{
+    snprintf(out, 18, "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+void format_ipv4(const uint8_t* ip, char* out)
+{
+    snprintf(out, 16, "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+}
+
+} // namespace
+
+fastethernet_frame_decoder::sptr fastethernet_frame_decoder::make(int stats_interval_ms,
+                                                                  bool trace_latency,
+                                                                  const std::string& filter,
+                                                                  int batch_size,
+                                                                  int batch_bytes,
+                                                                  int batch_timeout_ms,
+                                                                  const std::string& len_tag_key)
 {
-    return gnuradio::make_block_sptr<fastethernet_frame_decoder_impl>();
+    return gnuradio::make_block_sptr<fastethernet_frame_decoder_impl>(
+        stats_interval_ms, trace_latency, filter, batch_size, batch_bytes, batch_timeout_ms, len_tag_key);
 }
 
-fastethernet_frame_decoder_impl::fastethernet_frame_decoder_impl()
-    : gr::sync_block("fastethernet_frame_decoder",
-                     gr::io_signature::make(1, 1, sizeof(uint8_t)),
-                     gr::io_signature::make(0, 0, 0)),
-      d_idle("11111111111111111111"),
-      d_marqueur_debut("111111100010001"),
-      d_marqueur_fin("011010011111111"),
-      d_dans_une_trame(false),
-      d_compteur_timeout(0),
-      d_MAX_BITS_SANS_FIN(30000),
-      d_compteur_trames(0),
-      d_compteur_erreurs(0)
+fastethernet_frame_decoder_impl::fastethernet_frame_decoder_impl(int stats_interval_ms,
+                                                                 bool trace_latency,
+                                                                 const std::string& filter,
+                                                                 int batch_size,
+                                                                 int batch_bytes,
+                                                                 int batch_timeout_ms,
+                                                                 const std::string& len_tag_key)
+    : gr::block("fastethernet_frame_decoder",
+                gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                gr::io_signature::make(0, 1, sizeof(uint8_t))),
+      d_debut_trame(0),
+      d_stats(stats_interval_ms),
+      d_trace(trace_latency),
+      d_filter(frame_filter::compile(filter)),
+      d_batch(batch_size, batch_bytes, batch_timeout_ms),
+      d_emit_dicts(true),
+      d_emit_records(false),
+      d_emit_stream(false),
+      d_decoded_connected(false),
+      d_stream(len_tag_key)
 {
     d_out_port = pmt::intern("decoded");
     message_port_register_out(d_out_port);
+    d_stats_port = pmt::intern("stats");
+    message_port_register_out(d_stats_port);
+    d_records_port = pmt::intern("records");
+    message_port_register_out(d_records_port);
+    d_filter_port = pmt::intern("filter");
+    message_port_register_in(d_filter_port);
+    set_msg_handler(d_filter_port, [this](const pmt::pmt_t& msg) { handle_filter(msg); });
     
-    d_table_5b4b["11110"] = "0000"; d_table_5b4b["01001"] = "0001";
-    d_table_5b4b["10100"] = "0010"; d_table_5b4b["10101"] = "0011";
-    d_table_5b4b["01010"] = "0100"; d_table_5b4b["01011"] = "0101";
-    d_table_5b4b["01110"] = "0110"; d_table_5b4b["01111"] = "0111";
-    d_table_5b4b["10010"] = "1000"; d_table_5b4b["10011"] = "1001";
-    d_table_5b4b["10110"] = "1010"; d_table_5b4b["10111"] = "1011";
-    d_table_5b4b["11010"] = "1100"; d_table_5b4b["11011"] = "1101";
-    d_table_5b4b["11100"] = "1110"; d_table_5b4b["11101"] = "1111";
-    d_table_5b4b["11000"] = "J";    d_table_5b4b["10001"] = "K";
-    d_table_5b4b["01101"] = "T";    d_table_5b4b["00111"] = "R";
-    
-    d_tampon = std::deque<char>(200);
+    // Byte output: at most one byte per 10 bits, offsets unrelated to the input's
+    set_relative_rate(1, 10);
+    set_tag_propagation_policy(TPP_DONT);
     
     std::cout << "[Frame Decoder] Initialise" << std::endl;
 }
 
 fastethernet_frame_decoder_impl::~fastethernet_frame_decoder_impl() {}
 
-bool fastethernet_frame_decoder_impl::nettoyer_idle()
+void fastethernet_frame_decoder_impl::set_stats_interval(int stats_interval_ms)
 {
-    std::string chaine(d_tampon.begin(), d_tampon.end());
-    size_t idx = chaine.find(d_idle);
-    if (idx != std::string::npos) {
-        std::string reste = chaine.substr(idx + d_idle.length());
-        d_tampon.clear();
-        std::string prefix = "1111111111";
-        for (char c : prefix) d_tampon.push_back(c);
-        for (char c : reste) d_tampon.push_back(c);
-        return true;
-    }
-    return false;
+    d_stats.set_interval(stats_interval_ms);
 }
 
-std::string fastethernet_frame_decoder_impl::decode_5b_4b(const std::string& bits_5b)
+void fastethernet_frame_decoder_impl::set_trace_latency(bool trace_latency)
 {
-    std::string result;
-    for (size_t i = 0; i + 5 <= bits_5b.length(); i += 5) {
-        std::string code = bits_5b.substr(i, 5);
-        auto it = d_table_5b4b.find(code);
-        if (it != d_table_5b4b.end()) {
-            std::string decoded = it->second;
-            if (decoded != "J" && decoded != "K" && decoded != "T" && decoded != "R") {
-                result += decoded;
-            }
-        }
-    }
-    return result.length() >= 8 ? result : "";
+    d_trace.set_enabled(trace_latency);
 }
 
-std::string fastethernet_frame_decoder_impl::echange_paquet(const std::string& bits)
+void fastethernet_frame_decoder_impl::set_filter(const std::string& filter)
 {
-    std::string result;
-    for (size_t i = 0; i + 8 <= bits.length(); i += 8) {
-        result += bits.substr(i + 4, 4) + bits.substr(i, 4);
-    }
-    return result;
+    std::atomic_store(&d_filter, frame_filter::compile(filter));
 }
 
-std::string fastethernet_frame_decoder_impl::binaire_vers_hexa(const std::string& bits)
+std::string fastethernet_frame_decoder_impl::filter() const
 {
-    std::ostringstream oss;
-    for (size_t i = 0; i + 8 <= bits.length(); i += 8) {
-        std::string octet = bits.substr(i, 8);
-        bool valid = true;
-        for (char c : octet) {
-            if (c != '0' && c != '1') {
-                valid = false;
-                break;
-            }
-        }
-        if (!valid) return "";
-        
-        int byte_val = std::stoi(octet, nullptr, 2);
-        oss << std::hex << std::setw(2) << std::setfill('0') << byte_val;
-    }
-    return oss.str();
+    frame_filter::sptr f = std::atomic_load(&d_filter);
+    return f ? f->expression() : "";
 }
 
-std::string fastethernet_frame_decoder_impl::tcp_flags_str(uint8_t flags)
+void fastethernet_frame_decoder_impl::handle_filter(const pmt::pmt_t& msg)
 {
-    std::vector<std::string> flag_names;
-    if (flags & 0x02) flag_names.push_back("SYN");
-    if (flags & 0x10) flag_names.push_back("ACK");
-    if (flags & 0x01) flag_names.push_back("FIN");
-    if (flags & 0x04) flag_names.push_back("RST");
-    if (flags & 0x08) flag_names.push_back("PSH");
-    if (flags & 0x20) flag_names.push_back("URG");
-    
-    std::string result;
-    for (size_t i = 0; i < flag_names.size(); i++) {
-        if (i > 0) result += " ";
-        result += flag_names[i];
+    pmt::pmt_t expr = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    if (!pmt::is_symbol(expr)) {
+        std::cout << "[Frame Decoder] filter: expected a symbol" << std::endl;
+        return;
+    }
+    try {
+        set_filter(pmt::symbol_to_string(expr));
+        std::cout << "[Frame Decoder] filter: '" << filter() << "'" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "[Frame Decoder] " << e.what() << ", filter unchanged" << std::endl;
     }
-    return result;
 }
 
-std::string fastethernet_frame_decoder_impl::payload_preview(
-    const std::string& hex_data, int offset, int max_bytes)
+int fastethernet_frame_decoder_impl::stats_interval() const { return d_stats.interval(); }
+bool fastethernet_frame_decoder_impl::trace_latency() const { return d_trace.enabled(); }
+uint64_t fastethernet_frame_decoder_impl::frames_decoded() const { return d_compteur_trames.get(); }
+uint64_t fastethernet_frame_decoder_impl::frames_timed_out() const { return d_compteur_timeouts.get(); }
+uint64_t fastethernet_frame_decoder_impl::decode_errors() const { return d_compteur_erreurs.get(); }
+uint64_t fastethernet_frame_decoder_impl::code_violations() const { return d_compteur_violations.get(); }
+uint64_t fastethernet_frame_decoder_impl::fcs_failures() const { return d_compteur_fcs.get(); }
+uint64_t fastethernet_frame_decoder_impl::frames_filtered() const { return d_compteur_filtres.get(); }
+uint64_t fastethernet_frame_decoder_impl::work_calls() const { return d_stats.work_calls(); }
+uint64_t fastethernet_frame_decoder_impl::work_ticks() const { return d_stats.work_ticks(); }
+
+void fastethernet_frame_decoder_impl::setup_rpc()
 {
-    try {
-        if (offset >= (int)hex_data.length()) return "";
-        
-        std::string payload_hex = hex_data.substr(offset);
-        if (payload_hex.length() < 2) return "";
-        
-        size_t preview_len = std::min((size_t)(max_bytes * 2), payload_hex.length());
-        std::string preview = payload_hex.substr(0, preview_len);
-        
-        std::ostringstream oss;
-        for (size_t i = 0; i < preview.length(); i += 2) {
-            if (i > 0) oss << " ";
-            oss << preview.substr(i, 2);
-        }
-        
-        int payload_len = payload_hex.length() / 2;
-        if (payload_len > max_bytes) {
-            oss << " ... (" << payload_len << " octets total)";
-        }
-        
-        return oss.str();
-    } catch (...) {
-        return "";
+#ifdef GR_CTRLPORT
+    typedef fastethernet_frame_decoder B;
+    const struct {
+        const char* name;
+        uint64_t (B::*getter)() const;
+        const char* desc;
+    } counters[] = {
+        { "frames_decoded", &B::frames_decoded, "Frames decoded" },
+        { "frames_timed_out", &B::frames_timed_out, "Frames dropped by timeout" },
+        { "decode_errors", &B::decode_errors, "Frames that could not be decoded" },
+        { "code_violations", &B::code_violations, "Invalid 5B code-groups" },
+        { "fcs_failures", &B::fcs_failures, "Frames with a bad FCS" },
+        { "frames_filtered", &B::frames_filtered, "Frames dropped by the filter" },
+        { "work_calls", &B::work_calls, "work() calls" },
+        { "work_ticks", &B::work_ticks, "Time spent in work()" },
+    };
+    for (const auto& c : counters) {
+        add_rpc_variable(rpcbasic_sptr(new rpcbasic_register_get<B, uint64_t>(
+            alias(), c.name, c.getter, pmt::from_uint64(0), pmt::from_uint64(UINT64_MAX),
+            pmt::from_uint64(0), "", c.desc, RPC_PRIVLVL_MIN, DISPTIME | DISPOPTSTRIP)));
     }
+#endif
 }
 
-void fastethernet_frame_decoder_impl::send_frame_message(const std::string& hex_trame, int numero)
+bool fastethernet_frame_decoder_impl::start()
 {
-    if (hex_trame.length() < 42) return;
-    
-    int frame_length = hex_trame.length() / 2;
-    
-    std::string dest_mac = hex_trame.substr(14, 12);
-    std::string src_mac = hex_trame.substr(26, 12);
-    std::string ethertype_hex = hex_trame.substr(38, 4);
-    std::string data = hex_trame.substr(42);
-    
-    std::string dest_mac_fmt, src_mac_fmt;
-    for (int i = 0; i < 12; i += 2) {
-        if (i > 0) dest_mac_fmt += ":";
-        dest_mac_fmt += dest_mac.substr(i, 2);
+    // Only build what is consumed: no dicts unless "decoded" is connected
+    // or nothing else is; the byte output is checked in general_work()
+    d_emit_records = !pmt::is_null(message_subscribers(d_records_port));
+    d_decoded_connected = !pmt::is_null(message_subscribers(d_out_port));
+    d_emit_dicts = d_decoded_connected || !d_emit_records;
+    return true;
+}
+
+bool fastethernet_frame_decoder_impl::stop()
+{
+    flush_batch();
+    return true;
+}
+
+// frame is PMT_NIL when only binary records are emitted.
+void fastethernet_frame_decoder_impl::publish(const pmt::pmt_t& frame, size_t bytes)
+{
+    if (!d_batch.enabled()) {
+        if (d_emit_dicts) message_port_pub(d_out_port, frame);
+        flush_records();
+        d_trace.published();
+    } else if (d_batch.add(frame, bytes, d_trace.take())) {
+        flush_batch();
     }
-    for (int i = 0; i < 12; i += 2) {
-        if (i > 0) src_mac_fmt += ":";
-        src_mac_fmt += src_mac.substr(i, 2);
+}
+
+void fastethernet_frame_decoder_impl::flush_batch()
+{
+    if (d_batch.empty()) return;
+    pmt::pmt_t frames = d_batch.take(d_batch_stamps);
+    if (d_emit_dicts) message_port_pub(d_out_port, frames);
+    flush_records();
+    for (const auto& s : d_batch_stamps) d_trace.published(s);
+}
+
+void fastethernet_frame_decoder_impl::flush_records()
+{
+    if (d_records.empty()) return;
+    const std::vector<uint8_t>& m = d_records.finish();
+    message_port_pub(d_records_port, pmt::init_u8vector(m.size(), m.data()));
+    d_records.clear();
+}
+
+// Hex bytes separated by spaces, PREVIEW_BYTES at most, then the length
+// when the payload is longer.
+std::string fastethernet_frame_decoder_impl::payload_preview(const uint8_t* payload, size_t len)
+{
+    char buf[3 * PREVIEW_BYTES + 32];
+    char* p = buf;
+    char* end = buf + sizeof(buf);
+    buf[0] = '\0';
+    for (size_t i = 0; i < std::min(len, PREVIEW_BYTES); i++) {
+        p += snprintf(p, end - p, i ? " %02x" : "%02x", payload[i]);
     }
+    if (len > PREVIEW_BYTES) snprintf(p, end - p, " ... (%zu octets total)", len);
+    return buf;
+}
+
+void fastethernet_frame_decoder_impl::send_frame_message(const frame_slot& trame)
+{
+    const uint8_t* octets = trame.data;
+    // Preamble and SFD included
+    int frame_length = trame.len + PREAMBULE;
     
-    int ethertype = 0;
-    try {
-        ethertype = std::stoi(ethertype_hex, nullptr, 16);
-    } catch (...) {}
+    char dest_mac[18], src_mac[18];
+    format_mac(octets, dest_mac);
+    format_mac(octets + 6, src_mac);
     
-    std::string ethertype_name;
+    int ethertype = (octets[12] << 8) | octets[13];
+    const char* ethertype_name;
     switch (ethertype) {
         case 0x0800: ethertype_name = "IPv4"; break;
         case 0x0806: ethertype_name = "ARP"; break;
@@ -193,11 +242,11 @@ void fastethernet_frame_decoder_impl::send_frame_message(const std::string& hex_
     }
     
     pmt::pmt_t d = pmt::make_dict();
-    d = pmt::dict_add(d, pmt::intern("frame_num"), pmt::from_long(numero));
+    d = pmt::dict_add(d, pmt::intern("frame_num"), pmt::from_long(trame.frame_num));
     d = pmt::dict_add(d, pmt::intern("length"), pmt::from_long(frame_length));
     d = pmt::dict_add(d, pmt::intern("frame_length"), pmt::from_long(frame_length));
-    d = pmt::dict_add(d, pmt::intern("mac_dst"), pmt::intern(dest_mac_fmt));
-    d = pmt::dict_add(d, pmt::intern("mac_src"), pmt::intern(src_mac_fmt));
+    d = pmt::dict_add(d, pmt::intern("mac_dst"), pmt::intern(dest_mac));
+    d = pmt::dict_add(d, pmt::intern("mac_src"), pmt::intern(src_mac));
     d = pmt::dict_add(d, pmt::intern("ethertype_outer"), pmt::from_long(ethertype));
     d = pmt::dict_add(d, pmt::intern("ethertype_outer_name"), pmt::intern(ethertype_name));
     d = pmt::dict_add(d, pmt::intern("ethertype"), pmt::from_long(ethertype));
@@ -209,75 +258,51 @@ void fastethernet_frame_decoder_impl::send_frame_message(const std::string& hex_
     d = pmt::dict_add(d, pmt::intern("vlan_dei"), pmt::from_long(0));
     
     int ip_version = 0;
-    std::string ip_src = "";
-    std::string ip_dst = "";
+    char ip_src[16] = "";
+    char ip_dst[16] = "";
     int ip_ttl = -1;
     int l4_proto = -1;
-    std::string l4_name = "";
+    char l4_name[16] = "";
     int src_port = -1;
     int dst_port = -1;
     std::string tcp_flags = "";
     int icmp_type = -1;
     int icmp_code = -1;
-    std::string info = "";
+    char info[96] = "";
     std::string payload_str = "";
     
-    if (ethertype == 0x0800 && data.length() >= 40) {
-        try {
-            ip_version = 4;
-            
-            std::string ttl_hex = data.substr(16, 2);
-            ip_ttl = std::stoi(ttl_hex, nullptr, 16);
-            
-            std::string proto_byte = data.substr(18, 2);
-            int proto_val = std::stoi(proto_byte, nullptr, 16);
-            std::string proto_name;
-            switch (proto_val) {
-                case 0x06: proto_name = "TCP"; break;
-                case 0x11: proto_name = "UDP"; break;
-                case 0x01: proto_name = "ICMP"; break;
-                default: proto_name = "Proto " + std::to_string(proto_val);
-            }
-            l4_proto = proto_val;
-            l4_name = proto_name;
-            
-            std::ostringstream oss_src, oss_dst;
-            for (int i = 24; i < 32; i += 2) {
-                if (i > 24) oss_src << ".";
-                oss_src << std::stoi(data.substr(i, 2), nullptr, 16);
-            }
-            for (int i = 32; i < 40; i += 2) {
-                if (i > 32) oss_dst << ".";
-                oss_dst << std::stoi(data.substr(i, 2), nullptr, 16);
-            }
-            ip_src = oss_src.str();
-            ip_dst = oss_dst.str();
-            
-            if ((proto_name == "TCP" || proto_name == "UDP") && data.length() >= 48) {
-                src_port = std::stoi(data.substr(40, 4), nullptr, 16);
-                dst_port = std::stoi(data.substr(44, 4), nullptr, 16);
-                
-                if (proto_name == "TCP" && data.length() >= 66) {
-                    std::string flags_hex = data.substr(66, 2);
-                    int flags_val = std::stoi(flags_hex, nullptr, 16);
-                    tcp_flags = tcp_flags_str(flags_val);
-                }
-                
-                info = ip_src + ":" + std::to_string(src_port) + " -> " + 
-                       ip_dst + ":" + std::to_string(dst_port) + " (" + proto_name + ")";
-                
-                int payload_offset = 40 + 40;
-                payload_str = payload_preview(data, payload_offset, 64);
-                
-            } else if (proto_name == "ICMP" && data.length() >= 42) {
-                icmp_type = std::stoi(data.substr(40, 2), nullptr, 16);
-                icmp_code = data.length() >= 44 ? std::stoi(data.substr(42, 2), nullptr, 16) : 0;
-                info = "ICMP type " + std::to_string(icmp_type) + ", code " + 
-                       std::to_string(icmp_code) + " " + ip_src + " -> " + ip_dst;
-            } else {
-                info = proto_name + " " + ip_src + " -> " + ip_dst;
-            }
-        } catch (...) {}
+    // IPv4 header without options, then the TCP or UDP ports and TCP flags
+    const uint8_t* ip = octets + 14;
+    size_t ip_len = trame.len - 14;
+    if (ethertype == 0x0800 && ip_len >= 20) {
+        ip_version = 4;
+        ip_ttl = ip[8];
+        l4_proto = ip[9];
+        switch (l4_proto) {
+            case 0x06: snprintf(l4_name, sizeof(l4_name), "TCP"); break;
+            case 0x11: snprintf(l4_name, sizeof(l4_name), "UDP"); break;
+            case 0x01: snprintf(l4_name, sizeof(l4_name), "ICMP"); break;
+            default: snprintf(l4_name, sizeof(l4_name), "Proto %d", l4_proto);
+        }
+        format_ipv4(ip + 12, ip_src);
+        format_ipv4(ip + 16, ip_dst);
+        
+        if ((l4_proto == 0x06 || l4_proto == 0x11) && ip_len >= 24) {
+            src_port = (ip[20] << 8) | ip[21];
+            dst_port = (ip[22] << 8) | ip[23];
+            if (l4_proto == 0x06 && ip_len >= 34) tcp_flags = tcp_flags_string(ip[33]);
+            snprintf(info, sizeof(info), "%s:%d -> %s:%d (%s)",
+                     ip_src, src_port, ip_dst, dst_port, l4_name);
+            // After a 20-byte TCP header
+            if (ip_len > 40) payload_str = payload_preview(ip + 40, ip_len - 40);
+        } else if (l4_proto == 0x01 && ip_len >= 21) {
+            icmp_type = ip[20];
+            icmp_code = ip_len >= 22 ? ip[21] : 0;
+            snprintf(info, sizeof(info), "ICMP type %d, code %d %s -> %s",
+                     icmp_type, icmp_code, ip_src, ip_dst);
+        } else {
+            snprintf(info, sizeof(info), "%s %s -> %s", l4_name, ip_src, ip_dst);
+        }
     }
     
     d = pmt::dict_add(d, pmt::intern("ip_version"), pmt::from_long(ip_version));
@@ -294,110 +319,110 @@ void fastethernet_frame_decoder_impl::send_frame_message(const std::string& hex_
     d = pmt::dict_add(d, pmt::intern("payload_preview"), pmt::intern(payload_str));
     d = pmt::dict_add(d, pmt::intern("info"), pmt::intern(info));
     
-    message_port_pub(d_out_port, d);
+    // Raw frame (destination MAC to FCS) and where it starts in the input
+    d = pmt::dict_add(d, pmt::intern("sample_offset"), pmt::from_uint64(trame.sample_offset));
+    d = pmt::dict_add(d, pmt::intern("frame"), pmt::init_u8vector(trame.len, trame.data));
+    d = pmt::dict_add(d, pmt::intern("fcs_ok"), pmt::from_bool(trame.fcs_ok));
+    d = d_trace.dissected(d);
+    
+    publish(d, trame.len);
 }
 
-void fastethernet_frame_decoder_impl::afficher_trame(const std::string& hex_trame, int numero)
+void fastethernet_frame_decoder_impl::afficher_trame(const frame_slot& trame)
 {
-    if (hex_trame.length() < 42) return;
+    const uint8_t* octets = trame.data;
+    char dest_mac[18], src_mac[18], ethertype[5];
+    format_mac(octets, dest_mac);
+    format_mac(octets + 6, src_mac);
+    snprintf(ethertype, sizeof(ethertype), "%02x%02x", octets[12], octets[13]);
     
-    std::string dest_mac = hex_trame.substr(14, 12);
-    std::string src_mac = hex_trame.substr(26, 12);
-    std::string ethertype = hex_trame.substr(38, 4);
-    std::string data = hex_trame.substr(42);
-    
-    std::string dest_mac_fmt, src_mac_fmt;
-    for (int i = 0; i < 12; i += 2) {
-        if (i > 0) dest_mac_fmt += ":";
-        dest_mac_fmt += dest_mac.substr(i, 2);
-    }
-    for (int i = 0; i < 12; i += 2) {
-        if (i > 0) src_mac_fmt += ":";
-        src_mac_fmt += src_mac.substr(i, 2);
+    int type = (octets[12] << 8) | octets[13];
+    const char* ethertype_name;
+    switch (type) {
+        case 0x0800: ethertype_name = "IPv4"; break;
+        case 0x0806: ethertype_name = "ARP"; break;
+        case 0x86DD: ethertype_name = "IPv6"; break;
+        case 0x8100: ethertype_name = "VLAN"; break;
+        default: ethertype_name = "Unknown";
     }
     
-    std::string ethertype_name;
-    if (ethertype == "0800") ethertype_name = "IPv4";
-    else if (ethertype == "0806") ethertype_name = "ARP";
-    else if (ethertype == "86dd") ethertype_name = "IPv6";
-    else if (ethertype == "8100") ethertype_name = "VLAN";
-    else ethertype_name = "Unknown";
-    
     std::cout << "\n======================================================================" << std::endl;
-    std::cout << "Trame #" << numero << " - " << (hex_trame.length() / 2) << " octets" << std::endl;
+    std::cout << "Trame #" << trame.frame_num << " - " << (trame.len + PREAMBULE) << " octets" << std::endl;
     std::cout << "======================================================================" << std::endl;
-    std::cout << "DEST MAC:   " << dest_mac_fmt << std::endl;
-    std::cout << "SRC MAC:    " << src_mac_fmt << std::endl;
+    std::cout << "DEST MAC:   " << dest_mac << std::endl;
+    std::cout << "SRC MAC:    " << src_mac << std::endl;
     std::cout << "EtherType:  " << ethertype << " (" << ethertype_name << ")" << std::endl;
     
-    if (ethertype == "0800" && data.length() >= 40) {
-        try {
-            int ttl = std::stoi(data.substr(16, 2), nullptr, 16);
-            std::string proto_byte = data.substr(18, 2);
-            std::string proto_name;
-            if (proto_byte == "06") proto_name = "TCP";
-            else if (proto_byte == "11") proto_name = "UDP";
-            else if (proto_byte == "01") proto_name = "ICMP";
-            else proto_name = proto_byte;
-            
-            std::ostringstream oss_src, oss_dst;
-            for (int i = 24; i < 32; i += 2) {
-                if (i > 24) oss_src << ".";
-                oss_src << std::stoi(data.substr(i, 2), nullptr, 16);
-            }
-            for (int i = 32; i < 40; i += 2) {
-                if (i > 32) oss_dst << ".";
-                oss_dst << std::stoi(data.substr(i, 2), nullptr, 16);
-            }
-            
-            std::cout << "Protocol:   " << proto_name << std::endl;
-            std::cout << "IP Source:  " << oss_src.str() << std::endl;
-            std::cout << "IP Dest:    " << oss_dst.str() << std::endl;
-            std::cout << "TTL:        " << ttl << std::endl;
+    // IPv4 header without options, then the TCP or UDP ports and TCP flags
+    const uint8_t* ip = octets + 14;
+    size_t ip_len = trame.len - 14;
+    if (type == 0x0800 && ip_len >= 20) {
+        char proto_byte[3], ip_src[16], ip_dst[16];
+        snprintf(proto_byte, sizeof(proto_byte), "%02x", ip[9]);
+        const char* proto_name;
+        switch (ip[9]) {
+            case 0x06: proto_name = "TCP"; break;
+            case 0x11: proto_name = "UDP"; break;
+            case 0x01: proto_name = "ICMP"; break;
+            default: proto_name = proto_byte;
+        }
+        format_ipv4(ip + 12, ip_src);
+        format_ipv4(ip + 16, ip_dst);
+        
+        std::cout << "Protocol:   " << proto_name << std::endl;
+        std::cout << "IP Source:  " << ip_src << std::endl;
+        std::cout << "IP Dest:    " << ip_dst << std::endl;
+        std::cout << "TTL:        " << (int)ip[8] << std::endl;
+        
+        if ((ip[9] == 0x06 || ip[9] == 0x11) && ip_len >= 24) {
+            int sport = (ip[20] << 8) | ip[21];
+            int dport = (ip[22] << 8) | ip[23];
+            std::cout << "Ports:      " << sport << " -> " << dport << std::endl;
             
-            if ((proto_name == "TCP" || proto_name == "UDP") && data.length() >= 48) {
-                int sport = std::stoi(data.substr(40, 4), nullptr, 16);
-                int dport = std::stoi(data.substr(44, 4), nullptr, 16);
-                std::cout << "Ports:      " << sport << " -> " << dport << std::endl;
-                
-                if (proto_name == "TCP" && data.length() >= 66) {
-                    int flags = std::stoi(data.substr(66, 2), nullptr, 16);
-                    std::string flags_str = tcp_flags_str(flags);
-                    if (!flags_str.empty()) {
-                        std::cout << "TCP Flags:  " << flags_str << std::endl;
-                    }
+            if (ip[9] == 0x06 && ip_len >= 34) {
+                std::string flags_str = tcp_flags_string(ip[33]);
+                if (!flags_str.empty()) {
+                    std::cout << "TCP Flags:  " << flags_str << std::endl;
                 }
             }
-        } catch (...) {}
+        }
     }
     
     std::cout << "======================================================================" << std::endl;
 }
 
-bool fastethernet_frame_decoder_impl::traiter_trame(const std::string& trame_bits)
+bool fastethernet_frame_decoder_impl::traiter_trame(std::string_view trame_5b)
 {
     try {
-        size_t idx_debut = trame_bits.find(d_marqueur_debut);
-        size_t idx_fin = trame_bits.find(d_marqueur_fin, idx_debut);
+        frame_arena::handle trame = d_arena.acquire();
+        uint64_t violations = 0;
+        trame->len = decode_code_groups(trame_5b, trame->data, FRAME_SLOT_BYTES, violations);
+        if (violations) d_compteur_violations.add(violations);
+        if (!trame->len) return false;
         
-        if (idx_debut == std::string::npos || idx_fin == std::string::npos) return false;
-        
-        std::string trame_5b = trame_bits.substr(idx_debut + d_marqueur_debut.length(), 
-                                                  idx_fin - idx_debut - d_marqueur_debut.length());
-        if (trame_5b.length() < 5) return false;
-        
-        std::string trame_4b = decode_5b_4b(trame_5b);
-        if (trame_4b.empty()) return false;
-        
-        std::string trame_echangee = echange_paquet(trame_4b);
-        std::string hex_trame = binaire_vers_hexa(trame_echangee);
-        
-        if (hex_trame.empty() || hex_trame.length() < 42) return false;
+        frame_filter::sptr filtre = std::atomic_load(&d_filter);
+        if (filtre && !filtre->match(trame->data, trame->len)) {
+            d_compteur_filtres.add();
+            return true;
+        }
+        trame->fcs_ok = check_fcs(trame->data, trame->len);
+        if (!trame->fcs_ok) d_compteur_fcs.add();
         
-        d_compteur_trames++;
+        d_compteur_trames.add();
+        trame->frame_num = d_compteur_trames.get();
+        trame->sample_offset = d_debut_trame;
         
-        afficher_trame(hex_trame, d_compteur_trames);
-        send_frame_message(hex_trame, d_compteur_trames);
+        afficher_trame(*trame);
+        if (d_emit_records) {
+            d_records.add(trame->data, trame->len, trame->frame_num, trame->sample_offset, trame->fcs_ok);
+        }
+        if (d_emit_stream) d_stream.add(trame->data, trame->len, trame->sample_offset, trame->fcs_ok);
+        if (d_emit_dicts) {
+            send_frame_message(*trame);
+        } else {
+            d_trace.dissected();
+            publish(pmt::PMT_NIL, trame->len);
+        }
         
         return true;
         
@@ -406,63 +431,78 @@ bool fastethernet_frame_decoder_impl::traiter_trame(const std::string& trame_bit
     }
 }
 
-int fastethernet_frame_decoder_impl::work(int noutput_items,
-                                           gr_vector_const_void_star& input_items,
-                                           gr_vector_void_star& output_items)
+void fastethernet_frame_decoder_impl::frame_start(uint64_t offset)
+{
+    d_debut_trame = offset;
+    d_trace.sfd(offset);
+}
+
+void fastethernet_frame_decoder_impl::frame_end(std::string_view trame_5b, uint64_t offset)
+{
+    d_trace.eof(offset, d_stats.work_start());
+    if (trame_5b.empty() || !traiter_trame(trame_5b)) {
+        d_compteur_erreurs.add();
+    }
+}
+
+void fastethernet_frame_decoder_impl::frame_timeout() { d_compteur_timeouts.add(); }
+
+// Writes queued frame bytes after the produced ones; returns the new total.
+int fastethernet_frame_decoder_impl::write_stream(uint8_t* out, int produced, int noutput_items)
+{
+    return produced + d_stream.write(out + produced,
+                                     noutput_items - produced,
+                                     nitems_written(0) + produced,
+                                     [this](uint64_t offset, const pmt::pmt_t& key, const pmt::pmt_t& value) {
+                                         add_item_tag(0, offset, key, value);
+                                     });
+}
+
+void fastethernet_frame_decoder_impl::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    // Queued frame bytes are written without new input
+    ninput_items_required[0] = d_stream.empty() ? 1 : 0;
+}
+
+int fastethernet_frame_decoder_impl::general_work(int noutput_items,
+                                                   gr_vector_int& ninput_items,
+                                                   gr_vector_const_void_star& input_items,
+                                                   gr_vector_void_star& output_items)
 {
     const uint8_t* bits_descrambles = (const uint8_t*)input_items[0];
+    const int ninput = ninput_items[0];
+    uint8_t* out = output_items.empty() ? nullptr : (uint8_t*)output_items[0];
+    d_emit_stream = out != nullptr;
+    d_emit_dicts = d_decoded_connected || (!d_emit_records && !d_emit_stream);
     
-    for (int i = 0; i < noutput_items; i++) {
-        char bit_str = (bits_descrambles[i] & 1) ? '1' : '0';
-        
-        if (d_tampon.size() >= 200) d_tampon.pop_front();
-        d_tampon.push_back(bit_str);
-        
-        nettoyer_idle();
-        std::string chaine_courante(d_tampon.begin(), d_tampon.end());
-        
-        if (!d_dans_une_trame) {
-            std::string pattern_debut = d_marqueur_debut + "01011010110101101011";
-            
-            if (chaine_courante.find(pattern_debut) != std::string::npos) {
-                d_dans_une_trame = true;
-                d_compteur_timeout = 0;
-                size_t pos = chaine_courante.find(d_marqueur_debut);
-                d_trame_courante = chaine_courante.substr(pos);
-                d_tampon.clear();
-                for (char c : d_trame_courante) d_tampon.push_back(c);
-            }
-            
-        } else {
-            d_trame_courante += bit_str;
-            d_compteur_timeout++;
-            
-            if (d_trame_courante.find(d_marqueur_fin) != std::string::npos) {
-                size_t pos = d_trame_courante.find(d_marqueur_fin);
-                std::string contenu = d_trame_courante.substr(0, pos);
-                std::string trame_complete = contenu + d_marqueur_fin;
-                std::string reste = d_trame_courante.substr(pos + d_marqueur_fin.length());
-                
-                if (!traiter_trame(trame_complete)) {
-                    d_compteur_erreurs++;
-                }
-                
-                d_tampon.clear();
-                for (char c : reste) d_tampon.push_back(c);
-                d_trame_courante.clear();
-                d_dans_une_trame = false;
-                d_compteur_timeout = 0;
-                
-            } else if (d_compteur_timeout >= d_MAX_BITS_SANS_FIN) {
-                d_tampon.clear();
-                d_trame_courante.clear();
-                d_dans_une_trame = false;
-                d_compteur_timeout = 0;
-            }
-        }
+    // Frames of the previous calls go first; the input waits until they fit
+    int produced = 0;
+    if (d_emit_stream) {
+        produced = write_stream(out, 0, noutput_items);
+        if (!d_stream.empty()) return produced;
+    }
+    
+    d_stats.work_begin();
+    
+    d_framer.process(bits_descrambles, ninput, *this);
+    
+    if (d_batch.expired()) flush_batch();
+    
+    if (d_stats.work_end()) {
+        pmt::pmt_t st = d_stats.make_dict(alias());
+        st = pmt::dict_add(st, pmt::intern("frames_decoded"), pmt::from_uint64(frames_decoded()));
+        st = pmt::dict_add(st, pmt::intern("frames_timed_out"), pmt::from_uint64(frames_timed_out()));
+        st = pmt::dict_add(st, pmt::intern("decode_errors"), pmt::from_uint64(decode_errors()));
+        st = pmt::dict_add(st, pmt::intern("code_violations"), pmt::from_uint64(code_violations()));
+        st = pmt::dict_add(st, pmt::intern("fcs_failures"), pmt::from_uint64(fcs_failures()));
+        st = pmt::dict_add(st, pmt::intern("frames_filtered"), pmt::from_uint64(frames_filtered()));
+        st = d_trace.add_to_stats(st);
+        message_port_pub(d_stats_port, st);
     }
     
-    return noutput_items;
+    consume_each(ninput);
+    if (d_emit_stream) produced = write_stream(out, produced, noutput_items);
+    return produced;
 }
 
 } // namespace ethernet
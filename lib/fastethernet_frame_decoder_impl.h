@@ -1,11 +1,19 @@
 #ifndef INCLUDED_ETHERNET_FASTETHERNET_FRAME_DECODER_IMPL_H
 #define INCLUDED_ETHERNET_FASTETHERNET_FRAME_DECODER_IMPL_H
 
+#include "block_stats.h"
+#include "frame_arena.h"
+#include "frame_batcher.h"
+#include "frame_stream.h"
+#include "framer_4b5b.h"
+#include "latency_trace.h"
 #include <gnuradio/ethernet/fastethernet_frame_decoder.h>
+#include <gnuradio/ethernet/frame_filter.h>
+#include <gnuradio/ethernet/frame_record.h>
 #include <pmt/pmt.h>
-#include <deque>
 #include <string>
-#include <map>
+#include <string_view>
+#include <vector>
 
 namespace gr {
 namespace ethernet {
@@ -14,38 +22,81 @@ class fastethernet_frame_decoder_impl : public fastethernet_frame_decoder
 {
 private:
     pmt::pmt_t d_out_port;
+    pmt::pmt_t d_stats_port;
+    pmt::pmt_t d_filter_port;
+    pmt::pmt_t d_records_port;
     
-    std::string d_idle;
-    std::string d_marqueur_debut;
-    std::string d_marqueur_fin;
-    std::map<std::string, std::string> d_table_5b4b;
+    framer_4b5b d_framer;
+    uint64_t d_debut_trame; // input offset of the /J/ of the current frame
     
-    std::deque<char> d_tampon;
-    std::string d_trame_courante;
-    bool d_dans_une_trame;
-    int d_compteur_timeout;
-    int d_MAX_BITS_SANS_FIN;
+    stat_counter d_compteur_trames;
+    stat_counter d_compteur_erreurs;
+    stat_counter d_compteur_timeouts;
+    stat_counter d_compteur_violations;
+    stat_counter d_compteur_fcs;
+    stat_counter d_compteur_filtres;
+    block_stats d_stats;
+    frame_trace d_trace;
+    frame_filter::sptr d_filter; // nullptr: no filter; std::atomic_load/store only
+    frame_batcher d_batch;
+    frame_record_writer d_records;
+    std::vector<frame_trace::stamps> d_batch_stamps;
+    frame_arena d_arena;
+    bool d_emit_dicts;         // "decoded" is connected, or nothing else is
+    bool d_emit_records;       // "records" is connected
+    bool d_emit_stream;        // the byte output is connected
+    bool d_decoded_connected;
+    frame_stream d_stream;
     
-    int d_compteur_trames;
-    int d_compteur_erreurs;
-    
-    bool nettoyer_idle();
-    std::string decode_5b_4b(const std::string& bits_5b);
-    std::string echange_paquet(const std::string& bits);
-    std::string binaire_vers_hexa(const std::string& bits);
-    std::string tcp_flags_str(uint8_t flags);
-    std::string payload_preview(const std::string& hex_data, int offset, int max_bytes);
-    void send_frame_message(const std::string& hex_trame, int numero);
-    void afficher_trame(const std::string& hex_trame, int numero);
-    bool traiter_trame(const std::string& trame_bits);
+    std::string payload_preview(const uint8_t* payload, size_t len);
+    void send_frame_message(const frame_slot& trame);
+    void afficher_trame(const frame_slot& trame);
+    bool traiter_trame(std::string_view trame_5b);
+    // framer_4b5b handler
+    void frame_start(uint64_t offset);
+    void frame_end(std::string_view trame_5b, uint64_t offset);
+    void frame_timeout();
+    friend class framer_4b5b;
+    void handle_filter(const pmt::pmt_t& msg);
+    void publish(const pmt::pmt_t& frame, size_t bytes);
+    void flush_batch();
+    void flush_records();
+    int write_stream(uint8_t* out, int produced, int noutput_items);
 
 public:
-    fastethernet_frame_decoder_impl();
+    fastethernet_frame_decoder_impl(int stats_interval_ms,
+                                    bool trace_latency,
+                                    const std::string& filter,
+                                    int batch_size,
+                                    int batch_bytes,
+                                    int batch_timeout_ms,
+                                    const std::string& len_tag_key);
     ~fastethernet_frame_decoder_impl();
     
-    int work(int noutput_items,
-             gr_vector_const_void_star& input_items,
-             gr_vector_void_star& output_items) override;
+    void set_stats_interval(int stats_interval_ms) override;
+    int stats_interval() const override;
+    void set_trace_latency(bool trace_latency) override;
+    bool trace_latency() const override;
+    void set_filter(const std::string& filter) override;
+    std::string filter() const override;
+    uint64_t frames_decoded() const override;
+    uint64_t frames_timed_out() const override;
+    uint64_t decode_errors() const override;
+    uint64_t code_violations() const override;
+    uint64_t fcs_failures() const override;
+    uint64_t frames_filtered() const override;
+    uint64_t work_calls() const override;
+    uint64_t work_ticks() const override;
+    
+    void setup_rpc() override;
+    bool start() override;
+    bool stop() override;
+    
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
 };
 
 } // namespace ethernet
@@ -0,0 +1,47 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "fastethernet_scrambler_impl.h"
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+fastethernet_scrambler::sptr fastethernet_scrambler::make(int seed)
+{
+    return gnuradio::make_block_sptr<fastethernet_scrambler_impl>(seed);
+}
+
+fastethernet_scrambler_impl::fastethernet_scrambler_impl(int seed)
+    : gr::sync_block("fastethernet_scrambler",
+                     gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                     gr::io_signature::make(1, 1, sizeof(uint8_t))),
+      d_lfsr(seed)
+{
+    if ((seed & 0x7FF) == 0) {
+        throw std::invalid_argument("fastethernet_scrambler: seed must be a non-zero 11-bit value");
+    }
+}
+
+fastethernet_scrambler_impl::~fastethernet_scrambler_impl() {}
+
+int fastethernet_scrambler_impl::work(int noutput_items,
+                                      gr_vector_const_void_star& input_items,
+                                      gr_vector_void_star& output_items)
+{
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    uint8_t* out = (uint8_t*)output_items[0];
+
+    scrambler_lfsr lfsr = d_lfsr;
+    for (int i = 0; i < noutput_items; i++) {
+        out[i] = (in[i] & 1) ^ lfsr.next();
+    }
+    d_lfsr = lfsr;
+
+    return noutput_items;
+}
+
+} // namespace ethernet
+} // namespace gr
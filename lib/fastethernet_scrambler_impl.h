@@ -0,0 +1,27 @@
+#ifndef INCLUDED_ETHERNET_FASTETHERNET_SCRAMBLER_IMPL_H
+#define INCLUDED_ETHERNET_FASTETHERNET_SCRAMBLER_IMPL_H
+
+#include <gnuradio/ethernet/fastethernet_scrambler.h>
+#include <gnuradio/ethernet/line_coding.h>
+
+namespace gr {
+namespace ethernet {
+
+class fastethernet_scrambler_impl : public fastethernet_scrambler
+{
+private:
+    scrambler_lfsr d_lfsr;
+
+public:
+    fastethernet_scrambler_impl(int seed);
+    ~fastethernet_scrambler_impl();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
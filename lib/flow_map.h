@@ -0,0 +1,177 @@
+#ifndef INCLUDED_ETHERNET_FLOW_MAP_H
+#define INCLUDED_ETHERNET_FLOW_MAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+// Unidirectional flow key. IP flows: addresses, protocol and ports (0
+// without a TCP/UDP header); other frames: MACs in src/dst and the
+// EtherType. Zero-initialised so that keys compare and hash as bytes.
+struct flow_key {
+    uint8_t src[16];
+    uint8_t dst[16];
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint16_t vlan; // 0xFFFF when untagged
+    uint16_t ethertype;
+    uint8_t ip_proto;
+    uint8_t ip_version; // 4, 6, or 0 for a MAC flow
+    uint8_t pad[6];
+
+    flow_key() { memset(this, 0, sizeof(*this)); }
+    bool operator==(const flow_key& o) const { return memcmp(this, &o, sizeof(*this)) == 0; }
+};
+
+struct flow_entry {
+    flow_key key;
+    uint64_t hash;
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t first_sample;
+    uint64_t last_sample;
+    uint64_t first_ns;
+    uint64_t last_ns;
+    uint8_t tcp_flags; // OR of the flags seen
+    uint32_t slot;     // position in the hash table
+    uint32_t prev;     // LRU list, towards the most recently seen
+    uint32_t next;
+};
+
+/*
+ * Fixed-capacity flow table: linear probing over a power-of-two slot
+ * array at most half full, with backward-shift deletion (no tombstones,
+ * probe sequences stay short under churn). Entries live in a pool
+ * allocated once; an intrusive list orders them by last use, so both the
+ * LRU victim and the idle flows are found from the tail without a scan.
+ */
+class flow_map
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    explicit flow_map(size_t capacity)
+        : d_entries(capacity > 0 ? capacity : 1), d_head(NONE), d_tail(NONE), d_size(0)
+    {
+        size_t slots = 2;
+        while (slots < 2 * d_entries.size()) slots <<= 1;
+        d_slots.assign(slots, NONE);
+        d_mask = slots - 1;
+        d_free.reserve(d_entries.size());
+        for (size_t i = d_entries.size(); i > 0; i--) d_free.push_back(i - 1);
+    }
+
+    size_t size() const { return d_size; }
+    size_t capacity() const { return d_entries.size(); }
+    bool full() const { return d_free.empty(); }
+
+    static uint64_t hash(const flow_key& k)
+    {
+        uint64_t w[sizeof(flow_key) / 8];
+        memcpy(w, &k, sizeof(k));
+        uint64_t h = 0x243F6A8885A308D3ULL;
+        for (uint64_t x : w) {
+            h ^= x;
+            h *= 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 29;
+        }
+        return h;
+    }
+
+    flow_entry* find(const flow_key& k, uint64_t h)
+    {
+        for (size_t i = h & d_mask;; i = (i + 1) & d_mask) {
+            uint32_t e = d_slots[i];
+            if (e == NONE) return nullptr;
+            if (d_entries[e].hash == h && d_entries[e].key == k) return &d_entries[e];
+        }
+    }
+
+    // New zeroed entry at the head of the LRU list; the table must not be full.
+    flow_entry* insert(const flow_key& k, uint64_t h)
+    {
+        uint32_t e = d_free.back();
+        d_free.pop_back();
+        size_t i = h & d_mask;
+        while (d_slots[i] != NONE) i = (i + 1) & d_mask;
+        d_slots[i] = e;
+
+        flow_entry& f = d_entries[e];
+        f = flow_entry();
+        f.key = k;
+        f.hash = h;
+        f.slot = i;
+        f.prev = f.next = NONE;
+        link_head(e);
+        d_size++;
+        return &f;
+    }
+
+    // Marks the entry as the most recently seen.
+    void touch(flow_entry* f)
+    {
+        uint32_t e = f - d_entries.data();
+        if (d_head == e) return;
+        unlink(e);
+        link_head(e);
+    }
+
+    // Least recently seen entry, null when empty.
+    flow_entry* oldest() { return d_tail == NONE ? nullptr : &d_entries[d_tail]; }
+
+    // Towards the most recently seen, null at the head.
+    flow_entry* newer(flow_entry* f) { return f->prev == NONE ? nullptr : &d_entries[f->prev]; }
+
+    void erase(flow_entry* f)
+    {
+        uint32_t e = f - d_entries.data();
+        unlink(e);
+        size_t i = f->slot;
+        for (size_t j = (i + 1) & d_mask; d_slots[j] != NONE; j = (j + 1) & d_mask) {
+            size_t home = d_entries[d_slots[j]].hash & d_mask;
+            // Move j back into the hole unless its home lies cyclically in (i, j]
+            bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+            if (stays) continue;
+            d_slots[i] = d_slots[j];
+            d_entries[d_slots[i]].slot = i;
+            i = j;
+        }
+        d_slots[i] = NONE;
+        d_free.push_back(e);
+        d_size--;
+    }
+
+private:
+    std::vector<flow_entry> d_entries;
+    std::vector<uint32_t> d_slots;
+    std::vector<uint32_t> d_free;
+    size_t d_mask;
+    uint32_t d_head; // most recently seen
+    uint32_t d_tail;
+    size_t d_size;
+
+    void link_head(uint32_t e)
+    {
+        d_entries[e].prev = NONE;
+        d_entries[e].next = d_head;
+        if (d_head != NONE) d_entries[d_head].prev = e;
+        d_head = e;
+        if (d_tail == NONE) d_tail = e;
+    }
+
+    void unlink(uint32_t e)
+    {
+        flow_entry& f = d_entries[e];
+        if (f.prev != NONE) d_entries[f.prev].next = f.next; else d_head = f.next;
+        if (f.next != NONE) d_entries[f.next].prev = f.prev; else d_tail = f.prev;
+        f.prev = f.next = NONE;
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,238 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "flow_table_impl.h"
+#include "frame_input.h"
+#include <gnuradio/io_signature.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+// Period of the idle and interval checks
+const auto SWEEP_PERIOD = std::chrono::milliseconds(100);
+
+} // namespace
+
+flow_table::sptr flow_table::make(int max_flows, double idle_timeout_s, double report_interval_s)
+{
+    return gnuradio::make_block_sptr<flow_table_impl>(max_flows, idle_timeout_s, report_interval_s);
+}
+
+flow_table_impl::flow_table_impl(int max_flows, double idle_timeout_s, double report_interval_s)
+    : gr::block("flow_table", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+      d_idle_ns(idle_timeout_s > 0 ? (uint64_t)(idle_timeout_s * 1e9) : 0),
+      d_interval_ns(report_interval_s > 0 ? (uint64_t)(report_interval_s * 1e9) : 0),
+      d_next_report(0),
+      d_flows(max_flows > 0 ? max_flows : 1),
+      d_running(false)
+{
+    d_in_port = pmt::intern("frames");
+    d_out_port = pmt::intern("flows");
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](const pmt::pmt_t& msg) { handle_frames(msg); });
+
+    std::cout << "[Flow Table] " << d_flows.capacity() << " flows, idle timeout "
+              << idle_timeout_s << " s";
+    if (d_interval_ns) std::cout << ", reports every " << report_interval_s << " s";
+    std::cout << std::endl;
+}
+
+flow_table_impl::~flow_table_impl() { stop(); }
+
+uint64_t flow_table_impl::active_flows() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_flows.size();
+}
+
+uint64_t flow_table_impl::flows_expired() const { return d_expired.get(); }
+uint64_t flow_table_impl::flows_evicted() const { return d_evicted.get(); }
+uint64_t flow_table_impl::frames_received() const { return d_received.get(); }
+
+bool flow_table_impl::start()
+{
+    d_next_report = d_interval_ns ? frame_record_time_ns() + d_interval_ns : 0;
+    d_running = true;
+    d_sweeper = std::thread([this] {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        while (d_running) {
+            d_wake.wait_for(lock, SWEEP_PERIOD);
+            if (!d_running) break;
+            sweep(frame_record_time_ns(), false);
+            lock.unlock();
+            publish();
+            lock.lock();
+        }
+    });
+    return block::start();
+}
+
+// Reports every remaining flow, so that nothing accounted is lost at the end.
+bool flow_table_impl::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (!d_running) return block::stop();
+        d_running = false;
+    }
+    d_wake.notify_all();
+    d_sweeper.join();
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        sweep(frame_record_time_ns(), true);
+    }
+    publish();
+    return block::stop();
+}
+
+void flow_table_impl::handle_frames(const pmt::pmt_t& msg)
+{
+    read_frames(msg, d_writer, [this](const uint8_t* data, size_t len) {
+        return add_records(data, len);
+    });
+    publish(); // LRU evictions
+}
+
+bool flow_table_impl::add_records(const uint8_t* msg, size_t len)
+{
+    frame_record_reader batch;
+    if (!batch.open(msg, len)) return false;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (size_t i = 0; i < batch.count(); i++) account(batch.header(i));
+    return true;
+}
+
+// Called with d_mutex held.
+void flow_table_impl::account(const uint8_t* h)
+{
+    frame_record_view r(h);
+    bool ip = r.ip_version() != 0;
+
+    flow_key k;
+    k.vlan = r.has_vlan() ? r.vlan_id() : 0xFFFF;
+    k.ethertype = r.ethertype();
+    if (ip) {
+        k.ip_version = r.ip_version();
+        k.ip_proto = r.ip_proto();
+        memcpy(k.src, r.ip_src(), 16);
+        memcpy(k.dst, r.ip_dst(), 16);
+        k.src_port = r.src_port();
+        k.dst_port = r.dst_port();
+    } else {
+        memcpy(k.src, r.mac_src(), 6);
+        memcpy(k.dst, r.mac_dst(), 6);
+    }
+
+    uint64_t hash = flow_map::hash(k);
+    flow_entry* f = d_flows.find(k, hash);
+    if (!f) {
+        if (d_flows.full()) {
+            flow_entry* victim = d_flows.oldest();
+            report(*victim, "evicted");
+            d_flows.erase(victim);
+            d_evicted.add();
+        }
+        f = d_flows.insert(k, hash);
+    } else {
+        d_flows.touch(f);
+    }
+
+    uint64_t sample = r.sample_offset();
+    uint64_t t = r.time_ns();
+    // First frame of the flow, or of the period after an interval report
+    if (f->packets == 0) {
+        f->first_sample = sample;
+        f->first_ns = t;
+    }
+    f->packets++;
+    f->bytes += r.frame_len();
+    f->last_sample = sample;
+    f->last_ns = t;
+    if (r.is_tcp()) f->tcp_flags |= r.tcp_flags();
+    d_received.add();
+}
+
+// Called with d_mutex held. A report covers the frames since the flow's
+// previous one, first_* included: flows with no frame since are not
+// reported again.
+void flow_table_impl::report(const flow_entry& f, const char* reason)
+{
+    if (f.packets == 0) return;
+    const flow_key& k = f.key;
+    std::string src, dst, mac_src, mac_dst;
+    if (k.ip_version) {
+        src = format_ip(k.ip_version, k.src);
+        dst = format_ip(k.ip_version, k.dst);
+    } else {
+        mac_src = format_mac(k.src);
+        mac_dst = format_mac(k.dst);
+    }
+    bool ports = k.ip_proto == 6 || k.ip_proto == 17;
+
+    pmt::pmt_t d = pmt::make_dict();
+    d = pmt::dict_add(d, pmt::intern("vlan_id"), pmt::from_long(k.vlan == 0xFFFF ? -1 : k.vlan));
+    d = pmt::dict_add(d, pmt::intern("ethertype"), pmt::from_long(k.ethertype));
+    d = pmt::dict_add(d, pmt::intern("mac_src"), pmt::intern(mac_src));
+    d = pmt::dict_add(d, pmt::intern("mac_dst"), pmt::intern(mac_dst));
+    d = pmt::dict_add(d, pmt::intern("ip_version"), pmt::from_long(k.ip_version));
+    d = pmt::dict_add(d, pmt::intern("ip_src"), pmt::intern(src));
+    d = pmt::dict_add(d, pmt::intern("ip_dst"), pmt::intern(dst));
+    d = pmt::dict_add(d, pmt::intern("l4_proto"), pmt::from_long(k.ip_version ? k.ip_proto : -1));
+    d = pmt::dict_add(d, pmt::intern("src_port"), pmt::from_long(ports ? k.src_port : -1));
+    d = pmt::dict_add(d, pmt::intern("dst_port"), pmt::from_long(ports ? k.dst_port : -1));
+    d = pmt::dict_add(d, pmt::intern("packets"), pmt::from_uint64(f.packets));
+    d = pmt::dict_add(d, pmt::intern("bytes"), pmt::from_uint64(f.bytes));
+    d = pmt::dict_add(d, pmt::intern("first_sample"), pmt::from_uint64(f.first_sample));
+    d = pmt::dict_add(d, pmt::intern("last_sample"), pmt::from_uint64(f.last_sample));
+    d = pmt::dict_add(d, pmt::intern("first_time_ns"), pmt::from_uint64(f.first_ns));
+    d = pmt::dict_add(d, pmt::intern("last_time_ns"), pmt::from_uint64(f.last_ns));
+    d = pmt::dict_add(d, pmt::intern("tcp_flags"), pmt::intern(tcp_flags_string(f.tcp_flags)));
+    d = pmt::dict_add(d, pmt::intern("reason"), pmt::intern(reason));
+    d_reports.push_back(d);
+}
+
+// Called with d_mutex held: reports and removes the idle flows (all of them
+// when all is set), then the interval reports when due.
+void flow_table_impl::sweep(uint64_t now, bool all)
+{
+    // The LRU tail is the flow seen longest ago: stop at the first active one
+    while (flow_entry* f = d_flows.oldest()) {
+        if (!all && (d_idle_ns == 0 || f->last_ns + d_idle_ns > now)) break;
+        report(*f, all ? "end" : "idle");
+        d_flows.erase(f);
+        d_expired.add();
+    }
+
+    if (all || d_interval_ns == 0 || now < d_next_report) return;
+    d_next_report = now + d_interval_ns;
+    for (flow_entry* f = d_flows.oldest(); f; f = d_flows.newer(f)) {
+        report(*f, "interval");
+        f->packets = 0;
+        f->bytes = 0;
+        f->tcp_flags = 0;
+    }
+}
+
+// Publishes the pending reports as one message, outside the lock.
+void flow_table_impl::publish()
+{
+    std::vector<pmt::pmt_t> reports;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (d_reports.empty()) return;
+        reports.swap(d_reports);
+    }
+    pmt::pmt_t v = pmt::make_vector(reports.size(), pmt::PMT_NIL);
+    for (size_t i = 0; i < reports.size(); i++) pmt::vector_set(v, i, reports[i]);
+    message_port_pub(d_out_port, v);
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,64 @@
+#ifndef INCLUDED_ETHERNET_FLOW_TABLE_IMPL_H
+#define INCLUDED_ETHERNET_FLOW_TABLE_IMPL_H
+
+#include "block_stats.h"
+#include "flow_map.h"
+#include <gnuradio/ethernet/flow_table.h>
+#include <gnuradio/ethernet/frame_record.h>
+#include <pmt/pmt.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+class flow_table_impl : public flow_table
+{
+private:
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    uint64_t d_idle_ns;
+    uint64_t d_interval_ns; // 0: no interval reports
+    uint64_t d_next_report;
+
+    // The table is shared by the message handler and the sweep thread
+    mutable std::mutex d_mutex;
+    flow_map d_flows;
+    std::vector<pmt::pmt_t> d_reports; // flow dicts not published yet
+    frame_record_writer d_writer;      // decoded dicts -> records
+
+    std::thread d_sweeper;
+    std::condition_variable d_wake;
+    bool d_running;
+
+    stat_counter d_received;
+    stat_counter d_expired;
+    stat_counter d_evicted;
+
+    void handle_frames(const pmt::pmt_t& msg);
+    bool add_records(const uint8_t* msg, size_t len);
+    void account(const uint8_t* header);
+    void report(const flow_entry& f, const char* reason);
+    void sweep(uint64_t now, bool all);
+    void publish();
+
+public:
+    flow_table_impl(int max_flows, double idle_timeout_s, double report_interval_s);
+    ~flow_table_impl();
+
+    bool start() override;
+    bool stop() override;
+
+    uint64_t active_flows() const override;
+    uint64_t flows_expired() const override;
+    uint64_t flows_evicted() const override;
+    uint64_t frames_received() const override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef INCLUDED_ETHERNET_FRAME_ARENA_H
+#define INCLUDED_ETHERNET_FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+// Largest frame a slot holds: a 9000-byte jumbo payload, headers, FCS and
+// the 100BASE-TX preamble, rounded up.
+const size_t FRAME_SLOT_BYTES = 9216;
+
+/*
+ * One decoded frame: its bytes and what the decoder learnt about it.
+ */
+struct frame_slot {
+    size_t len;             // bytes used in data
+    uint64_t sample_offset; // input offset the decoder reports for the frame
+    uint64_t frame_num;
+    bool fcs_ok;
+    uint8_t data[FRAME_SLOT_BYTES];
+};
+
+/*
+ * Free list of frame slots for one decoder. acquire() hands out a slot
+ * that goes back to the list when its handle is destroyed, so once the
+ * decoder has as many slots as it ever holds at once, decoding a frame
+ * allocates nothing. Slots are never freed before the arena. Not
+ * thread-safe: one arena per work() thread.
+ */
+class frame_arena
+{
+public:
+    class releaser
+    {
+    public:
+        releaser() : d_arena(nullptr) {}
+        explicit releaser(frame_arena* arena) : d_arena(arena) {}
+        void operator()(frame_slot* slot) const { d_arena->d_free.push_back(slot); }
+
+    private:
+        frame_arena* d_arena;
+    };
+    typedef std::unique_ptr<frame_slot, releaser> handle;
+
+    explicit frame_arena(size_t prealloc = 1)
+    {
+        d_slots.reserve(prealloc);
+        d_free.reserve(prealloc);
+        for (size_t i = 0; i < prealloc; i++) grow();
+    }
+
+    // A slot with len = 0; its other fields are left as the last user set them.
+    handle acquire()
+    {
+        if (d_free.empty()) grow();
+        frame_slot* slot = d_free.back();
+        d_free.pop_back();
+        slot->len = 0;
+        return handle(slot, releaser(this));
+    }
+
+    // Slots allocated so far.
+    size_t allocated() const { return d_slots.size(); }
+    // Slots in use.
+    size_t in_use() const { return d_slots.size() - d_free.size(); }
+
+private:
+    std::vector<std::unique_ptr<frame_slot>> d_slots;
+    std::vector<frame_slot*> d_free;
+
+    void grow()
+    {
+        d_slots.emplace_back(new frame_slot);
+        // Room for every slot, so releasing one never allocates
+        d_free.reserve(d_slots.size());
+        d_free.push_back(d_slots.back().get());
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef INCLUDED_ETHERNET_FRAME_BATCHER_H
+#define INCLUDED_ETHERNET_FRAME_BATCHER_H
+
+#include "latency_trace.h"
+#include <gnuradio/high_res_timer.h>
+#include <pmt/pmt.h>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Collects decoded frame dicts into one PMT vector message. The batch is
+ * due when it holds max_frames frames, max_bytes frame bytes, or when its
+ * oldest frame is timeout_ms old, whichever comes first (0 disables a
+ * limit). max_frames <= 1 disables batching.
+ */
+class frame_batcher
+{
+public:
+    frame_batcher(int max_frames, int max_bytes, int timeout_ms)
+        : d_max_frames(max_frames > 1 ? max_frames : 0),
+          d_max_bytes(max_bytes > 0 ? max_bytes : 0),
+          d_timeout(timeout_ms > 0 ? gr::high_res_timer_tps() / 1000 * timeout_ms : 0),
+          d_bytes(0),
+          d_first(0)
+    {
+        d_frames.reserve(d_max_frames);
+        d_stamps.reserve(d_max_frames);
+    }
+
+    bool enabled() const { return d_max_frames > 0; }
+    bool empty() const { return d_frames.empty(); }
+
+    // Returns true when the batch is due.
+    bool add(const pmt::pmt_t& frame, size_t bytes, const frame_trace::stamps& stamps)
+    {
+        if (d_frames.empty() && d_timeout > 0) d_first = gr::high_res_timer_now();
+        d_frames.push_back(frame);
+        d_stamps.push_back(stamps);
+        d_bytes += bytes;
+        return d_frames.size() >= d_max_frames || (d_max_bytes > 0 && d_bytes >= d_max_bytes) ||
+               expired();
+    }
+
+    // Time limit reached; checked at the end of every work() call.
+    bool expired() const
+    {
+        return d_timeout > 0 && !d_frames.empty() &&
+               gr::high_res_timer_now() - d_first >= d_timeout;
+    }
+
+    // The batch as a PMT vector of dicts, in decoding order; empties it.
+    // stamps is overwritten; both keep their capacity from batch to batch.
+    pmt::pmt_t take(std::vector<frame_trace::stamps>& stamps)
+    {
+        pmt::pmt_t v = pmt::make_vector(d_frames.size(), pmt::PMT_NIL);
+        for (size_t i = 0; i < d_frames.size(); i++) {
+            pmt::vector_set(v, i, d_frames[i]);
+        }
+        stamps.assign(d_stamps.begin(), d_stamps.end());
+        d_stamps.clear();
+        d_frames.clear();
+        d_bytes = 0;
+        return v;
+    }
+
+private:
+    size_t d_max_frames;
+    size_t d_max_bytes;
+    gr::high_res_timer_type d_timeout;
+    std::vector<pmt::pmt_t> d_frames;
+    std::vector<frame_trace::stamps> d_stamps;
+    size_t d_bytes;
+    gr::high_res_timer_type d_first;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
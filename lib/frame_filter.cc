@@ -0,0 +1,494 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "frame_headers.h"
+#include <gnuradio/ethernet/frame_filter.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+enum filter_op : uint8_t {
+    OP_TRUE,
+    OP_AND,
+    OP_OR,
+    OP_NOT,
+    OP_ETHER_SRC,
+    OP_ETHER_DST,
+    OP_ETHER_HOST,
+    OP_ETHER_PROTO, // a = ethertype (after the VLAN tag)
+    OP_VLAN,        // any 802.1Q/802.1ad tag
+    OP_VLAN_ID,     // a = VLAN ID
+    OP_IP_SRC,      // a = address, b = mask
+    OP_IP_DST,
+    OP_IP_HOST,
+    OP_IP_PROTO,    // a = IPv4 protocol / IPv6 next header
+    OP_PORT_SRC,    // a..b = port range, TCP or UDP
+    OP_PORT_DST,
+    OP_PORT_ANY,
+    OP_LEN_GE,      // a = length
+    OP_LEN_LE,
+};
+
+// Parentheses and "not" nested deeper than this are rejected: each level
+// costs a few parser frames and an eval() frame. And/or chains cost none.
+const int MAX_NESTING = 64;
+
+const char* OP_NAMES[] = { "true",      "and",       "or",       "not",     "ether src",
+                           "ether dst", "ether host", "ether proto", "vlan",  "vlan id",
+                           "ip src",    "ip dst",    "ip host",  "ip proto", "src port",
+                           "dst port",  "port",      "len >=",   "len <=" };
+
+// And/or chains are right-deep: the rest of a chain is followed in the
+// loop, so only nesting recurses.
+bool eval(const std::vector<frame_filter::node>& nodes, int32_t i, const frame_view& v)
+{
+    for (;;) {
+        const frame_filter::node& n = nodes[i];
+        switch (n.op) {
+        case OP_TRUE:
+            return true;
+        case OP_AND:
+            if (!eval(nodes, n.left, v)) return false;
+            i = n.right;
+            continue;
+        case OP_OR:
+            if (eval(nodes, n.left, v)) return true;
+            i = n.right;
+            continue;
+        case OP_NOT:
+            return !eval(nodes, n.left, v);
+        case OP_ETHER_SRC:
+            return v.len >= 14 && memcmp(v.p + 6, n.mac, 6) == 0;
+        case OP_ETHER_DST:
+            return v.len >= 14 && memcmp(v.p, n.mac, 6) == 0;
+        case OP_ETHER_HOST:
+            return v.len >= 14 && (memcmp(v.p, n.mac, 6) == 0 || memcmp(v.p + 6, n.mac, 6) == 0);
+        case OP_ETHER_PROTO:
+            return v.len >= 14 && v.ethertype == n.a;
+        case OP_VLAN:
+            return v.vlan >= 0;
+        case OP_VLAN_ID:
+            return v.vlan == (int)n.a;
+        case OP_IP_SRC:
+            return v.ipv4 && (be32(v.p + v.l3 + 12) & n.b) == n.a;
+        case OP_IP_DST:
+            return v.ipv4 && (be32(v.p + v.l3 + 16) & n.b) == n.a;
+        case OP_IP_HOST:
+            return v.ipv4 && ((be32(v.p + v.l3 + 12) & n.b) == n.a ||
+                              (be32(v.p + v.l3 + 16) & n.b) == n.a);
+        case OP_IP_PROTO:
+            return v.ip_proto == (int)n.a;
+        case OP_PORT_SRC:
+        case OP_PORT_DST:
+        case OP_PORT_ANY: {
+            if (v.l4 == 0 || (v.ip_proto != 6 && v.ip_proto != 17)) return false;
+            uint32_t sport = be16(v.p + v.l4);
+            uint32_t dport = be16(v.p + v.l4 + 2);
+            bool src = sport >= n.a && sport <= n.b;
+            bool dst = dport >= n.a && dport <= n.b;
+            if (n.op == OP_PORT_SRC) return src;
+            if (n.op == OP_PORT_DST) return dst;
+            return src || dst;
+        }
+        case OP_LEN_GE:
+            return v.wire_len >= n.a;
+        case OP_LEN_LE:
+            return v.wire_len <= n.a;
+        }
+        return false;
+    }
+}
+
+std::vector<std::string> tokenize(const std::string& s)
+{
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < s.size()) {
+        char c = s[i];
+        if (isspace((unsigned char)c)) {
+            i++;
+        } else if (c == '(' || c == ')' || c == '!') {
+            tokens.push_back(std::string(1, c));
+            i++;
+        } else if ((c == '&' || c == '|') && i + 1 < s.size() && s[i + 1] == c) {
+            tokens.push_back(c == '&' ? "and" : "or");
+            i += 2;
+        } else {
+            size_t j = i;
+            while (j < s.size() && !isspace((unsigned char)s[j]) && !strchr("()!&|", s[j])) {
+                j++;
+            }
+            if (j == i) throw std::invalid_argument("filter: unexpected '" + std::string(1, c) + "'");
+            tokens.push_back(s.substr(i, j - i));
+            i = j;
+        }
+    }
+    return tokens;
+}
+
+/*
+ * Recursive descent parser:
+ *   expr    := term ("or" term)*
+ *   term    := factor ("and" factor)*
+ *   factor  := ("not" | "!") factor | "(" expr ")" | primitive
+ *
+ * Chains of "or" and "and" become right-deep trees, evaluated left to
+ * right. Nesting (parentheses, "not") is limited to MAX_NESTING levels.
+ */
+class filter_parser
+{
+public:
+    filter_parser(const std::string& expression, std::vector<frame_filter::node>& nodes)
+        : d_tokens(tokenize(expression)), d_pos(0), d_nesting(0), d_nodes(nodes)
+    {
+    }
+
+    int32_t parse()
+    {
+        if (d_tokens.empty()) return add(OP_TRUE);
+        int32_t root = expr();
+        if (d_pos < d_tokens.size()) error("unexpected");
+        return root;
+    }
+
+private:
+    std::vector<std::string> d_tokens;
+    size_t d_pos;
+    int d_nesting;
+    std::vector<frame_filter::node>& d_nodes;
+
+    [[noreturn]] void error(const std::string& what)
+    {
+        std::string at = d_pos < d_tokens.size() ? "'" + d_tokens[d_pos] + "'" : "end of expression";
+        throw std::invalid_argument("filter: " + what + " at " + at);
+    }
+
+    bool peek(const char* word) const
+    {
+        return d_pos < d_tokens.size() && d_tokens[d_pos] == word;
+    }
+
+    bool accept(const char* word)
+    {
+        if (!peek(word)) return false;
+        d_pos++;
+        return true;
+    }
+
+    const std::string& next(const char* what)
+    {
+        if (d_pos >= d_tokens.size()) error(std::string("expected ") + what);
+        return d_tokens[d_pos++];
+    }
+
+    int32_t add(uint8_t op, uint32_t a = 0, uint32_t b = 0, int32_t left = -1, int32_t right = -1)
+    {
+        frame_filter::node n;
+        memset(&n, 0, sizeof(n));
+        n.op = op;
+        n.a = a;
+        n.b = b;
+        n.left = left;
+        n.right = right;
+        d_nodes.push_back(n);
+        return d_nodes.size() - 1;
+    }
+
+    // a op b op c as a op (b op c)
+    int32_t chain(uint8_t op, const std::vector<int32_t>& operands)
+    {
+        int32_t right = operands.back();
+        for (size_t k = operands.size() - 1; k-- > 0;) {
+            right = add(op, 0, 0, operands[k], right);
+        }
+        return right;
+    }
+
+    int32_t expr()
+    {
+        std::vector<int32_t> terms{ term() };
+        while (accept("or")) {
+            terms.push_back(term());
+        }
+        return chain(OP_OR, terms);
+    }
+
+    int32_t term()
+    {
+        std::vector<int32_t> factors{ factor() };
+        while (accept("and")) {
+            factors.push_back(factor());
+        }
+        return chain(OP_AND, factors);
+    }
+
+    int32_t factor()
+    {
+        if (peek("not") || peek("!") || peek("(")) {
+            if (d_nesting == MAX_NESTING) error("nested too deeply");
+            d_nesting++;
+        } else {
+            return primitive();
+        }
+
+        int32_t f;
+        if (accept("(")) {
+            f = expr();
+            if (!accept(")")) error("expected ')'");
+        } else {
+            d_pos++;
+            f = add(OP_NOT, 0, 0, factor());
+        }
+        d_nesting--;
+        return f;
+    }
+
+    uint32_t number(const char* what, uint32_t max)
+    {
+        const std::string& tok = next(what);
+        char* end = nullptr;
+        unsigned long v = strtoul(tok.c_str(), &end, 0);
+        if (tok.empty() || *end != '\0' || v > max) {
+            d_pos--;
+            error(std::string("expected ") + what);
+        }
+        return v;
+    }
+
+    void mac(uint8_t out[6])
+    {
+        const std::string& tok = next("MAC address");
+        unsigned int b[6];
+        char tail;
+        if (sscanf(tok.c_str(), "%x:%x:%x:%x:%x:%x%c", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5],
+                   &tail) != 6) {
+            d_pos--;
+            error("expected MAC address");
+        }
+        for (int i = 0; i < 6; i++) {
+            if (b[i] > 0xFF) {
+                d_pos--;
+                error("expected MAC address");
+            }
+            out[i] = b[i];
+        }
+    }
+
+    // A.B.C.D or A.B.C.D/LEN; the mask is all ones without /LEN.
+    void ipv4(uint32_t& addr, uint32_t& mask, bool allow_prefix)
+    {
+        const std::string& tok = next("IPv4 address");
+        unsigned int b[4];
+        unsigned int prefix = 32;
+        int consumed = 0;
+        bool ok = sscanf(tok.c_str(), "%u.%u.%u.%u%n", &b[0], &b[1], &b[2], &b[3], &consumed) == 4;
+        if (ok && tok[consumed] == '/' && allow_prefix) {
+            char* end = nullptr;
+            prefix = strtoul(tok.c_str() + consumed + 1, &end, 10);
+            ok = *end == '\0' && prefix <= 32 && end != tok.c_str() + consumed + 1;
+        } else if (ok) {
+            ok = tok[consumed] == '\0';
+        }
+        for (int i = 0; ok && i < 4; i++) ok = b[i] <= 0xFF;
+        if (!ok) {
+            d_pos--;
+            error(allow_prefix ? "expected IPv4 network" : "expected IPv4 address");
+        }
+        mask = prefix == 0 ? 0 : 0xFFFFFFFFu << (32 - prefix);
+        addr = ((b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3]) & mask;
+    }
+
+    // [src|dst] port N | [src|dst] portrange N-M, after the direction.
+    int32_t port(uint8_t op)
+    {
+        if (accept("port")) {
+            uint32_t p = number("port number", 65535);
+            return add(op, p, p);
+        }
+        if (accept("portrange")) {
+            const std::string& tok = next("port range");
+            unsigned int lo, hi;
+            char tail;
+            if (sscanf(tok.c_str(), "%u-%u%c", &lo, &hi, &tail) != 2 || lo > hi || hi > 65535) {
+                d_pos--;
+                error("expected port range N-M");
+            }
+            return add(op, lo, hi);
+        }
+        error("expected 'port' or 'portrange'");
+    }
+
+    // host, net or port after src/dst (or without direction).
+    int32_t directed(uint8_t ip_op, uint8_t port_op)
+    {
+        uint32_t addr, mask;
+        if (accept("host")) {
+            ipv4(addr, mask, false);
+            return add(ip_op, addr, mask);
+        }
+        if (accept("net")) {
+            ipv4(addr, mask, true);
+            return add(ip_op, addr, mask);
+        }
+        return port(port_op);
+    }
+
+    int32_t transport(uint32_t proto)
+    {
+        int32_t p = add(OP_IP_PROTO, proto);
+        uint8_t op = OP_PORT_ANY;
+        if (accept("src")) {
+            op = OP_PORT_SRC;
+        } else if (accept("dst")) {
+            op = OP_PORT_DST;
+        } else if (!peek("port") && !peek("portrange")) {
+            return p;
+        }
+        return add(OP_AND, 0, 0, p, port(op));
+    }
+
+    int32_t primitive()
+    {
+        const std::string& tok = next("primitive");
+        if (tok == "ether") {
+            int32_t n;
+            if (accept("proto")) return add(OP_ETHER_PROTO, number("ethertype", 0xFFFF));
+            if (accept("src")) {
+                n = add(OP_ETHER_SRC);
+            } else if (accept("dst")) {
+                n = add(OP_ETHER_DST);
+            } else if (accept("host")) {
+                n = add(OP_ETHER_HOST);
+            } else {
+                error("expected src, dst, host or proto");
+            }
+            mac(d_nodes[n].mac);
+            return n;
+        }
+        if (tok == "vlan") {
+            if (d_pos < d_tokens.size() && isdigit((unsigned char)d_tokens[d_pos][0])) {
+                return add(OP_VLAN_ID, number("VLAN ID", 4095));
+            }
+            return add(OP_VLAN);
+        }
+        if (tok == "ip") {
+            if (accept("proto")) return add(OP_IP_PROTO, number("protocol", 255));
+            return add(OP_ETHER_PROTO, 0x0800);
+        }
+        if (tok == "ip6") return add(OP_ETHER_PROTO, 0x86DD);
+        if (tok == "arp") return add(OP_ETHER_PROTO, 0x0806);
+        if (tok == "proto") return add(OP_IP_PROTO, number("protocol", 255));
+        if (tok == "tcp") return transport(6);
+        if (tok == "udp") return transport(17);
+        if (tok == "icmp") return add(OP_IP_PROTO, 1);
+        if (tok == "src") return directed(OP_IP_SRC, OP_PORT_SRC);
+        if (tok == "dst") return directed(OP_IP_DST, OP_PORT_DST);
+        if (tok == "host" || tok == "net" || tok == "port" || tok == "portrange") {
+            d_pos--;
+            return directed(OP_IP_HOST, OP_PORT_ANY);
+        }
+        if (tok == "greater") return add(OP_LEN_GE, number("length", 0xFFFF));
+        if (tok == "less") return add(OP_LEN_LE, number("length", 0xFFFF));
+        d_pos--;
+        error("unknown primitive");
+    }
+};
+
+} // namespace
+
+frame_filter::frame_filter(const std::string& expression) : d_expression(expression)
+{
+    filter_parser parser(expression, d_nodes);
+    d_root = parser.parse();
+}
+
+bool frame_filter::match(const uint8_t* frame, size_t len) const
+{
+    return match(frame, len, len);
+}
+
+bool frame_filter::match(const uint8_t* frame, size_t caplen, size_t wire_len) const
+{
+    frame_view v;
+    parse_headers(frame, caplen, v);
+    v.wire_len = wire_len;
+    return eval(d_nodes, d_root, v);
+}
+
+frame_filter::sptr frame_filter::compile(const std::string& expression)
+{
+    if (expression.find_first_not_of(" \t\r\n") == std::string::npos) return nullptr;
+    return std::make_shared<const frame_filter>(expression);
+}
+
+std::string frame_filter::dump() const
+{
+    std::ostringstream oss;
+    struct printer {
+        const std::vector<node>& nodes;
+        std::ostringstream& oss;
+        void print(int32_t i, int depth)
+        {
+            const node& n = nodes[i];
+            oss << std::string(2 * depth, ' ') << OP_NAMES[n.op];
+            switch (n.op) {
+            case OP_ETHER_SRC:
+            case OP_ETHER_DST:
+            case OP_ETHER_HOST:
+                for (int k = 0; k < 6; k++) {
+                    oss << (k ? ":" : " ") << std::hex << (n.mac[k] >> 4) << (n.mac[k] & 0xF)
+                        << std::dec;
+                }
+                break;
+            case OP_ETHER_PROTO:
+                oss << " 0x" << std::hex << n.a << std::dec;
+                break;
+            case OP_IP_SRC:
+            case OP_IP_DST:
+            case OP_IP_HOST:
+                oss << " " << (n.a >> 24) << "." << ((n.a >> 16) & 0xFF) << "."
+                    << ((n.a >> 8) & 0xFF) << "." << (n.a & 0xFF) << " mask 0x" << std::hex
+                    << n.b << std::dec;
+                break;
+            case OP_PORT_SRC:
+            case OP_PORT_DST:
+            case OP_PORT_ANY:
+                oss << " " << n.a;
+                if (n.b != n.a) oss << "-" << n.b;
+                break;
+            case OP_VLAN_ID:
+            case OP_IP_PROTO:
+            case OP_LEN_GE:
+            case OP_LEN_LE:
+                oss << " " << n.a;
+                break;
+            }
+            oss << "\n";
+            // The operands of a chain at the same level
+            int32_t j = i;
+            while (n.op != OP_NOT && n.right >= 0 && nodes[j].op == n.op) {
+                print(nodes[j].left, depth + 1);
+                j = nodes[j].right;
+            }
+            if (j != i) {
+                print(j, depth + 1);
+            } else if (n.left >= 0) {
+                print(n.left, depth + 1);
+            }
+        }
+    } p{ d_nodes, oss };
+    p.print(d_root, 0);
+    return oss.str();
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,70 @@
+#ifndef INCLUDED_ETHERNET_FRAME_HEADERS_H
+#define INCLUDED_ETHERNET_FRAME_HEADERS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gr {
+namespace ethernet {
+
+// Header offsets of one frame (destination MAC first), computed once.
+struct frame_view {
+    const uint8_t* p;
+    size_t len;         // bytes available
+    size_t wire_len;    // length on the wire, larger for a truncated capture
+    int vlan;           // -1 when untagged
+    uint32_t vlan_tci;  // whole TCI, 0 when untagged
+    uint32_t ethertype; // after the tag
+    size_t l3;
+    int ip_proto;       // -1 when not IP
+    size_t l4;          // 0 when there is no usable L4 header
+    bool ipv4;
+};
+
+inline uint32_t be16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+inline uint32_t be32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+inline void parse_headers(const uint8_t* p, size_t len, frame_view& v)
+{
+    v.p = p;
+    v.len = len;
+    v.wire_len = len;
+    v.vlan = -1;
+    v.vlan_tci = 0;
+    v.ethertype = 0;
+    v.l3 = 14;
+    v.ip_proto = -1;
+    v.l4 = 0;
+    v.ipv4 = false;
+    if (len < 14) return;
+
+    v.ethertype = be16(p + 12);
+    if ((v.ethertype == 0x8100 || v.ethertype == 0x88A8) && len >= 18) {
+        v.vlan_tci = be16(p + 14);
+        v.vlan = v.vlan_tci & 0x0FFF;
+        v.ethertype = be16(p + 16);
+        v.l3 = 18;
+    }
+
+    const uint8_t* ip = p + v.l3;
+    if (v.ethertype == 0x0800 && len >= v.l3 + 20 && (ip[0] >> 4) == 4) {
+        v.ipv4 = true;
+        v.ip_proto = ip[9];
+        size_t ihl = (ip[0] & 0x0F) * 4;
+        bool first_fragment = (be16(ip + 6) & 0x1FFF) == 0;
+        if (ihl >= 20 && first_fragment) v.l4 = v.l3 + ihl;
+    } else if (v.ethertype == 0x86DD && len >= v.l3 + 40) {
+        // No extension header walk: the next header must be L4 directly
+        v.ip_proto = ip[6];
+        v.l4 = v.l3 + 40;
+    }
+    if (v.l4 + 4 > len) v.l4 = 0;
+}
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef INCLUDED_ETHERNET_FRAME_INPUT_H
+#define INCLUDED_ETHERNET_FRAME_INPUT_H
+
+#include <gnuradio/ethernet/frame_record.h>
+#include <pmt/pmt.h>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Message of a "frames" input port: a record batch from a decoder's
+ * "records" port, or its "decoded" dicts (one, or a batched vector),
+ * which are converted to one record batch with writer. A PDU's metadata
+ * is dropped. Calls add(msg, len) on the batch; returns false when
+ * nothing in the message was usable.
+ */
+template <typename F>
+bool read_frames(const pmt::pmt_t& msg, frame_record_writer& writer, F add)
+{
+    pmt::pmt_t m = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    if (pmt::is_u8vector(m)) {
+        size_t len = 0;
+        const uint8_t* data = pmt::u8vector_elements(m, len);
+        return add(data, len);
+    }
+
+    auto add_dict = [&writer](const pmt::pmt_t& d) {
+        if (!pmt::is_dict(d)) return false;
+        pmt::pmt_t frame = pmt::dict_ref(d, pmt::intern("frame"), pmt::PMT_NIL);
+        if (!pmt::is_u8vector(frame)) return false;
+        size_t len = 0;
+        const uint8_t* bytes = pmt::u8vector_elements(frame, len);
+        pmt::pmt_t num = pmt::dict_ref(d, pmt::intern("frame_num"), pmt::PMT_NIL);
+        pmt::pmt_t offset = pmt::dict_ref(d, pmt::intern("sample_offset"), pmt::PMT_NIL);
+        pmt::pmt_t fcs_ok = pmt::dict_ref(d, pmt::intern("fcs_ok"), pmt::PMT_F);
+        writer.add(bytes, len,
+                   pmt::is_integer(num) ? pmt::to_long(num) : 0,
+                   pmt::is_uint64(offset) ? pmt::to_uint64(offset) : 0,
+                   pmt::is_true(fcs_ok));
+        return true;
+    };
+    bool ok = false;
+    if (pmt::is_dict(m)) {
+        ok = add_dict(m);
+    } else if (pmt::is_vector(m)) {
+        for (size_t i = 0; i < pmt::length(m); i++) ok |= add_dict(pmt::vector_ref(m, i));
+    }
+    if (!writer.empty()) {
+        const std::vector<uint8_t>& batch = writer.finish();
+        add(batch.data(), batch.size());
+        writer.clear();
+    }
+    return ok;
+}
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
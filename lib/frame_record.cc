@@ -0,0 +1,205 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "frame_headers.h"
+#include <gnuradio/ethernet/frame_record.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+inline void put16(uint8_t* p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+inline void put32(uint8_t* p, uint32_t v)
+{
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+inline void put64(uint8_t* p, uint64_t v)
+{
+    put32(p, (uint32_t)v);
+    put32(p + 4, (uint32_t)(v >> 32));
+}
+
+inline uint32_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t get32(const uint8_t* p) { return get16(p) | (get16(p + 2) << 16); }
+
+} // namespace
+
+uint64_t frame_record_time_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string format_mac(const uint8_t* m)
+{
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x", m[0], m[1], m[2], m[3], m[4], m[5]);
+    return buf;
+}
+
+std::string format_ip(int ip_version, const uint8_t* addr)
+{
+    if (ip_version != 4 && ip_version != 6) return "";
+    char buf[INET6_ADDRSTRLEN];
+    int family = ip_version == 4 ? AF_INET : AF_INET6;
+    return inet_ntop(family, addr, buf, sizeof(buf)) ? buf : "";
+}
+
+std::string tcp_flags_string(uint8_t flags)
+{
+    static const struct {
+        uint8_t bit;
+        const char* name;
+    } names[] = { { 0x02, "SYN" }, { 0x10, "ACK" }, { 0x01, "FIN" },
+                  { 0x04, "RST" }, { 0x08, "PSH" }, { 0x20, "URG" } };
+    std::string s;
+    for (const auto& n : names) {
+        if (!(flags & n.bit)) continue;
+        if (!s.empty()) s += " ";
+        s += n.name;
+    }
+    return s;
+}
+
+frame_record_writer::frame_record_writer() {}
+
+void frame_record_writer::add(const uint8_t* frame,
+                              size_t len,
+                              uint64_t frame_num,
+                              uint64_t sample_offset,
+                              bool fcs_ok,
+                              uint8_t lane)
+{
+    if (len > 0xFFFF) len = 0xFFFF;
+
+    size_t pos = d_headers.size();
+    d_headers.resize(pos + FRAME_RECORD_SIZE, 0);
+    uint8_t* r = d_headers.data() + pos;
+
+    frame_view v;
+    parse_headers(frame, len, v);
+
+    uint16_t flags = fcs_ok ? FRAME_RECORD_FCS_OK : 0;
+    put64(r + 0, frame_num);
+    put64(r + 8, sample_offset);
+    put64(r + 16, frame_record_time_ns());
+    put32(r + 24, d_data.size());
+    put16(r + 28, len);
+    put16(r + 32, v.ethertype);
+    put16(r + 34, v.vlan_tci);
+    r[49] = lane;
+    if (v.vlan >= 0) flags |= FRAME_RECORD_VLAN;
+    if (len >= 14) {
+        memcpy(r + 52, frame, 6);
+        memcpy(r + 58, frame + 6, 6);
+    }
+
+    const uint8_t* ip = frame + v.l3;
+    if (v.ipv4) {
+        flags |= FRAME_RECORD_IPV4;
+        r[45] = ip[8];
+        memcpy(r + 64, ip + 12, 4);
+        memcpy(r + 80, ip + 16, 4);
+    } else if (v.ip_proto >= 0) {
+        flags |= FRAME_RECORD_IPV6;
+        r[45] = ip[7];
+        memcpy(r + 64, ip + 8, 16);
+        memcpy(r + 80, ip + 24, 16);
+    }
+    if (v.ip_proto >= 0) {
+        put16(r + 36, v.l3);
+        r[44] = v.ip_proto;
+    }
+
+    if (v.l4 != 0) {
+        const uint8_t* l4 = frame + v.l4;
+        flags |= FRAME_RECORD_L4;
+        put16(r + 38, v.l4);
+        if (v.ip_proto == 6 || v.ip_proto == 17) {
+            put16(r + 40, be16(l4));
+            put16(r + 42, be16(l4 + 2));
+            if (v.ip_proto == 6 && v.l4 + 14 <= len) r[46] = l4[13];
+        } else if (v.ip_proto == 1 || v.ip_proto == 58) {
+            r[47] = l4[0];
+            r[48] = l4[1];
+        }
+    }
+    put16(r + 30, flags);
+
+    d_data.insert(d_data.end(), frame, frame + len);
+}
+
+const std::vector<uint8_t>& frame_record_writer::finish()
+{
+    size_t data_offset = FRAME_RECORD_BATCH_HEADER + d_headers.size();
+    d_message.resize(data_offset + d_data.size());
+    uint8_t* m = d_message.data();
+    put32(m + 0, FRAME_RECORD_MAGIC);
+    put16(m + 4, FRAME_RECORD_VERSION);
+    put16(m + 6, FRAME_RECORD_SIZE);
+    put32(m + 8, count());
+    put32(m + 12, data_offset);
+    if (!d_headers.empty()) {
+        memcpy(m + FRAME_RECORD_BATCH_HEADER, d_headers.data(), d_headers.size());
+    }
+    if (!d_data.empty()) memcpy(m + data_offset, d_data.data(), d_data.size());
+    return d_message;
+}
+
+void frame_record_writer::clear()
+{
+    d_headers.clear();
+    d_data.clear();
+}
+
+frame_record_reader::frame_record_reader()
+    : d_msg(nullptr), d_count(0), d_record_size(FRAME_RECORD_SIZE), d_data(nullptr), d_data_len(0)
+{
+}
+
+bool frame_record_reader::open(const uint8_t* msg, size_t len)
+{
+    d_count = 0;
+    if (len < FRAME_RECORD_BATCH_HEADER || get32(msg) != FRAME_RECORD_MAGIC) return false;
+    uint32_t version = get16(msg + 4);
+    size_t record_size = get16(msg + 6);
+    size_t count = get32(msg + 8);
+    size_t data_offset = get32(msg + 12);
+    if (version < 1 || record_size < FRAME_RECORD_SIZE || data_offset > len ||
+        data_offset < FRAME_RECORD_BATCH_HEADER ||
+        count > (data_offset - FRAME_RECORD_BATCH_HEADER) / record_size) {
+        return false;
+    }
+    d_msg = msg;
+    d_count = count;
+    d_record_size = record_size;
+    d_data = msg + data_offset;
+    d_data_len = len - data_offset;
+    return true;
+}
+
+const uint8_t* frame_record_reader::frame(size_t i, size_t& len) const
+{
+    frame_record_view r = record(i);
+    size_t off = r.data_offset();
+    len = r.frame_len();
+    if (off > d_data_len || len > d_data_len - off) return nullptr;
+    return d_data + off;
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,82 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "frame_record_zmq_sink_impl.h"
+#include <gnuradio/io_signature.h>
+#include <zmq.h>
+#include <iostream>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+frame_record_zmq_sink::sptr
+frame_record_zmq_sink::make(const std::string& address, bool bind, int hwm)
+{
+    return gnuradio::make_block_sptr<frame_record_zmq_sink_impl>(address, bind, hwm);
+}
+
+frame_record_zmq_sink_impl::frame_record_zmq_sink_impl(const std::string& address,
+                                                       bool bind,
+                                                       int hwm)
+    : gr::block("frame_record_zmq_sink",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_context(zmq_ctx_new()),
+      d_socket(nullptr)
+{
+    if (d_context) d_socket = zmq_socket(d_context, ZMQ_PUB);
+    if (!d_socket) {
+        if (d_context) zmq_ctx_term(d_context);
+        throw std::runtime_error("frame_record_zmq_sink: cannot create the ZMQ socket");
+    }
+
+    int linger = 0;
+    zmq_setsockopt(d_socket, ZMQ_LINGER, &linger, sizeof(linger));
+    if (hwm > 0) zmq_setsockopt(d_socket, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+
+    int rc = bind ? zmq_bind(d_socket, address.c_str()) : zmq_connect(d_socket, address.c_str());
+    if (rc != 0) {
+        std::string err = zmq_strerror(zmq_errno());
+        zmq_close(d_socket);
+        zmq_ctx_term(d_context);
+        throw std::runtime_error("frame_record_zmq_sink: " + address + ": " + err);
+    }
+
+    d_in_port = pmt::intern("records");
+    message_port_register_in(d_in_port);
+    set_msg_handler(d_in_port, [this](const pmt::pmt_t& msg) { handle_records(msg); });
+
+    std::cout << "[Record ZMQ Sink] " << (bind ? "Bound to " : "Connected to ") << address
+              << std::endl;
+}
+
+frame_record_zmq_sink_impl::~frame_record_zmq_sink_impl()
+{
+    zmq_close(d_socket);
+    zmq_ctx_term(d_context);
+}
+
+uint64_t frame_record_zmq_sink_impl::batches_sent() const { return d_sent.get(); }
+uint64_t frame_record_zmq_sink_impl::batches_dropped() const { return d_dropped.get(); }
+
+// Runs in the message handler thread only, which owns the socket.
+void frame_record_zmq_sink_impl::handle_records(const pmt::pmt_t& msg)
+{
+    pmt::pmt_t blob = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    if (!pmt::is_u8vector(blob)) {
+        d_dropped.add();
+        return;
+    }
+    size_t len = 0;
+    const uint8_t* data = pmt::u8vector_elements(blob, len);
+    if (zmq_send(d_socket, data, len, ZMQ_DONTWAIT) < 0) {
+        d_dropped.add();
+    } else {
+        d_sent.add();
+    }
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,35 @@
+#ifndef INCLUDED_ETHERNET_FRAME_RECORD_ZMQ_SINK_IMPL_H
+#define INCLUDED_ETHERNET_FRAME_RECORD_ZMQ_SINK_IMPL_H
+
+#include "block_stats.h"
+#include <gnuradio/ethernet/frame_record_zmq_sink.h>
+#include <pmt/pmt.h>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+class frame_record_zmq_sink_impl : public frame_record_zmq_sink
+{
+private:
+    pmt::pmt_t d_in_port;
+    void* d_context;
+    void* d_socket;
+
+    stat_counter d_sent;
+    stat_counter d_dropped;
+
+    void handle_records(const pmt::pmt_t& msg);
+
+public:
+    frame_record_zmq_sink_impl(const std::string& address, bool bind, int hwm);
+    ~frame_record_zmq_sink_impl();
+
+    uint64_t batches_sent() const override;
+    uint64_t batches_dropped() const override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef INCLUDED_ETHERNET_FRAME_RING_H
+#define INCLUDED_ETHERNET_FRAME_RING_H
+
+#include <gnuradio/ethernet/frame_record.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Fixed-depth ring of frame records for one writer and any number of
+ * readers, without locks. Each slot holds a record header (frame_record.h
+ * layout, data_offset unused) and the first snap_len bytes of the frame.
+ * Frames get consecutive ids from 1; frame id lives in slot (id - 1) %
+ * depth until it is overwritten depth frames later.
+ *
+ * Every slot has a sequence word (a seqlock): 0 while the writer fills
+ * it, then the id it holds. A reader checks the word before and after
+ * copying the slot and drops the copy when it changed, so a slow reader
+ * only ever loses frames that are already gone, it never sees a torn one.
+ */
+class frame_ring
+{
+public:
+    struct entry {
+        uint64_t id;
+        uint8_t header[FRAME_RECORD_SIZE];
+        uint16_t caplen;
+        const uint8_t* data; // into the caller's buffer, see read()
+    };
+
+    frame_ring(size_t depth, size_t snap_len)
+        : d_depth(std::max<size_t>(depth, 1)),
+          d_snap_len(snap_len),
+          d_slot_size(SLOT_HEADER + ((snap_len + 63) & ~(size_t)63)),
+          d_seq(new std::atomic<uint64_t>[d_depth]()),
+          d_slots(new uint8_t[d_depth * d_slot_size]),
+          d_last(0)
+    {
+    }
+
+    size_t depth() const { return d_depth; }
+    size_t snap_len() const { return d_snap_len; }
+
+    // Id of the newest frame, 0 when empty.
+    uint64_t last_id() const { return d_last.load(std::memory_order_acquire); }
+
+    // Oldest id still readable.
+    uint64_t first_id() const
+    {
+        uint64_t last = last_id();
+        return last > d_depth ? last - d_depth + 1 : 1;
+    }
+
+    // Writer only. Returns the id of the frame.
+    uint64_t push(const uint8_t* header, const uint8_t* frame, size_t len)
+    {
+        uint64_t id = d_last.load(std::memory_order_relaxed) + 1;
+        size_t i = (id - 1) % d_depth;
+        uint8_t* slot = d_slots.get() + i * d_slot_size;
+        uint16_t caplen = std::min(len, d_snap_len);
+
+        d_seq[i].store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(slot, header, FRAME_RECORD_SIZE);
+        memcpy(slot + FRAME_RECORD_SIZE, &caplen, sizeof(caplen));
+        memcpy(slot + SLOT_HEADER, frame, caplen);
+        d_seq[i].store(id, std::memory_order_release);
+        d_last.store(id, std::memory_order_release);
+        return id;
+    }
+
+    /*
+     * Copies frame id into e, its bytes into buf (snap_len bytes). Returns
+     * false when the frame was overwritten or is not written yet.
+     */
+    bool read(uint64_t id, entry& e, uint8_t* buf) const
+    {
+        if (id == 0) return false;
+        size_t i = (id - 1) % d_depth;
+        const uint8_t* slot = d_slots.get() + i * d_slot_size;
+        if (d_seq[i].load(std::memory_order_acquire) != id) return false;
+
+        memcpy(e.header, slot, FRAME_RECORD_SIZE);
+        memcpy(&e.caplen, slot + FRAME_RECORD_SIZE, sizeof(e.caplen));
+        e.caplen = std::min<size_t>(e.caplen, d_snap_len);
+        memcpy(buf, slot + SLOT_HEADER, e.caplen);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (d_seq[i].load(std::memory_order_relaxed) != id) return false;
+
+        e.id = id;
+        e.data = buf;
+        return true;
+    }
+
+private:
+    static const size_t SLOT_HEADER = 128; // record header + caplen, padded
+
+    size_t d_depth;
+    size_t d_snap_len;
+    size_t d_slot_size;
+    std::unique_ptr<std::atomic<uint64_t>[]> d_seq;
+    std::unique_ptr<uint8_t[]> d_slots;
+    std::atomic<uint64_t> d_last;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,491 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/frame_store.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+const size_t SEGMENT_ROWS = 65536;
+const size_t MIN_SEGMENT_BYTES = 64 * 1024;
+// Column bytes per frame: 5 u64, 1 u32, 6 u16, 2 u8 and two 16-byte addresses
+const size_t ROW_BYTES = 5 * 8 + 4 + 6 * 2 + 2 + 32;
+// One posting plus its share of a hash map node
+const size_t POSTING_BYTES = 4;
+const size_t KEY_BYTES = 64;
+
+enum index_kind { IDX_MAC, IDX_IP, IDX_PORT, IDX_ETHERTYPE, IDX_VLAN, IDX_COUNT };
+
+inline uint64_t mac48(const uint8_t* m)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 6; i++) v = (v << 8) | m[i];
+    return v;
+}
+
+inline uint64_t ip_key(const uint8_t* a)
+{
+    uint64_t hi, lo;
+    memcpy(&hi, a, 8);
+    memcpy(&lo, a + 8, 8);
+    return hi * 0x9E3779B97F4A7C15ULL ^ lo;
+}
+
+bool parse_mac(const std::string& s, uint64_t& mac)
+{
+    unsigned int b[6];
+    char sep[5];
+    char end;
+    if (sscanf(s.c_str(), "%2x%c%2x%c%2x%c%2x%c%2x%c%2x%c", &b[0], &sep[0], &b[1], &sep[1],
+               &b[2], &sep[2], &b[3], &sep[3], &b[4], &sep[4], &b[5], &end) != 11) {
+        return false;
+    }
+    mac = 0;
+    for (int i = 0; i < 6; i++) {
+        if (i < 5 && sep[i] != ':' && sep[i] != '-') return false;
+        mac = (mac << 8) | b[i];
+    }
+    return true;
+}
+
+// Address in the record layout: IPv4 in the first 4 bytes, zero padded
+bool parse_ip(const std::string& s, uint8_t addr[16], int& version)
+{
+    memset(addr, 0, 16);
+    if (inet_pton(AF_INET, s.c_str(), addr) == 1) {
+        version = 4;
+        return true;
+    }
+    if (inet_pton(AF_INET6, s.c_str(), addr) == 1) {
+        version = 6;
+        return true;
+    }
+    return false;
+}
+
+// A MAC stored by mac48()
+std::string fmt_mac(uint64_t m)
+{
+    uint8_t bytes[6];
+    for (int i = 5; i >= 0; i--, m >>= 8) bytes[i] = m & 0xFF;
+    return format_mac(bytes);
+}
+
+long parse_number(const std::string& key, const std::string& value, long lo, long hi)
+{
+    char* end = nullptr;
+    long v = strtol(value.c_str(), &end, 0);
+    if (value.empty() || *end != '\0' || v < lo || v > hi) {
+        throw std::invalid_argument("frame_store: bad " + key + " '" + value + "'");
+    }
+    return v;
+}
+
+int parse_tcp_flags(const std::string& value)
+{
+    static const struct {
+        const char* name;
+        int bit;
+    } names[] = { { "FIN", 0x01 }, { "SYN", 0x02 }, { "RST", 0x04 }, { "PSH", 0x08 },
+                  { "ACK", 0x10 }, { "URG", 0x20 }, { "ECE", 0x40 }, { "CWR", 0x80 } };
+    if (!value.empty() && isdigit((unsigned char)value[0])) {
+        return parse_number("tcp_flags", value, 0, 0xFF);
+    }
+    int flags = 0;
+    size_t pos = 0;
+    while (pos <= value.size()) {
+        size_t end = value.find_first_of(",|", pos);
+        if (end == std::string::npos) end = value.size();
+        std::string name = value.substr(pos, end - pos);
+        for (auto& c : name) c = toupper((unsigned char)c);
+        int bit = 0;
+        for (const auto& n : names) {
+            if (name == n.name) bit = n.bit;
+        }
+        if (!bit) throw std::invalid_argument("frame_store: unknown TCP flag '" + name + "'");
+        flags |= bit;
+        pos = end + 1;
+    }
+    return flags;
+}
+
+} // namespace
+
+struct frame_store::segment {
+    uint64_t first_id = 0;
+    uint64_t t_min = UINT64_MAX;
+    uint64_t t_max = 0;
+    size_t memory = 0;
+
+    std::vector<uint64_t> time_ns, frame_num, sample_offset, mac_src, mac_dst;
+    std::vector<uint32_t> data_offset;
+    std::vector<uint16_t> frame_len, flags, ethertype, vlan_tci, src_port, dst_port;
+    std::vector<uint8_t> ip_proto, tcp_flags;
+    std::vector<uint8_t> ip_src, ip_dst; // 16 bytes per frame
+    std::vector<uint8_t> bytes;
+
+    // key -> rows, ascending
+    std::unordered_map<uint64_t, std::vector<uint32_t>> index[IDX_COUNT];
+
+    size_t rows() const { return time_ns.size(); }
+
+    void post(int kind, uint64_t key, uint32_t row)
+    {
+        auto& list = index[kind][key];
+        if (!list.empty() && list.back() == row) return; // source == destination
+        if (list.empty()) memory += KEY_BYTES;
+        list.push_back(row);
+        memory += POSTING_BYTES;
+    }
+};
+
+namespace {
+
+// A query with its keys decoded, matched row by row against a segment
+struct matcher {
+    bool mac_set = false;
+    uint64_t mac = 0;
+    int ip_version = 0;
+    uint8_t ip[16];
+    int port = -1, ethertype = -1, vlan = -1, ip_proto = -1, tcp_flags = 0;
+    uint64_t t_from = 0;
+
+    explicit matcher(const frame_store::query& q)
+    {
+        if (!q.mac.empty()) {
+            if (!parse_mac(q.mac, mac)) {
+                throw std::invalid_argument("frame_store: bad MAC '" + q.mac + "'");
+            }
+            mac_set = true;
+        }
+        if (!q.ip.empty() && !parse_ip(q.ip, ip, ip_version)) {
+            throw std::invalid_argument("frame_store: bad IP address '" + q.ip + "'");
+        }
+        port = q.port;
+        ethertype = q.ethertype;
+        vlan = q.vlan;
+        ip_proto = q.ip_proto;
+        tcp_flags = q.tcp_flags;
+        if (q.last_s > 0) {
+            uint64_t now = frame_record_time_ns();
+            uint64_t span = (uint64_t)(q.last_s * 1e9);
+            t_from = span < now ? now - span : 0;
+        }
+    }
+
+    bool match(const frame_store::segment& s, size_t r) const
+    {
+        uint16_t f = s.flags[r];
+        if (s.time_ns[r] < t_from) return false;
+        if (mac_set && s.mac_src[r] != mac && s.mac_dst[r] != mac) return false;
+        if (ethertype >= 0 && s.ethertype[r] != ethertype) return false;
+        if (vlan >= 0 && (!(f & FRAME_RECORD_VLAN) || (s.vlan_tci[r] & 0x0FFF) != vlan)) {
+            return false;
+        }
+        bool is_ip = f & (FRAME_RECORD_IPV4 | FRAME_RECORD_IPV6);
+        if (ip_version) {
+            if ((ip_version == 4) != bool(f & FRAME_RECORD_IPV4) || !is_ip) return false;
+            if (memcmp(&s.ip_src[r * 16], ip, 16) && memcmp(&s.ip_dst[r * 16], ip, 16)) {
+                return false;
+            }
+        }
+        if (ip_proto >= 0 && (!is_ip || s.ip_proto[r] != ip_proto)) return false;
+        bool l4 = is_ip && (f & FRAME_RECORD_L4);
+        if (port >= 0) {
+            bool ports = l4 && (s.ip_proto[r] == 6 || s.ip_proto[r] == 17);
+            if (!ports || (s.src_port[r] != port && s.dst_port[r] != port)) return false;
+        }
+        if (tcp_flags) {
+            if (!l4 || s.ip_proto[r] != 6 || (s.tcp_flags[r] & tcp_flags) != tcp_flags) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Shortest posting list among the indexed fields of the query; false when
+    // no field is indexed, *rows null when one of them has no entry at all.
+    bool candidates(const frame_store::segment& s, const std::vector<uint32_t>** rows) const
+    {
+        bool indexed = false;
+        *rows = nullptr;
+        auto pick = [&](int kind, uint64_t key) {
+            auto it = s.index[kind].find(key);
+            const std::vector<uint32_t>* list = it == s.index[kind].end() ? nullptr : &it->second;
+            if (!indexed || (*rows && (!list || list->size() < (*rows)->size()))) *rows = list;
+            indexed = true;
+        };
+        if (mac_set) pick(IDX_MAC, mac);
+        if (ip_version) pick(IDX_IP, ip_key(ip));
+        if (port >= 0) pick(IDX_PORT, port);
+        if (ethertype >= 0) pick(IDX_ETHERTYPE, ethertype);
+        if (vlan >= 0) pick(IDX_VLAN, vlan);
+        return indexed;
+    }
+};
+
+} // namespace
+
+frame_store::query frame_store::query::parse(const std::string& text)
+{
+    query q;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find_first_of(" &", pos);
+        if (end == std::string::npos) end = text.size();
+        std::string kv = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (kv.empty()) continue;
+
+        size_t eq = kv.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("frame_store: expected key=value, got '" + kv + "'");
+        }
+        std::string key = kv.substr(0, eq);
+        std::string value = kv.substr(eq + 1);
+        std::string lower = value;
+        for (auto& c : lower) c = tolower((unsigned char)c);
+
+        if (key == "mac") {
+            uint64_t mac;
+            if (!parse_mac(value, mac)) {
+                throw std::invalid_argument("frame_store: bad MAC '" + value + "'");
+            }
+            q.mac = value;
+        } else if (key == "ip") {
+            uint8_t addr[16];
+            int version;
+            if (!parse_ip(value, addr, version)) {
+                throw std::invalid_argument("frame_store: bad IP address '" + value + "'");
+            }
+            q.ip = value;
+        } else if (key == "port") {
+            q.port = parse_number(key, value, 0, 0xFFFF);
+        } else if (key == "ethertype") {
+            q.ethertype = lower == "ipv4" ? 0x0800
+                          : lower == "ipv6" ? 0x86DD
+                          : lower == "arp" ? 0x0806
+                                           : parse_number(key, value, 0, 0xFFFF);
+        } else if (key == "vlan") {
+            q.vlan = parse_number(key, value, 0, 0x0FFF);
+        } else if (key == "proto") {
+            q.ip_proto = lower == "tcp" ? 6
+                         : lower == "udp" ? 17
+                         : lower == "icmp" ? 1
+                         : lower == "icmp6" ? 58
+                                            : parse_number(key, value, 0, 0xFF);
+        } else if (key == "tcp_flags") {
+            q.tcp_flags = parse_tcp_flags(value);
+        } else if (key == "last") {
+            char* e = nullptr;
+            q.last_s = strtod(value.c_str(), &e);
+            if (value.empty() || *e != '\0' || q.last_s < 0) {
+                throw std::invalid_argument("frame_store: bad last '" + value + "'");
+            }
+        } else if (key == "since") {
+            q.since_id = strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "limit") {
+            q.limit = parse_number(key, value, 1, 1L << 30);
+        } else {
+            throw std::invalid_argument("frame_store: unknown key '" + key + "'");
+        }
+    }
+    return q;
+}
+
+frame_store::frame_store(size_t budget_bytes)
+    : d_budget(budget_bytes),
+      d_segment_bytes(std::max(budget_bytes / 16, MIN_SEGMENT_BYTES)),
+      d_next_id(1),
+      d_memory(0)
+{
+}
+
+frame_store::~frame_store() {}
+
+void frame_store::add(const uint8_t* frame,
+                      size_t len,
+                      uint64_t frame_num,
+                      uint64_t sample_offset,
+                      bool fcs_ok)
+{
+    frame_record_writer writer;
+    writer.add(frame, len, frame_num, sample_offset, fcs_ok);
+    const std::vector<uint8_t>& batch = writer.finish();
+    add_records(batch.data(), batch.size());
+}
+
+bool frame_store::add_records(const uint8_t* msg, size_t len)
+{
+    frame_record_reader batch;
+    if (!batch.open(msg, len)) return false;
+    std::unique_lock<std::shared_mutex> lock(d_mutex);
+    for (size_t i = 0; i < batch.count(); i++) {
+        size_t frame_len;
+        const uint8_t* frame = batch.frame(i, frame_len);
+        if (frame) add_record(batch.header(i), frame);
+    }
+    evict();
+    return true;
+}
+
+void frame_store::add_record(const uint8_t* h, const uint8_t* frame)
+{
+    if (d_segments.empty() || d_segments.back()->rows() >= SEGMENT_ROWS ||
+        d_segments.back()->memory >= d_segment_bytes) {
+        d_segments.emplace_back(new segment);
+        d_segments.back()->first_id = d_next_id;
+    }
+    segment& s = *d_segments.back();
+    uint32_t row = s.rows();
+    size_t before = s.memory;
+
+    frame_record_view r(h);
+    uint64_t t = r.time_ns();
+    uint16_t len = r.frame_len();
+    s.time_ns.push_back(t);
+    s.frame_num.push_back(r.frame_num());
+    s.sample_offset.push_back(r.sample_offset());
+    s.mac_dst.push_back(mac48(r.mac_dst()));
+    s.mac_src.push_back(mac48(r.mac_src()));
+    s.data_offset.push_back(s.bytes.size());
+    s.frame_len.push_back(len);
+    s.flags.push_back(r.flags());
+    s.ethertype.push_back(r.ethertype());
+    s.vlan_tci.push_back(r.vlan_tci());
+    s.src_port.push_back(r.src_port());
+    s.dst_port.push_back(r.dst_port());
+    s.ip_proto.push_back(r.ip_proto());
+    s.tcp_flags.push_back(r.tcp_flags());
+    s.ip_src.insert(s.ip_src.end(), r.ip_src(), r.ip_src() + 16);
+    s.ip_dst.insert(s.ip_dst.end(), r.ip_dst(), r.ip_dst() + 16);
+    s.bytes.insert(s.bytes.end(), frame, frame + len);
+    s.t_min = std::min(s.t_min, t);
+    s.t_max = std::max(s.t_max, t);
+    s.memory += ROW_BYTES + len;
+
+    s.post(IDX_MAC, s.mac_src.back(), row);
+    s.post(IDX_MAC, s.mac_dst.back(), row);
+    s.post(IDX_ETHERTYPE, s.ethertype.back(), row);
+    if (r.has_vlan()) s.post(IDX_VLAN, r.vlan_id(), row);
+    if (r.ip_version()) {
+        s.post(IDX_IP, ip_key(r.ip_src()), row);
+        s.post(IDX_IP, ip_key(r.ip_dst()), row);
+        if (r.has_ports()) {
+            s.post(IDX_PORT, s.src_port.back(), row);
+            s.post(IDX_PORT, s.dst_port.back(), row);
+        }
+    }
+
+    d_memory += s.memory - before;
+    d_next_id++;
+}
+
+void frame_store::evict()
+{
+    // The segment being filled is kept even when it alone exceeds the budget
+    while (d_memory > d_budget && d_segments.size() > 1) {
+        d_memory -= d_segments.front()->memory;
+        d_segments.pop_front();
+    }
+}
+
+std::vector<frame_store::frame> frame_store::find(const query& q) const
+{
+    matcher m(q);
+    std::vector<frame> out;
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+
+    auto emit = [&](const segment& s, size_t r) {
+        frame f;
+        uint16_t flags = s.flags[r];
+        f.id = s.first_id + r;
+        f.time_ns = s.time_ns[r];
+        f.frame_num = s.frame_num[r];
+        f.sample_offset = s.sample_offset[r];
+        f.fcs_ok = flags & FRAME_RECORD_FCS_OK;
+        f.ethertype = s.ethertype[r];
+        f.vlan = (flags & FRAME_RECORD_VLAN) ? s.vlan_tci[r] & 0x0FFF : -1;
+        f.ip_version = (flags & FRAME_RECORD_IPV4) ? 4 : (flags & FRAME_RECORD_IPV6) ? 6 : 0;
+        f.ip_proto = f.ip_version ? s.ip_proto[r] : -1;
+        bool ports = f.ip_version && (flags & FRAME_RECORD_L4) &&
+                     (f.ip_proto == 6 || f.ip_proto == 17);
+        f.src_port = ports ? s.src_port[r] : -1;
+        f.dst_port = ports ? s.dst_port[r] : -1;
+        f.tcp_flags = ports && f.ip_proto == 6 ? s.tcp_flags[r] : 0;
+        f.mac_src = fmt_mac(s.mac_src[r]);
+        f.mac_dst = fmt_mac(s.mac_dst[r]);
+        f.ip_src = format_ip(f.ip_version, &s.ip_src[r * 16]);
+        f.ip_dst = format_ip(f.ip_version, &s.ip_dst[r * 16]);
+        const uint8_t* p = s.bytes.data() + s.data_offset[r];
+        f.data.assign(p, p + s.frame_len[r]);
+        out.push_back(std::move(f));
+    };
+
+    // Newest segment first, newest row first, until limit matches
+    for (auto it = d_segments.rbegin(); it != d_segments.rend() && out.size() < q.limit; ++it) {
+        const segment& s = **it;
+        if (s.rows() == 0 || s.t_max < m.t_from) continue;
+        if (s.first_id + s.rows() - 1 <= q.since_id) break;
+        size_t first_row = q.since_id >= s.first_id ? q.since_id - s.first_id + 1 : 0;
+
+        const std::vector<uint32_t>* rows;
+        if (m.candidates(s, &rows)) {
+            if (!rows) continue;
+            for (auto r = rows->rbegin(); r != rows->rend() && out.size() < q.limit; ++r) {
+                if (*r < first_row) break;
+                if (m.match(s, *r)) emit(s, *r);
+            }
+        } else {
+            // Column scan: test the single-column predicates before the rest
+            const uint8_t* flags = s.tcp_flags.data();
+            const uint8_t* proto = s.ip_proto.data();
+            for (size_t r = s.rows(); r > first_row && out.size() < q.limit; r--) {
+                if (m.tcp_flags && (flags[r - 1] & m.tcp_flags) != m.tcp_flags) continue;
+                if (m.ip_proto >= 0 && proto[r - 1] != m.ip_proto) continue;
+                if (m.match(s, r - 1)) emit(s, r - 1);
+            }
+        }
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+size_t frame_store::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+    return d_segments.empty() ? 0 : d_next_id - d_segments.front()->first_id;
+}
+
+uint64_t frame_store::first_id() const
+{
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+    return d_segments.empty() ? d_next_id : d_segments.front()->first_id;
+}
+
+uint64_t frame_store::last_id() const
+{
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+    return d_next_id - 1;
+}
+
+size_t frame_store::memory_used() const
+{
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+    return d_memory;
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,109 @@
+#ifndef INCLUDED_ETHERNET_FRAME_STREAM_H
+#define INCLUDED_ETHERNET_FRAME_STREAM_H
+
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Decoded frames waiting for a decoder's byte output. The frames are
+ * written back to back, and the first byte of each gets a length tag, as
+ * tagged_stream_blocks expect, plus sample_offset (uint64), fcs_ok (bool)
+ * and lane (long) tags. A frame that does not fit in the output buffer
+ * goes on in the next call. Both buffers keep their capacity: once the
+ * largest backlog has been seen, queueing a frame allocates nothing.
+ */
+class frame_stream
+{
+public:
+    explicit frame_stream(const std::string& len_tag_key)
+        : d_len_key(pmt::intern(len_tag_key)),
+          d_offset_key(pmt::intern("sample_offset")),
+          d_fcs_key(pmt::intern("fcs_ok")),
+          d_lane_key(pmt::intern("lane")),
+          d_head(0),
+          d_read(0),
+          d_pos(0)
+    {
+    }
+
+    bool empty() const { return d_head == d_frames.size(); }
+
+    void add(const uint8_t* data, size_t len, uint64_t sample_offset, bool fcs_ok, uint8_t lane = 0)
+    {
+        if (len == 0) return;
+        d_bytes.insert(d_bytes.end(), data, data + len);
+        d_frames.push_back({ len, sample_offset, fcs_ok, lane });
+    }
+
+    /*
+     * Copies queued bytes to out, at most noutput_items, and returns their
+     * number. tag(offset, key, value) is called for the tags of each frame
+     * whose first byte is written, offset being nitems_written + its
+     * index in out.
+     */
+    template <typename F>
+    int write(uint8_t* out, int noutput_items, uint64_t nitems_written, F&& tag)
+    {
+        size_t produced = 0;
+        size_t room = noutput_items;
+        while (d_head < d_frames.size() && produced < room) {
+            const entry& f = d_frames[d_head];
+            if (d_pos == 0) {
+                uint64_t offset = nitems_written + produced;
+                tag(offset, d_len_key, pmt::from_long(f.len));
+                tag(offset, d_offset_key, pmt::from_uint64(f.sample_offset));
+                tag(offset, d_fcs_key, pmt::from_bool(f.fcs_ok));
+                tag(offset, d_lane_key, pmt::from_long(f.lane));
+            }
+            size_t n = std::min(f.len - d_pos, room - produced);
+            memcpy(out + produced, d_bytes.data() + d_read + d_pos, n);
+            produced += n;
+            d_pos += n;
+            if (d_pos < f.len) break;
+            d_read += f.len;
+            d_pos = 0;
+            d_head++;
+        }
+        if (empty()) clear();
+        return produced;
+    }
+
+    void clear()
+    {
+        d_bytes.clear();
+        d_frames.clear();
+        d_head = 0;
+        d_read = 0;
+        d_pos = 0;
+    }
+
+private:
+    struct entry {
+        size_t len;
+        uint64_t sample_offset;
+        bool fcs_ok;
+        uint8_t lane;
+    };
+
+    const pmt::pmt_t d_len_key;
+    const pmt::pmt_t d_offset_key;
+    const pmt::pmt_t d_fcs_key;
+    const pmt::pmt_t d_lane_key;
+    std::vector<uint8_t> d_bytes;
+    std::vector<entry> d_frames;
+    size_t d_head; // first frame not fully written
+    size_t d_read; // its first byte in d_bytes
+    size_t d_pos;  // its bytes already written
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef INCLUDED_ETHERNET_FRAMER_4B5B_H
+#define INCLUDED_ETHERNET_FRAMER_4B5B_H
+
+#include "jk_scanner.h"
+#include <gnuradio/ethernet/line_coding.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * fastethernet_frame_decoder's framing of descrambled bits, shared with
+ * decode_4b5b() and the lanes. Between frames, jk_scanner finds IDLE,
+ * /J/K/ and the first preamble code-groups; the frame's bits are then kept
+ * as '0' and '1' characters until /T/R/ and IDLE end it on a code-group
+ * boundary, or dropped after MAX_BITS bits without an end. Offsets count
+ * the bits given to process() since construction.
+ *
+ * process() reports to a handler h:
+ *   h.frame_start(offset)        a frame starts, offset is its /J/
+ *   h.frame_end(groups, offset)  the frame ended on bit offset; groups are
+ *                                its code-groups between /J/K/ and /T/R/,
+ *                                empty when they could not be found
+ *   h.frame_timeout()            a frame was dropped
+ */
+class framer_4b5b
+{
+public:
+    static const size_t MAX_BITS = 30000;
+
+    framer_4b5b() : d_in_frame(false), d_frame_bits(0), d_pos(0), d_start(0)
+    {
+        d_bits.reserve(MAX_BITS + 256);
+    }
+
+    template <typename H>
+    void process(const uint8_t* bits, size_t n, H& h)
+    {
+        for (size_t i = 0; i < n; i++) {
+            // Between frames the scanner takes the bits up to the end of /J/K/
+            // and the first preamble symbols, or all of them
+            if (!d_in_frame) {
+                i += d_jk.scan(bits + i, n - i) - 1;
+                if (d_jk.found()) {
+                    d_in_frame = true;
+                    d_frame_bits = 0;
+                    d_bits.clear();
+                    size_t k = d_jk.frame_bits(d_bits);
+                    // The bits start with IDLE /J/K/; input i is their last so far
+                    d_start = d_pos + i - (k - 1) + (START.length() - 10);
+                    h.frame_start(d_start);
+                }
+                continue;
+            }
+
+            d_bits += (bits[i] & 1) ? '1' : '0';
+            d_frame_bits++;
+
+            // The first bit looks at all the bits the frame started with;
+            // after it, an end not found yet can only end on the new bit.
+            // It starts on a code-group boundary (the bits start with /J/K/)
+            size_t pos = std::string::npos;
+            if (d_frame_bits == 1) {
+                pos = find_code_groups(d_bits, END);
+            } else if ((d_bits.length() - END.length()) % 5 == 0 &&
+                       d_bits.compare(d_bits.length() - END.length(), END.length(), END) == 0) {
+                pos = d_bits.length() - END.length();
+            }
+
+            if (pos != std::string::npos) {
+                h.frame_end(code_groups(std::string_view(d_bits).substr(0, pos + END.length())),
+                            d_pos + i);
+                reset();
+            } else if (d_frame_bits >= MAX_BITS) {
+                h.frame_timeout();
+                reset();
+            }
+        }
+        d_pos += n;
+    }
+
+    // No frame reported later starts before this position
+    uint64_t next_start() const
+    {
+        if (d_in_frame) return d_start;
+        // The scanner starts a frame at most WINDOW bits back
+        return d_pos < jk_scanner::WINDOW ? 0 : d_pos - jk_scanner::WINDOW;
+    }
+
+private:
+    // IDLE /J/K/, and /T/R/ IDLE
+    static constexpr std::string_view START = "111111100010001";
+    static constexpr std::string_view END = "011010011111111";
+
+    jk_scanner d_jk;
+    // Keeps its capacity: the bit loop does not allocate
+    std::string d_bits;
+    bool d_in_frame;
+    size_t d_frame_bits;
+    uint64_t d_pos;
+    uint64_t d_start;
+
+    void reset()
+    {
+        d_jk.reset();
+        d_bits.clear();
+        d_in_frame = false;
+        d_frame_bits = 0;
+    }
+
+    // First match of marker that starts on a code-group boundary, counted
+    // from the start of bits; frame data can hold the same bits at other
+    // offsets
+    static size_t find_code_groups(std::string_view bits, std::string_view marker)
+    {
+        size_t pos = bits.find(marker);
+        while (pos != std::string::npos && pos % 5 != 0) {
+            pos = bits.find(marker, pos + 1);
+        }
+        return pos;
+    }
+
+    // The code-groups between the first /J/K/ and the /T/R/ after it
+    static std::string_view code_groups(std::string_view bits)
+    {
+        size_t start = bits.find(START);
+        if (start == std::string::npos) return std::string_view();
+        size_t end = find_code_groups(bits.substr(start), END);
+        if (end == std::string::npos || end < START.length() + 5) return std::string_view();
+        return bits.substr(start + START.length(), end - START.length());
+    }
+};
+
+/*
+ * Code-groups between /J/K/ and /T/R/ to the frame bytes, from the
+ * destination MAC: the first nibble of a byte is its low one, /J/K/T/R/
+ * are skipped, other code-groups that are not data are counted in
+ * violations and skipped, and the preamble and SFD dropped. Returns the
+ * frame length, 0 when the preamble, SFD and Ethernet header are not all
+ * there or the frame is longer than cap.
+ */
+inline size_t decode_code_groups(std::string_view groups,
+                                 uint8_t* out,
+                                 size_t cap,
+                                 uint64_t& violations)
+{
+    // Preamble and SFD bytes before the destination MAC, and the shortest
+    // frame decoded
+    const size_t PREAMBLE = 7;
+    const size_t MIN_BYTES = PREAMBLE + 14;
+    enum { INVALID = -1, CONTROL = 16 };
+    static const struct table {
+        int8_t entries[32];
+        table()
+        {
+            for (int i = 0; i < 32; i++) entries[i] = INVALID;
+            for (int i = 0; i < 16; i++) entries[FIVEB_CODES[i]] = i;
+            entries[FIVEB_J] = CONTROL;
+            entries[FIVEB_K] = CONTROL;
+            entries[FIVEB_T] = CONTROL;
+            entries[FIVEB_R] = CONTROL;
+        }
+    } codes;
+
+    size_t nibbles = 0;
+    size_t bytes = 0;
+    uint8_t low = 0;
+    for (size_t i = 0; i + 5 <= groups.length(); i += 5) {
+        int code = 0;
+        for (size_t b = i; b < i + 5; b++) code = (code << 1) | (groups[b] == '1');
+        int nibble = codes.entries[code];
+        if (nibble == INVALID) {
+            violations++;
+        } else if (nibble != CONTROL) {
+            if (nibbles++ & 1) {
+                if (bytes >= PREAMBLE && bytes - PREAMBLE < cap) {
+                    out[bytes - PREAMBLE] = (nibble << 4) | low;
+                }
+                bytes++;
+            } else {
+                low = nibble;
+            }
+        }
+    }
+    if (bytes < MIN_BYTES || bytes - PREAMBLE > cap) return 0;
+    return bytes - PREAMBLE;
+}
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
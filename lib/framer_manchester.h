@@ -0,0 +1,102 @@
+#ifndef INCLUDED_ETHERNET_FRAMER_MANCHESTER_H
+#define INCLUDED_ETHERNET_FRAMER_MANCHESTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * ethernet_10baset_decoder's framing of the half-bits after an SFD, shared
+ * with decode_10baset() and the lanes. A frame starts at an SFD, which
+ * also ends the frame in progress, and ends when the line goes quiet after
+ * TP_IDL (two half-bit pairs without a transition) or after
+ * MAX_FRAME_BYTES bytes.
+ */
+class framer_manchester
+{
+public:
+    // Longest frame kept: 1522 bytes (VLAN tagged) plus some margin
+    static const size_t MAX_FRAME_BYTES = 1530;
+
+    framer_manchester() : d_in_frame(false), d_start(0) { d_halfbits.reserve(MAX_HALFBITS); }
+
+    bool in_frame() const { return d_in_frame; }
+    // Offset of the first half-bit after the SFD
+    uint64_t start() const { return d_start; }
+
+    void begin(uint64_t offset)
+    {
+        d_in_frame = true;
+        d_start = offset;
+        d_halfbits.clear();
+    }
+
+    // Takes the next half-bit of the frame; true when the frame ends on it.
+    bool push(uint8_t halfbit)
+    {
+        d_halfbits.push_back(halfbit & 1);
+        return end_of_frame() || d_halfbits.size() >= MAX_HALFBITS;
+    }
+
+    /*
+     * Ends the frame and writes its bytes to out, which holds at least
+     * MAX_FRAME_BYTES. Returns their number, 0 when the frame is too short
+     * for an Ethernet header.
+     */
+    size_t finish(uint8_t* out)
+    {
+        d_in_frame = false;
+        if (d_halfbits.size() < MIN_BYTES * 8 * 2) return 0;
+        size_t len = to_bytes(out);
+        return len < MIN_BYTES ? 0 : len;
+    }
+
+private:
+    static const size_t MIN_BYTES = 14;
+    static const size_t MAX_HALFBITS = MAX_FRAME_BYTES * 8 * 2;
+
+    bool d_in_frame;
+    uint64_t d_start;
+    std::vector<uint8_t> d_halfbits;
+
+    // The line goes quiet after TP_IDL: two half-bit pairs without a
+    // transition, dropped from the frame.
+    bool end_of_frame()
+    {
+        size_t n = d_halfbits.size();
+        if (n < 4 || (n & 1)) return false;
+        if (d_halfbits[n - 4] != d_halfbits[n - 3] || d_halfbits[n - 2] != d_halfbits[n - 1]) {
+            return false;
+        }
+        d_halfbits.resize(n - 4);
+        return true;
+    }
+
+    // Manchester pairs to bytes, LSB first (01 = 1, 10 = 0, other pairs skipped).
+    size_t to_bytes(uint8_t* out) const
+    {
+        size_t len = 0;
+        uint8_t byte = 0;
+        int nbits = 0;
+        for (size_t i = 0; i + 1 < d_halfbits.size() && len < MAX_FRAME_BYTES; i += 2) {
+            uint8_t a = d_halfbits[i];
+            uint8_t b = d_halfbits[i + 1];
+            if (a == b) continue;
+            byte |= b << nbits;
+            if (++nbits == 8) {
+                out[len++] = byte;
+                byte = 0;
+                nbits = 0;
+            }
+        }
+        return len;
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
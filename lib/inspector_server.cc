@@ -0,0 +1,347 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "inspector_server.h"
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+const size_t DEFAULT_LIMIT = 500;
+const size_t MAX_LIMIT = 10000;
+const auto WS_PERIOD = std::chrono::milliseconds(100);
+
+std::string url_decode(const std::string& s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < s.size() && isxdigit((unsigned char)s[i + 1]) &&
+                   isxdigit((unsigned char)s[i + 2])) {
+            out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+// Splits a request target into its path and decoded query parameters.
+std::string parse_target(beast::string_view target, std::map<std::string, std::string>& params)
+{
+    std::string t(target);
+    size_t q = t.find('?');
+    if (q == std::string::npos) return t;
+    std::string query = t.substr(q + 1);
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t amp = query.find('&', pos);
+        if (amp == std::string::npos) amp = query.size();
+        std::string kv = query.substr(pos, amp - pos);
+        size_t eq = kv.find('=');
+        if (!kv.empty()) {
+            params[url_decode(kv.substr(0, eq))] =
+                eq == std::string::npos ? "" : url_decode(kv.substr(eq + 1));
+        }
+        pos = amp + 1;
+    }
+    return t.substr(0, q);
+}
+
+std::string json_string(const std::string& s)
+{
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Query parameters shared by /api/frames and /ws; throws on a bad filter.
+inspector_backend::query make_query(const std::map<std::string, std::string>& params)
+{
+    inspector_backend::query q = { 0, true, DEFAULT_LIMIT, nullptr, false };
+    auto it = params.find("since");
+    if (it != params.end() && !it->second.empty()) {
+        q.since = strtoull(it->second.c_str(), nullptr, 10);
+        q.newest = false;
+    }
+    it = params.find("limit");
+    if (it != params.end() && !it->second.empty()) {
+        long n = strtol(it->second.c_str(), nullptr, 10);
+        q.limit = n < 1 ? 1 : std::min<size_t>(n, MAX_LIMIT);
+    }
+    it = params.find("filter");
+    if (it != params.end()) q.filter = frame_filter::compile(it->second);
+    return q;
+}
+
+std::string page_json(const inspector_backend::page& p)
+{
+    return "{\"first_id\":" + std::to_string(p.first) + ",\"last_id\":" + std::to_string(p.last) +
+           ",\"next\":" + std::to_string(p.next) + ",\"frames\":" + p.json + "}";
+}
+
+} // namespace
+
+class inspector_server::impl
+{
+public:
+    impl(inspector_backend& backend, const std::string& address, int port, const std::string& html)
+        : d_backend(backend), d_html(html), d_acceptor(d_ioc)
+    {
+        tcp::endpoint ep(net::ip::make_address(address), port);
+        d_acceptor.open(ep.protocol());
+        d_acceptor.set_option(net::socket_base::reuse_address(true));
+        d_acceptor.bind(ep);
+        d_acceptor.listen();
+        accept();
+    }
+
+    net::io_context d_ioc;
+    inspector_backend& d_backend;
+    std::string d_html;
+    tcp::acceptor d_acceptor;
+
+    void accept();
+    http::response<http::string_body> handle(const http::request<http::string_body>& req);
+};
+
+namespace {
+
+class ws_session : public std::enable_shared_from_this<ws_session>
+{
+public:
+    ws_session(tcp::socket&& socket, inspector_server::impl& server)
+        : d_ws(std::move(socket)), d_timer(d_ws.get_executor()), d_server(server)
+    {
+    }
+
+    void run(http::request<http::string_body> req)
+    {
+        std::map<std::string, std::string> params;
+        parse_target(req.target(), params);
+        try {
+            d_query = make_query(params);
+        } catch (const std::invalid_argument& e) {
+            d_error = e.what();
+        }
+        d_ws.async_accept(req,
+                          beast::bind_front_handler(&ws_session::on_accept, shared_from_this()));
+    }
+
+private:
+    websocket::stream<beast::tcp_stream> d_ws;
+    net::steady_timer d_timer;
+    inspector_server::impl& d_server;
+    inspector_backend::query d_query;
+    std::string d_error;
+    std::string d_out;
+    beast::flat_buffer d_in;
+
+    void on_accept(beast::error_code ec)
+    {
+        if (ec) return;
+        d_ws.text(true);
+        d_ws.auto_fragment(false);
+        if (!d_error.empty()) {
+            d_out = "{\"error\":" + json_string(d_error) + "}";
+            d_ws.async_write(net::buffer(d_out), [self = shared_from_this()](beast::error_code, size_t) {
+                self->d_ws.async_close(websocket::close_code::policy_error,
+                                       [self](beast::error_code) {});
+            });
+            return;
+        }
+        read();
+        push();
+    }
+
+    // Client messages are ignored; a read error means the client left.
+    void read()
+    {
+        d_ws.async_read(d_in, [self = shared_from_this()](beast::error_code ec, size_t) {
+            if (ec) {
+                self->d_timer.cancel();
+                return;
+            }
+            self->d_in.consume(self->d_in.size());
+            self->read();
+        });
+    }
+
+    void push()
+    {
+        inspector_backend::page p = d_server.d_backend.frames(d_query);
+        d_query.newest = false;
+        d_query.since = p.next;
+        if (p.count == 0) {
+            wait();
+            return;
+        }
+        d_out = page_json(p);
+        d_ws.async_write(net::buffer(d_out),
+                         [self = shared_from_this()](beast::error_code ec, size_t) {
+                             if (!ec) self->wait();
+                         });
+    }
+
+    void wait()
+    {
+        d_timer.expires_after(WS_PERIOD);
+        d_timer.async_wait([self = shared_from_this()](beast::error_code ec) {
+            if (!ec) self->push();
+        });
+    }
+};
+
+class http_session : public std::enable_shared_from_this<http_session>
+{
+public:
+    http_session(tcp::socket&& socket, inspector_server::impl& server)
+        : d_stream(std::move(socket)), d_server(server)
+    {
+    }
+
+    void read()
+    {
+        d_req = {};
+        d_stream.expires_after(std::chrono::seconds(30));
+        http::async_read(d_stream, d_buffer, d_req,
+                         beast::bind_front_handler(&http_session::on_read, shared_from_this()));
+    }
+
+private:
+    beast::tcp_stream d_stream;
+    beast::flat_buffer d_buffer;
+    http::request<http::string_body> d_req;
+    inspector_server::impl& d_server;
+
+    void on_read(beast::error_code ec, size_t)
+    {
+        if (ec) {
+            d_stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+            return;
+        }
+        if (websocket::is_upgrade(d_req)) {
+            d_stream.expires_never();
+            std::make_shared<ws_session>(d_stream.release_socket(), d_server)
+                ->run(std::move(d_req));
+            return;
+        }
+        auto res = std::make_shared<http::response<http::string_body>>(d_server.handle(d_req));
+        http::async_write(d_stream, *res,
+                          [self = shared_from_this(), res](beast::error_code ec, size_t) {
+                              if (ec || res->need_eof()) {
+                                  self->d_stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+                                  return;
+                              }
+                              self->read();
+                          });
+    }
+};
+
+} // namespace
+
+void inspector_server::impl::accept()
+{
+    d_acceptor.async_accept(d_ioc, [this](beast::error_code ec, tcp::socket socket) {
+        if (ec == net::error::operation_aborted) return;
+        if (!ec) std::make_shared<http_session>(std::move(socket), *this)->read();
+        accept();
+    });
+}
+
+http::response<http::string_body>
+inspector_server::impl::handle(const http::request<http::string_body>& req)
+{
+    std::map<std::string, std::string> params;
+    std::string path = parse_target(req.target(), params);
+
+    http::response<http::string_body> res(http::status::ok, req.version());
+    res.set(http::field::server, "gr-ethernet inspector");
+    res.set(http::field::content_type, "application/json");
+    res.set(http::field::cache_control, "no-store");
+    res.keep_alive(req.keep_alive());
+
+    try {
+        if (req.method() == http::verb::get && path == "/") {
+            res.set(http::field::content_type, "text/html; charset=utf-8");
+            res.body() = d_html;
+        } else if (req.method() == http::verb::get && path == "/api/frames") {
+            res.body() = page_json(d_backend.frames(make_query(params)));
+        } else if (req.method() == http::verb::get && path == "/api/query") {
+            std::string text;
+            for (const auto& kv : params) text += kv.first + "=" + kv.second + "&";
+            res.body() = d_backend.store_json(text);
+        } else if (req.method() == http::verb::get && path == "/api/status") {
+            res.body() = d_backend.status_json();
+        } else if (req.method() == http::verb::get && path == "/data") {
+            inspector_backend::query q = { 0, true, DEFAULT_LIMIT, nullptr, true };
+            res.body() = d_backend.frames(q).json;
+        } else if (req.method() == http::verb::post && path == "/clear") {
+            d_backend.clear();
+            res.body() = "{\"success\":true}";
+        } else {
+            res.result(http::status::not_found);
+            res.body() = "{\"error\":\"not found\"}";
+        }
+    } catch (const std::invalid_argument& e) {
+        res.result(http::status::bad_request);
+        res.body() = "{\"error\":" + json_string(e.what()) + "}";
+    }
+    res.prepare_payload();
+    return res;
+}
+
+inspector_server::inspector_server(inspector_backend& backend,
+                                   const std::string& address,
+                                   int port,
+                                   const std::string& html)
+{
+    try {
+        d_impl.reset(new impl(backend, address, port, html));
+    } catch (const boost::system::system_error& e) {
+        throw std::runtime_error("inspector: cannot listen on " + address + ":" +
+                                 std::to_string(port) + ": " + e.what());
+    }
+    d_thread = std::thread([this] { d_impl->d_ioc.run(); });
+}
+
+inspector_server::~inspector_server()
+{
+    d_impl->d_ioc.stop();
+    d_thread.join();
+}
+
+int inspector_server::port() const { return d_impl->d_acceptor.local_endpoint().port(); }
+
+} // namespace ethernet
+} // namespace gr
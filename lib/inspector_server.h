@@ -0,0 +1,67 @@
+#ifndef INCLUDED_ETHERNET_INSPECTOR_SERVER_H
+#define INCLUDED_ETHERNET_INSPECTOR_SERVER_H
+
+#include <gnuradio/ethernet/frame_filter.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace gr {
+namespace ethernet {
+
+// Frame store behind the server, called from the server thread.
+class inspector_backend
+{
+public:
+    struct query {
+        uint64_t since;   // frames with a larger id
+        bool newest;      // no since: the newest frames
+        size_t limit;
+        frame_filter::sptr filter;
+        bool reverse;     // newest first
+    };
+
+    struct page {
+        std::string json; // JSON array of frames
+        size_t count;
+        uint64_t first;   // oldest id still stored
+        uint64_t last;    // newest id
+        uint64_t next;    // since of the next incremental query
+    };
+
+    virtual ~inspector_backend() {}
+    virtual page frames(const query& q) = 0;
+    // frame_store::query::parse text; throws std::invalid_argument
+    virtual std::string store_json(const std::string& query) = 0;
+    virtual std::string status_json() = 0;
+    virtual void clear() = 0;
+};
+
+/*
+ * HTTP and WebSocket front of the inspector sink (Boost.Beast), on one
+ * io_context thread. Binds in the constructor (throws on failure) and
+ * serves until destruction.
+ */
+class inspector_server
+{
+public:
+    inspector_server(inspector_backend& backend,
+                     const std::string& address,
+                     int port,
+                     const std::string& html);
+    ~inspector_server();
+
+    int port() const;
+
+    class impl;
+
+private:
+    std::unique_ptr<impl> d_impl;
+    std::thread d_thread;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,317 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "inspector_sink_impl.h"
+#include "frame_input.h"
+#include "inspector_html.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+// Frames examined per query at most, so a rare filter cannot stall the server
+const uint64_t MAX_SCAN = 1 << 20;
+
+const char* ethertype_name(uint32_t t)
+{
+    switch (t) {
+    case 0x0800: return "IPv4";
+    case 0x0806: return "ARP";
+    case 0x86DD: return "IPv6";
+    case 0x8100: return "802.1Q VLAN";
+    case 0x8847: return "MPLS unicast";
+    case 0x8848: return "MPLS multicast";
+    default: return nullptr;
+    }
+}
+
+std::string l4_name(int proto)
+{
+    switch (proto) {
+    case 1: return "ICMP";
+    case 6: return "TCP";
+    case 17: return "UDP";
+    default: return "Proto " + std::to_string(proto);
+    }
+}
+
+void add_field(std::string& out, const char* key, const std::string& value)
+{
+    out += '"';
+    out += key;
+    out += "\":\"";
+    out += value; // only generated text: no escaping needed
+    out += "\",";
+}
+
+void add_field(std::string& out, const char* key, int64_t value)
+{
+    out += '"';
+    out += key;
+    out += "\":";
+    out += std::to_string(value);
+    out += ',';
+}
+
+} // namespace
+
+inspector_sink::sptr
+inspector_sink::make(
+    int depth, int snap_len, const std::string& address, int port, int store_mb)
+{
+    return gnuradio::make_block_sptr<inspector_sink_impl>(
+        depth, snap_len, address, port, store_mb);
+}
+
+inspector_sink_impl::inspector_sink_impl(int depth,
+                                         int snap_len,
+                                         const std::string& address,
+                                         int port,
+                                         int store_mb)
+    : gr::block("inspector_sink", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+      d_ring(depth > 0 ? depth : 1, std::max(snap_len, 64)),
+      d_cleared(0)
+{
+    d_in_port = pmt::intern("frames");
+    message_port_register_in(d_in_port);
+    set_msg_handler(d_in_port, [this](const pmt::pmt_t& msg) { handle_frames(msg); });
+
+    if (store_mb > 0) d_store = std::make_shared<frame_store>((size_t)store_mb << 20);
+
+    d_server.reset(new inspector_server(*this, address, port, INSPECTOR_HTML));
+    std::cout << "[Inspector] " << d_ring.depth() << " frames";
+    if (d_store) std::cout << ", " << store_mb << " MiB store";
+    std::cout << ", http://" << address << ":" << d_server->port() << "/" << std::endl;
+}
+
+inspector_sink_impl::~inspector_sink_impl() {}
+
+uint64_t inspector_sink_impl::frames_received() const { return d_received.get(); }
+uint64_t inspector_sink_impl::messages_ignored() const { return d_ignored.get(); }
+
+void inspector_sink_impl::handle_frames(const pmt::pmt_t& msg)
+{
+    bool ok = read_frames(msg, d_writer, [this](const uint8_t* data, size_t len) {
+        return add_records(data, len);
+    });
+    if (!ok) d_ignored.add();
+}
+
+bool inspector_sink_impl::add_records(const uint8_t* msg, size_t len)
+{
+    frame_record_reader batch;
+    if (!batch.open(msg, len)) return false;
+    for (size_t i = 0; i < batch.count(); i++) {
+        size_t frame_len;
+        const uint8_t* frame = batch.frame(i, frame_len);
+        if (!frame) continue;
+        d_ring.push(batch.header(i), frame, frame_len);
+        d_received.add();
+    }
+    if (d_store) d_store->add_records(msg, len);
+    return true;
+}
+
+void inspector_sink_impl::append_json(std::string& out, const frame_ring::entry& e)
+{
+    frame_record_view r(e.header);
+    uint32_t frame_len = r.frame_len();
+    uint32_t eth = r.ethertype();
+    uint32_t l4_offset = r.l4_offset();
+    int ip_proto = r.ip_proto();
+
+    char buf[64];
+    time_t secs = r.time_ns() / 1000000000ULL;
+    struct tm tm;
+    localtime_r(&secs, &tm);
+    strftime(buf, sizeof(buf), "%H:%M:%S", &tm);
+    std::string timestamp = buf;
+
+    const char* known = ethertype_name(eth);
+    if (known) {
+        snprintf(buf, sizeof(buf), "%s", known);
+    } else if (eth < 0x0600) {
+        snprintf(buf, sizeof(buf), "Length (%u)", eth);
+    } else {
+        snprintf(buf, sizeof(buf), "0x%04x", eth);
+    }
+    std::string eth_name = buf;
+    snprintf(buf, sizeof(buf), "0x%04x", eth);
+    std::string eth_hex = buf;
+
+    int ip_version = r.ip_version();
+    std::string ip_src, ip_dst, l4, info, tcp_flags, preview;
+    bool ports = r.has_ports();
+    bool icmp = r.is_icmp();
+    if (eth == 0x0806) info = "ARP";
+    if (ip_version) {
+        ip_src = format_ip(ip_version, r.ip_src());
+        ip_dst = format_ip(ip_version, r.ip_dst());
+        l4 = l4_name(ip_proto);
+        if (ports) {
+            info = ip_src + ":" + std::to_string(r.src_port()) + " -> " + ip_dst + ":" +
+                   std::to_string(r.dst_port()) + " (" + l4 + ")";
+            if (r.is_tcp()) tcp_flags = tcp_flags_string(r.tcp_flags());
+            size_t hdr = 8;
+            if (ip_proto == 6) {
+                hdr = l4_offset + 12 < e.caplen ? (e.data[l4_offset + 12] >> 4) * 4 : 20;
+            }
+            size_t start = l4_offset + hdr;
+            size_t end = frame_len >= 4 ? frame_len - 4 : 0; // without the FCS
+            if (start < end) {
+                size_t shown = std::min<size_t>({ end - start, 64, e.caplen > start ? e.caplen - start : 0 });
+                for (size_t i = 0; i < shown; i++) {
+                    snprintf(buf, sizeof(buf), i ? " %02x" : "%02x", e.data[start + i]);
+                    preview += buf;
+                }
+                if (end - start > shown) {
+                    preview += " ... (" + std::to_string(end - start) + " octets total)";
+                }
+            }
+        } else if (icmp) {
+            info = "ICMP type " + std::to_string(r.icmp_type()) + ", code " +
+                   std::to_string(r.icmp_code()) + " " +
+                   ip_src + " -> " + ip_dst;
+        } else {
+            info = "IPv" + std::to_string(ip_version) + " " + l4 + " " + ip_src + " -> " + ip_dst;
+        }
+    }
+
+    out += '{';
+    add_field(out, "id", e.id);
+    add_field(out, "frame_num", r.frame_num());
+    add_field(out, "sample_offset", r.sample_offset());
+    add_field(out, "timestamp", timestamp);
+    add_field(out, "mac_src", format_mac(r.mac_src()));
+    add_field(out, "mac_dst", format_mac(r.mac_dst()));
+    add_field(out, "ethertype", eth_hex);
+    add_field(out, "ethertype_name", eth_name);
+    add_field(out, "vlan_id", r.vlan_id());
+    add_field(out, "frame_len", frame_len);
+    add_field(out, "fcs_ok", r.fcs_ok() ? 1 : 0);
+    add_field(out, "ip_version", ip_version);
+    add_field(out, "ip_src", ip_src);
+    add_field(out, "ip_dst", ip_dst);
+    add_field(out, "ip_ttl", ip_version ? r.ip_ttl() : -1);
+    add_field(out, "l4_proto", ip_version ? ip_proto : -1);
+    add_field(out, "l4_name", l4);
+    add_field(out, "src_port", ports ? r.src_port() : -1);
+    add_field(out, "dst_port", ports ? r.dst_port() : -1);
+    add_field(out, "tcp_flags", tcp_flags);
+    add_field(out, "icmp_type", icmp ? r.icmp_type() : -1);
+    add_field(out, "icmp_code", icmp ? r.icmp_code() : -1);
+    add_field(out, "payload_preview", preview);
+    add_field(out, "info", info);
+    add_field(out, "proto_label", l4.empty() ? eth_name : eth_name + "/" + l4);
+    add_field(out, "lane", r.lane());
+    out.back() = '}';
+}
+
+inspector_backend::page inspector_sink_impl::frames(const query& q)
+{
+    page p;
+    p.last = d_ring.last_id();
+    p.first = std::max(d_ring.first_id(), d_cleared.load() + 1);
+    p.count = 0;
+    // A since beyond the newest id comes from an earlier run: start over
+    p.next = q.since > p.last ? p.first - 1 : std::max(q.since, p.first - 1);
+
+    std::vector<uint8_t> buf(d_ring.snap_len());
+    frame_ring::entry e;
+    std::vector<std::string> items;
+    auto keep = [&](uint64_t id) {
+        if (!d_ring.read(id, e, buf.data())) return;
+        if (q.filter && !q.filter->match(e.data, e.caplen, frame_record_view(e.header).frame_len())) return;
+        items.emplace_back();
+        append_json(items.back(), e);
+    };
+
+    if (q.newest) {
+        uint64_t stop = p.last > MAX_SCAN ? std::max(p.first, p.last - MAX_SCAN + 1) : p.first;
+        for (uint64_t id = p.last; id >= stop && id > 0 && items.size() < q.limit; id--) keep(id);
+        std::reverse(items.begin(), items.end());
+        p.next = p.last;
+    } else {
+        uint64_t id = p.next + 1;
+        uint64_t stop = std::min(p.last, p.next + MAX_SCAN);
+        for (; id <= stop && items.size() < q.limit; id++) keep(id);
+        p.next = id - 1;
+    }
+
+    if (q.reverse) std::reverse(items.begin(), items.end());
+    p.count = items.size();
+    p.json = "[";
+    for (size_t i = 0; i < items.size(); i++) {
+        if (i) p.json += ',';
+        p.json += items[i];
+    }
+    p.json += ']';
+    return p;
+}
+
+std::string inspector_sink_impl::store_json(const std::string& text)
+{
+    if (!d_store) throw std::invalid_argument("no frame store (store_mb is 0)");
+    frame_store::query q = frame_store::query::parse(text);
+    std::vector<frame_store::frame> frames = d_store->find(q);
+
+    std::string out = "{\"first_id\":" + std::to_string(d_store->first_id()) +
+                      ",\"last_id\":" + std::to_string(d_store->last_id()) +
+                      ",\"count\":" + std::to_string(frames.size()) + ",\"frames\":[";
+    char buf[16];
+    for (size_t i = 0; i < frames.size(); i++) {
+        const frame_store::frame& f = frames[i];
+        if (i) out += ',';
+        out += '{';
+        add_field(out, "id", f.id);
+        add_field(out, "frame_num", f.frame_num);
+        add_field(out, "sample_offset", f.sample_offset);
+        add_field(out, "time_ns", f.time_ns);
+        add_field(out, "mac_src", f.mac_src);
+        add_field(out, "mac_dst", f.mac_dst);
+        snprintf(buf, sizeof(buf), "0x%04x", f.ethertype);
+        add_field(out, "ethertype", buf);
+        add_field(out, "vlan_id", f.vlan);
+        add_field(out, "frame_len", f.data.size());
+        add_field(out, "fcs_ok", f.fcs_ok ? 1 : 0);
+        add_field(out, "ip_version", f.ip_version);
+        add_field(out, "ip_src", f.ip_src);
+        add_field(out, "ip_dst", f.ip_dst);
+        add_field(out, "l4_proto", f.ip_proto);
+        add_field(out, "src_port", f.src_port);
+        add_field(out, "dst_port", f.dst_port);
+        add_field(out, "tcp_flags", tcp_flags_string(f.tcp_flags));
+        out.back() = '}';
+    }
+    return out + "]}";
+}
+
+std::string inspector_sink_impl::status_json()
+{
+    std::string store;
+    if (d_store) {
+        store = ",\"store_frames\":" + std::to_string(d_store->size()) +
+                ",\"store_bytes\":" + std::to_string(d_store->memory_used()) +
+                ",\"store_budget\":" + std::to_string(d_store->budget());
+    }
+    return "{\"depth\":" + std::to_string(d_ring.depth()) +
+           ",\"snap_len\":" + std::to_string(d_ring.snap_len()) +
+           ",\"first_id\":" + std::to_string(std::max(d_ring.first_id(), d_cleared.load() + 1)) +
+           ",\"last_id\":" + std::to_string(d_ring.last_id()) +
+           ",\"frames_received\":" + std::to_string(d_received.get()) +
+           ",\"messages_ignored\":" + std::to_string(d_ignored.get()) + store + "}";
+}
+
+void inspector_sink_impl::clear() { d_cleared.store(d_ring.last_id()); }
+
+} // namespace ethernet
+} // namespace gr
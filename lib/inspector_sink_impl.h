@@ -0,0 +1,52 @@
+#ifndef INCLUDED_ETHERNET_INSPECTOR_SINK_IMPL_H
+#define INCLUDED_ETHERNET_INSPECTOR_SINK_IMPL_H
+
+#include "block_stats.h"
+#include "frame_ring.h"
+#include "inspector_server.h"
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/inspector_sink.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+class inspector_sink_impl : public inspector_sink, public inspector_backend
+{
+private:
+    pmt::pmt_t d_in_port;
+
+    frame_ring d_ring;
+    frame_record_writer d_writer; // decoded dicts -> records
+    std::atomic<uint64_t> d_cleared; // last id hidden by /clear
+    stat_counter d_received;
+    stat_counter d_ignored;
+    frame_store::sptr d_store;
+    std::unique_ptr<inspector_server> d_server;
+
+    void handle_frames(const pmt::pmt_t& msg);
+    bool add_records(const uint8_t* msg, size_t len);
+    void append_json(std::string& out, const frame_ring::entry& e);
+
+public:
+    inspector_sink_impl(
+        int depth, int snap_len, const std::string& address, int port, int store_mb);
+    ~inspector_sink_impl();
+
+    uint64_t frames_received() const override;
+    uint64_t messages_ignored() const override;
+    frame_store::sptr store() const override { return d_store; }
+
+    page frames(const query& q) override;
+    std::string store_json(const std::string& query) override;
+    std::string status_json() override;
+    void clear() override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef INCLUDED_ETHERNET_JK_SCANNER_H
+#define INCLUDED_ETHERNET_JK_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Finds the start of a 100BASE-TX frame in descrambled bits, one per byte:
+ * IDLE, /J/K/ and the first four preamble code-groups. Bits are packed 64
+ * at a time, and every alignment of a packed word is compared against the
+ * pattern at once: the word is shifted by each pattern bit's distance to
+ * the pattern end and ANDed into a mask of the candidate end positions.
+ * The mask empties on the third shift in IDLE, so an inter-frame gap costs
+ * a few instructions per 64 bits.
+ *
+ * The frame then starts where fastethernet_frame_decoder always started
+ * it: at the first /J/K/ marker of the last 200 bits that no run of 20
+ * ones followed.
+ */
+class jk_scanner
+{
+public:
+    // 11111 11000 10001 01011 01011 01011 01011, first bit highest
+    static const uint64_t START = 0x7F115AD6B;
+    static const int START_BITS = 35;
+    // 11111 11000 10001, the first 15 bits of START
+    static const unsigned MARKER = 0x7F11;
+    static const int MARKER_BITS = 15;
+    static const int IDLE_BITS = 20;
+    static const size_t WINDOW = 200;
+
+    jk_scanner() : d_filled(0), d_found(false)
+    {
+        for (auto& w : d_hist) w = 0;
+    }
+
+    // Forgets the bits seen so far: the next match lies entirely after them.
+    void reset()
+    {
+        d_filled = 0;
+        d_found = false;
+    }
+
+    /*
+     * Takes bits until the start pattern completes. Returns the number of
+     * bits used, all n when there was no match; on a match, found() is
+     * true and the last bit used is the pattern's last one.
+     */
+    size_t scan(const uint8_t* bits, size_t n)
+    {
+        d_found = false;
+        size_t used = 0;
+        while (used < n) {
+            int k = n - used < 64 ? int(n - used) : 64;
+            uint64_t chunk = pack(bits + used, k);
+            push(chunk, k);
+            uint64_t ends = match(k);
+            if (ends) {
+                // The latest bits are the lowest: the first match is the
+                // highest, and the bits after it go back to the caller
+                int later = first_end(ends);
+                pop(later);
+                d_found = true;
+                return used + k - later;
+            }
+            used += k;
+        }
+        return used;
+    }
+
+    bool found() const { return d_found; }
+
+    /*
+     * Bits from the start of the frame to the end of the match, as '0' and
+     * '1' characters appended to out. Returns their number.
+     */
+    size_t frame_bits(std::string& out) const
+    {
+        size_t len = d_filled < WINDOW ? d_filled : WINDOW;
+        size_t start = std::string::npos;
+        unsigned shift = 0;
+        int ones = 0;
+        for (size_t j = 0; j < len; j++) {
+            unsigned b = bit(len - 1 - j);
+            shift = ((shift << 1) | b) & ((1u << MARKER_BITS) - 1);
+            ones = b ? ones + 1 : 0;
+            if (ones >= IDLE_BITS) {
+                start = std::string::npos;
+            } else if (start == std::string::npos && j + 1 >= size_t(MARKER_BITS) &&
+                       shift == MARKER) {
+                start = j + 1 - MARKER_BITS;
+            }
+        }
+        size_t count = len - start;
+        for (size_t j = start; j < len; j++) out.push_back(bit(len - 1 - j) ? '1' : '0');
+        return count;
+    }
+
+private:
+    static const int HIST_WORDS = 5; // WINDOW bits after dropping up to 63
+    uint64_t d_hist[HIST_WORDS];     // latest bits in d_hist[0], the latest one lowest
+    size_t d_filled;                 // bits since reset()
+    bool d_found;
+
+    // k bits, the first one highest
+    static uint64_t pack(const uint8_t* bits, int k)
+    {
+        uint64_t w = 0;
+        int j = 0;
+        for (; j + 8 <= k; j += 8) {
+            uint64_t x;
+            memcpy(&x, bits + j, 8);
+            // One multiply gathers the eight 0/1 bytes: byte i lands on bit 7 - i
+            x &= 0x0101010101010101ULL;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            w = (w << 8) | ((x * 0x0102040810204080ULL) >> 56);
+#else
+            w = (w << 8) | ((x * 0x8040201008040201ULL) >> 56);
+#endif
+        }
+        for (; j < k; j++) w = (w << 1) | (bits[j] & 1);
+        return w;
+    }
+
+    void push(uint64_t chunk, int k)
+    {
+        if (k == 64) {
+            for (int i = HIST_WORDS - 1; i > 0; i--) d_hist[i] = d_hist[i - 1];
+            d_hist[0] = chunk;
+        } else {
+            for (int i = HIST_WORDS - 1; i > 0; i--) {
+                d_hist[i] = (d_hist[i] << k) | (d_hist[i - 1] >> (64 - k));
+            }
+            d_hist[0] = (d_hist[0] << k) | chunk;
+        }
+        d_filled += k;
+    }
+
+    // Drops the latest k < 64 bits again.
+    void pop(int k)
+    {
+        if (k == 0) return;
+        for (int i = 0; i < HIST_WORDS - 1; i++) {
+            d_hist[i] = (d_hist[i] >> k) | (d_hist[i + 1] << (64 - k));
+        }
+        d_hist[HIST_WORDS - 1] >>= k;
+        d_filled -= k;
+    }
+
+    // The latest bits, each delayed by d < 64
+    uint64_t delayed(int d) const
+    {
+        return d == 0 ? d_hist[0] : (d_hist[0] >> d) | (d_hist[1] << (64 - d));
+    }
+
+    // Bit age bits before the latest one
+    unsigned bit(size_t age) const { return (d_hist[age / 64] >> (age % 64)) & 1; }
+
+    // Ends of the start pattern among the latest k bits, latest lowest
+    uint64_t match(int k) const
+    {
+        uint64_t ends = k == 64 ? ~0ULL : (1ULL << k) - 1;
+        // Ends with fewer than START_BITS bits since reset()
+        if (d_filled < size_t(START_BITS)) return 0;
+        size_t valid = d_filled - START_BITS + 1;
+        if (valid < 64) ends &= (1ULL << valid) - 1;
+        for (int d = 0; d < START_BITS && ends; d++) {
+            uint64_t w = delayed(d);
+            ends &= (START >> d & 1) ? w : ~w;
+        }
+        return ends;
+    }
+
+    // Bits after the earliest end in ends
+    static int first_end(uint64_t ends) { return 63 - __builtin_clzll(ends); }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef INCLUDED_ETHERNET_LANE_DECODER_H
+#define INCLUDED_ETHERNET_LANE_DECODER_H
+
+#include "descrambler_core.h"
+#include "frame_arena.h"
+#include "framer_4b5b.h"
+#include "framer_manchester.h"
+#include "level_slicer.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * The batch decoders' processing, with its state kept between calls so a
+ * stream can be decoded buffer by buffer. Positions are counted from the
+ * first item ever given, frames are handed to an emit(frame, len, start)
+ * callback with the same start offset as the batch functions. A stream
+ * decoded in one call gives the batch functions' frames.
+ *
+ * The lanes run the blocks' own cores, with the blocks' default
+ * parameters: the frames are those of the receive chain.
+ */
+
+// fastethernet_descrambler::make() defaults
+const int SEARCH_WINDOW = 50;
+const int IDLE_RUN = 40;
+const int MAX_IDLE_NO_IDLE = 100;
+const int MAX_IN_FRAME_NO_IDLE = 20000;
+
+// ethernet_10baset_decoder: end of the preamble and SFD, as given to the
+// example's Correlate Access Code - Tag
+const char SFD_HALFBITS[] = "01100110011001100110011001100110011001100101";
+
+/*
+ * descramble(): fastethernet_descrambler's output, bits copied unchanged
+ * while unlocked.
+ */
+class lane_descrambler
+{
+public:
+    lane_descrambler(int search_window = SEARCH_WINDOW,
+                     int idle_run = IDLE_RUN,
+                     int max_idle_no_idle = MAX_IDLE_NO_IDLE,
+                     int max_in_frame_no_idle = MAX_IN_FRAME_NO_IDLE,
+                     int idle_errors = 0)
+        : d_core(search_window, idle_run, max_idle_no_idle, max_in_frame_no_idle, idle_errors),
+          d_locks(0)
+    {
+    }
+
+    // out may be in
+    void process(const uint8_t* in, size_t n, uint8_t* out)
+    {
+        for (size_t i = 0; i < n; i++) {
+            int bit = in[i] & 1;
+            if (!d_core.locked()) {
+                out[i] = in[i];
+                if (d_core.search(bit) != descrambler_core::NONE) d_locks++;
+                continue;
+            }
+            descrambler_core::event ev;
+            out[i] = d_core.descramble(bit, ev);
+        }
+    }
+
+    // Times the scrambler state was acquired
+    size_t locks() const { return d_locks; }
+
+private:
+    descrambler_core d_core;
+    size_t d_locks;
+};
+
+/*
+ * decode_4b5b(): fastethernet_frame_decoder's frames, start at the /J/.
+ */
+class lane_framer_4b5b
+{
+public:
+    lane_framer_4b5b() : d_start(0), d_frame(FRAME_SLOT_BYTES) {}
+
+    template <typename F>
+    void process(const uint8_t* bits, size_t n, F&& emit)
+    {
+        handler<F> h{ *this, emit };
+        d_framer.process(bits, n, h);
+    }
+
+    // No frame emitted later starts before this position
+    uint64_t next_start() const { return d_framer.next_start(); }
+
+private:
+    framer_4b5b d_framer;
+    uint64_t d_start;
+    std::vector<uint8_t> d_frame;
+
+    template <typename F>
+    struct handler {
+        lane_framer_4b5b& lane;
+        F& emit;
+
+        void frame_start(uint64_t offset) { lane.d_start = offset; }
+        void frame_end(std::string_view groups, uint64_t)
+        {
+            uint64_t violations = 0;
+            size_t len = decode_code_groups(groups, lane.d_frame.data(), lane.d_frame.size(), violations);
+            if (len) emit(lane.d_frame.data(), len, lane.d_start);
+        }
+        void frame_timeout() {}
+    };
+};
+
+/*
+ * decode_10baset() after the slicer: the example's access code tag and
+ * ethernet_10baset_decoder's framing. A frame starts at the first half-bit
+ * after the SFD; an SFD inside a frame ends it, as a tag does.
+ */
+class lane_framer_manchester
+{
+public:
+    lane_framer_manchester() : d_pos(0), d_shift(0), d_frame(framer_manchester::MAX_FRAME_BYTES)
+    {
+        d_code = 0;
+        for (size_t i = 0; i < CODE_LEN; i++) d_code = (d_code << 1) | (SFD_HALFBITS[i] == '1');
+    }
+
+    template <typename F>
+    void push(uint8_t halfbit, F&& emit)
+    {
+        // Correlate Access Code - Tag: the tag goes on the half-bit after
+        // the code, compared with the half-bits before it (zeros at first)
+        if (d_shift == d_code) {
+            if (d_framer.in_frame()) end(emit);
+            d_framer.begin(d_pos);
+        }
+        if (d_framer.in_frame() && d_framer.push(halfbit)) end(emit);
+        d_shift = ((d_shift << 1) | (halfbit & 1)) & CODE_MASK;
+        d_pos++;
+    }
+
+    // Ends the current frame at the last half-bit given
+    template <typename F>
+    void flush(F&& emit)
+    {
+        if (d_framer.in_frame()) end(emit);
+    }
+
+    // No frame emitted later starts before this position
+    uint64_t next_start() const { return d_framer.in_frame() ? d_framer.start() : d_pos; }
+
+private:
+    static const size_t CODE_LEN = sizeof(SFD_HALFBITS) - 1;
+    static const uint64_t CODE_MASK = (uint64_t(1) << CODE_LEN) - 1;
+
+    framer_manchester d_framer;
+    uint64_t d_code;
+    uint64_t d_pos;
+    uint64_t d_shift;
+    std::vector<uint8_t> d_frame;
+
+    template <typename F>
+    void end(F&& emit)
+    {
+        size_t len = d_framer.finish(d_frame.data());
+        if (len) emit(d_frame.data(), len, d_framer.start());
+    }
+};
+
+/*
+ * decode_100basetx() on a stream: slicer, MLT-3, descrambler and 4B/5B.
+ */
+template <typename T>
+class lane_100basetx
+{
+public:
+    lane_100basetx(float threshold, float gain, int idle_run = IDLE_RUN)
+        : d_slice(threshold, gain),
+          d_prev(0),
+          d_descrambler(SEARCH_WINDOW, idle_run, MAX_IDLE_NO_IDLE, MAX_IN_FRAME_NO_IDLE)
+    {
+    }
+
+    template <typename F>
+    void process(const T* symbols, size_t n, F&& emit)
+    {
+        if (d_bits.size() < n) d_bits.resize(n);
+        uint8_t* bits = d_bits.data();
+        for (size_t i = 0; i < n; i++) {
+            int level = d_slice(symbols[i]);
+            bits[i] = level != d_prev;
+            d_prev = level;
+        }
+        d_descrambler.process(bits, n, bits);
+        d_framer.process(bits, n, emit);
+    }
+
+    // A frame still open is dropped, as by decode_4b5b()
+    template <typename F>
+    void flush(F&&)
+    {
+    }
+
+    uint64_t next_start() const { return d_framer.next_start(); }
+    size_t locks() const { return d_descrambler.locks(); }
+
+private:
+    level_slicer<T> d_slice;
+    int d_prev;
+    lane_descrambler d_descrambler;
+    lane_framer_4b5b d_framer;
+    std::vector<uint8_t> d_bits;
+};
+
+/*
+ * decode_10baset() on a stream: slicer with hysteresis and Manchester framer.
+ */
+template <typename T>
+class lane_10baset
+{
+public:
+    lane_10baset(float threshold, float gain) : d_slice(threshold, gain), d_level(0) {}
+
+    template <typename F>
+    void process(const T* samples, size_t n, F&& emit)
+    {
+        for (size_t i = 0; i < n; i++) {
+            // Hysteresis, as the example's Threshold block
+            int l = d_slice(samples[i]);
+            if (l) d_level = l > 0;
+            d_framer.push(d_level, emit);
+        }
+    }
+
+    template <typename F>
+    void flush(F&& emit)
+    {
+        d_framer.flush(emit);
+    }
+
+    uint64_t next_start() const { return d_framer.next_start(); }
+
+private:
+    level_slicer<T> d_slice;
+    uint8_t d_level;
+    lane_framer_manchester d_framer;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
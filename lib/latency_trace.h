@@ -0,0 +1,226 @@
+#ifndef INCLUDED_ETHERNET_LATENCY_TRACE_H
+#define INCLUDED_ETHERNET_LATENCY_TRACE_H
+
+#include <gnuradio/high_res_timer.h>
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * HDR-style histogram of durations in nanoseconds: exact below 128 ns,
+ * then 64 linear sub-buckets per power of two (at most 1.6% error), up
+ * to 2^40 ns. Larger values go to the last bucket; max() stays exact.
+ */
+class latency_histogram
+{
+public:
+    latency_histogram() : d_counts(SUB + MAX_SHIFT * HALF, 0), d_count(0), d_max(0) {}
+
+    void record(uint64_t ns)
+    {
+        d_counts[index(ns)]++;
+        d_count++;
+        if (ns > d_max) d_max = ns;
+    }
+
+    // Upper bound of the bucket holding quantile q (0 < q <= 1).
+    uint64_t percentile(double q) const
+    {
+        if (d_count == 0) return 0;
+        uint64_t rank = (uint64_t)(q * d_count + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < d_counts.size(); i++) {
+            seen += d_counts[i];
+            if (seen >= rank) return std::min(upper_bound(i), d_max);
+        }
+        return d_max;
+    }
+
+    uint64_t count() const { return d_count; }
+    uint64_t max() const { return d_max; }
+
+    void reset()
+    {
+        std::fill(d_counts.begin(), d_counts.end(), 0);
+        d_count = 0;
+        d_max = 0;
+    }
+
+private:
+    static const int SUB_BITS = 7;
+    static const uint64_t SUB = 1 << SUB_BITS;
+    static const uint64_t HALF = SUB / 2;
+    static const int MAX_SHIFT = 34;
+
+    std::vector<uint64_t> d_counts;
+    uint64_t d_count;
+    uint64_t d_max;
+
+    static size_t index(uint64_t v)
+    {
+        if (v < SUB) return v;
+        int shift = 63 - __builtin_clzll(v) - (SUB_BITS - 1);
+        if (shift > MAX_SHIFT) return SUB + MAX_SHIFT * HALF - 1;
+        return SUB + (shift - 1) * HALF + ((v >> shift) - HALF);
+    }
+
+    static uint64_t upper_bound(size_t i)
+    {
+        if (i < SUB) return i;
+        size_t k = i - SUB;
+        int shift = k / HALF + 1;
+        return (((k % HALF) + HALF + 1) << shift) - 1;
+    }
+};
+
+/*
+ * Per-frame latency trace of a decoder. Timestamps are high_res_timer
+ * ticks (monotonic) taken at:
+ *   - arrival: start of the work() call that brought the last symbol
+ *   - sfd:     start of frame detected
+ *   - eof:     end of frame detected
+ *   - dissected: decoded dict (or binary record) built, just before
+ *                message_port_pub()
+ *   - published: message_port_pub() returned (for the whole batch when
+ *                batching, so the wait in the batch counts as publish)
+ * Nothing is read from the clock while tracing is disabled. Used from the
+ * work() thread only, except set_enabled().
+ */
+class frame_trace
+{
+public:
+    // Timestamps of one frame, kept by the batcher until the batch is sent.
+    struct stamps {
+        bool active;
+        gr::high_res_timer_type arrival;
+        gr::high_res_timer_type sfd;
+        gr::high_res_timer_type eof;
+        gr::high_res_timer_type dissected;
+    };
+
+    explicit frame_trace(bool enabled)
+        : d_enabled(enabled),
+          d_active(false),
+          d_sfd_offset(0),
+          d_eof_offset(0),
+          d_t_arrival(0),
+          d_t_sfd(0),
+          d_t_eof(0),
+          d_t_dissected(0)
+    {
+    }
+
+    void set_enabled(bool enabled) { d_enabled.store(enabled); }
+    bool enabled() const { return d_enabled.load(); }
+
+    void sfd(uint64_t offset)
+    {
+        d_active = d_enabled.load(std::memory_order_relaxed);
+        if (!d_active) return;
+        d_sfd_offset = offset;
+        d_t_sfd = gr::high_res_timer_now();
+    }
+
+    void eof(uint64_t offset, gr::high_res_timer_type arrival)
+    {
+        if (!d_active) return;
+        d_eof_offset = offset;
+        d_t_arrival = arrival;
+        d_t_eof = gr::high_res_timer_now();
+    }
+
+    // Dissection done without a decoded dict (binary records only).
+    void dissected()
+    {
+        if (d_active) d_t_dissected = gr::high_res_timer_now();
+    }
+
+    // Adds the offsets and timestamps to the decoded dict.
+    pmt::pmt_t dissected(pmt::pmt_t d)
+    {
+        if (!d_active) return d;
+        dissected();
+        pmt::pmt_t t = pmt::make_dict();
+        t = pmt::dict_add(t, pmt::intern("sfd_offset"), pmt::from_uint64(d_sfd_offset));
+        t = pmt::dict_add(t, pmt::intern("eof_offset"), pmt::from_uint64(d_eof_offset));
+        t = pmt::dict_add(t, pmt::intern("t_arrival"), pmt::from_uint64(d_t_arrival));
+        t = pmt::dict_add(t, pmt::intern("t_sfd"), pmt::from_uint64(d_t_sfd));
+        t = pmt::dict_add(t, pmt::intern("t_eof"), pmt::from_uint64(d_t_eof));
+        t = pmt::dict_add(t, pmt::intern("t_dissected"), pmt::from_uint64(d_t_dissected));
+        return pmt::dict_add(d, pmt::intern("trace"), t);
+    }
+
+    // Ends the trace of the current frame.
+    stamps take()
+    {
+        stamps s = { d_active, d_t_arrival, d_t_sfd, d_t_eof, d_t_dissected };
+        d_active = false;
+        return s;
+    }
+
+    void published() { published(take()); }
+
+    void published(const stamps& s)
+    {
+        if (!s.active) return;
+        gr::high_res_timer_type now = gr::high_res_timer_now();
+        d_hist[FRAME].record(to_ns(s.eof - s.sfd));
+        d_hist[DETECT].record(to_ns(s.eof - s.arrival));
+        d_hist[DISSECT].record(to_ns(s.dissected - s.eof));
+        d_hist[PUBLISH].record(to_ns(now - s.dissected));
+        d_hist[TOTAL].record(to_ns(now - s.arrival));
+    }
+
+    /*
+     * Adds "latency" to a stats dict: count, p50, p99, p999 and max (ns)
+     * of each stage since the previous call, then starts a new interval.
+     */
+    pmt::pmt_t add_to_stats(pmt::pmt_t st)
+    {
+        if (!enabled()) return st;
+        static const char* names[NSTAGES] = { "frame", "detect", "dissect", "publish", "total" };
+        pmt::pmt_t lat = pmt::make_dict();
+        for (int s = 0; s < NSTAGES; s++) {
+            const latency_histogram& h = d_hist[s];
+            pmt::pmt_t p = pmt::make_dict();
+            p = pmt::dict_add(p, pmt::intern("count"), pmt::from_uint64(h.count()));
+            p = pmt::dict_add(p, pmt::intern("p50_ns"), pmt::from_uint64(h.percentile(0.5)));
+            p = pmt::dict_add(p, pmt::intern("p99_ns"), pmt::from_uint64(h.percentile(0.99)));
+            p = pmt::dict_add(p, pmt::intern("p999_ns"), pmt::from_uint64(h.percentile(0.999)));
+            p = pmt::dict_add(p, pmt::intern("max_ns"), pmt::from_uint64(h.max()));
+            lat = pmt::dict_add(lat, pmt::intern(names[s]), p);
+            d_hist[s].reset();
+        }
+        return pmt::dict_add(st, pmt::intern("latency"), lat);
+    }
+
+private:
+    enum { FRAME, DETECT, DISSECT, PUBLISH, TOTAL, NSTAGES };
+
+    std::atomic<bool> d_enabled;
+    bool d_active; // the current frame is traced
+    uint64_t d_sfd_offset;
+    uint64_t d_eof_offset;
+    gr::high_res_timer_type d_t_arrival;
+    gr::high_res_timer_type d_t_sfd;
+    gr::high_res_timer_type d_t_eof;
+    gr::high_res_timer_type d_t_dissected;
+    latency_histogram d_hist[NSTAGES];
+
+    static uint64_t to_ns(gr::high_res_timer_type ticks)
+    {
+        if (ticks <= 0) return 0;
+        return (uint64_t)((double)ticks * 1e9 / gr::high_res_timer_tps());
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
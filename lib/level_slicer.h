@@ -0,0 +1,66 @@
+#ifndef INCLUDED_ETHERNET_LEVEL_SLICER_H
+#define INCLUDED_ETHERNET_LEVEL_SLICER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Compares samples with +/- threshold after a gain, in the sample type:
+ * the gain is folded into the threshold when it is set, so integer samples
+ * from a digitizer are compared as integers, without conversion or
+ * scaling. For an integer x, x > t holds exactly when x > floor(t), and
+ * x < -t when x < -floor(t).
+ */
+template <typename T>
+class level_slicer
+{
+public:
+    level_slicer(float threshold, float gain) { set(threshold, gain); }
+
+    void set(float threshold, float gain)
+    {
+        if (!(gain > 0)) throw std::invalid_argument("gain must be positive");
+        float t = threshold / gain;
+        if constexpr (std::is_floating_point<T>::value) {
+            d_level = t;
+        } else {
+            // Past the range of every supported type, and no overflow of -level
+            d_level = (level_t)std::floor(std::min(std::max(t, -LIMIT), LIMIT));
+        }
+    }
+
+    // +1 above the threshold, -1 below minus the threshold, 0 in between
+    int operator()(T x) const { return x > d_level ? 1 : x < -d_level ? -1 : 0; }
+
+    // Outside +/- the threshold
+    bool active(T x) const { return (x > d_level) | (x < -d_level); }
+
+    // Whether any of in[0, n) is active, without a branch per sample
+    bool any_active(const T* in, size_t n) const
+    {
+        const level_t level = d_level;
+        int any = 0;
+        for (size_t i = 0; i < n; i++) {
+            any |= (in[i] > level) | (in[i] < -level);
+        }
+        return any;
+    }
+
+private:
+    typedef typename std::conditional<std::is_floating_point<T>::value, T, int32_t>::type level_t;
+    static constexpr float LIMIT = 1 << 20;
+
+    level_t d_level;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,46 @@
+#include <gnuradio/ethernet/line_coding.h>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+struct crc32_table {
+    uint32_t entries[256];
+
+    crc32_table()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int b = 0; b < 8; b++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+} // namespace
+
+uint32_t crc32(const uint8_t* data, size_t len)
+{
+    static const crc32_table table;
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ table.entries[(crc ^ data[i]) & 0xFF];
+    }
+    return ~crc;
+}
+
+bool check_fcs(const uint8_t* frame, size_t len)
+{
+    if (len < 4) return false;
+    uint32_t fcs = crc32(frame, len - 4);
+    const uint8_t* tail = frame + len - 4;
+    return tail[0] == (fcs & 0xFF) && tail[1] == ((fcs >> 8) & 0xFF) &&
+           tail[2] == ((fcs >> 16) & 0xFF) && tail[3] == (fcs >> 24);
+}
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,151 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "line_impairments_impl.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+const int GAUSS_TABLE_BITS = 16;
+const float JITTER_CORRELATION = 0.99f;
+const float MAX_JITTER = 0.99f;
+
+struct gaussian_table {
+    float entries[1 << GAUSS_TABLE_BITS];
+
+    gaussian_table()
+    {
+        // Box-Muller over a fixed LCG: the table is the same on every run.
+        uint32_t x = 12345;
+        auto uniform = [&x]() {
+            x = x * 1664525u + 1013904223u;
+            return ((x >> 8) + 0.5f) / 16777216.0f;
+        };
+        for (int i = 0; i < (1 << GAUSS_TABLE_BITS); i += 2) {
+            float r = std::sqrt(-2.0f * std::log(uniform()));
+            float t = 2.0f * (float)M_PI * uniform();
+            entries[i] = r * std::cos(t);
+            entries[i + 1] = r * std::sin(t);
+        }
+    }
+};
+
+const gaussian_table& gauss()
+{
+    static const gaussian_table table;
+    return table;
+}
+
+} // namespace
+
+line_impairments::sptr
+line_impairments::make(float noise_rms, float jitter_rms, float wander_cutoff, int seed)
+{
+    return gnuradio::make_block_sptr<line_impairments_impl>(
+        noise_rms, jitter_rms, wander_cutoff, seed);
+}
+
+line_impairments_impl::line_impairments_impl(float noise_rms,
+                                             float jitter_rms,
+                                             float wander_cutoff,
+                                             int seed)
+    : gr::sync_block("line_impairments",
+                     gr::io_signature::make(1, 1, sizeof(float)),
+                     gr::io_signature::make(1, 1, sizeof(float))),
+      d_noise_rms(0.0f),
+      d_jitter_rms(0.0f),
+      d_wander_alpha(0.0f),
+      d_rng(seed != 0 ? (uint32_t)seed : 0x9E3779B9u),
+      d_jitter(0.0f),
+      d_baseline(0.0f)
+{
+    gauss();
+    set_noise_rms(noise_rms);
+    set_jitter_rms(jitter_rms);
+    set_wander_cutoff(wander_cutoff);
+
+    // Jitter interpolates between the previous, current and next samples.
+    set_history(3);
+}
+
+line_impairments_impl::~line_impairments_impl() {}
+
+void line_impairments_impl::set_noise_rms(float noise_rms)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+    d_noise_rms = std::max(noise_rms, 0.0f);
+}
+
+void line_impairments_impl::set_jitter_rms(float jitter_rms)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+    d_jitter_rms = std::max(jitter_rms, 0.0f);
+}
+
+void line_impairments_impl::set_wander_cutoff(float wander_cutoff)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+    d_wander_alpha =
+        wander_cutoff > 0.0f ? 1.0f - std::exp(-2.0f * (float)M_PI * wander_cutoff) : 0.0f;
+}
+
+float line_impairments_impl::gaussian()
+{
+    // xorshift32
+    d_rng ^= d_rng << 13;
+    d_rng ^= d_rng >> 17;
+    d_rng ^= d_rng << 5;
+    return gauss().entries[d_rng >> (32 - GAUSS_TABLE_BITS)];
+}
+
+int line_impairments_impl::work(int noutput_items,
+                                gr_vector_const_void_star& input_items,
+                                gr_vector_void_star& output_items)
+{
+    const float* in = (const float*)input_items[0];
+    float* out = (float*)output_items[0];
+
+    gr::thread::scoped_lock lock(d_setlock);
+
+    if (d_noise_rms == 0.0f && d_jitter_rms == 0.0f && d_wander_alpha == 0.0f) {
+        memcpy(out, in + 1, noutput_items * sizeof(float));
+        return noutput_items;
+    }
+
+    const float jitter_drive =
+        d_jitter_rms * std::sqrt(1.0f - JITTER_CORRELATION * JITTER_CORRELATION);
+
+    for (int i = 0; i < noutput_items; i++) {
+        float x = in[i + 1];
+
+        if (d_jitter_rms > 0.0f) {
+            d_jitter = JITTER_CORRELATION * d_jitter + jitter_drive * gaussian();
+            d_jitter = std::min(std::max(d_jitter, -MAX_JITTER), MAX_JITTER);
+            float neighbour = d_jitter >= 0.0f ? in[i + 2] : in[i];
+            x += std::fabs(d_jitter) * (neighbour - x);
+        }
+
+        if (d_wander_alpha > 0.0f) {
+            d_baseline += d_wander_alpha * (x - d_baseline);
+            x -= d_baseline;
+        }
+
+        if (d_noise_rms > 0.0f) {
+            x += d_noise_rms * gaussian();
+        }
+
+        out[i] = x;
+    }
+
+    return noutput_items;
+}
+
+} // namespace ethernet
+} // namespace gr
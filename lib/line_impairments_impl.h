@@ -0,0 +1,38 @@
+#ifndef INCLUDED_ETHERNET_LINE_IMPAIRMENTS_IMPL_H
+#define INCLUDED_ETHERNET_LINE_IMPAIRMENTS_IMPL_H
+
+#include <gnuradio/ethernet/line_impairments.h>
+
+namespace gr {
+namespace ethernet {
+
+class line_impairments_impl : public line_impairments
+{
+private:
+    float d_noise_rms;
+    float d_jitter_rms;
+    float d_wander_alpha;
+
+    uint32_t d_rng;
+    float d_jitter;   // current fractional delay, AR(1)
+    float d_baseline; // low-pass of the signal, removed by the AC coupling
+
+    float gaussian();
+
+public:
+    line_impairments_impl(float noise_rms, float jitter_rms, float wander_cutoff, int seed);
+    ~line_impairments_impl();
+
+    void set_noise_rms(float noise_rms) override;
+    void set_jitter_rms(float jitter_rms) override;
+    void set_wander_cutoff(float wander_cutoff) override;
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
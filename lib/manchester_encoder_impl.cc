@@ -0,0 +1,151 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "manchester_encoder_impl.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+manchester_encoder::sptr manchester_encoder::make(double samples_per_bit,
+                                                  int idle_bits,
+                                                  const std::string& len_tag_key)
+{
+    return gnuradio::make_block_sptr<manchester_encoder_impl>(
+        samples_per_bit, idle_bits, len_tag_key);
+}
+
+manchester_encoder_impl::manchester_encoder_impl(double samples_per_bit,
+                                                 int idle_bits,
+                                                 const std::string& len_tag_key)
+    : gr::block("manchester_encoder",
+                gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                gr::io_signature::make(1, 1, sizeof(float))),
+      d_samples_per_bit(samples_per_bit),
+      d_idle_bits(std::max(idle_bits, 0)),
+      d_len_tag_key(pmt::intern(len_tag_key)),
+      d_started(false),
+      d_remaining(0),
+      d_half_bits(0),
+      d_pending_pos(0)
+{
+    if (samples_per_bit < 2.0) {
+        throw std::invalid_argument("manchester_encoder: samples_per_bit must be >= 2");
+    }
+
+    set_relative_rate(8.0 * samples_per_bit);
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+manchester_encoder_impl::~manchester_encoder_impl() {}
+
+void manchester_encoder_impl::forecast(int noutput_items,
+                                       gr_vector_int& ninput_items_required)
+{
+    // Samples left over (the end of the last frame) need no input
+    ninput_items_required[0] =
+        d_pending_pos < d_pending.size()
+            ? 0
+            : std::max(1, (int)(noutput_items / (8.0 * d_samples_per_bit)));
+}
+
+// Half-bit h spans samples [round(h * spb / 2), round((h + 1) * spb / 2)).
+void manchester_encoder_impl::push_half_bit(float level)
+{
+    const double half = d_samples_per_bit / 2.0;
+    uint64_t start = (uint64_t)std::llround(d_half_bits * half);
+    uint64_t end = (uint64_t)std::llround((d_half_bits + 1) * half);
+    d_pending.insert(d_pending.end(), end - start, level);
+    d_half_bits++;
+}
+
+void manchester_encoder_impl::push_byte(uint8_t byte)
+{
+    for (int b = 0; b < 8; b++) {
+        bool one = (byte >> b) & 1;
+        push_half_bit(one ? -1.0f : 1.0f);
+        push_half_bit(one ? 1.0f : -1.0f);
+    }
+}
+
+void manchester_encoder_impl::push_idle()
+{
+    for (int i = 0; i < 2 * d_idle_bits; i++) {
+        push_half_bit(0.0f);
+    }
+}
+
+void manchester_encoder_impl::end_frame()
+{
+    // TP_IDL: the line is held high for 2 bit times before going silent.
+    for (int i = 0; i < 4; i++) {
+        push_half_bit(1.0f);
+    }
+    push_idle();
+    d_remaining = 0;
+}
+
+int manchester_encoder_impl::general_work(int noutput_items,
+                                          gr_vector_int& ninput_items,
+                                          gr_vector_const_void_star& input_items,
+                                          gr_vector_void_star& output_items)
+{
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    float* out = (float*)output_items[0];
+    const int ninput = ninput_items[0];
+
+    std::vector<gr::tag_t> tags;
+    get_tags_in_window(tags, 0, 0, ninput, d_len_tag_key);
+    const uint64_t nread = nitems_read(0);
+    size_t tag_idx = 0;
+
+    int consumed = 0;
+    int produced = 0;
+
+    while (true) {
+        if (d_pending_pos < d_pending.size()) {
+            size_t n = std::min((size_t)(noutput_items - produced),
+                                d_pending.size() - d_pending_pos);
+            memcpy(out + produced, d_pending.data() + d_pending_pos, n * sizeof(float));
+            produced += n;
+            d_pending_pos += n;
+            if (d_pending_pos < d_pending.size()) break;
+            d_pending.clear();
+            d_pending_pos = 0;
+        }
+        if (consumed >= ninput) break;
+
+        while (tag_idx < tags.size() && tags[tag_idx].offset < nread + consumed) {
+            tag_idx++;
+        }
+        bool frame_start =
+            tag_idx < tags.size() && tags[tag_idx].offset == nread + consumed;
+
+        if (frame_start) {
+            if (d_remaining > 0) end_frame(); // truncated frame
+            if (!d_started) push_idle();
+            d_started = true;
+            d_remaining = pmt::to_long(tags[tag_idx].value);
+            tag_idx++;
+            if (d_remaining <= 0) continue;
+        } else if (d_remaining == 0) {
+            consumed++;
+            continue;
+        }
+
+        push_byte(in[consumed]);
+        consumed++;
+        if (--d_remaining == 0) end_frame();
+    }
+
+    consume_each(consumed);
+    return produced;
+}
+
+} // namespace ethernet
+} // namespace gr
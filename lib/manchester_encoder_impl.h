@@ -0,0 +1,47 @@
+#ifndef INCLUDED_ETHERNET_MANCHESTER_ENCODER_IMPL_H
+#define INCLUDED_ETHERNET_MANCHESTER_ENCODER_IMPL_H
+
+#include <gnuradio/ethernet/manchester_encoder.h>
+#include <pmt/pmt.h>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+class manchester_encoder_impl : public manchester_encoder
+{
+private:
+    double d_samples_per_bit;
+    int d_idle_bits;
+    pmt::pmt_t d_len_tag_key;
+
+    bool d_started;
+    long d_remaining;
+    uint64_t d_half_bits;
+
+    std::vector<float> d_pending;
+    size_t d_pending_pos;
+
+    void push_half_bit(float level);
+    void push_byte(uint8_t byte);
+    void push_idle();
+    void end_frame();
+
+public:
+    manchester_encoder_impl(double samples_per_bit,
+                            int idle_bits,
+                            const std::string& len_tag_key);
+    ~manchester_encoder_impl();
+
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,57 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "mlt3_encoder_impl.h"
+#include <gnuradio/io_signature.h>
+
+namespace gr {
+namespace ethernet {
+
+mlt3_encoder::sptr mlt3_encoder::make(float amplitude)
+{
+    return gnuradio::make_block_sptr<mlt3_encoder_impl>(amplitude);
+}
+
+mlt3_encoder_impl::mlt3_encoder_impl(float amplitude)
+    : gr::sync_block("mlt3_encoder",
+                     gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                     gr::io_signature::make(1, 1, sizeof(float))),
+      d_amplitude(amplitude),
+      d_phase(0)
+{
+}
+
+mlt3_encoder_impl::~mlt3_encoder_impl() {}
+
+void mlt3_encoder_impl::set_amplitude(float amplitude)
+{
+    d_amplitude = amplitude;
+}
+
+float mlt3_encoder_impl::amplitude() const
+{
+    return d_amplitude;
+}
+
+int mlt3_encoder_impl::work(int noutput_items,
+                            gr_vector_const_void_star& input_items,
+                            gr_vector_void_star& output_items)
+{
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    float* out = (float*)output_items[0];
+
+    const float levels[4] = { 0.0f, d_amplitude, 0.0f, -d_amplitude };
+    int phase = d_phase;
+
+    for (int i = 0; i < noutput_items; i++) {
+        phase = (phase + (in[i] & 1)) & 3;
+        out[i] = levels[phase];
+    }
+
+    d_phase = phase;
+    return noutput_items;
+}
+
+} // namespace ethernet
+} // namespace gr
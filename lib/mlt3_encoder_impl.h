@@ -0,0 +1,30 @@
+#ifndef INCLUDED_ETHERNET_MLT3_ENCODER_IMPL_H
+#define INCLUDED_ETHERNET_MLT3_ENCODER_IMPL_H
+
+#include <gnuradio/ethernet/mlt3_encoder.h>
+
+namespace gr {
+namespace ethernet {
+
+class mlt3_encoder_impl : public mlt3_encoder
+{
+private:
+    float d_amplitude;
+    int d_phase;
+
+public:
+    mlt3_encoder_impl(float amplitude);
+    ~mlt3_encoder_impl();
+
+    void set_amplitude(float amplitude) override;
+    float amplitude() const override;
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -0,0 +1,271 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "multilane_decoder_impl.h"
+#include <gnuradio/ethernet/line_coding.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+template <class T>
+typename multilane_decoder_blk<T>::sptr multilane_decoder_blk<T>::make(const std::string& standard,
+                                                                        int lanes,
+                                                                        float threshold,
+                                                                        float gain,
+                                                                        int threads,
+                                                                        const std::vector<int>& cpus,
+                                                                        const std::string& len_tag_key)
+{
+    return gnuradio::make_block_sptr<multilane_decoder_impl<T>>(
+        standard, lanes, threshold, gain, threads, cpus, len_tag_key);
+}
+
+template <class T>
+multilane_decoder_impl<T>::multilane_decoder_impl(const std::string& standard,
+                                                  int lanes,
+                                                  float threshold,
+                                                  float gain,
+                                                  int threads,
+                                                  const std::vector<int>& cpus,
+                                                  const std::string& len_tag_key)
+    : gr::block("multilane_decoder",
+                gr::io_signature::make(lanes, lanes, sizeof(T)),
+                gr::io_signature::make(0, 1, sizeof(uint8_t))),
+      d_threads(std::min(threads, lanes)),
+      d_cpus(cpus),
+      d_n(0),
+      d_stream(len_tag_key),
+      d_emit_stream(false)
+{
+    if (lanes < 1 || lanes > 256) {
+        throw std::invalid_argument("multilane_decoder: lanes must be in [1, 256]");
+    }
+    if (threads < 0) throw std::invalid_argument("multilane_decoder: threads must be >= 0");
+    bool tx = standard == "100BASE-TX";
+    if (!tx && standard != "10BASE-T") {
+        throw std::invalid_argument("multilane_decoder: unknown standard " + standard);
+    }
+
+    for (int i = 0; i < lanes; i++) {
+        d_lanes.emplace_back(new lane);
+        if (tx) {
+            d_lanes.back()->tx.reset(new lane_100basetx<T>(threshold, gain));
+        } else {
+            d_lanes.back()->t10.reset(new lane_10baset<T>(threshold, gain));
+        }
+    }
+    d_in.resize(lanes);
+    d_decode = [this](size_t i) { decode(i); };
+
+    d_records_port = pmt::intern("records");
+    this->message_port_register_out(d_records_port);
+
+    // Byte output: at most one byte per 10 symbols or 16 samples, offsets
+    // unrelated to the inputs'
+    this->set_relative_rate(1, tx ? 10 : 16);
+    this->set_tag_propagation_policy(gr::block::TPP_DONT);
+}
+
+template <class T>
+multilane_decoder_impl<T>::~multilane_decoder_impl()
+{
+}
+
+template <class T>
+int multilane_decoder_impl<T>::lanes() const
+{
+    return d_lanes.size();
+}
+
+template <class T>
+int multilane_decoder_impl<T>::threads() const
+{
+    return d_threads;
+}
+
+template <class T>
+uint64_t multilane_decoder_impl<T>::frames_decoded() const
+{
+    return d_frames.get();
+}
+
+template <class T>
+uint64_t multilane_decoder_impl<T>::lane_frames(int lane) const
+{
+    if (lane < 0 || lane >= (int)d_lanes.size()) return 0;
+    return d_lanes[lane]->frames.get();
+}
+
+template <class T>
+bool multilane_decoder_impl<T>::start()
+{
+    d_pool.reset(new worker_pool(d_threads));
+    for (int k = 0; k < d_threads && k < (int)d_cpus.size(); k++) {
+        if (d_cpus[k] < 0 || d_pool->pin(k, d_cpus[k])) continue;
+        std::cout << "[Multi-Lane Decoder] could not pin worker " << k << " to CPU "
+                  << d_cpus[k] << std::endl;
+    }
+    return gr::block::start();
+}
+
+// Frames still held (and a 10BASE-T frame cut by the end of the stream)
+// are published, so that nothing decoded is lost.
+template <class T>
+bool multilane_decoder_impl<T>::stop()
+{
+    d_pool.reset();
+    // The scheduler no longer reads the byte output
+    d_emit_stream = false;
+    for (size_t i = 0; i < d_lanes.size(); i++) {
+        lane& l = *d_lanes[i];
+        if (l.t10) {
+            l.t10->flush([&l](const uint8_t* frame, size_t len, uint64_t start) {
+                keep(l, frame, len, start);
+            });
+        }
+    }
+    merge(std::numeric_limits<uint64_t>::max());
+    publish();
+    return gr::block::stop();
+}
+
+template <class T>
+void multilane_decoder_impl<T>::keep(lane& l, const uint8_t* frame, size_t len, uint64_t start)
+{
+    frame_arena::handle slot = l.arena.acquire();
+    slot->len = std::min(len, FRAME_SLOT_BYTES);
+    memcpy(slot->data, frame, slot->len);
+    slot->sample_offset = start;
+    slot->fcs_ok = check_fcs(frame, len);
+    l.pending.push_back(std::move(slot));
+    l.frames.add();
+}
+
+// Runs on the worker of lane i.
+template <class T>
+void multilane_decoder_impl<T>::decode(size_t i)
+{
+    lane& l = *d_lanes[i];
+    auto emit = [&l](const uint8_t* frame, size_t len, uint64_t start) {
+        keep(l, frame, len, start);
+    };
+    if (l.tx) {
+        l.tx->process(d_in[i], d_n, emit);
+    } else {
+        l.t10->process(d_in[i], d_n, emit);
+    }
+}
+
+// Adds to the batch, in (sample_offset, lane) order, the pending frames
+// that start before horizon.
+template <class T>
+void multilane_decoder_impl<T>::merge(uint64_t horizon)
+{
+    while (true) {
+        lane* next = nullptr;
+        size_t next_lane = 0;
+        for (size_t i = 0; i < d_lanes.size(); i++) {
+            lane& l = *d_lanes[i];
+            if (l.head == l.pending.size()) continue;
+            if (!next || l.pending[l.head]->sample_offset < next->pending[next->head]->sample_offset) {
+                next = &l;
+                next_lane = i;
+            }
+        }
+        if (!next) break;
+        frame_arena::handle& slot = next->pending[next->head];
+        if (slot->sample_offset >= horizon) break;
+        d_records.add(slot->data,
+                      slot->len,
+                      d_frames.get() + 1,
+                      slot->sample_offset,
+                      slot->fcs_ok,
+                      next_lane);
+        if (d_emit_stream) {
+            d_stream.add(slot->data, slot->len, slot->sample_offset, slot->fcs_ok, next_lane);
+        }
+        d_frames.add();
+        slot.reset();
+        next->head++;
+    }
+    for (auto& l : d_lanes) {
+        l->pending.erase(l->pending.begin(), l->pending.begin() + l->head);
+        l->head = 0;
+    }
+}
+
+template <class T>
+void multilane_decoder_impl<T>::publish()
+{
+    if (d_records.empty()) return;
+    const std::vector<uint8_t>& m = d_records.finish();
+    this->message_port_pub(d_records_port, pmt::init_u8vector(m.size(), m.data()));
+    d_records.clear();
+}
+
+// Writes queued frame bytes after the produced ones; returns the new total.
+template <class T>
+int multilane_decoder_impl<T>::write_stream(uint8_t* out, int produced, int noutput_items)
+{
+    return produced + d_stream.write(out + produced,
+                                     noutput_items - produced,
+                                     this->nitems_written(0) + produced,
+                                     [this](uint64_t offset, const pmt::pmt_t& key, const pmt::pmt_t& value) {
+                                         this->add_item_tag(0, offset, key, value);
+                                     });
+}
+
+template <class T>
+void multilane_decoder_impl<T>::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    // Queued frame bytes are written without new input
+    for (auto& n : ninput_items_required) n = d_stream.empty() ? 1 : 0;
+}
+
+template <class T>
+int multilane_decoder_impl<T>::general_work(int noutput_items,
+                                            gr_vector_int& ninput_items,
+                                            gr_vector_const_void_star& input_items,
+                                            gr_vector_void_star& output_items)
+{
+    uint8_t* out = output_items.empty() ? nullptr : (uint8_t*)output_items[0];
+    d_emit_stream = out != nullptr;
+
+    // Frames of the previous calls go first; the input waits until they fit
+    int produced = 0;
+    if (d_emit_stream) {
+        produced = write_stream(out, 0, noutput_items);
+        if (!d_stream.empty()) return produced;
+    }
+
+    // The lanes stay aligned: all take the same number of items
+    int n = *std::min_element(ninput_items.begin(), ninput_items.end());
+    for (size_t i = 0; i < d_lanes.size(); i++) d_in[i] = (const T*)input_items[i];
+    d_n = n;
+    d_pool->run(d_lanes.size(), d_decode);
+
+    // No lane can still emit a frame starting before the horizon
+    uint64_t horizon = std::numeric_limits<uint64_t>::max();
+    for (auto& l : d_lanes) {
+        horizon = std::min(horizon, l->tx ? l->tx->next_start() : l->t10->next_start());
+    }
+    merge(horizon);
+    publish();
+    this->consume_each(n);
+    if (d_emit_stream) produced = write_stream(out, produced, noutput_items);
+    return produced;
+}
+
+template class multilane_decoder_blk<float>;
+template class multilane_decoder_blk<std::int16_t>;
+template class multilane_decoder_blk<std::int8_t>;
+
+} // namespace ethernet
+} // namespace gr
@@ -0,0 +1,86 @@
+#ifndef INCLUDED_ETHERNET_MULTILANE_DECODER_IMPL_H
+#define INCLUDED_ETHERNET_MULTILANE_DECODER_IMPL_H
+
+#include "block_stats.h"
+#include "frame_arena.h"
+#include "frame_stream.h"
+#include "lane_decoder.h"
+#include "worker_pool.h"
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/multilane_decoder.h>
+#include <pmt/pmt.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+template <class T>
+class multilane_decoder_impl : public multilane_decoder_blk<T>
+{
+private:
+    // State of one input. The worker of the lane decodes into its arena and
+    // appends to pending; work() merges and releases once the workers are done.
+    struct lane {
+        std::unique_ptr<lane_100basetx<T>> tx;
+        std::unique_ptr<lane_10baset<T>> t10;
+        frame_arena arena;
+        std::vector<frame_arena::handle> pending; // in sample_offset order
+        size_t head;                              // first frame not published
+        stat_counter frames;
+
+        lane() : arena(4), head(0) { pending.reserve(16); }
+    };
+
+    const int d_threads;
+    const std::vector<int> d_cpus;
+    std::vector<std::unique_ptr<lane>> d_lanes;
+    std::unique_ptr<worker_pool> d_pool;
+    std::function<void(size_t)> d_decode;
+
+    // Input of the current work() call, read by the workers
+    std::vector<const T*> d_in;
+    size_t d_n;
+
+    frame_record_writer d_records;
+    pmt::pmt_t d_records_port;
+    stat_counter d_frames;
+    frame_stream d_stream;
+    bool d_emit_stream; // the byte output is connected
+
+    static void keep(lane& l, const uint8_t* frame, size_t len, uint64_t start);
+    void decode(size_t i);
+    void merge(uint64_t horizon);
+    void publish();
+    int write_stream(uint8_t* out, int produced, int noutput_items);
+
+public:
+    multilane_decoder_impl(const std::string& standard,
+                           int lanes,
+                           float threshold,
+                           float gain,
+                           int threads,
+                           const std::vector<int>& cpus,
+                           const std::string& len_tag_key);
+    ~multilane_decoder_impl();
+
+    int lanes() const override;
+    int threads() const override;
+    uint64_t frames_decoded() const override;
+    uint64_t lane_frames(int lane) const override;
+
+    bool start() override;
+    bool stop() override;
+
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
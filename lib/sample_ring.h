@@ -0,0 +1,94 @@
+#ifndef INCLUDED_ETHERNET_SAMPLE_RING_H
+#define INCLUDED_ETHERNET_SAMPLE_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Ring of the latest samples of a stream, for one writer and one reader,
+ * without locks. Sample s (counted from the first one pushed) lives in
+ * slot s % size() until s + size() is pushed.
+ *
+ * As in frame_ring, the reader copies first and checks afterwards: the
+ * writer announces how far it is going to write (claimed()) before it
+ * writes, and publishes it (written()) after. A copy of samples from s on
+ * is intact when, after the copy, nothing up to s + size() was claimed.
+ */
+template <class T>
+class sample_ring
+{
+public:
+    explicit sample_ring(size_t min_size)
+        : d_size(round_up(min_size)),
+          d_mask(d_size - 1),
+          d_buf(new T[d_size]()),
+          d_claimed(0),
+          d_written(0)
+    {
+    }
+
+    size_t size() const { return d_size; }
+
+    // Samples pushed so far.
+    uint64_t written() const { return d_written.load(std::memory_order_acquire); }
+
+    // Writer only.
+    void push(const T* in, size_t n)
+    {
+        uint64_t w = d_written.load(std::memory_order_relaxed);
+        uint64_t end = w + n;
+        // Only the last size() samples survive the call
+        if (n > d_size) {
+            in += n - d_size;
+            w += n - d_size;
+            n = d_size;
+        }
+        d_claimed.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        size_t i = w & d_mask;
+        size_t first = std::min(n, d_size - i);
+        memcpy(d_buf.get() + i, in, first * sizeof(T));
+        memcpy(d_buf.get(), in + first, (n - first) * sizeof(T));
+        d_written.store(end, std::memory_order_release);
+    }
+
+    /*
+     * Copies samples [start, start + n) to out, n <= size(). Returns false
+     * when some of them were overwritten, or are not written yet.
+     */
+    bool read(uint64_t start, size_t n, T* out) const
+    {
+        if (n > d_size || start + n > written()) return false;
+        size_t i = start & d_mask;
+        size_t first = std::min(n, d_size - i);
+        memcpy(out, d_buf.get() + i, first * sizeof(T));
+        memcpy(out + first, d_buf.get(), (n - first) * sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return d_claimed.load(std::memory_order_relaxed) <= start + d_size;
+    }
+
+private:
+    const size_t d_size;
+    const size_t d_mask;
+    std::unique_ptr<T[]> d_buf;
+    std::atomic<uint64_t> d_claimed;
+    std::atomic<uint64_t> d_written;
+
+    static size_t round_up(size_t n)
+    {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
@@ -4,54 +4,184 @@
 
 #include "slicer3_impl.h"
 #include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
 
 namespace gr {
 namespace ethernet {
 
-slicer3::sptr slicer3::make(float threshold)
+namespace {
+
+// Samples per threshold update, and weight of a window in the level estimates
+const int ADAPT_WINDOW = 1024;
+const float ADAPT_RATE = 0.25f;
+// Relative change of the threshold that is tagged
+const float TAG_CHANGE = 0.01f;
+// Lowest level estimate, in input units: a silent line stops tagging
+const float MIN_LEVEL = 1e-6f;
+
+} // namespace
+
+template <class T>
+typename slicer3_blk<T>::sptr
+slicer3_blk<T>::make(float threshold, float gain, bool adaptive, float fraction)
 {
-    return gnuradio::make_block_sptr<slicer3_impl>(threshold);
+    return gnuradio::make_block_sptr<slicer3_impl<T>>(threshold, gain, adaptive, fraction);
 }
 
-slicer3_impl::slicer3_impl(float threshold)
+template <class T>
+slicer3_impl<T>::slicer3_impl(float threshold, float gain, bool adaptive, float fraction)
     : gr::sync_block("slicer3",
-                     gr::io_signature::make(1, 1, sizeof(float)),
+                     gr::io_signature::make(1, 1, sizeof(T)),
                      gr::io_signature::make(1, 1, sizeof(float))),
-      d_threshold(threshold)
+      d_threshold(threshold),
+      d_gain(gain),
+      d_slicer(threshold, gain),
+      d_adaptive(adaptive),
+      d_fraction(fraction),
+      d_tagged(0),
+      d_tag_key(pmt::intern("threshold"))
 {
+    if (adaptive && !(fraction > 0 && fraction <= 1)) {
+        throw std::invalid_argument("fraction must be in (0, 1]");
+    }
+    restart(threshold);
 }
 
-slicer3_impl::~slicer3_impl() {}
+template <class T>
+slicer3_impl<T>::~slicer3_impl() {}
 
-void slicer3_impl::set_threshold(float threshold)
+// Called with d_mutex held, or from the constructor.
+template <class T>
+void slicer3_impl<T>::restart(float threshold)
 {
+    float level = std::max(std::fabs(threshold / d_gain) / d_fraction, MIN_LEVEL);
+    d_level_pos = level;
+    d_level_neg = level;
+    d_sum_pos = 0;
+    d_sum_neg = 0;
+    d_count_pos = 0;
+    d_count_neg = 0;
+    d_window_fill = 0;
+}
+
+template <class T>
+void slicer3_impl<T>::set_threshold(float threshold)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_slicer.set(threshold, d_gain);
     d_threshold = threshold;
+    if (d_adaptive) restart(threshold);
 }
 
-float slicer3_impl::threshold() const
+template <class T>
+float slicer3_impl<T>::threshold() const
 {
     return d_threshold;
 }
 
-int slicer3_impl::work(int noutput_items,
-                       gr_vector_const_void_star& input_items,
-                       gr_vector_void_star& output_items)
+template <class T>
+void slicer3_impl<T>::set_gain(float gain)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    // The adapted threshold stays put in input units, only its scale changes
+    float threshold = d_adaptive ? d_threshold / d_gain * gain : d_threshold.load();
+    d_slicer.set(threshold, gain);
+    d_threshold = threshold;
+    d_gain = gain;
+}
+
+template <class T>
+float slicer3_impl<T>::gain() const
+{
+    return d_gain;
+}
+
+template <class T>
+bool slicer3_impl<T>::adaptive() const
 {
-    const float* in = (const float*)input_items[0];
+    return d_adaptive;
+}
+
+template <class T>
+float slicer3_impl<T>::fraction() const
+{
+    return d_fraction;
+}
+
+// Called with d_mutex held at the end of a window; offset is the first
+// sample of the next one.
+template <class T>
+void slicer3_impl<T>::adapt(uint64_t offset)
+{
+    // A side without samples is above the signal: halve it
+    if (d_count_pos) {
+        d_level_pos += (d_sum_pos / d_count_pos - d_level_pos) * ADAPT_RATE;
+    } else {
+        d_level_pos = std::max(d_level_pos * 0.5f, MIN_LEVEL);
+    }
+    if (d_count_neg) {
+        d_level_neg += (d_sum_neg / d_count_neg - d_level_neg) * ADAPT_RATE;
+    } else {
+        d_level_neg = std::max(d_level_neg * 0.5f, MIN_LEVEL);
+    }
+    d_sum_pos = 0;
+    d_sum_neg = 0;
+    d_count_pos = 0;
+    d_count_neg = 0;
+
+    float threshold = d_fraction * 0.5f * (d_level_pos + d_level_neg) * d_gain;
+    d_slicer.set(threshold, d_gain);
+    d_threshold = threshold;
+    if (std::fabs(threshold - d_tagged) > TAG_CHANGE * d_tagged || d_tagged == 0) {
+        this->add_item_tag(0, offset, d_tag_key, pmt::from_double(threshold));
+        d_tagged = threshold;
+    }
+}
+
+template <class T>
+int slicer3_impl<T>::work(int noutput_items,
+                          gr_vector_const_void_star& input_items,
+                          gr_vector_void_star& output_items)
+{
+    const T* in = (const T*)input_items[0];
     float* out = (float*)output_items[0];
-    
-    for (int i = 0; i < noutput_items; i++) {
-        if (in[i] > d_threshold) {
-            out[i] = 1.0f;
-        } else if (in[i] < -d_threshold) {
-            out[i] = -1.0f;
-        } else {
-            out[i] = 0.0f;
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (!d_adaptive) {
+        for (int i = 0; i < noutput_items; i++) {
+            out[i] = (float)d_slicer(in[i]);
+        }
+        return noutput_items;
+    }
+
+    int i = 0;
+    while (i < noutput_items) {
+        int end = std::min(noutput_items, i + ADAPT_WINDOW - d_window_fill);
+        d_window_fill += end - i;
+        for (; i < end; i++) {
+            int level = d_slicer(in[i]);
+            out[i] = (float)level;
+            if (level > 0) {
+                d_sum_pos += in[i];
+                d_count_pos++;
+            } else if (level < 0) {
+                d_sum_neg -= in[i];
+                d_count_neg++;
+            }
+        }
+        if (d_window_fill == ADAPT_WINDOW) {
+            adapt(this->nitems_written(0) + i);
+            d_window_fill = 0;
         }
     }
-    
+
     return noutput_items;
 }
 
+template class slicer3_blk<float>;
+template class slicer3_blk<std::int16_t>;
+template class slicer3_blk<std::int8_t>;
+
 } // namespace ethernet
 } // namespace gr
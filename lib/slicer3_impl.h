@@ -1,23 +1,52 @@
 #ifndef INCLUDED_ETHERNET_SLICER3_IMPL_H
 #define INCLUDED_ETHERNET_SLICER3_IMPL_H
 
+#include "level_slicer.h"
 #include <gnuradio/ethernet/slicer3.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <mutex>
 
 namespace gr {
 namespace ethernet {
 
-class slicer3_impl : public slicer3
+template <class T>
+class slicer3_impl : public slicer3_blk<T>
 {
 private:
-    float d_threshold;
+    std::mutex d_mutex; // setters against work()
+    std::atomic<float> d_threshold;
+    float d_gain;
+    level_slicer<T> d_slicer;
+
+    // Adaptive mode: MLT-3 level estimates in input units, and the sums of
+    // the current window
+    const bool d_adaptive;
+    const float d_fraction;
+    float d_level_pos;
+    float d_level_neg;
+    float d_sum_pos;
+    float d_sum_neg;
+    int d_count_pos;
+    int d_count_neg;
+    int d_window_fill;
+    float d_tagged; // threshold of the last tag, 0 before the first
+    pmt::pmt_t d_tag_key;
+
+    void restart(float threshold);
+    void adapt(uint64_t offset);
 
 public:
-    slicer3_impl(float threshold);
+    slicer3_impl(float threshold, float gain, bool adaptive, float fraction);
     ~slicer3_impl();
-    
+
     void set_threshold(float threshold) override;
     float threshold() const override;
-    
+    void set_gain(float gain) override;
+    float gain() const override;
+    bool adaptive() const override;
+    float fraction() const override;
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items) override;
@@ -0,0 +1,366 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "snapshot_sink_impl.h"
+#include "frame_input.h"
+#include <gnuradio/io_signature.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+// Longest wait of the writer thread, should a wake-up from work() be missed
+const auto SAVE_PERIOD = std::chrono::milliseconds(100);
+
+const uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+// Capture Source format names
+template <class T>
+const char* sample_format();
+template <>
+const char* sample_format<float>() { return "float32"; }
+template <>
+const char* sample_format<std::int16_t>() { return "int16"; }
+template <>
+const char* sample_format<std::int8_t>() { return "int8"; }
+
+std::string json_string(const std::string& s)
+{
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c >= 0x20) out += c;
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+template <class T>
+typename snapshot_sink_blk<T>::sptr snapshot_sink_blk<T>::make(const std::string& prefix,
+                                                                int pre,
+                                                                int post,
+                                                                double samples_per_item,
+                                                                int delay,
+                                                                double samp_rate,
+                                                                int ring_size,
+                                                                int max_snapshots,
+                                                                const std::string& trigger_tag)
+{
+    return gnuradio::make_block_sptr<snapshot_sink_impl<T>>(prefix, pre, post, samples_per_item,
+                                                            delay, samp_rate, ring_size,
+                                                            max_snapshots, trigger_tag);
+}
+
+template <class T>
+snapshot_sink_impl<T>::snapshot_sink_impl(const std::string& prefix,
+                                          int pre,
+                                          int post,
+                                          double samples_per_item,
+                                          int delay,
+                                          double samp_rate,
+                                          int ring_size,
+                                          int max_snapshots,
+                                          const std::string& trigger_tag)
+    : gr::sync_block("snapshot_sink",
+                     gr::io_signature::make(1, 1, sizeof(T)),
+                     gr::io_signature::make(0, 0, 0)),
+      d_prefix(prefix),
+      d_pre(std::max(pre, 0)),
+      d_post(std::max(post, 0)),
+      d_samples_per_item(samples_per_item),
+      d_delay(delay),
+      d_samp_rate(samp_rate),
+      d_max_snapshots(std::max(max_snapshots, 0)),
+      d_tag_key(trigger_tag.empty() ? pmt::PMT_NIL : pmt::intern(trigger_tag)),
+      d_in_port(pmt::intern("trigger")),
+      d_ring(std::max<size_t>(std::max(ring_size, 1), d_pre + d_post)),
+      d_saving(false),
+      d_wake_at(NEVER),
+      d_running(false)
+{
+    if (prefix.empty()) {
+        throw std::invalid_argument("snapshot_sink: prefix must not be empty");
+    }
+    if (pre < 0 || post < 0 || pre + post == 0) {
+        throw std::invalid_argument("snapshot_sink: pre and post must be >= 0, not both 0");
+    }
+    if (!(samples_per_item > 0)) {
+        throw std::invalid_argument("snapshot_sink: samples_per_item must be positive");
+    }
+    this->message_port_register_in(d_in_port);
+    this->set_msg_handler(d_in_port, [this](const pmt::pmt_t& msg) { handle_trigger(msg); });
+
+    std::cout << "[Snapshot Sink] " << d_pre << " + " << d_post
+              << " samples per snapshot, ring of " << d_ring.size() << " samples, to "
+              << d_prefix << "_NNNNNN.raw" << std::endl;
+}
+
+template <class T>
+snapshot_sink_impl<T>::~snapshot_sink_impl()
+{
+    stop();
+}
+
+template <class T>
+bool snapshot_sink_impl<T>::start()
+{
+    d_running = true;
+    d_saver = std::thread([this] {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        while (d_running) {
+            d_wake.wait_for(lock, SAVE_PERIOD, [this] {
+                return !d_running ||
+                       d_ring.written() >= d_wake_at.load(std::memory_order_relaxed);
+            });
+            if (!d_running) break;
+            save_ready(lock, false);
+        }
+    });
+    return gr::block::start();
+}
+
+// Writes what the pending windows have, so that no trigger is lost at the end.
+template <class T>
+bool snapshot_sink_impl<T>::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (!d_running) return gr::block::stop();
+        d_running = false;
+    }
+    d_wake.notify_all();
+    d_saver.join();
+    {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        save_ready(lock, true);
+    }
+    return gr::block::stop();
+}
+
+template <class T>
+uint64_t snapshot_sink_impl<T>::raw_sample(uint64_t item) const
+{
+    double s = item * d_samples_per_item + d_delay;
+    return s > 0 ? (uint64_t)std::llround(s) : 0;
+}
+
+template <class T>
+void snapshot_sink_impl<T>::handle_trigger(const pmt::pmt_t& msg)
+{
+    pmt::pmt_t m = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    pmt::pmt_t offset = pmt::PMT_NIL;
+    if (pmt::is_integer(m) || pmt::is_uint64(m)) {
+        offset = m;
+    } else if (pmt::is_dict(m) && !pmt::dict_has_key(m, pmt::intern("frame"))) {
+        offset = pmt::dict_ref(m, pmt::intern("sample_offset"), pmt::PMT_NIL);
+    }
+    if (pmt::is_integer(offset) || pmt::is_uint64(offset)) {
+        trigger t = {};
+        t.reason = "message";
+        t.sample = raw_sample(pmt::is_uint64(offset) ? pmt::to_uint64(offset)
+                                                     : std::max(pmt::to_long(offset), 0L));
+        add_trigger(t);
+        return;
+    }
+    read_frames(msg, d_writer, [this](const uint8_t* data, size_t len) {
+        return add_records(data, len);
+    });
+}
+
+template <class T>
+bool snapshot_sink_impl<T>::add_records(const uint8_t* msg, size_t len)
+{
+    frame_record_reader batch;
+    if (!batch.open(msg, len)) return false;
+    for (size_t i = 0; i < batch.count(); i++) {
+        frame_record_view r = batch.record(i);
+        if (r.fcs_ok()) continue;
+        trigger t;
+        t.reason = "fcs";
+        t.from_frame = true;
+        t.frame_num = r.frame_num();
+        t.sample_offset = r.sample_offset();
+        t.time_ns = r.time_ns();
+        t.frame_len = r.frame_len();
+        t.lane = r.lane();
+        t.sample = raw_sample(t.sample_offset);
+        add_trigger(t);
+    }
+    return true;
+}
+
+template <class T>
+void snapshot_sink_impl<T>::add_trigger(const trigger& t)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_triggers.add();
+    if (!d_pending.empty()) {
+        window& last = d_pending.back();
+        if (t.sample >= last.start && t.sample < last.end) {
+            last.triggers.push_back(t);
+            return;
+        }
+    }
+    // Written, being saved or waiting: a failed save frees its place
+    uint64_t taken = d_written.get() + d_saving + d_pending.size();
+    if (d_max_snapshots && taken >= d_max_snapshots) {
+        d_dropped.add();
+        return;
+    }
+    window w;
+    w.start = t.sample > d_pre ? t.sample - d_pre : 0;
+    w.end = t.sample + d_post;
+    w.sample = t.sample;
+    w.triggers.push_back(t);
+    d_pending.push_back(std::move(w));
+    uint64_t end = d_pending.back().end;
+    if (end < d_wake_at.load(std::memory_order_relaxed)) {
+        d_wake_at.store(end, std::memory_order_relaxed);
+    }
+    if (d_ring.written() >= end) d_wake.notify_one();
+}
+
+// Saves the pending windows whose samples are all in, or already lost,
+// or all of them with what there is when all is set. Called with d_mutex
+// held through lock.
+template <class T>
+void snapshot_sink_impl<T>::save_ready(std::unique_lock<std::mutex>& lock, bool all)
+{
+    while (true) {
+        uint64_t written = d_ring.written();
+        auto it = d_pending.begin();
+        while (it != d_pending.end() && !all && written < it->end &&
+               written <= it->start + d_ring.size()) {
+            ++it;
+        }
+        if (it == d_pending.end()) break;
+
+        window w = std::move(*it);
+        d_pending.erase(it);
+        d_saving = true;
+        lock.unlock();
+        bool ok = save(w, all);
+        lock.lock();
+        d_saving = false;
+        if (ok) {
+            d_written.add();
+        } else {
+            d_dropped.add();
+        }
+    }
+    uint64_t wake_at = NEVER;
+    for (const window& w : d_pending) wake_at = std::min(wake_at, w.end);
+    d_wake_at.store(wake_at, std::memory_order_relaxed);
+}
+
+template <class T>
+bool snapshot_sink_impl<T>::save(const window& w, bool truncate)
+{
+    uint64_t end = truncate ? std::min(w.end, d_ring.written()) : w.end;
+    if (end <= w.start) return false;
+    size_t n = end - w.start;
+    d_copy.resize(n);
+    if (!d_ring.read(w.start, n, d_copy.data())) {
+        std::cout << "[Snapshot Sink] samples " << w.start << " to " << end
+                  << " overwritten before they were saved, ring_size too small?"
+                  << std::endl;
+        return false;
+    }
+    return write_files(w, end);
+}
+
+template <class T>
+bool snapshot_sink_impl<T>::write_files(const window& w, uint64_t end)
+{
+    char num[32];
+    snprintf(num, sizeof(num), "_%06llu", (unsigned long long)(d_written.get() + 1));
+    std::string raw_path = d_prefix + num + ".raw";
+    std::string json_path = d_prefix + num + ".json";
+
+    FILE* f = fopen(raw_path.c_str(), "wb");
+    if (!f) {
+        std::cout << "[Snapshot Sink] cannot write " << raw_path << ": " << strerror(errno)
+                  << std::endl;
+        return false;
+    }
+    bool ok = fwrite(d_copy.data(), sizeof(T), d_copy.size(), f) == d_copy.size();
+    ok &= fclose(f) == 0;
+
+    FILE* j = ok ? fopen(json_path.c_str(), "w") : nullptr;
+    if (!j) {
+        std::cout << "[Snapshot Sink] cannot write " << (ok ? json_path : raw_path) << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    size_t slash = raw_path.rfind('/');
+    std::string file = slash == std::string::npos ? raw_path : raw_path.substr(slash + 1);
+    fprintf(j, "{\n");
+    fprintf(j, "  \"file\": %s,\n", json_string(file).c_str());
+    fprintf(j, "  \"format\": \"%s\",\n", sample_format<T>());
+    fprintf(j, "  \"samp_rate\": %.17g,\n", d_samp_rate);
+    fprintf(j, "  \"first_sample\": %llu,\n", (unsigned long long)w.start);
+    fprintf(j, "  \"samples\": %llu,\n", (unsigned long long)(end - w.start));
+    fprintf(j, "  \"trigger_sample\": %llu,\n", (unsigned long long)w.sample);
+    fprintf(j, "  \"pre\": %llu,\n", (unsigned long long)(w.sample - w.start));
+    fprintf(j, "  \"post\": %llu,\n", (unsigned long long)(end > w.sample ? end - w.sample : 0));
+    fprintf(j, "  \"truncated\": %s,\n", end < w.end ? "true" : "false");
+    fprintf(j, "  \"time_ns\": %llu,\n", (unsigned long long)frame_record_time_ns());
+    fprintf(j, "  \"triggers\": [");
+    for (size_t i = 0; i < w.triggers.size(); i++) {
+        const trigger& t = w.triggers[i];
+        fprintf(j, "%s\n    {\"reason\": \"%s\", \"sample\": %llu", i ? "," : "", t.reason,
+                (unsigned long long)t.sample);
+        if (t.from_frame) {
+            fprintf(j,
+                    ", \"frame_num\": %llu, \"sample_offset\": %llu, \"time_ns\": %llu, "
+                    "\"frame_len\": %u, \"lane\": %u",
+                    (unsigned long long)t.frame_num, (unsigned long long)t.sample_offset,
+                    (unsigned long long)t.time_ns, (unsigned)t.frame_len, (unsigned)t.lane);
+        }
+        fprintf(j, "}");
+    }
+    fprintf(j, "\n  ]\n}\n");
+    return fclose(j) == 0;
+}
+
+template <class T>
+int snapshot_sink_impl<T>::work(int noutput_items,
+                                gr_vector_const_void_star& input_items,
+                                gr_vector_void_star& output_items)
+{
+    const T* in = (const T*)input_items[0];
+
+    if (!pmt::is_null(d_tag_key)) {
+        this->get_tags_in_window(d_tags, 0, 0, noutput_items, d_tag_key);
+        for (const tag_t& tag : d_tags) {
+            trigger t = {};
+            t.reason = "tag";
+            t.sample = tag.offset;
+            add_trigger(t);
+        }
+    }
+
+    d_ring.push(in, noutput_items);
+    if (d_ring.written() >= d_wake_at.load(std::memory_order_relaxed)) {
+        d_wake.notify_one();
+    }
+    return noutput_items;
+}
+
+template class snapshot_sink_blk<float>;
+template class snapshot_sink_blk<std::int16_t>;
+template class snapshot_sink_blk<std::int8_t>;
+
+} // namespace ethernet
+} // namespace gr
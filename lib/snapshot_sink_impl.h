@@ -0,0 +1,108 @@
+#ifndef INCLUDED_ETHERNET_SNAPSHOT_SINK_IMPL_H
+#define INCLUDED_ETHERNET_SNAPSHOT_SINK_IMPL_H
+
+#include "block_stats.h"
+#include "sample_ring.h"
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/snapshot_sink.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace ethernet {
+
+template <class T>
+class snapshot_sink_impl : public snapshot_sink_blk<T>
+{
+private:
+    struct trigger {
+        const char* reason; // "fcs", "message" or "tag"
+        uint64_t sample;    // raw sample
+        bool from_frame;    // the fields below are set
+        uint64_t frame_num;
+        uint64_t sample_offset;
+        uint64_t time_ns;
+        uint16_t frame_len;
+        uint8_t lane;
+    };
+
+    struct window {
+        uint64_t start;  // first raw sample
+        uint64_t end;    // past the last one
+        uint64_t sample; // first trigger
+        std::vector<trigger> triggers;
+    };
+
+    const std::string d_prefix;
+    const uint64_t d_pre;
+    const uint64_t d_post;
+    const double d_samples_per_item;
+    const int64_t d_delay;
+    const double d_samp_rate;
+    const uint64_t d_max_snapshots;
+    pmt::pmt_t d_tag_key; // PMT_NIL: no tag triggers
+    pmt::pmt_t d_in_port;
+
+    sample_ring<T> d_ring;
+
+    // The pending windows are shared by work(), the message handler and
+    // the writer thread
+    std::mutex d_mutex;
+    std::deque<window> d_pending;
+    bool d_saving; // a window taken from d_pending is being saved
+    frame_record_writer d_writer; // decoded dicts -> records
+
+    std::thread d_saver;
+    std::condition_variable d_wake;
+    std::atomic<uint64_t> d_wake_at; // end of the first pending window
+    bool d_running;
+
+    std::vector<T> d_copy; // writer thread only
+    std::vector<tag_t> d_tags;
+
+    stat_counter d_triggers; // d_mutex held
+    stat_counter d_dropped;  // d_mutex held
+    stat_counter d_written;  // d_mutex held
+
+    void handle_trigger(const pmt::pmt_t& msg);
+    bool add_records(const uint8_t* msg, size_t len);
+    uint64_t raw_sample(uint64_t item) const;
+    void add_trigger(const trigger& t);
+    void save_ready(std::unique_lock<std::mutex>& lock, bool all);
+    bool save(const window& w, bool truncate);
+    bool write_files(const window& w, uint64_t end);
+
+public:
+    snapshot_sink_impl(const std::string& prefix,
+                       int pre,
+                       int post,
+                       double samples_per_item,
+                       int delay,
+                       double samp_rate,
+                       int ring_size,
+                       int max_snapshots,
+                       const std::string& trigger_tag);
+    ~snapshot_sink_impl();
+
+    bool start() override;
+    bool stop() override;
+
+    uint64_t triggers() const override { return d_triggers.get(); }
+    uint64_t snapshots_written() const override { return d_written.get(); }
+    uint64_t snapshots_dropped() const override { return d_dropped.get(); }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
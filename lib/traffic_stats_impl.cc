@@ -0,0 +1,252 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "traffic_stats_impl.h"
+#include "frame_input.h"
+#include <gnuradio/io_signature.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace gr {
+namespace ethernet {
+
+namespace {
+
+const size_t CM_WIDTH = 2048;
+const size_t CM_DEPTH = 4;
+const int MAX_TOP_K = 1024;
+// Keys monitored per reported key: a key above 1/(SS_FACTOR * top_k) of the
+// traffic is never missed
+const size_t SS_FACTOR = 8;
+const uint8_t V4_MAPPED[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+
+enum { DIM_MAC, DIM_IP, DIM_PORT };
+
+// IPv4 addresses are stored IPv4-mapped, so both families share a dimension
+sketch_key ip_key(const uint8_t* addr, bool v4)
+{
+    sketch_key k;
+    if (v4) {
+        memcpy(k.b, V4_MAPPED, 12);
+        memcpy(k.b + 12, addr, 4);
+    } else {
+        memcpy(k.b, addr, 16);
+    }
+    return k;
+}
+
+std::string key_str(int dim, const sketch_key& k)
+{
+    char buf[16];
+    const uint8_t* b = k.b;
+    switch (dim) {
+    case DIM_MAC:
+        return format_mac(b);
+    case DIM_IP:
+        if (memcmp(b, V4_MAPPED, 12) == 0) return format_ip(4, b + 12);
+        return format_ip(6, b);
+    default:
+        snprintf(buf, sizeof(buf), "%s/%u", b[0] == 6 ? "tcp" : "udp", (b[1] << 8) | b[2]);
+        return buf;
+    }
+}
+
+} // namespace
+
+traffic_stats::sptr traffic_stats::make(int top_k, double interval_s, bool reset)
+{
+    return gnuradio::make_block_sptr<traffic_stats_impl>(top_k, interval_s, reset);
+}
+
+traffic_stats_impl::dimension::dimension(const char* name, size_t top_k)
+    : name(name),
+      packets(CM_WIDTH, CM_DEPTH),
+      bytes(CM_WIDTH, CM_DEPTH),
+      top_packets(SS_FACTOR * top_k),
+      top_bytes(SS_FACTOR * top_k),
+      top_k(top_k)
+{
+}
+
+void traffic_stats_impl::dimension::add(const sketch_key& key, uint64_t len)
+{
+    uint64_t h = key.hash();
+    packets.add(h, 1);
+    bytes.add(h, len);
+    top_packets.add(key, h, 1);
+    top_bytes.add(key, h, len);
+}
+
+void traffic_stats_impl::dimension::clear()
+{
+    packets.clear();
+    bytes.clear();
+    top_packets.clear();
+    top_bytes.clear();
+}
+
+traffic_stats_impl::traffic_stats_impl(int top_k, double interval_s, bool reset)
+    : gr::block("traffic_stats", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+      d_interval_ns(interval_s > 0 ? (uint64_t)(interval_s * 1e9) : 1000000000ULL),
+      d_reset(reset),
+      d_dims{ { "mac", (size_t)std::min(std::max(top_k, 1), MAX_TOP_K) },
+              { "ip", (size_t)std::min(std::max(top_k, 1), MAX_TOP_K) },
+              { "port", (size_t)std::min(std::max(top_k, 1), MAX_TOP_K) } },
+      d_frames(0),
+      d_bytes(0),
+      d_since_ns(frame_record_time_ns()),
+      d_running(false)
+{
+    d_in_port = pmt::intern("frames");
+    d_out_port = pmt::intern("summary");
+    message_port_register_in(d_in_port);
+    message_port_register_out(d_out_port);
+    set_msg_handler(d_in_port, [this](const pmt::pmt_t& msg) { handle_frames(msg); });
+}
+
+traffic_stats_impl::~traffic_stats_impl() { stop(); }
+
+uint64_t traffic_stats_impl::frames_received() const { return d_received.get(); }
+
+bool traffic_stats_impl::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_since_ns = frame_record_time_ns();
+    }
+    d_running = true;
+    d_snapshots = std::thread([this] {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        auto next = std::chrono::steady_clock::now() + std::chrono::nanoseconds(d_interval_ns);
+        while (d_running) {
+            d_wake.wait_until(lock, next);
+            if (!d_running) break;
+            if (std::chrono::steady_clock::now() < next) continue;
+            next += std::chrono::nanoseconds(d_interval_ns);
+            pmt::pmt_t s = snapshot(frame_record_time_ns());
+            lock.unlock();
+            message_port_pub(d_out_port, s);
+            lock.lock();
+        }
+    });
+    return block::start();
+}
+
+// Publishes a last snapshot, covering the end of the run.
+bool traffic_stats_impl::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (!d_running) return block::stop();
+        d_running = false;
+    }
+    d_wake.notify_all();
+    d_snapshots.join();
+    pmt::pmt_t s;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        s = snapshot(frame_record_time_ns());
+    }
+    message_port_pub(d_out_port, s);
+    return block::stop();
+}
+
+void traffic_stats_impl::handle_frames(const pmt::pmt_t& msg)
+{
+    read_frames(msg, d_writer, [this](const uint8_t* data, size_t len) {
+        return add_records(data, len);
+    });
+}
+
+bool traffic_stats_impl::add_records(const uint8_t* msg, size_t len)
+{
+    frame_record_reader batch;
+    if (!batch.open(msg, len)) return false;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (size_t i = 0; i < batch.count(); i++) account(batch.header(i));
+    return true;
+}
+
+// Called with d_mutex held.
+void traffic_stats_impl::account(const uint8_t* h)
+{
+    frame_record_view r(h);
+    uint64_t len = r.frame_len();
+    d_frames++;
+    d_bytes += len;
+
+    sketch_key mac_src, mac_dst;
+    memcpy(mac_src.b, r.mac_src(), 6);
+    memcpy(mac_dst.b, r.mac_dst(), 6);
+    d_dims[DIM_MAC].add(mac_src, len);
+    d_distinct_macs.add(mac_src.hash());
+    d_distinct_macs.add(mac_dst.hash());
+
+    if (r.ip_version()) {
+        bool v4 = r.ip_version() == 4;
+        sketch_key src = ip_key(r.ip_src(), v4);
+        d_dims[DIM_IP].add(src, len);
+        d_distinct_ips.add(src.hash());
+        d_distinct_ips.add(ip_key(r.ip_dst(), v4).hash());
+
+        if (r.has_ports()) {
+            sketch_key port;
+            port.b[0] = r.ip_proto();
+            port.b[1] = r.dst_port() >> 8;
+            port.b[2] = r.dst_port() & 0xFF;
+            d_dims[DIM_PORT].add(port, len);
+        }
+    }
+    d_received.add();
+}
+
+// Called with d_mutex held.
+pmt::pmt_t traffic_stats_impl::snapshot(uint64_t now)
+{
+    pmt::pmt_t s = pmt::make_dict();
+    s = pmt::dict_add(s, pmt::intern("start_ns"), pmt::from_uint64(d_since_ns));
+    s = pmt::dict_add(s, pmt::intern("end_ns"), pmt::from_uint64(now));
+    s = pmt::dict_add(s, pmt::intern("frames"), pmt::from_uint64(d_frames));
+    s = pmt::dict_add(s, pmt::intern("bytes"), pmt::from_uint64(d_bytes));
+    s = pmt::dict_add(s, pmt::intern("distinct_macs"), pmt::from_uint64(d_distinct_macs.estimate()));
+    s = pmt::dict_add(s, pmt::intern("distinct_ips"), pmt::from_uint64(d_distinct_ips.estimate()));
+
+    for (int dim = 0; dim < 3; dim++) {
+        dimension& d = d_dims[dim];
+        for (int by_bytes = 0; by_bytes < 2; by_bytes++) {
+            std::vector<space_saving::item> top =
+                by_bytes ? d.top_bytes.top(d.top_k) : d.top_packets.top(d.top_k);
+            pmt::pmt_t list = pmt::make_vector(top.size(), pmt::PMT_NIL);
+            for (size_t i = 0; i < top.size(); i++) {
+                const space_saving::item& it = top[i];
+                uint64_t h = it.key.hash();
+                uint64_t packets = by_bytes ? d.packets.estimate(h) : it.count;
+                uint64_t bytes = by_bytes ? it.count : d.bytes.estimate(h);
+                pmt::pmt_t e = pmt::make_dict();
+                e = pmt::dict_add(e, pmt::intern("key"), pmt::intern(key_str(dim, it.key)));
+                e = pmt::dict_add(e, pmt::intern("packets"), pmt::from_uint64(packets));
+                e = pmt::dict_add(e, pmt::intern("bytes"), pmt::from_uint64(bytes));
+                e = pmt::dict_add(e, pmt::intern("error"), pmt::from_uint64(it.error));
+                pmt::vector_set(list, i, e);
+            }
+            std::string name = std::string("top_") + d.name + (by_bytes ? "_bytes" : "_packets");
+            s = pmt::dict_add(s, pmt::intern(name), list);
+        }
+    }
+
+    if (d_reset) {
+        for (auto& d : d_dims) d.clear();
+        d_distinct_macs.clear();
+        d_distinct_ips.clear();
+        d_frames = 0;
+        d_bytes = 0;
+        d_since_ns = now;
+    }
+    return s;
+}
+
+} // namespace ethernet
+} // namespace gr
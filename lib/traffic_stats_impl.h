@@ -0,0 +1,73 @@
+#ifndef INCLUDED_ETHERNET_TRAFFIC_STATS_IMPL_H
+#define INCLUDED_ETHERNET_TRAFFIC_STATS_IMPL_H
+
+#include "block_stats.h"
+#include "sketches.h"
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/traffic_stats.h>
+#include <pmt/pmt.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace gr {
+namespace ethernet {
+
+class traffic_stats_impl : public traffic_stats
+{
+private:
+    // Sketches of one dimension (source MAC, source IP, destination port)
+    struct dimension {
+        const char* name;
+        count_min packets;
+        count_min bytes;
+        space_saving top_packets;
+        space_saving top_bytes;
+        size_t top_k;
+
+        dimension(const char* name, size_t top_k);
+        void add(const sketch_key& key, uint64_t len);
+        void clear();
+    };
+
+    pmt::pmt_t d_in_port;
+    pmt::pmt_t d_out_port;
+
+    uint64_t d_interval_ns;
+    bool d_reset;
+
+    // Sketches are shared by the message handler and the snapshot thread
+    std::mutex d_mutex;
+    dimension d_dims[3];
+    hyperloglog d_distinct_macs;
+    hyperloglog d_distinct_ips;
+    uint64_t d_frames;
+    uint64_t d_bytes;
+    uint64_t d_since_ns; // start of the period covered
+    frame_record_writer d_writer; // decoded dicts -> records
+
+    std::thread d_snapshots;
+    std::condition_variable d_wake;
+    bool d_running;
+
+    stat_counter d_received;
+
+    void handle_frames(const pmt::pmt_t& msg);
+    bool add_records(const uint8_t* msg, size_t len);
+    void account(const uint8_t* header);
+    pmt::pmt_t snapshot(uint64_t now);
+
+public:
+    traffic_stats_impl(int top_k, double interval_s, bool reset);
+    ~traffic_stats_impl();
+
+    bool start() override;
+    bool stop() override;
+
+    uint64_t frames_received() const override;
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
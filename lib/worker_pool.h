@@ -0,0 +1,112 @@
+#ifndef INCLUDED_ETHERNET_WORKER_POOL_H
+#define INCLUDED_ETHERNET_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace gr {
+namespace ethernet {
+
+/*
+ * Fixed set of threads running one batch of tasks at a time. Task i always
+ * runs on thread i % size(), so per-task state stays on the same thread,
+ * and on the same core once the threads are pinned. run() returns when
+ * every task of the batch is done; with no threads, the tasks run on the
+ * caller. Only one thread calls run().
+ */
+class worker_pool
+{
+public:
+    explicit worker_pool(size_t threads)
+        : d_task(nullptr), d_tasks(0), d_generation(0), d_pending(0), d_stop(false)
+    {
+        d_threads.reserve(threads);
+        for (size_t k = 0; k < threads; k++) {
+            d_threads.emplace_back([this, k] { loop(k); });
+        }
+    }
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_stop = true;
+        }
+        d_wake.notify_all();
+        for (auto& t : d_threads) t.join();
+    }
+
+    size_t size() const { return d_threads.size(); }
+
+    void run(size_t n, const std::function<void(size_t)>& task)
+    {
+        if (d_threads.empty()) {
+            for (size_t i = 0; i < n; i++) task(i);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(d_mutex);
+        d_task = &task;
+        d_tasks = n;
+        d_pending = d_threads.size();
+        d_generation++;
+        d_wake.notify_all();
+        d_done.wait(lock, [this] { return d_pending == 0; });
+        d_task = nullptr;
+    }
+
+    // Restricts thread k to one CPU; false when that is not possible.
+    bool pin(size_t k, int cpu)
+    {
+#ifdef __linux__
+        if (k >= d_threads.size() || cpu < 0 || cpu >= CPU_SETSIZE) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(d_threads[k].native_handle(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+private:
+    std::vector<std::thread> d_threads;
+    std::mutex d_mutex;
+    std::condition_variable d_wake;
+    std::condition_variable d_done;
+    const std::function<void(size_t)>* d_task;
+    size_t d_tasks;
+    uint64_t d_generation;
+    size_t d_pending;
+    bool d_stop;
+
+    void loop(size_t k)
+    {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(d_mutex);
+        while (true) {
+            d_wake.wait(lock, [&] { return d_stop || d_generation != seen; });
+            if (d_stop) return;
+            seen = d_generation;
+            const std::function<void(size_t)>& task = *d_task;
+            size_t n = d_tasks;
+            lock.unlock();
+            for (size_t i = k; i < n; i += d_threads.size()) task(i);
+            lock.lock();
+            if (--d_pending == 0) d_done.notify_one();
+        }
+    }
+};
+
+} // namespace ethernet
+} // namespace gr
+
+#endif
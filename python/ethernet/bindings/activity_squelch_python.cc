@@ -0,0 +1,35 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/activity_squelch.h>
+
+template <class T>
+void bind_activity_squelch_template(py::module& m, const char* classname)
+{
+    using activity_squelch_blk = ::gr::ethernet::activity_squelch_blk<T>;
+
+    py::class_<activity_squelch_blk, gr::block, gr::basic_block,
+               std::shared_ptr<activity_squelch_blk>>(m, classname, py::dynamic_attr())
+        .def(py::init(&activity_squelch_blk::make),
+             py::arg("samp_rate"),
+             py::arg("threshold") = 0.1f,
+             py::arg("pre") = 1e-6,
+             py::arg("post") = 1e-6,
+             "Creates a 10BASE-T activity squelch block")
+        .def("set_threshold", &activity_squelch_blk::set_threshold, py::arg("threshold"))
+        .def("threshold", &activity_squelch_blk::threshold)
+        .def("bursts", &activity_squelch_blk::bursts)
+        .def("samples_dropped", &activity_squelch_blk::samples_dropped)
+        .def("nlp_count", &activity_squelch_blk::nlp_count)
+        .def("flp_count", &activity_squelch_blk::flp_count);
+}
+
+void bind_activity_squelch(py::module& m)
+{
+    bind_activity_squelch_template<float>(m, "activity_squelch");
+    bind_activity_squelch_template<std::int16_t>(m, "activity_squelch_s");
+    bind_activity_squelch_template<std::int8_t>(m, "activity_squelch_b");
+}
@@ -0,0 +1,202 @@
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/batch_decode.h>
+
+namespace {
+
+using ::gr::ethernet::frame_record_reader;
+using ::gr::ethernet::frame_record_writer;
+
+template <typename T>
+using in_array = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Version 1 record header, same names as the web inspector's dtype
+py::dtype record_dtype()
+{
+    static const struct {
+        const char* name;
+        const char* format;
+        int offset;
+    } fields[] = {
+        { "frame_num", "<u8", 0 },   { "sample_offset", "<u8", 8 }, { "time_ns", "<u8", 16 },
+        { "data_offset", "<u4", 24 }, { "frame_len", "<u2", 28 },  { "flags", "<u2", 30 },
+        { "ethertype", "<u2", 32 },   { "vlan_tci", "<u2", 34 },   { "l3_offset", "<u2", 36 },
+        { "l4_offset", "<u2", 38 },   { "src_port", "<u2", 40 },   { "dst_port", "<u2", 42 },
+        { "ip_proto", "u1", 44 },     { "ip_ttl", "u1", 45 },      { "tcp_flags", "u1", 46 },
+        { "icmp_type", "u1", 47 },    { "icmp_code", "u1", 48 },   { "lane", "u1", 49 },
+        { "mac_dst", "V6", 52 },      { "mac_src", "V6", 58 },     { "ip_src", "V16", 64 },
+        { "ip_dst", "V16", 80 },
+    };
+    py::list names, formats, offsets;
+    for (const auto& f : fields) {
+        names.append(f.name);
+        formats.append(f.format);
+        offsets.append(f.offset);
+    }
+    py::dict spec;
+    spec["names"] = names;
+    spec["formats"] = formats;
+    spec["offsets"] = offsets;
+    spec["itemsize"] = ::gr::ethernet::FRAME_RECORD_SIZE;
+    return py::dtype::from_args(spec);
+}
+
+// NumPy array owning the vector's buffer, without a copy
+template <typename T>
+py::array_t<T> to_array(std::vector<T>&& v)
+{
+    auto* owned = new std::vector<T>(std::move(v));
+    py::capsule base(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), base);
+}
+
+// (records, data): one structured element per frame, viewing the batch in
+// place, and the frame bytes, indexed by the records' data_offset
+py::tuple to_records(frame_record_writer& w)
+{
+    auto* msg = new std::vector<uint8_t>(w.finish());
+    py::capsule base(msg, [](void* p) { delete static_cast<std::vector<uint8_t>*>(p); });
+    frame_record_reader batch;
+    batch.open(msg->data(), msg->size());
+    size_t data_offset = msg->size();
+    if (batch.count() > 0) {
+        size_t len;
+        data_offset = batch.frame(0, len) - msg->data();
+    }
+    py::array records(record_dtype(),
+                      { (py::ssize_t)batch.count() },
+                      { (py::ssize_t)::gr::ethernet::FRAME_RECORD_SIZE },
+                      msg->data() + ::gr::ethernet::FRAME_RECORD_BATCH_HEADER,
+                      base);
+    py::bytes data((const char*)msg->data() + data_offset, msg->size() - data_offset);
+    return py::make_tuple(records, data);
+}
+
+// Functions that slice samples, for one input array type. Integer arrays
+// are taken as they are; other arrays are converted to float32.
+template <typename A>
+void bind_sliced(py::module& m, bool doc)
+{
+    m.def(
+        "decode_100basetx",
+        [](A symbols, float threshold, int idle_run, float gain) {
+            frame_record_writer w;
+            {
+                py::gil_scoped_release release;
+                ::gr::ethernet::decode_100basetx(symbols.data(), symbols.size(), w, threshold,
+                                                 idle_run, gain);
+            }
+            return to_records(w);
+        },
+        py::arg("symbols"),
+        py::arg("threshold") = 0.25f,
+        py::arg("idle_run") = 40,
+        py::arg("gain") = 1.0f,
+        doc ? "Frames of 100BASE-TX symbols (one per symbol): (records, data). "
+              "records is a structured array of binary frame record headers; frame i is "
+              "data[r.data_offset : r.data_offset + r.frame_len]."
+            : "");
+
+    m.def(
+        "decode_10baset",
+        [](A samples, float threshold, float gain) {
+            frame_record_writer w;
+            {
+                py::gil_scoped_release release;
+                ::gr::ethernet::decode_10baset(samples.data(), samples.size(), w, threshold, gain);
+            }
+            return to_records(w);
+        },
+        py::arg("samples"),
+        py::arg("threshold") = 0.1f,
+        py::arg("gain") = 1.0f,
+        doc ? "Frames of 10BASE-T half-bit samples (two per bit): (records, data)." : "");
+
+    m.def(
+        "mlt3_decode",
+        [](A symbols, float threshold, float gain) {
+            py::array_t<uint8_t> bits(symbols.size());
+            uint8_t* out = bits.mutable_data();
+            {
+                py::gil_scoped_release release;
+                ::gr::ethernet::mlt3_decode(symbols.data(), symbols.size(), threshold, out, gain);
+            }
+            return bits;
+        },
+        py::arg("symbols"),
+        py::arg("threshold") = 0.25f,
+        py::arg("gain") = 1.0f,
+        doc ? "Scrambled bits (uint8) of MLT-3 symbols, as Slicer3 + MLT-3 to Scrambled." : "");
+}
+
+} // namespace
+
+void bind_batch_decode(py::module& m)
+{
+    // Exact integer types first: overloads are tried in order
+    bind_sliced<py::array_t<int8_t, py::array::c_style>>(m, false);
+    bind_sliced<py::array_t<int16_t, py::array::c_style>>(m, false);
+    bind_sliced<in_array<float>>(m, true);
+
+    m.def(
+        "descramble",
+        [](in_array<uint8_t> bits,
+           int search_window,
+           int idle_run,
+           int max_idle_no_idle,
+           int max_in_frame_no_idle,
+           int idle_errors) {
+            py::array_t<uint8_t> out(bits.size());
+            uint8_t* o = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                ::gr::ethernet::descramble(bits.data(),
+                                           bits.size(),
+                                           o,
+                                           search_window,
+                                           idle_run,
+                                           max_idle_no_idle,
+                                           max_in_frame_no_idle,
+                                           idle_errors);
+            }
+            return out;
+        },
+        py::arg("bits"),
+        py::arg("search_window") = 50,
+        py::arg("idle_run") = 40,
+        py::arg("max_idle_no_idle") = 100,
+        py::arg("max_in_frame_no_idle") = 20000,
+        py::arg("idle_errors") = 0,
+        "Descrambled 100BASE-TX bits (uint8), as by fastethernet_descrambler with the same "
+        "parameters; bits are copied while unlocked.");
+
+    m.def(
+        "decode_4b5b",
+        [](in_array<uint8_t> bits) {
+            frame_record_writer w;
+            {
+                py::gil_scoped_release release;
+                ::gr::ethernet::decode_4b5b(bits.data(), bits.size(), w);
+            }
+            return to_records(w);
+        },
+        py::arg("bits"),
+        "Frames of descrambled 100BASE-TX bits (uint8): (records, data).");
+
+    m.def(
+        "manchester_decode",
+        [](in_array<uint8_t> halfbits) {
+            std::vector<uint8_t> bits(halfbits.size() / 2);
+            {
+                py::gil_scoped_release release;
+                bits.resize(::gr::ethernet::manchester_decode(halfbits.data(), halfbits.size(),
+                                                              bits.data()));
+            }
+            return to_array(std::move(bits));
+        },
+        py::arg("halfbits"),
+        "Bits (uint8) of Manchester half-bit pairs: 01 is 1, 10 is 0, others are dropped.");
+}
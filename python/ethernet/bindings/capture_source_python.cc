@@ -0,0 +1,27 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/capture_source.h>
+
+void bind_capture_source(py::module& m)
+{
+    using capture_source = ::gr::ethernet::capture_source;
+
+    py::class_<capture_source, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<capture_source>>(m, "capture_source", py::dynamic_attr())
+        .def(py::init(&capture_source::make),
+             py::arg("filename"),
+             py::arg("format") = "float32",
+             py::arg("samp_rate") = 0,
+             py::arg("scale") = 1.0f,
+             py::arg("header_bytes") = 0,
+             py::arg("repeat") = false,
+             "Creates a memory-mapped oscilloscope capture source")
+        .def("nsamples", &capture_source::nsamples)
+        .def("samp_rate", &capture_source::samp_rate)
+        .def("set_scale", &capture_source::set_scale, py::arg("scale"))
+        .def("scale", &capture_source::scale);
+}
@@ -10,9 +10,29 @@ void bind_ethernet_10baset_decoder(py::module& m)
 {
     using ethernet_10baset_decoder = ::gr::ethernet::ethernet_10baset_decoder;
 
-    py::class_<ethernet_10baset_decoder, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<ethernet_10baset_decoder, gr::block, gr::basic_block,
                std::shared_ptr<ethernet_10baset_decoder>>(m, "ethernet_10baset_decoder", py::dynamic_attr())
         .def(py::init(&ethernet_10baset_decoder::make),
              py::arg("tag_name") = "packet",
-             "Creates an Ethernet 10BASE-T decoder");
+             py::arg("stats_interval_ms") = 0,
+             py::arg("trace_latency") = false,
+             py::arg("filter") = "",
+             py::arg("batch_size") = 0,
+             py::arg("batch_bytes") = 0,
+             py::arg("batch_timeout_ms") = 0,
+             py::arg("len_tag_key") = "packet_len",
+             "Creates an Ethernet 10BASE-T decoder")
+        .def("set_stats_interval", &ethernet_10baset_decoder::set_stats_interval,
+             py::arg("stats_interval_ms"))
+        .def("stats_interval", &ethernet_10baset_decoder::stats_interval)
+        .def("set_trace_latency", &ethernet_10baset_decoder::set_trace_latency,
+             py::arg("trace_latency"))
+        .def("trace_latency", &ethernet_10baset_decoder::trace_latency)
+        .def("set_filter", &ethernet_10baset_decoder::set_filter, py::arg("filter"))
+        .def("filter", &ethernet_10baset_decoder::filter)
+        .def("frames_decoded", &ethernet_10baset_decoder::frames_decoded)
+        .def("fcs_failures", &ethernet_10baset_decoder::fcs_failures)
+        .def("frames_filtered", &ethernet_10baset_decoder::frames_filtered)
+        .def("work_calls", &ethernet_10baset_decoder::work_calls)
+        .def("work_ticks", &ethernet_10baset_decoder::work_ticks);
 }
@@ -0,0 +1,19 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/ethernet_framer.h>
+
+void bind_ethernet_framer(py::module& m)
+{
+    using ethernet_framer = ::gr::ethernet::ethernet_framer;
+
+    py::class_<ethernet_framer, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<ethernet_framer>>(m, "ethernet_framer", py::dynamic_attr())
+        .def(py::init(&ethernet_framer::make),
+             py::arg("repeat") = false,
+             py::arg("len_tag_key") = "packet_len",
+             "Creates an Ethernet framer (preamble, SFD, padding and FCS)");
+}
@@ -0,0 +1,19 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/fastethernet_4b5b_encoder.h>
+
+void bind_fastethernet_4b5b_encoder(py::module& m)
+{
+    using fastethernet_4b5b_encoder = ::gr::ethernet::fastethernet_4b5b_encoder;
+
+    py::class_<fastethernet_4b5b_encoder, gr::block, gr::basic_block,
+               std::shared_ptr<fastethernet_4b5b_encoder>>(m, "fastethernet_4b5b_encoder", py::dynamic_attr())
+        .def(py::init(&fastethernet_4b5b_encoder::make),
+             py::arg("idle_symbols") = 24,
+             py::arg("len_tag_key") = "packet_len",
+             "Creates a 100BASE-TX 4B/5B encoder");
+}
@@ -18,5 +18,24 @@ void bind_fastethernet_descrambler(py::module& m)
              py::arg("max_idle_no_idle") = 100,
              py::arg("max_in_frame_no_idle") = 20000,
              py::arg("print_debug") = false,
-             "Creates a Fast Ethernet descrambler with auto-resync");
+             py::arg("stats_interval_ms") = 0,
+             py::arg("ber_window") = 0,
+             py::arg("idle_errors") = 0,
+             "Creates a Fast Ethernet descrambler with auto-resync")
+        .def("set_stats_interval", &fastethernet_descrambler::set_stats_interval,
+             py::arg("stats_interval_ms"))
+        .def("stats_interval", &fastethernet_descrambler::stats_interval)
+        .def("locked", &fastethernet_descrambler::locked)
+        .def("resync_count", &fastethernet_descrambler::resync_count)
+        .def("last_lock_bits", &fastethernet_descrambler::last_lock_bits)
+        .def("unlocked_bits", &fastethernet_descrambler::unlocked_bits)
+        .def("fast_relocks", &fastethernet_descrambler::fast_relocks)
+        .def("lock_holds", &fastethernet_descrambler::lock_holds)
+        .def("idle_bits", &fastethernet_descrambler::idle_bits)
+        .def("idle_bit_errors", &fastethernet_descrambler::idle_bit_errors)
+        .def("ber", &fastethernet_descrambler::ber)
+        .def("line_seconds", &fastethernet_descrambler::line_seconds)
+        .def("errored_seconds", &fastethernet_descrambler::errored_seconds)
+        .def("work_calls", &fastethernet_descrambler::work_calls)
+        .def("work_ticks", &fastethernet_descrambler::work_ticks);
 }
@@ -10,8 +10,31 @@ void bind_fastethernet_frame_decoder(py::module& m)
 {
     using fastethernet_frame_decoder = ::gr::ethernet::fastethernet_frame_decoder;
 
-    py::class_<fastethernet_frame_decoder, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<fastethernet_frame_decoder, gr::block, gr::basic_block,
                std::shared_ptr<fastethernet_frame_decoder>>(m, "fastethernet_frame_decoder", py::dynamic_attr())
         .def(py::init(&fastethernet_frame_decoder::make),
-             "Creates a Fast Ethernet frame decoder (100BASE-TX)");
+             py::arg("stats_interval_ms") = 0,
+             py::arg("trace_latency") = false,
+             py::arg("filter") = "",
+             py::arg("batch_size") = 0,
+             py::arg("batch_bytes") = 0,
+             py::arg("batch_timeout_ms") = 0,
+             py::arg("len_tag_key") = "packet_len",
+             "Creates a Fast Ethernet frame decoder (100BASE-TX)")
+        .def("set_stats_interval", &fastethernet_frame_decoder::set_stats_interval,
+             py::arg("stats_interval_ms"))
+        .def("stats_interval", &fastethernet_frame_decoder::stats_interval)
+        .def("set_trace_latency", &fastethernet_frame_decoder::set_trace_latency,
+             py::arg("trace_latency"))
+        .def("trace_latency", &fastethernet_frame_decoder::trace_latency)
+        .def("set_filter", &fastethernet_frame_decoder::set_filter, py::arg("filter"))
+        .def("filter", &fastethernet_frame_decoder::filter)
+        .def("frames_decoded", &fastethernet_frame_decoder::frames_decoded)
+        .def("frames_timed_out", &fastethernet_frame_decoder::frames_timed_out)
+        .def("decode_errors", &fastethernet_frame_decoder::decode_errors)
+        .def("code_violations", &fastethernet_frame_decoder::code_violations)
+        .def("fcs_failures", &fastethernet_frame_decoder::fcs_failures)
+        .def("frames_filtered", &fastethernet_frame_decoder::frames_filtered)
+        .def("work_calls", &fastethernet_frame_decoder::work_calls)
+        .def("work_ticks", &fastethernet_frame_decoder::work_ticks);
 }
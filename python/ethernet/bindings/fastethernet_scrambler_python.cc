@@ -0,0 +1,18 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/fastethernet_scrambler.h>
+
+void bind_fastethernet_scrambler(py::module& m)
+{
+    using fastethernet_scrambler = ::gr::ethernet::fastethernet_scrambler;
+
+    py::class_<fastethernet_scrambler, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<fastethernet_scrambler>>(m, "fastethernet_scrambler", py::dynamic_attr())
+        .def(py::init(&fastethernet_scrambler::make),
+             py::arg("seed") = 0x7FF,
+             "Creates a 100BASE-TX scrambler");
+}
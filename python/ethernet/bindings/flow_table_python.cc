@@ -0,0 +1,24 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/flow_table.h>
+
+void bind_flow_table(py::module& m)
+{
+    using flow_table = ::gr::ethernet::flow_table;
+
+    py::class_<flow_table, gr::block, gr::basic_block,
+               std::shared_ptr<flow_table>>(m, "flow_table", py::dynamic_attr())
+        .def(py::init(&flow_table::make),
+             py::arg("max_flows") = 65536,
+             py::arg("idle_timeout_s") = 30.0,
+             py::arg("report_interval_s") = 0.0,
+             "Per-flow accounting of decoded frames, reported on expiry or at intervals")
+        .def("active_flows", &flow_table::active_flows)
+        .def("flows_expired", &flow_table::flows_expired)
+        .def("flows_evicted", &flow_table::flows_evicted)
+        .def("frames_received", &flow_table::frames_received);
+}
@@ -0,0 +1,22 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/frame_record_zmq_sink.h>
+
+void bind_frame_record_zmq_sink(py::module& m)
+{
+    using frame_record_zmq_sink = ::gr::ethernet::frame_record_zmq_sink;
+
+    py::class_<frame_record_zmq_sink, gr::block, gr::basic_block,
+               std::shared_ptr<frame_record_zmq_sink>>(m, "frame_record_zmq_sink", py::dynamic_attr())
+        .def(py::init(&frame_record_zmq_sink::make),
+             py::arg("address") = "tcp://127.0.0.1:5556",
+             py::arg("bind") = true,
+             py::arg("hwm") = -1,
+             "Publishes binary frame record batches on a ZMQ PUB socket")
+        .def("batches_sent", &frame_record_zmq_sink::batches_sent)
+        .def("batches_dropped", &frame_record_zmq_sink::batches_dropped);
+}
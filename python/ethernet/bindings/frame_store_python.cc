@@ -0,0 +1,86 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/frame_store.h>
+
+void bind_frame_store(py::module& m)
+{
+    using frame_store = ::gr::ethernet::frame_store;
+
+    py::class_<frame_store, std::shared_ptr<frame_store>> store(
+        m, "frame_store", "Indexed in-memory store of decoded frames");
+
+    py::class_<frame_store::query>(store, "query")
+        .def(py::init<>())
+        .def_static("parse", &frame_store::query::parse, py::arg("text"))
+        .def_readwrite("mac", &frame_store::query::mac)
+        .def_readwrite("ip", &frame_store::query::ip)
+        .def_readwrite("port", &frame_store::query::port)
+        .def_readwrite("ethertype", &frame_store::query::ethertype)
+        .def_readwrite("vlan", &frame_store::query::vlan)
+        .def_readwrite("ip_proto", &frame_store::query::ip_proto)
+        .def_readwrite("tcp_flags", &frame_store::query::tcp_flags)
+        .def_readwrite("last_s", &frame_store::query::last_s)
+        .def_readwrite("since_id", &frame_store::query::since_id)
+        .def_readwrite("limit", &frame_store::query::limit);
+
+    py::class_<frame_store::frame>(store, "frame")
+        .def_readonly("id", &frame_store::frame::id)
+        .def_readonly("time_ns", &frame_store::frame::time_ns)
+        .def_readonly("frame_num", &frame_store::frame::frame_num)
+        .def_readonly("sample_offset", &frame_store::frame::sample_offset)
+        .def_readonly("fcs_ok", &frame_store::frame::fcs_ok)
+        .def_readonly("ethertype", &frame_store::frame::ethertype)
+        .def_readonly("vlan", &frame_store::frame::vlan)
+        .def_readonly("ip_version", &frame_store::frame::ip_version)
+        .def_readonly("ip_proto", &frame_store::frame::ip_proto)
+        .def_readonly("src_port", &frame_store::frame::src_port)
+        .def_readonly("dst_port", &frame_store::frame::dst_port)
+        .def_readonly("tcp_flags", &frame_store::frame::tcp_flags)
+        .def_readonly("mac_src", &frame_store::frame::mac_src)
+        .def_readonly("mac_dst", &frame_store::frame::mac_dst)
+        .def_readonly("ip_src", &frame_store::frame::ip_src)
+        .def_readonly("ip_dst", &frame_store::frame::ip_dst)
+        .def_property_readonly("data", [](const frame_store::frame& f) {
+            return py::bytes((const char*)f.data.data(), f.data.size());
+        });
+
+    store.def(py::init<size_t>(), py::arg("budget_bytes"))
+        .def(
+            "add",
+            [](frame_store& s, py::bytes frame, uint64_t frame_num, uint64_t sample_offset,
+               bool fcs_ok) {
+                std::string b = frame;
+                s.add((const uint8_t*)b.data(), b.size(), frame_num, sample_offset, fcs_ok);
+            },
+            py::arg("frame"),
+            py::arg("frame_num") = 0,
+            py::arg("sample_offset") = 0,
+            py::arg("fcs_ok") = true)
+        .def(
+            "add_records",
+            [](frame_store& s, py::bytes batch) {
+                std::string b = batch;
+                return s.add_records((const uint8_t*)b.data(), b.size());
+            },
+            py::arg("batch"))
+        .def("find", &frame_store::find, py::arg("query"),
+             py::call_guard<py::gil_scoped_release>())
+        .def(
+            "find",
+            [](const frame_store& s, const std::string& text) {
+                frame_store::query q = frame_store::query::parse(text);
+                py::gil_scoped_release release;
+                return s.find(q);
+            },
+            py::arg("query"),
+            "Frames matching key=value pairs, e.g. \"mac=02:00:00:00:00:01 tcp_flags=RST last=60\"")
+        .def("size", &frame_store::size)
+        .def("first_id", &frame_store::first_id)
+        .def("last_id", &frame_store::last_id)
+        .def("memory_used", &frame_store::memory_used)
+        .def("budget", &frame_store::budget);
+}
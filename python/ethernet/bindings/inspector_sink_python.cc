@@ -0,0 +1,25 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/inspector_sink.h>
+
+void bind_inspector_sink(py::module& m)
+{
+    using inspector_sink = ::gr::ethernet::inspector_sink;
+
+    py::class_<inspector_sink, gr::block, gr::basic_block,
+               std::shared_ptr<inspector_sink>>(m, "inspector_sink", py::dynamic_attr())
+        .def(py::init(&inspector_sink::make),
+             py::arg("depth") = 262144,
+             py::arg("snap_len") = 128,
+             py::arg("address") = "127.0.0.1",
+             py::arg("port") = 8080,
+             py::arg("store_mb") = 256,
+             "Keeps decoded frames in a ring and serves them over HTTP/WebSocket")
+        .def("frames_received", &inspector_sink::frames_received)
+        .def("messages_ignored", &inspector_sink::messages_ignored)
+        .def("store", &inspector_sink::store);
+}
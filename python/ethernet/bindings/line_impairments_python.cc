@@ -0,0 +1,24 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/line_impairments.h>
+
+void bind_line_impairments(py::module& m)
+{
+    using line_impairments = ::gr::ethernet::line_impairments;
+
+    py::class_<line_impairments, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<line_impairments>>(m, "line_impairments", py::dynamic_attr())
+        .def(py::init(&line_impairments::make),
+             py::arg("noise_rms") = 0.0f,
+             py::arg("jitter_rms") = 0.0f,
+             py::arg("wander_cutoff") = 0.0f,
+             py::arg("seed") = 0,
+             "Creates a noise / jitter / baseline wander impairment block")
+        .def("set_noise_rms", &line_impairments::set_noise_rms, py::arg("noise_rms"))
+        .def("set_jitter_rms", &line_impairments::set_jitter_rms, py::arg("jitter_rms"))
+        .def("set_wander_cutoff", &line_impairments::set_wander_cutoff, py::arg("wander_cutoff"));
+}
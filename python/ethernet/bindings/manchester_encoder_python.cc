@@ -0,0 +1,20 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/manchester_encoder.h>
+
+void bind_manchester_encoder(py::module& m)
+{
+    using manchester_encoder = ::gr::ethernet::manchester_encoder;
+
+    py::class_<manchester_encoder, gr::block, gr::basic_block,
+               std::shared_ptr<manchester_encoder>>(m, "manchester_encoder", py::dynamic_attr())
+        .def(py::init(&manchester_encoder::make),
+             py::arg("samples_per_bit") = 2.0,
+             py::arg("idle_bits") = 96,
+             py::arg("len_tag_key") = "packet_len",
+             "Creates a 10BASE-T Manchester encoder");
+}
@@ -0,0 +1,20 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/mlt3_encoder.h>
+
+void bind_mlt3_encoder(py::module& m)
+{
+    using mlt3_encoder = ::gr::ethernet::mlt3_encoder;
+
+    py::class_<mlt3_encoder, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<mlt3_encoder>>(m, "mlt3_encoder", py::dynamic_attr())
+        .def(py::init(&mlt3_encoder::make),
+             py::arg("amplitude") = 1.0f,
+             "Creates an MLT-3 line encoder")
+        .def("set_amplitude", &mlt3_encoder::set_amplitude, py::arg("amplitude"))
+        .def("amplitude", &mlt3_encoder::amplitude);
+}
@@ -0,0 +1,36 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/multilane_decoder.h>
+
+template <class T>
+void bind_multilane_decoder_template(py::module& m, const char* classname)
+{
+    using multilane_decoder_blk = ::gr::ethernet::multilane_decoder_blk<T>;
+
+    py::class_<multilane_decoder_blk, gr::block, gr::basic_block,
+               std::shared_ptr<multilane_decoder_blk>>(m, classname, py::dynamic_attr())
+        .def(py::init(&multilane_decoder_blk::make),
+             py::arg("standard") = "100BASE-TX",
+             py::arg("lanes") = 2,
+             py::arg("threshold") = 0.25f,
+             py::arg("gain") = 1.0f,
+             py::arg("threads") = 2,
+             py::arg("cpus") = std::vector<int>(),
+             py::arg("len_tag_key") = "packet_len",
+             "Creates a multi-lane Ethernet decoder block")
+        .def("lanes", &multilane_decoder_blk::lanes)
+        .def("threads", &multilane_decoder_blk::threads)
+        .def("frames_decoded", &multilane_decoder_blk::frames_decoded)
+        .def("lane_frames", &multilane_decoder_blk::lane_frames, py::arg("lane"));
+}
+
+void bind_multilane_decoder(py::module& m)
+{
+    bind_multilane_decoder_template<float>(m, "multilane_decoder");
+    bind_multilane_decoder_template<std::int16_t>(m, "multilane_decoder_s");
+    bind_multilane_decoder_template<std::int8_t>(m, "multilane_decoder_b");
+}
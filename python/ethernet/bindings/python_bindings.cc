@@ -4,19 +4,55 @@
 
 namespace py = pybind11;
 
+void bind_capture_source(py::module& m);
 void bind_slicer3(py::module& m);
 void bind_mlt3_to_scrambled(py::module& m);
 void bind_fastethernet_descrambler(py::module& m);
+void bind_activity_squelch(py::module& m);
 void bind_ethernet_10baset_decoder(py::module& m);
 void bind_fastethernet_frame_decoder(py::module& m);
+void bind_ethernet_framer(py::module& m);
+void bind_fastethernet_4b5b_encoder(py::module& m);
+void bind_fastethernet_scrambler(py::module& m);
+void bind_mlt3_encoder(py::module& m);
+void bind_manchester_encoder(py::module& m);
+void bind_line_impairments(py::module& m);
+void bind_inspector_sink(py::module& m);
+void bind_frame_store(py::module& m);
+void bind_flow_table(py::module& m);
+void bind_traffic_stats(py::module& m);
+void bind_snapshot_sink(py::module& m);
+void bind_batch_decode(py::module& m);
+void bind_multilane_decoder(py::module& m);
+#ifdef ETHERNET_HAVE_ZMQ
+void bind_frame_record_zmq_sink(py::module& m);
+#endif
 
 PYBIND11_MODULE(ethernet_python, m)
 {
     m.doc() = "Ethernet blocks for GNU Radio";
     
+    bind_capture_source(m);
     bind_slicer3(m);
     bind_mlt3_to_scrambled(m);
     bind_fastethernet_descrambler(m);
+    bind_activity_squelch(m);
     bind_ethernet_10baset_decoder(m);
     bind_fastethernet_frame_decoder(m);
+    bind_ethernet_framer(m);
+    bind_fastethernet_4b5b_encoder(m);
+    bind_fastethernet_scrambler(m);
+    bind_mlt3_encoder(m);
+    bind_manchester_encoder(m);
+    bind_line_impairments(m);
+    bind_inspector_sink(m);
+    bind_frame_store(m);
+    bind_flow_table(m);
+    bind_traffic_stats(m);
+    bind_snapshot_sink(m);
+    bind_batch_decode(m);
+    bind_multilane_decoder(m);
+#ifdef ETHERNET_HAVE_ZMQ
+    bind_frame_record_zmq_sink(m);
+#endif
 }
@@ -6,15 +6,30 @@ namespace py = pybind11;
 
 #include <gnuradio/ethernet/slicer3.h>
 
-void bind_slicer3(py::module& m)
+template <class T>
+void bind_slicer3_template(py::module& m, const char* classname)
 {
-    using slicer3 = ::gr::ethernet::slicer3;
+    using slicer3_blk = ::gr::ethernet::slicer3_blk<T>;
 
-    py::class_<slicer3, gr::sync_block, gr::block, gr::basic_block,
-               std::shared_ptr<slicer3>>(m, "slicer3", py::dynamic_attr())
-        .def(py::init(&slicer3::make),
+    py::class_<slicer3_blk, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<slicer3_blk>>(m, classname, py::dynamic_attr())
+        .def(py::init(&slicer3_blk::make),
              py::arg("threshold") = 0.33f,
+             py::arg("gain") = 1.0f,
+             py::arg("adaptive") = false,
+             py::arg("fraction") = 0.5f,
              "Creates a 3-level slicer block")
-        .def("set_threshold", &slicer3::set_threshold, py::arg("threshold"))
-        .def("threshold", &slicer3::threshold);
+        .def("set_threshold", &slicer3_blk::set_threshold, py::arg("threshold"))
+        .def("threshold", &slicer3_blk::threshold)
+        .def("set_gain", &slicer3_blk::set_gain, py::arg("gain"))
+        .def("gain", &slicer3_blk::gain)
+        .def("adaptive", &slicer3_blk::adaptive)
+        .def("fraction", &slicer3_blk::fraction);
+}
+
+void bind_slicer3(py::module& m)
+{
+    bind_slicer3_template<float>(m, "slicer3");
+    bind_slicer3_template<std::int16_t>(m, "slicer3_s");
+    bind_slicer3_template<std::int8_t>(m, "slicer3_b");
 }
@@ -0,0 +1,37 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/snapshot_sink.h>
+
+template <class T>
+void bind_snapshot_sink_template(py::module& m, const char* classname)
+{
+    using snapshot_sink_blk = ::gr::ethernet::snapshot_sink_blk<T>;
+
+    py::class_<snapshot_sink_blk, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<snapshot_sink_blk>>(m, classname, py::dynamic_attr())
+        .def(py::init(&snapshot_sink_blk::make),
+             py::arg("prefix"),
+             py::arg("pre") = 4096,
+             py::arg("post") = 4096,
+             py::arg("samples_per_item") = 1.0,
+             py::arg("delay") = 0,
+             py::arg("samp_rate") = 0.0,
+             py::arg("ring_size") = 1 << 22,
+             py::arg("max_snapshots") = 0,
+             py::arg("trigger_tag") = "",
+             "Writes the raw samples around errored frames to files")
+        .def("triggers", &snapshot_sink_blk::triggers)
+        .def("snapshots_written", &snapshot_sink_blk::snapshots_written)
+        .def("snapshots_dropped", &snapshot_sink_blk::snapshots_dropped);
+}
+
+void bind_snapshot_sink(py::module& m)
+{
+    bind_snapshot_sink_template<float>(m, "snapshot_sink");
+    bind_snapshot_sink_template<std::int16_t>(m, "snapshot_sink_s");
+    bind_snapshot_sink_template<std::int8_t>(m, "snapshot_sink_b");
+}
@@ -0,0 +1,21 @@
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ethernet/traffic_stats.h>
+
+void bind_traffic_stats(py::module& m)
+{
+    using traffic_stats = ::gr::ethernet::traffic_stats;
+
+    py::class_<traffic_stats, gr::block, gr::basic_block,
+               std::shared_ptr<traffic_stats>>(m, "traffic_stats", py::dynamic_attr())
+        .def(py::init(&traffic_stats::make),
+             py::arg("top_k") = 10,
+             py::arg("interval_s") = 10.0,
+             py::arg("reset") = false,
+             "Top talkers (Space-Saving, Count-Min) and distinct hosts (HyperLogLog) in fixed memory")
+        .def("frames_received", &traffic_stats::frames_received);
+}
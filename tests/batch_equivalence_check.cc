@@ -0,0 +1,360 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Receive blocks against the batch functions and the Multi-Lane Decoder.
+ *
+ *   batch_equivalence_check [--seed N]
+ *
+ * The same synthetic line signal goes through three decoders, which must
+ * return the same frames (bytes, fcs_ok and sample_offset, in order):
+ *
+ *   blocks      the receive chain of the examples, in a flowgraph:
+ *               100BASE-TX  Slicer3 -> MLT-3 to Scrambled -> Descrambler
+ *                           -> Frame Decoder
+ *               10BASE-T    Threshold -> Float to UChar -> Correlate
+ *                           Access Code Tag -> 10BASE-T Decoder
+ *   batch       decode_100basetx() or decode_10baset(), on the whole signal
+ *   multilane   a one-lane Multi-Lane Decoder, in a flowgraph
+ *
+ * The 100BASE-TX signal has a burst of random bits and a bit slip in the
+ * middle of the traffic (locks regained on the predicted state), then
+ * random bits and traffic under another scrambler seed (lock regained by
+ * the seed search). The 10BASE-T signal has frames whose payload holds the
+ * preamble and SFD. The blocks must also decode at least half of the
+ * frames sent, so that the comparison does not pass on empty outputs.
+ *
+ * Exit codes: 0 pass, 1 mismatch, 2 usage error.
+ */
+
+#include <gnuradio/blocks/float_to_uchar.h>
+#include <gnuradio/blocks/threshold_ff.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/digital/correlate_access_code_tag_bb.h>
+#include <gnuradio/ethernet/batch_decode.h>
+#include <gnuradio/ethernet/ethernet_10baset_decoder.h>
+#include <gnuradio/ethernet/fastethernet_descrambler.h>
+#include <gnuradio/ethernet/fastethernet_frame_decoder.h>
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/mlt3_to_scrambled.h>
+#include <gnuradio/ethernet/multilane_decoder.h>
+#include <gnuradio/ethernet/slicer3.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/top_block.h>
+#include "synthetic_signal.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int EXIT_MISMATCH = 1;
+const int EXIT_USAGE = 2;
+
+const int FRAME_COUNT = 60;
+const float THRESHOLD_100 = 0.25f;
+const float THRESHOLD_10 = 0.1f;
+
+// Preamble and SFD as Manchester half-bits, as in decode_10BASE-T.grc
+const char* SFD_ACCESS_CODE = "01100110011001100110011001100110011001100101";
+
+struct decoded_frame {
+    uint64_t offset;
+    std::vector<uint8_t> bytes;
+    bool fcs_ok;
+
+    bool operator==(const decoded_frame& o) const
+    {
+        return offset == o.offset && bytes == o.bytes && fcs_ok == o.fcs_ok;
+    }
+};
+
+// Keeps the frames of "decoded" dicts and of record batches, in order.
+class frame_collector : public gr::block
+{
+public:
+    typedef std::shared_ptr<frame_collector> sptr;
+
+    static sptr make() { return gnuradio::make_block_sptr<frame_collector>(); }
+
+    frame_collector()
+        : gr::block("frame_collector",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_port(pmt::intern("in"))
+    {
+        message_port_register_in(d_port);
+        set_msg_handler(d_port, [this](const pmt::pmt_t& msg) { store(msg); });
+    }
+
+    // Messages still queued when the flowgraph stopped.
+    void drain()
+    {
+        pmt::pmt_t msg;
+        while ((msg = delete_head_nowait(d_port)).get() != nullptr) {
+            store(msg);
+        }
+    }
+
+    std::vector<decoded_frame> frames()
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        return d_frames;
+    }
+
+private:
+    pmt::pmt_t d_port;
+    std::mutex d_mutex;
+    std::vector<decoded_frame> d_frames;
+
+    void store(const pmt::pmt_t& msg)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (pmt::is_u8vector(msg)) {
+            size_t len = 0;
+            const uint8_t* batch = pmt::u8vector_elements(msg, len);
+            gr::ethernet::frame_record_reader reader;
+            if (!reader.open(batch, len)) return;
+            for (size_t i = 0; i < reader.count(); i++) {
+                size_t frame_len = 0;
+                const uint8_t* frame = reader.frame(i, frame_len);
+                gr::ethernet::frame_record_view r = reader.record(i);
+                d_frames.push_back(
+                    { r.sample_offset(), std::vector<uint8_t>(frame, frame + frame_len), r.fcs_ok() });
+            }
+            return;
+        }
+        decoded_frame f;
+        f.offset = pmt::to_uint64(
+            pmt::dict_ref(msg, pmt::intern("sample_offset"), pmt::from_uint64(0)));
+        pmt::pmt_t bytes = pmt::dict_ref(msg, pmt::intern("frame"), pmt::PMT_NIL);
+        if (pmt::is_u8vector(bytes)) {
+            f.bytes = pmt::u8vector_elements(bytes);
+        }
+        f.fcs_ok = pmt::to_bool(pmt::dict_ref(msg, pmt::intern("fcs_ok"), pmt::PMT_F));
+        d_frames.push_back(std::move(f));
+    }
+};
+
+// The decoders print every frame; the test output only keeps the summary.
+class cout_silencer
+{
+public:
+    cout_silencer() : d_saved(std::cout.rdbuf(d_sink.rdbuf())) {}
+    ~cout_silencer() { std::cout.rdbuf(d_saved); }
+
+private:
+    std::ostringstream d_sink;
+    std::streambuf* d_saved;
+};
+
+std::string to_hex(const std::vector<uint8_t>& bytes)
+{
+    std::ostringstream oss;
+    for (uint8_t b : bytes) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << (int)b;
+    }
+    return oss.str();
+}
+
+std::vector<std::vector<uint8_t>> make_frames(std::mt19937& rng, size_t count)
+{
+    static const size_t payloads[] = { 1, 18, 200, 1000, 64, 1472, 5 };
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t i = 0; i < count; i++) {
+        frames.push_back(bench::make_udp_frame(payloads[rng() % 7], rng()));
+    }
+    return frames;
+}
+
+// Scrambled 100BASE-TX traffic with a burst, a slip and a new seed.
+std::vector<float> make_100basetx_signal(std::mt19937& rng)
+{
+    std::vector<uint8_t> first = bench::make_5b_stream(make_frames(rng, FRAME_COUNT / 2), 40);
+    std::vector<uint8_t> line = bench::scramble(first, 0x5A5);
+
+    // Channel errors over 600 bits, then a bit lost by the symbol timing:
+    // the scrambler keeps running through both
+    size_t burst = line.size() / 4 + rng() % (line.size() / 8);
+    std::vector<uint8_t> noise = bench::random_bits(600, rng());
+    std::copy(noise.begin(), noise.end(), line.begin() + burst);
+    line.erase(line.begin() + line.size() / 2 + rng() % (line.size() / 8));
+
+    // A link that came back with another seed
+    std::vector<uint8_t> gap = bench::random_bits(5000, rng());
+    line.insert(line.end(), gap.begin(), gap.end());
+    std::vector<uint8_t> second = bench::make_5b_stream(make_frames(rng, FRAME_COUNT / 2), 40);
+    std::vector<uint8_t> scrambled = bench::scramble(second, 0x3C7);
+    line.insert(line.end(), scrambled.begin(), scrambled.end());
+    return bench::mlt3_levels(line, 0.05f);
+}
+
+// 10BASE-T half-bit samples, the line quiet between frames.
+std::vector<float> make_10baset_signal(std::mt19937& rng)
+{
+    std::vector<std::vector<uint8_t>> frames = make_frames(rng, FRAME_COUNT);
+    for (size_t i = 0; i < frames.size(); i += 5) {
+        // The end of the preamble and the SFD inside the payload
+        std::vector<uint8_t>& f = frames[i];
+        f.resize(f.size() - 4);
+        static const uint8_t sfd[] = { 0x55, 0x55, 0x55, 0xD5 };
+        std::copy(sfd, sfd + 4, f.begin() + 42 + rng() % (f.size() - 46));
+        uint32_t fcs = gr::ethernet::crc32(f.data(), f.size());
+        for (int b = 0; b < 4; b++) f.push_back((fcs >> (8 * b)) & 0xFF);
+    }
+
+    std::vector<float> samples;
+    std::vector<gr::tag_t> tags;
+    for (const auto& frame : frames) {
+        samples.insert(samples.end(), 200, 0.0f);
+        for (uint8_t h : bench::make_manchester_stream({ frame }, 0, "packet", tags)) {
+            samples.push_back(h ? 1.0f : -1.0f);
+        }
+    }
+    samples.insert(samples.end(), 200, 0.0f);
+    return samples;
+}
+
+std::vector<decoded_frame> run_blocks(const std::string& standard, const std::vector<float>& signal)
+{
+    auto tb = gr::make_top_block("batch_equivalence");
+    auto src = gr::blocks::vector_source_f::make(signal);
+    auto collector = frame_collector::make();
+    if (standard == "100BASE-TX") {
+        auto slicer = gr::ethernet::slicer3::make(THRESHOLD_100);
+        auto levels = gr::ethernet::mlt3_to_scrambled::make();
+        auto descrambler = gr::ethernet::fastethernet_descrambler::make();
+        auto decoder = gr::ethernet::fastethernet_frame_decoder::make();
+        tb->connect(src, 0, slicer, 0);
+        tb->connect(slicer, 0, levels, 0);
+        tb->connect(levels, 0, descrambler, 0);
+        tb->connect(descrambler, 0, decoder, 0);
+        tb->msg_connect(decoder, "decoded", collector, "in");
+    } else {
+        auto threshold = gr::blocks::threshold_ff::make(-THRESHOLD_10, THRESHOLD_10, 0.0f);
+        auto to_bits = gr::blocks::float_to_uchar::make();
+        auto sfd = gr::digital::correlate_access_code_tag_bb::make(SFD_ACCESS_CODE, 0, "packet");
+        auto decoder = gr::ethernet::ethernet_10baset_decoder::make("packet");
+        tb->connect(src, 0, threshold, 0);
+        tb->connect(threshold, 0, to_bits, 0);
+        tb->connect(to_bits, 0, sfd, 0);
+        tb->connect(sfd, 0, decoder, 0);
+        tb->msg_connect(decoder, "decoded", collector, "in");
+    }
+    {
+        cout_silencer quiet;
+        tb->run();
+    }
+    collector->drain();
+    return collector->frames();
+}
+
+std::vector<decoded_frame> run_multilane(const std::string& standard,
+                                         const std::vector<float>& signal)
+{
+    auto tb = gr::make_top_block("batch_equivalence");
+    auto src = gr::blocks::vector_source_f::make(signal);
+    float threshold = standard == "100BASE-TX" ? THRESHOLD_100 : THRESHOLD_10;
+    auto decoder = gr::ethernet::multilane_decoder::make(standard, 1, threshold, 1.0f, 0);
+    auto collector = frame_collector::make();
+    tb->connect(src, 0, decoder, 0);
+    tb->msg_connect(decoder, "records", collector, "in");
+    tb->run();
+    collector->drain();
+    return collector->frames();
+}
+
+std::vector<decoded_frame> run_batch(const std::string& standard, const std::vector<float>& signal)
+{
+    gr::ethernet::frame_record_writer writer;
+    if (standard == "100BASE-TX") {
+        gr::ethernet::decode_100basetx(signal.data(), signal.size(), writer, THRESHOLD_100);
+    } else {
+        gr::ethernet::decode_10baset(signal.data(), signal.size(), writer, THRESHOLD_10);
+    }
+    const std::vector<uint8_t>& batch = writer.finish();
+    gr::ethernet::frame_record_reader reader;
+    std::vector<decoded_frame> frames;
+    if (!reader.open(batch.data(), batch.size())) return frames;
+    for (size_t i = 0; i < reader.count(); i++) {
+        size_t len = 0;
+        const uint8_t* frame = reader.frame(i, len);
+        gr::ethernet::frame_record_view r = reader.record(i);
+        frames.push_back({ r.sample_offset(), std::vector<uint8_t>(frame, frame + len), r.fcs_ok() });
+    }
+    return frames;
+}
+
+bool compare(const std::string& what,
+             const std::vector<decoded_frame>& expected,
+             const std::vector<decoded_frame>& actual)
+{
+    size_t n = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < n; i++) {
+        if (expected[i] == actual[i]) continue;
+        std::cout << what << ": frame " << i << " differs:" << std::endl;
+        std::cout << "  blocks @" << expected[i].offset << " fcs_ok " << expected[i].fcs_ok
+                  << " " << to_hex(expected[i].bytes) << std::endl;
+        std::cout << "  got    @" << actual[i].offset << " fcs_ok " << actual[i].fcs_ok << " "
+                  << to_hex(actual[i].bytes) << std::endl;
+        return false;
+    }
+    if (expected.size() != actual.size()) {
+        std::cout << what << ": " << actual.size() << " frames, blocks " << expected.size()
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool check(const std::string& standard, const std::vector<float>& signal)
+{
+    std::vector<decoded_frame> blocks = run_blocks(standard, signal);
+    size_t good = 0;
+    for (const auto& f : blocks) good += f.fcs_ok;
+    std::cout << standard << ": blocks " << blocks.size() << " frames, " << good
+              << " with a good FCS, of " << FRAME_COUNT << " sent" << std::endl;
+    if (good < FRAME_COUNT / 2) {
+        std::cout << standard << ": too few frames decoded by the blocks" << std::endl;
+        return false;
+    }
+    return compare(standard + " batch", blocks, run_batch(standard, signal)) &&
+           compare(standard + " multilane", blocks, run_multilane(standard, signal));
+}
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog << " [--seed N]" << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    bool ok = check("100BASE-TX", make_100basetx_signal(rng));
+    ok = check("10BASE-T", make_10baset_signal(rng)) && ok;
+    if (ok) std::cout << "batch decoders ok" << std::endl;
+    return ok ? 0 : EXIT_MISMATCH;
+}
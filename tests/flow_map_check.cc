@@ -0,0 +1,220 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Flow Table hash map against std::unordered_map and std::list.
+ *
+ *   flow_map_check [--seed N]
+ *
+ * Random finds, inserts (evicting the least recently seen flow when the
+ * map is full, as the Flow Table does), erases of random and of the
+ * oldest flows, and touches run on flow_map and on a reference map with
+ * an LRU list. After every operation the sizes must agree; every few
+ * hundred operations, every key must be found with its value, absent
+ * keys must not be, and the LRU list walked from the oldest flow must
+ * match the reference order.
+ *
+ * Each run is repeated with the keys' hashes squeezed into a few slots
+ * near the end of the table, so probe sequences get long and wrap around,
+ * which is where backward-shift deletion goes wrong.
+ *
+ * Exit codes: 0 pass, 1 mismatch, 2 usage error.
+ */
+
+#include "flow_map.h"
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using gr::ethernet::flow_entry;
+using gr::ethernet::flow_key;
+using gr::ethernet::flow_map;
+
+namespace {
+
+const int EXIT_MISMATCH = 1;
+const int EXIT_USAGE = 2;
+
+const size_t CAPACITY = 1000;
+const int KEY_COUNT = 3000;
+const int OPERATIONS = 400000;
+const int CHECK_EVERY = 500;
+
+flow_key make_key(int i)
+{
+    flow_key k;
+    k.ip_version = 4;
+    k.ip_proto = 6;
+    k.src[0] = 10;
+    k.src[3] = i & 0xFF;
+    k.dst[3] = i >> 8;
+    k.src_port = i * 7;
+    k.dst_port = 80;
+    k.vlan = 0xFFFF;
+    k.ethertype = 0x0800;
+    return k;
+}
+
+class checker
+{
+public:
+    checker(unsigned seed, bool clustered)
+        : d_rng(seed), d_clustered(clustered), d_map(CAPACITY), d_ops(0)
+    {
+    }
+
+    bool run()
+    {
+        for (d_ops = 0; d_ops < OPERATIONS; d_ops++) {
+            int key = d_rng() % KEY_COUNT;
+            switch (d_rng() % 8) {
+            case 0:
+                if (!erase(key)) return false;
+                break;
+            case 1:
+                if (!erase_oldest()) return false;
+                break;
+            default:
+                if (!account(key)) return false;
+                break;
+            }
+            if (d_map.size() != d_ref.size()) return fail("size");
+            if (d_ops % CHECK_EVERY == 0 && !check_all()) return false;
+        }
+        return check_all();
+    }
+
+private:
+    std::mt19937 d_rng;
+    bool d_clustered;
+    flow_map d_map;
+    struct ref_flow {
+        std::list<int>::iterator lru; // position in d_lru
+        uint64_t packets;
+    };
+    std::unordered_map<int, ref_flow> d_ref;
+    std::list<int> d_lru; // most recently seen first
+    int d_ops;
+
+    uint64_t hash(int i) const
+    {
+        uint64_t h = flow_map::hash(make_key(i));
+        // Homes in the last few slots of the smallest table that holds
+        // CAPACITY: runs cross the end of the table
+        return d_clustered ? 2040 + h % 8 : h;
+    }
+
+    bool fail(const std::string& what)
+    {
+        std::cout << (d_clustered ? "clustered hashes" : "full hashes") << ", operation "
+                  << d_ops << ": " << what << " differs (size " << d_map.size()
+                  << ", expected " << d_ref.size() << ")" << std::endl;
+        return false;
+    }
+
+    // Find or insert, then count a frame, like flow_table_impl::account().
+    bool account(int key)
+    {
+        flow_key k = make_key(key);
+        flow_entry* f = d_map.find(k, hash(key));
+        auto it = d_ref.find(key);
+        if ((f != nullptr) != (it != d_ref.end())) return fail("find");
+        if (f) {
+            d_map.touch(f);
+            d_lru.splice(d_lru.begin(), d_lru, it->second.lru);
+        } else {
+            if (d_map.full()) {
+                flow_entry* victim = d_map.oldest();
+                int oldest = d_lru.back();
+                if (!victim || !(victim->key == make_key(oldest))) return fail("LRU victim");
+                d_map.erase(victim);
+                d_ref.erase(oldest);
+                d_lru.pop_back();
+            }
+            f = d_map.insert(k, hash(key));
+            if (f->packets != 0) return fail("new entry");
+            d_lru.push_front(key);
+            it = d_ref.emplace(key, ref_flow{ d_lru.begin(), 0 }).first;
+        }
+        f->packets++;
+        it->second.packets++;
+        return true;
+    }
+
+    bool erase(int key)
+    {
+        flow_entry* f = d_map.find(make_key(key), hash(key));
+        auto it = d_ref.find(key);
+        if ((f != nullptr) != (it != d_ref.end())) return fail("find before erase");
+        if (!f) return true;
+        d_map.erase(f);
+        d_lru.erase(it->second.lru);
+        d_ref.erase(it);
+        if (d_map.find(make_key(key), hash(key))) return fail("erased key");
+        return true;
+    }
+
+    bool erase_oldest()
+    {
+        flow_entry* f = d_map.oldest();
+        if ((f != nullptr) != !d_lru.empty()) return fail("oldest");
+        if (!f) return true;
+        if (!(f->key == make_key(d_lru.back()))) return fail("oldest key");
+        return erase(d_lru.back());
+    }
+
+    bool check_all()
+    {
+        // Every key: found with its count when present, absent otherwise
+        for (int key = 0; key < KEY_COUNT; key++) {
+            flow_entry* f = d_map.find(make_key(key), hash(key));
+            auto it = d_ref.find(key);
+            if ((f != nullptr) != (it != d_ref.end())) return fail("membership");
+            if (f && f->packets != it->second.packets) return fail("packets");
+        }
+
+        // The LRU list, oldest first, then its length
+        auto it = d_lru.rbegin();
+        size_t n = 0;
+        for (flow_entry* f = d_map.oldest(); f; f = d_map.newer(f), ++it, n++) {
+            if (it == d_lru.rend() || !(f->key == make_key(*it))) return fail("LRU order");
+        }
+        if (n != d_ref.size()) return fail("LRU length");
+        return true;
+    }
+};
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog << " [--seed N]" << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    for (bool clustered : { false, true }) {
+        checker c(seed, clustered);
+        if (!c.run()) return EXIT_MISMATCH;
+    }
+    std::cout << 2 * OPERATIONS << " operations on " << CAPACITY << " flows: ok" << std::endl;
+    return 0;
+}
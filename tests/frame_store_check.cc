@@ -0,0 +1,444 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Frame store queries against a linear scan of every frame still stored.
+ *
+ *   frame_store_check [--seed N]
+ *
+ * Random frames (ARP, IPv4 and IPv6 TCP/UDP/ICMP, non-first fragments,
+ * tagged or not) drawn from small pools of addresses and ports go into a
+ * store small enough to evict many segments. After every batch the ids
+ * and the memory budget are checked; every few thousand frames, random
+ * queries (indexed fields, which go through the posting lists, column
+ * scans, since/limit paging and last= windows) must return exactly the
+ * frames the scan finds, field for field. Query strings parse() rejects
+ * are checked last.
+ *
+ * Frame times are set in the records, a whole number of seconds in the
+ * past, so last= windows prune whole segments.
+ *
+ * Exit codes: 0 pass, 1 mismatch, 2 usage error.
+ */
+
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/frame_store.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using gr::ethernet::format_ip;
+using gr::ethernet::format_mac;
+using gr::ethernet::frame_record_view;
+using gr::ethernet::frame_record_writer;
+using gr::ethernet::frame_store;
+
+namespace {
+
+const int EXIT_MISMATCH = 1;
+const int EXIT_USAGE = 2;
+
+const size_t BUDGET = 2 << 20;
+const int FRAME_COUNT = 40000;
+const int CHECK_EVERY = 5000;
+const int QUERIES_PER_CHECK = 300;
+const int MAX_AGE_S = 100;
+
+const uint16_t PORTS[] = { 80, 443, 502, 1024, 5353, 40000 };
+const int VLANS[] = { -1, -1, 5, 10 };
+const int MAC_COUNT = 8;
+const int IP_COUNT = 8;
+
+// One frame as added, with its record header (time_ns included)
+struct stored {
+    uint64_t id;
+    std::vector<uint8_t> header;
+    std::vector<uint8_t> data;
+};
+
+std::vector<uint8_t> mac(int i) { return { 0x02, 0, 0, 0, 0, (uint8_t)i }; }
+
+std::vector<uint8_t> ipv4(int i) { return { 10, 0, 0, (uint8_t)(i + 1) }; }
+
+std::vector<uint8_t> ipv6(int i)
+{
+    std::vector<uint8_t> a = { 0x20, 0x01, 0x0d, 0xb8 };
+    a.resize(15, 0);
+    a.push_back(i + 1);
+    return a;
+}
+
+void put_be16(std::vector<uint8_t>& f, size_t pos, uint16_t v)
+{
+    f[pos] = v >> 8;
+    f[pos + 1] = v & 0xFF;
+}
+
+// Destination MAC to FCS; the FCS is not checked by the store.
+std::vector<uint8_t> make_frame(std::mt19937& rng)
+{
+    auto pick = [&](int n) { return (int)(rng() % n); };
+    std::vector<uint8_t> f;
+    auto append = [&](const std::vector<uint8_t>& b) { f.insert(f.end(), b.begin(), b.end()); };
+    append(mac(pick(MAC_COUNT)));
+    append(mac(pick(MAC_COUNT)));
+    int vlan = VLANS[pick(4)];
+    if (vlan >= 0) append({ 0x81, 0x00, (uint8_t)(pick(8) << 5), (uint8_t)vlan });
+
+    int kind = pick(8);
+    uint8_t proto = pick(3) == 0 ? 1 : pick(2) ? 6 : 17;
+    if (kind == 0) {
+        append({ 0x08, 0x06 });
+        f.resize(f.size() + 28, 0);
+    } else if (kind <= 4) {
+        size_t ip = f.size() + 2;
+        append({ 0x08, 0x00 });
+        f.resize(ip + 20, 0);
+        f[ip] = 0x45;
+        f[ip + 8] = 64;
+        f[ip + 9] = proto;
+        if (kind == 4) put_be16(f, ip + 6, 0x00B9); // not the first fragment
+        std::vector<uint8_t> src = ipv4(pick(IP_COUNT)), dst = ipv4(pick(IP_COUNT));
+        std::copy(src.begin(), src.end(), f.begin() + ip + 12);
+        std::copy(dst.begin(), dst.end(), f.begin() + ip + 16);
+    } else {
+        size_t ip = f.size() + 2;
+        append({ 0x86, 0xDD });
+        f.resize(ip + 40, 0);
+        if (proto == 1) proto = 58;
+        f[ip] = 0x60;
+        f[ip + 6] = proto;
+        f[ip + 7] = 64;
+        std::vector<uint8_t> src = ipv6(pick(IP_COUNT)), dst = ipv6(pick(IP_COUNT));
+        std::copy(src.begin(), src.end(), f.begin() + ip + 8);
+        std::copy(dst.begin(), dst.end(), f.begin() + ip + 24);
+    }
+    if (kind != 0) {
+        size_t l4 = f.size();
+        f.resize(l4 + 20, 0);
+        if (proto == 6 || proto == 17) {
+            put_be16(f, l4, PORTS[pick(6)]);
+            put_be16(f, l4 + 2, PORTS[pick(6)]);
+        }
+        if (proto == 6) {
+            f[l4 + 12] = 0x50;
+            f[l4 + 13] = rng() & 0x3F;
+        }
+    }
+    f.resize(std::max<size_t>(f.size() + pick(200), 60) + 4, 0xA5);
+    return f;
+}
+
+// The store's match, written from the record fields.
+bool matches(const frame_store::query& q, const stored& s, uint64_t t_from)
+{
+    frame_record_view r(s.header.data());
+    if (r.time_ns() < t_from) return false;
+    if (!q.mac.empty() && format_mac(r.mac_src()) != q.mac && format_mac(r.mac_dst()) != q.mac) {
+        return false;
+    }
+    if (!q.ip.empty()) {
+        int version = q.ip.find(':') != std::string::npos ? 6 : 4;
+        if (r.ip_version() != version) return false;
+        if (format_ip(version, r.ip_src()) != q.ip && format_ip(version, r.ip_dst()) != q.ip) {
+            return false;
+        }
+    }
+    if (q.ethertype >= 0 && r.ethertype() != q.ethertype) return false;
+    if (q.vlan >= 0 && r.vlan_id() != q.vlan) return false;
+    if (q.ip_proto >= 0 && (!r.ip_version() || r.ip_proto() != q.ip_proto)) return false;
+    if (q.port >= 0 &&
+        (!r.has_ports() || (r.src_port() != q.port && r.dst_port() != q.port))) {
+        return false;
+    }
+    if (q.tcp_flags && (!r.is_tcp() || (r.tcp_flags() & q.tcp_flags) != q.tcp_flags)) {
+        return false;
+    }
+    return true;
+}
+
+// Newest matches with an id above since_id, at most limit, oldest first.
+std::vector<const stored*> scan(const std::vector<stored>& frames,
+                                uint64_t first_id,
+                                const frame_store::query& q,
+                                uint64_t t_from)
+{
+    std::vector<const stored*> out;
+    for (size_t i = frames.size(); i > 0 && out.size() < q.limit; i--) {
+        const stored& s = frames[i - 1];
+        if (s.id < first_id || s.id <= q.since_id) break;
+        if (matches(q, s, t_from)) out.push_back(&s);
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+uint64_t window_start(double last_s, uint64_t now)
+{
+    if (last_s <= 0) return 0;
+    uint64_t span = (uint64_t)(last_s * 1e9);
+    return span < now ? now - span : 0;
+}
+
+std::string describe(const frame_store::query& q)
+{
+    std::string s;
+    if (!q.mac.empty()) s += " mac=" + q.mac;
+    if (!q.ip.empty()) s += " ip=" + q.ip;
+    if (q.port >= 0) s += " port=" + std::to_string(q.port);
+    if (q.ethertype >= 0) s += " ethertype=" + std::to_string(q.ethertype);
+    if (q.vlan >= 0) s += " vlan=" + std::to_string(q.vlan);
+    if (q.ip_proto >= 0) s += " proto=" + std::to_string(q.ip_proto);
+    if (q.tcp_flags) s += " tcp_flags=" + std::to_string(q.tcp_flags);
+    if (q.last_s > 0) s += " last=" + std::to_string(q.last_s);
+    s += " since=" + std::to_string(q.since_id) + " limit=" + std::to_string(q.limit);
+    return s;
+}
+
+// Empty when the store returned f for s, else the first field that differs.
+std::string compare(const frame_store::frame& f, const stored& s)
+{
+    frame_record_view r(s.header.data());
+    int version = r.ip_version();
+    if (f.id != s.id) return "id";
+    if (f.time_ns != r.time_ns()) return "time_ns";
+    if (f.frame_num != r.frame_num()) return "frame_num";
+    if (f.sample_offset != r.sample_offset()) return "sample_offset";
+    if (f.fcs_ok != r.fcs_ok()) return "fcs_ok";
+    if (f.ethertype != r.ethertype()) return "ethertype";
+    if (f.vlan != r.vlan_id()) return "vlan";
+    if (f.ip_version != version) return "ip_version";
+    if (f.ip_proto != (version ? r.ip_proto() : -1)) return "ip_proto";
+    if (f.src_port != (r.has_ports() ? r.src_port() : -1)) return "src_port";
+    if (f.dst_port != (r.has_ports() ? r.dst_port() : -1)) return "dst_port";
+    if (f.tcp_flags != (r.is_tcp() ? r.tcp_flags() : 0)) return "tcp_flags";
+    if (f.mac_src != format_mac(r.mac_src())) return "mac_src";
+    if (f.mac_dst != format_mac(r.mac_dst())) return "mac_dst";
+    if (f.ip_src != format_ip(version, r.ip_src())) return "ip_src";
+    if (f.ip_dst != format_ip(version, r.ip_dst())) return "ip_dst";
+    if (f.data != s.data) return "data";
+    return "";
+}
+
+frame_store::query random_query(std::mt19937& rng, uint64_t last_id)
+{
+    auto pick = [&](int n) { return (int)(rng() % n); };
+    auto sometimes = [&]() { return pick(4) == 0; };
+    frame_store::query q;
+    // One past each pool: a key with no posting list
+    if (sometimes()) q.mac = format_mac(mac(pick(MAC_COUNT + 1)).data());
+    if (sometimes()) {
+        int i = pick(IP_COUNT + 1);
+        q.ip = pick(2) ? format_ip(4, ipv4(i).data()) : format_ip(6, ipv6(i).data());
+    }
+    if (sometimes()) q.port = pick(7) < 6 ? PORTS[pick(6)] : 8080;
+    if (sometimes()) q.ethertype = pick(3) == 0 ? 0x0806 : pick(2) ? 0x0800 : 0x86DD;
+    if (sometimes()) q.vlan = pick(3) == 0 ? 7 : VLANS[2 + pick(2)];
+    if (sometimes()) q.ip_proto = pick(2) ? 6 : 17;
+    if (sometimes()) q.tcp_flags = 1 << pick(6);
+    if (sometimes()) q.last_s = pick(MAX_AGE_S + 10) + 0.5;
+    if (pick(2)) q.since_id = rng() % (last_id + 1);
+    static const size_t limits[] = { 1, 3, 50, 1000, 1000000 };
+    q.limit = limits[pick(5)];
+    return q;
+}
+
+// Runs n random queries; false on the first mismatch.
+bool check_queries(const frame_store& store,
+                   const std::vector<stored>& frames,
+                   std::mt19937& rng,
+                   int n,
+                   int& compared,
+                   int& skipped)
+{
+    for (int i = 0; i < n; i++) {
+        frame_store::query q = random_query(rng, store.last_id());
+        uint64_t before = gr::ethernet::frame_record_time_ns();
+        std::vector<frame_store::frame> got = store.find(q);
+        uint64_t after = gr::ethernet::frame_record_time_ns();
+
+        // The store took its clock in between: skip a window edge that
+        // falls on a frame time
+        auto want = scan(frames, store.first_id(), q, window_start(q.last_s, before));
+        if (q.last_s > 0) {
+            auto late = scan(frames, store.first_id(), q, window_start(q.last_s, after));
+            if (late.size() != want.size() || (!late.empty() && late[0] != want[0])) {
+                skipped++;
+                continue;
+            }
+        }
+
+        bool ok = got.size() == want.size();
+        std::string field = ok ? "" : "count";
+        for (size_t j = 0; ok && j < got.size(); j++) {
+            field = compare(got[j], *want[j]);
+            ok = field.empty();
+        }
+        if (!ok) {
+            std::cout << "query" << describe(q) << ": " << field << " differs, got "
+                      << got.size() << " frames, expected " << want.size() << std::endl;
+            return false;
+        }
+        compared++;
+    }
+    return true;
+}
+
+// Ids, size and memory after every batch.
+bool check_ids(const frame_store& store, uint64_t added, uint64_t& first_id)
+{
+    uint64_t first = store.first_id();
+    bool ok = store.last_id() == added && first >= first_id && first <= added &&
+              store.size() == added - first + 1 && store.memory_used() <= store.budget();
+    if (!ok) {
+        std::cout << "after " << added << " frames: first_id " << first << " (was " << first_id
+                  << "), last_id " << store.last_id() << ", size " << store.size()
+                  << ", memory " << store.memory_used() << std::endl;
+    }
+    first_id = first;
+    return ok;
+}
+
+bool check_parse()
+{
+    static const char* bad[] = { "nokey",
+                                 "foo=1",
+                                 "mac=zz",
+                                 "mac=02:00:00:00:00",
+                                 "mac=02:00:00:00:00:01:02",
+                                 "ip=10.0.0",
+                                 "ip=2001:db8::g",
+                                 "port=70000",
+                                 "port=-1",
+                                 "port=http",
+                                 "ethertype=0x10000",
+                                 "vlan=4096",
+                                 "proto=300",
+                                 "proto=sctp",
+                                 "tcp_flags=XYZ",
+                                 "tcp_flags=SYN,",
+                                 "tcp_flags=256",
+                                 "last=-1",
+                                 "last=1s",
+                                 "limit=0" };
+    bool ok = true;
+    for (const char* text : bad) {
+        try {
+            frame_store::query::parse(text);
+            std::cout << "parse(\"" << text << "\") did not throw" << std::endl;
+            ok = false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    frame_store::query q = frame_store::query::parse(
+        "mac=02-00-00-00-00-0A&ip=10.0.0.1 port=502 ethertype=ipv6 vlan=10 proto=udp "
+        "tcp_flags=syn|ACK last=2.5 since=7 limit=20");
+    if (q.mac != "02-00-00-00-00-0A" || q.ip != "10.0.0.1" || q.port != 502 ||
+        q.ethertype != 0x86DD || q.vlan != 10 || q.ip_proto != 17 || q.tcp_flags != 0x12 ||
+        q.last_s != 2.5 || q.since_id != 7 || q.limit != 20) {
+        std::cout << "parse: fields differ:" << describe(q) << std::endl;
+        ok = false;
+    }
+    q = frame_store::query::parse("ethertype=0x0806 proto=icmp6 tcp_flags=18");
+    if (q.ethertype != 0x0806 || q.ip_proto != 58 || q.tcp_flags != 18) {
+        std::cout << "parse: fields differ:" << describe(q) << std::endl;
+        ok = false;
+    }
+
+    // A query built in code is checked by find()
+    frame_store store(BUDGET);
+    frame_store::query direct;
+    direct.mac = "02:00:00:00:00";
+    try {
+        store.find(direct);
+        std::cout << "find() with a bad MAC did not throw" << std::endl;
+        ok = false;
+    } catch (const std::invalid_argument&) {
+    }
+    return ok;
+}
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog << " [--seed N]" << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    frame_store store(BUDGET);
+    std::vector<stored> frames;
+    uint64_t first_id = 1;
+    int compared = 0, skipped = 0;
+    bool ok = true;
+
+    // Ages fall from MAX_AGE_S to 0 over the run, a few of them out of order
+    uint64_t t0 = gr::ethernet::frame_record_time_ns();
+    auto time_of = [&](int i) {
+        int age = MAX_AGE_S - (int64_t)i * MAX_AGE_S / FRAME_COUNT;
+        if (rng() % 10 == 0) age = std::max(0, age + (int)(rng() % 7) - 3);
+        return t0 - (uint64_t)age * 1000000000ULL;
+    };
+
+    int next_check = CHECK_EVERY;
+    while (ok && (int)frames.size() < FRAME_COUNT) {
+        int n = std::min<int>(1 + rng() % 300, FRAME_COUNT - frames.size());
+        frame_record_writer writer;
+        std::vector<std::vector<uint8_t>> data;
+        for (int i = 0; i < n; i++) {
+            data.push_back(make_frame(rng));
+            uint64_t num = frames.size() + i;
+            writer.add(data.back().data(), data.back().size(), num, num * 20, rng() % 8 != 0);
+        }
+        std::vector<uint8_t> batch = writer.finish();
+        gr::ethernet::frame_record_reader reader;
+        reader.open(batch.data(), batch.size());
+        for (int i = 0; i < n; i++) {
+            uint8_t* h = batch.data() + (reader.header(i) - batch.data());
+            uint64_t t = time_of(frames.size());
+            for (int b = 0; b < 8; b++) h[16 + b] = t >> (8 * b);
+            frames.push_back({ frames.size() + 1,
+                               std::vector<uint8_t>(h, h + gr::ethernet::FRAME_RECORD_SIZE),
+                               data[i] });
+        }
+        store.add_records(batch.data(), batch.size());
+
+        ok = check_ids(store, frames.size(), first_id);
+        if (ok && (int)frames.size() >= next_check) {
+            next_check += CHECK_EVERY;
+            ok = check_queries(store, frames, rng, QUERIES_PER_CHECK, compared, skipped);
+        }
+    }
+    if (ok && first_id == 1) {
+        std::cout << "nothing was evicted: the budget is too large for the test" << std::endl;
+        ok = false;
+    }
+    ok = check_parse() && ok;
+
+    std::cout << frames.size() << " frames, " << store.size() << " stored from id " << first_id
+              << ", " << compared << " queries compared, " << skipped << " skipped" << std::endl;
+    return ok ? 0 : EXIT_MISMATCH;
+}
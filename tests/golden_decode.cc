@@ -0,0 +1,423 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Golden-output regression test for one 100BASE-TX acquisition.
+ *
+ *   golden_decode --capture output.bin --samp-rate 625e6 --gain 5.5
+ *                 --golden golden/output.bin.txt
+ *                 [--baseline output.bin.throughput --tolerance 0.3]
+ *
+ * The capture is scaled by the gain and its symbols recovered by the
+ * timing recovery below, not by the example's Symbol Sync (MMSE
+ * interpolation, whose output changes with the GNU Radio version): the
+ * golden files then hold for any version, but the test does not cover the
+ * example's front end. The symbols go through the receive blocks of
+ * decode_100BASE-TX.grc (Slicer3 to Frame Decoder), without throttle.
+ * Every decoded frame (offset in the decoder input, bytes) is compared
+ * with the golden file, and so are the frames of the batch functions
+ * (mlt3_decode(), descramble() and decode_4b5b() with the same
+ * parameters) on the same symbols. With --baseline, the best wall-time
+ * throughput of the timing recovery and the blocks over --runs runs is
+ * compared with the baseline too, which is recorded on the first run.
+ *
+ * Exit codes: 0 pass, 1 output or throughput regression (or golden file
+ * missing), 2 usage error, 77 skipped (capture missing). --update rewrites
+ * the golden file and the baseline instead of comparing.
+ */
+
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/ethernet/batch_decode.h>
+#include <gnuradio/ethernet/fastethernet_descrambler.h>
+#include <gnuradio/ethernet/fastethernet_frame_decoder.h>
+#include <gnuradio/ethernet/frame_record.h>
+#include <gnuradio/ethernet/mlt3_to_scrambled.h>
+#include <gnuradio/ethernet/slicer3.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/top_block.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int EXIT_REGRESSION = 1;
+const int EXIT_USAGE = 2;
+const int EXIT_SKIP = 77;
+
+struct options {
+    std::string capture;
+    std::string golden;
+    std::string baseline;
+    double samp_rate = 625e6;
+    float gain = 3.5f;
+    double tolerance = 0.3;
+    int runs = 3;
+    bool update = false;
+};
+
+struct decoded_frame {
+    uint64_t offset;
+    std::vector<uint8_t> bytes;
+
+    bool operator==(const decoded_frame& o) const
+    {
+        return offset == o.offset && bytes == o.bytes;
+    }
+};
+
+// Keeps every "decoded" message, in order.
+class frame_collector : public gr::block
+{
+public:
+    typedef std::shared_ptr<frame_collector> sptr;
+
+    static sptr make() { return gnuradio::make_block_sptr<frame_collector>(); }
+
+    frame_collector()
+        : gr::block("frame_collector",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_port(pmt::intern("in"))
+    {
+        message_port_register_in(d_port);
+        set_msg_handler(d_port, [this](const pmt::pmt_t& msg) { store(msg); });
+    }
+
+    // Messages still queued when the flowgraph stopped.
+    void drain()
+    {
+        pmt::pmt_t msg;
+        while ((msg = delete_head_nowait(d_port)).get() != nullptr) {
+            store(msg);
+        }
+    }
+
+    std::vector<decoded_frame> frames()
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        return d_frames;
+    }
+
+private:
+    pmt::pmt_t d_port;
+    std::mutex d_mutex;
+    std::vector<decoded_frame> d_frames;
+
+    void store(const pmt::pmt_t& msg)
+    {
+        decoded_frame f;
+        f.offset = pmt::to_uint64(
+            pmt::dict_ref(msg, pmt::intern("sample_offset"), pmt::from_uint64(0)));
+        pmt::pmt_t bytes = pmt::dict_ref(msg, pmt::intern("frame"), pmt::PMT_NIL);
+        if (pmt::is_u8vector(bytes)) {
+            f.bytes = pmt::u8vector_elements(bytes);
+        }
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_frames.push_back(std::move(f));
+    }
+};
+
+// The decoders print every frame; the test output only keeps the summary.
+class cout_silencer
+{
+public:
+    cout_silencer() : d_saved(std::cout.rdbuf(d_sink.rdbuf())) {}
+    ~cout_silencer() { std::cout.rdbuf(d_saved); }
+
+private:
+    std::ostringstream d_sink;
+    std::streambuf* d_saved;
+};
+
+bool read_capture(const std::string& path, std::vector<float>& samples)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    samples.resize((size_t)in.tellg() / sizeof(float));
+    in.seekg(0);
+    in.read((char*)samples.data(), samples.size() * sizeof(float));
+    return (bool)in;
+}
+
+// Gardner timing recovery, linearly interpolated: the error is the slope
+// across each symbol times how far the sample between them is from their
+// mean (zero for two-level signals, not for MLT-3), normalized by the
+// signal power and fed to a PI loop. Plain double arithmetic, so the
+// symbols are the same on every platform.
+std::vector<float> recover_symbols(const std::vector<float>& samples, double sps, float gain)
+{
+    const double KP = 0.05;
+    const double KI = KP * KP / 8;
+    const double POWER_RATE = 0.01;
+
+    auto at = [&](double t) {
+        size_t i = (size_t)t;
+        double frac = t - i;
+        return gain * samples[i] * (1 - frac) + gain * samples[i + 1] * frac;
+    };
+
+    std::vector<float> symbols;
+    symbols.reserve((size_t)(samples.size() / sps) + 1);
+    double t = sps;
+    double integral = 0;
+    double prev = 0;
+    double power = 1e-3;
+    while (t + 2 < samples.size()) {
+        double y = at(t);
+        double mid = at(t - sps / 2);
+        power += (y * y - power) * POWER_RATE;
+        double error = (prev - y) * (mid - (y + prev) / 2) / power;
+        symbols.push_back((float)y);
+        prev = y;
+
+        integral += KI * error;
+        double step = KP * error + integral;
+        t += sps + std::max(-sps / 2, std::min(sps / 2, step));
+    }
+    return symbols;
+}
+
+std::string to_hex(const std::vector<uint8_t>& bytes)
+{
+    std::ostringstream oss;
+    for (uint8_t b : bytes) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << (int)b;
+    }
+    return oss.str();
+}
+
+// Runs the capture once; returns the wall time of the symbol recovery and
+// tb->run() in seconds.
+double decode(const std::vector<float>& samples,
+              const options& opt,
+              std::vector<float>& symbols,
+              std::vector<decoded_frame>& frames)
+{
+    auto tb = gr::make_top_block("golden_decode");
+    auto src = gr::blocks::vector_source_f::make(std::vector<float>());
+    auto slicer = gr::ethernet::slicer3::make(0.25f);
+    auto mlt3 = gr::ethernet::mlt3_to_scrambled::make();
+    auto descrambler = gr::ethernet::fastethernet_descrambler::make(100, 40, 100, 20000, false);
+    auto decoder = gr::ethernet::fastethernet_frame_decoder::make();
+    auto collector = frame_collector::make();
+
+    tb->connect(src, 0, slicer, 0);
+    tb->connect(slicer, 0, mlt3, 0);
+    tb->connect(mlt3, 0, descrambler, 0);
+    tb->connect(descrambler, 0, decoder, 0);
+    tb->msg_connect(decoder, "decoded", collector, "in");
+
+    auto start = std::chrono::steady_clock::now();
+    symbols = recover_symbols(samples, opt.samp_rate / 125e6, opt.gain);
+    src->set_data(symbols);
+    {
+        cout_silencer quiet;
+        tb->run();
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    collector->drain();
+    frames = collector->frames();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// The same chain through the batch functions.
+std::vector<decoded_frame> decode_batch(const std::vector<float>& symbols)
+{
+    std::vector<uint8_t> bits(symbols.size());
+    gr::ethernet::mlt3_decode(symbols.data(), symbols.size(), 0.25f, bits.data());
+    gr::ethernet::descramble(bits.data(), bits.size(), bits.data(), 100, 40, 100, 20000);
+    gr::ethernet::frame_record_writer writer;
+    gr::ethernet::decode_4b5b(bits.data(), bits.size(), writer);
+
+    const std::vector<uint8_t>& batch = writer.finish();
+    gr::ethernet::frame_record_reader reader;
+    std::vector<decoded_frame> frames;
+    if (!reader.open(batch.data(), batch.size())) return frames;
+    for (size_t i = 0; i < reader.count(); i++) {
+        size_t len = 0;
+        const uint8_t* frame = reader.frame(i, len);
+        frames.push_back({ reader.record(i).sample_offset(), std::vector<uint8_t>(frame, frame + len) });
+    }
+    return frames;
+}
+
+bool read_golden(const std::string& path, std::vector<decoded_frame>& frames)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        decoded_frame f;
+        size_t len = 0;
+        std::string hex;
+        iss >> f.offset >> len >> hex;
+        for (size_t i = 0; i + 2 <= hex.length(); i += 2) {
+            f.bytes.push_back(std::stoi(hex.substr(i, 2), nullptr, 16));
+        }
+        frames.push_back(std::move(f));
+    }
+    return true;
+}
+
+bool write_golden(const options& opt, const std::vector<decoded_frame>& frames)
+{
+    std::ofstream out(opt.golden);
+    if (!out) return false;
+
+    std::string name = opt.capture.substr(opt.capture.find_last_of('/') + 1);
+    out << "# gr-ethernet golden output: " << name << "\n";
+    out << "# samp_rate " << opt.samp_rate << " gain " << opt.gain << "\n";
+    out << "# frames " << frames.size() << "\n";
+    out << "# <offset in decoder input> <length> <bytes, destination MAC to FCS>\n";
+    for (const auto& f : frames) {
+        out << f.offset << " " << f.bytes.size() << " " << to_hex(f.bytes) << "\n";
+    }
+    return true;
+}
+
+bool compare_frames(const std::vector<decoded_frame>& expected,
+                    const std::vector<decoded_frame>& actual)
+{
+    bool ok = expected.size() == actual.size();
+    if (!ok) {
+        std::cout << "frame count: expected " << expected.size() << ", got "
+                  << actual.size() << std::endl;
+    }
+
+    size_t n = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < n; i++) {
+        if (expected[i] == actual[i]) continue;
+        std::cout << "frame " << i << " differs:" << std::endl;
+        std::cout << "  expected @" << expected[i].offset << " "
+                  << to_hex(expected[i].bytes) << std::endl;
+        std::cout << "  got      @" << actual[i].offset << " "
+                  << to_hex(actual[i].bytes) << std::endl;
+        return false;
+    }
+    return ok;
+}
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog
+              << " --capture FILE --golden FILE [--baseline FILE] [--samp-rate SPS]"
+                 " [--gain G] [--tolerance FRACTION] [--runs N] [--update]"
+              << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--update") {
+            opt.update = true;
+        } else if (arg == "--capture" && has_value) {
+            opt.capture = argv[++i];
+        } else if (arg == "--golden" && has_value) {
+            opt.golden = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            opt.baseline = argv[++i];
+        } else if (arg == "--samp-rate" && has_value) {
+            opt.samp_rate = std::stod(argv[++i]);
+        } else if (arg == "--gain" && has_value) {
+            opt.gain = std::stof(argv[++i]);
+        } else if (arg == "--tolerance" && has_value) {
+            opt.tolerance = std::stod(argv[++i]);
+        } else if (arg == "--runs" && has_value) {
+            opt.runs = std::max(1, std::stoi(argv[++i]));
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (opt.capture.empty() || opt.golden.empty()) return usage(argv[0]);
+
+    std::vector<float> samples;
+    if (!read_capture(opt.capture, samples)) {
+        std::cout << "capture not found, skipping: " << opt.capture << std::endl;
+        return EXIT_SKIP;
+    }
+
+    // The golden files are committed: a missing one is a failure
+    std::vector<decoded_frame> expected;
+    if (!opt.update && !read_golden(opt.golden, expected)) {
+        std::cout << "golden file not found: " << opt.golden << std::endl;
+        std::cout << "run 'make update_golden' to create it" << std::endl;
+        return EXIT_REGRESSION;
+    }
+
+    std::vector<float> symbols;
+    std::vector<decoded_frame> frames;
+    double best = decode(samples, opt, symbols, frames);
+    for (int r = 1; r < opt.runs; r++) {
+        std::vector<decoded_frame> again;
+        best = std::min(best, decode(samples, opt, symbols, again));
+        if (!(again == frames)) {
+            std::cout << "output differs between runs" << std::endl;
+            return EXIT_REGRESSION;
+        }
+    }
+    double msps = samples.size() / best / 1e6;
+
+    std::cout << frames.size() << " frames, " << std::fixed << std::setprecision(2)
+              << msps << " MS/s (best of " << opt.runs << ")" << std::endl;
+    std::cout << "<DartMeasurement type=\"numeric/double\" name=\"throughput_msps\">"
+              << msps << "</DartMeasurement>" << std::endl;
+
+    if (opt.update) {
+        if (!write_golden(opt, frames)) {
+            std::cerr << "cannot write " << opt.golden << std::endl;
+            return EXIT_REGRESSION;
+        }
+        std::cout << "golden file written: " << opt.golden << std::endl;
+        if (!opt.baseline.empty()) {
+            std::ofstream(opt.baseline) << msps << "\n";
+        }
+        return 0;
+    }
+
+    if (!compare_frames(expected, frames)) return EXIT_REGRESSION;
+    if (!compare_frames(frames, decode_batch(symbols))) {
+        std::cout << "batch functions differ from the blocks" << std::endl;
+        return EXIT_REGRESSION;
+    }
+
+    // The baseline is machine-specific: recorded on the first run.
+    if (!opt.baseline.empty()) {
+        double ref = 0.0;
+        std::ifstream in(opt.baseline);
+        if (in >> ref && ref > 0.0) {
+            std::cout << "baseline " << ref << " MS/s, tolerance "
+                      << (int)(opt.tolerance * 100) << "%" << std::endl;
+            if (msps < ref * (1.0 - opt.tolerance)) {
+                std::cout << "throughput regression" << std::endl;
+                return EXIT_REGRESSION;
+            }
+        } else {
+            std::ofstream(opt.baseline) << msps << "\n";
+            std::cout << "baseline recorded: " << opt.baseline << std::endl;
+        }
+    }
+
+    return 0;
+}
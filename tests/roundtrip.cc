@@ -0,0 +1,286 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Transmit-to-receive round trip for one standard.
+ *
+ *   roundtrip --standard 100base-tx [--impairments]
+ *   roundtrip --standard 10base-t [--impairments]
+ *
+ * A set of PDUs (short frames that need padding up to full-size ones) goes
+ * through the transmit blocks and straight into the receive chain of the
+ * examples:
+ *
+ *   100BASE-TX: Framer -> 4B/5B Encoder -> Scrambler -> MLT-3 Encoder
+ *               -> Slicer3 -> MLT-3 to Scrambled -> Descrambler
+ *               -> Frame Decoder
+ *   10BASE-T:   Framer -> Manchester Encoder -> Threshold -> Float to UChar
+ *               -> Correlate Access Code Tag -> 10BASE-T Decoder
+ *
+ * With --impairments, Line Impairments sits between the line encoder and
+ * the receiver, with noise and jitter well inside what the receivers
+ * tolerate. Every frame must come out once, in order, with the bytes the
+ * framer was given (padded, FCS appended) and fcs_ok set.
+ *
+ * Exit codes: 0 pass, 1 mismatch, 2 usage error.
+ */
+
+#include <gnuradio/blocks/float_to_uchar.h>
+#include <gnuradio/blocks/threshold_ff.h>
+#include <gnuradio/digital/correlate_access_code_tag_bb.h>
+#include <gnuradio/ethernet/ethernet_10baset_decoder.h>
+#include <gnuradio/ethernet/ethernet_framer.h>
+#include <gnuradio/ethernet/fastethernet_4b5b_encoder.h>
+#include <gnuradio/ethernet/fastethernet_descrambler.h>
+#include <gnuradio/ethernet/fastethernet_frame_decoder.h>
+#include <gnuradio/ethernet/fastethernet_scrambler.h>
+#include <gnuradio/ethernet/line_impairments.h>
+#include <gnuradio/ethernet/manchester_encoder.h>
+#include <gnuradio/ethernet/mlt3_encoder.h>
+#include <gnuradio/ethernet/mlt3_to_scrambled.h>
+#include <gnuradio/ethernet/slicer3.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/top_block.h>
+#include "synthetic_signal.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int EXIT_MISMATCH = 1;
+const int EXIT_USAGE = 2;
+
+const int FRAME_COUNT = 40;
+const double TIMEOUT_S = 30.0;
+
+// Preamble and SFD as Manchester half-bits, as in decode_10BASE-T.grc
+const char* SFD_ACCESS_CODE = "01100110011001100110011001100110011001100101";
+
+struct decoded_frame {
+    std::vector<uint8_t> bytes;
+    bool fcs_ok;
+};
+
+// Keeps every "decoded" message, in order.
+class frame_collector : public gr::block
+{
+public:
+    typedef std::shared_ptr<frame_collector> sptr;
+
+    static sptr make() { return gnuradio::make_block_sptr<frame_collector>(); }
+
+    frame_collector()
+        : gr::block("frame_collector",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0)),
+          d_port(pmt::intern("in"))
+    {
+        message_port_register_in(d_port);
+        set_msg_handler(d_port, [this](const pmt::pmt_t& msg) { store(msg); });
+    }
+
+    // Messages still queued when the flowgraph stopped.
+    void drain()
+    {
+        pmt::pmt_t msg;
+        while ((msg = delete_head_nowait(d_port)).get() != nullptr) {
+            store(msg);
+        }
+    }
+
+    std::vector<decoded_frame> frames()
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        return d_frames;
+    }
+
+private:
+    pmt::pmt_t d_port;
+    std::mutex d_mutex;
+    std::vector<decoded_frame> d_frames;
+
+    void store(const pmt::pmt_t& msg)
+    {
+        decoded_frame f;
+        pmt::pmt_t bytes = pmt::dict_ref(msg, pmt::intern("frame"), pmt::PMT_NIL);
+        if (pmt::is_u8vector(bytes)) {
+            f.bytes = pmt::u8vector_elements(bytes);
+        }
+        f.fcs_ok = pmt::to_bool(pmt::dict_ref(msg, pmt::intern("fcs_ok"), pmt::PMT_F));
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_frames.push_back(std::move(f));
+    }
+};
+
+// The decoders print every frame; the test output only keeps the summary.
+class cout_silencer
+{
+public:
+    cout_silencer() : d_saved(std::cout.rdbuf(d_sink.rdbuf())) {}
+    ~cout_silencer() { std::cout.rdbuf(d_saved); }
+
+private:
+    std::ostringstream d_sink;
+    std::streambuf* d_saved;
+};
+
+std::string to_hex(const std::vector<uint8_t>& bytes)
+{
+    std::ostringstream oss;
+    for (uint8_t b : bytes) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << (int)b;
+    }
+    return oss.str();
+}
+
+// Frames as the receivers should return them: padded, FCS appended.
+std::vector<std::vector<uint8_t>> expected_frames()
+{
+    static const size_t payloads[] = { 1, 18, 200, 1000, 64, 1472, 5 };
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        frames.push_back(bench::make_udp_frame(payloads[i % 7], i));
+    }
+    return frames;
+}
+
+// What the framer gets: headers and payload, before padding and FCS.
+pmt::pmt_t make_pdu(const std::vector<uint8_t>& frame)
+{
+    size_t ip_len = (frame[16] << 8) | frame[17];
+    size_t len = 14 + ip_len;
+    return pmt::cons(pmt::PMT_NIL, pmt::init_u8vector(len, frame.data()));
+}
+
+// Runs the flowgraph until every frame came out or the time is up.
+std::vector<decoded_frame> run(const std::string& standard, bool impairments)
+{
+    auto tb = gr::make_top_block("roundtrip");
+    auto framer = gr::ethernet::ethernet_framer::make(false, "packet_len");
+    auto collector = frame_collector::make();
+    // Noise at 1/50 of the amplitude, jitter at 1/50 of a sample: no symbol
+    // errors at the MLT-3 slicer threshold (at 1/20 of each, about 1e-4)
+    auto channel = gr::ethernet::line_impairments::make(0.02f, 0.02f, 0.0f, 1);
+
+    if (standard == "100base-tx") {
+        auto encoder = gr::ethernet::fastethernet_4b5b_encoder::make(24, "packet_len");
+        auto scrambler = gr::ethernet::fastethernet_scrambler::make(0x5A5);
+        auto mlt3 = gr::ethernet::mlt3_encoder::make(1.0f);
+        auto slicer = gr::ethernet::slicer3::make(0.25f);
+        auto levels = gr::ethernet::mlt3_to_scrambled::make();
+        auto descrambler =
+            gr::ethernet::fastethernet_descrambler::make(100, 40, 100, 20000, false);
+        auto decoder = gr::ethernet::fastethernet_frame_decoder::make();
+
+        tb->connect(framer, 0, encoder, 0);
+        tb->connect(encoder, 0, scrambler, 0);
+        tb->connect(scrambler, 0, mlt3, 0);
+        if (impairments) {
+            tb->connect(mlt3, 0, channel, 0);
+            tb->connect(channel, 0, slicer, 0);
+        } else {
+            tb->connect(mlt3, 0, slicer, 0);
+        }
+        tb->connect(slicer, 0, levels, 0);
+        tb->connect(levels, 0, descrambler, 0);
+        tb->connect(descrambler, 0, decoder, 0);
+        tb->msg_connect(decoder, "decoded", collector, "in");
+    } else {
+        auto encoder = gr::ethernet::manchester_encoder::make(2.0, 96, "packet_len");
+        auto threshold = gr::blocks::threshold_ff::make(-0.1f, 0.1f, 0.0f);
+        auto to_bits = gr::blocks::float_to_uchar::make();
+        auto sfd = gr::digital::correlate_access_code_tag_bb::make(
+            SFD_ACCESS_CODE, 0, "packet");
+        auto decoder = gr::ethernet::ethernet_10baset_decoder::make("packet");
+
+        tb->connect(framer, 0, encoder, 0);
+        if (impairments) {
+            tb->connect(encoder, 0, channel, 0);
+            tb->connect(channel, 0, threshold, 0);
+        } else {
+            tb->connect(encoder, 0, threshold, 0);
+        }
+        tb->connect(threshold, 0, to_bits, 0);
+        tb->connect(to_bits, 0, sfd, 0);
+        tb->connect(sfd, 0, decoder, 0);
+        tb->msg_connect(decoder, "decoded", collector, "in");
+    }
+
+    for (const auto& frame : expected_frames()) {
+        framer->_post(pmt::intern("pdus"), make_pdu(frame));
+    }
+
+    // The framer has no end of stream: stop once the last frame is out
+    cout_silencer quiet;
+    tb->start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(TIMEOUT_S);
+    while (collector->frames().size() < (size_t)FRAME_COUNT &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    tb->stop();
+    tb->wait();
+
+    collector->drain();
+    return collector->frames();
+}
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog << " --standard 100base-tx|10base-t [--impairments]"
+              << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string standard;
+    bool impairments = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--impairments") {
+            impairments = true;
+        } else if (arg == "--standard" && i + 1 < argc) {
+            standard = argv[++i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (standard != "100base-tx" && standard != "10base-t") return usage(argv[0]);
+
+    auto expected = expected_frames();
+    auto frames = run(standard, impairments);
+
+    bool ok = frames.size() == expected.size();
+    if (!ok) {
+        std::cout << "frame count: expected " << expected.size() << ", got "
+                  << frames.size() << std::endl;
+    }
+    size_t n = std::min(expected.size(), frames.size());
+    for (size_t i = 0; i < n; i++) {
+        if (frames[i].bytes == expected[i] && frames[i].fcs_ok) continue;
+        std::cout << "frame " << i << " differs (fcs_ok " << frames[i].fcs_ok << "):"
+                  << std::endl;
+        std::cout << "  expected " << to_hex(expected[i]) << std::endl;
+        std::cout << "  got      " << to_hex(frames[i].bytes) << std::endl;
+        ok = false;
+        break;
+    }
+
+    std::cout << standard << (impairments ? " with impairments: " : ": ")
+              << frames.size() << "/" << expected.size() << " frames" << std::endl;
+    return ok ? 0 : EXIT_MISMATCH;
+}
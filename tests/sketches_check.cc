@@ -0,0 +1,308 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 Thomas Lavarenne.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Traffic Stats sketches against exact counts.
+ *
+ *   sketches_check [--seed N]
+ *
+ * A Zipf stream (exponent 1.1 over 100,000 keys, 1,000,000 frames of 64
+ * to 1518 bytes) is summarised as Traffic Stats does (Space-Saving over
+ * 8 * top_k keys, Count-Min 4 x 2048) and checked against exact counts:
+ *
+ *   Space-Saving  every monitored count within [count - error, count],
+ *                 error at most total / capacity, every key above
+ *                 total / capacity monitored, and each of top(k) at least
+ *                 the true k-th weight minus total / capacity. The same
+ *                 stream with hashes squeezed into four values must give
+ *                 the same summary: the index only finds keys.
+ *   Count-Min     no undercount, each add raising the estimate of its key
+ *                 by exactly its weight, no more than exp(-depth) of the
+ *                 keys off by more than e / width of the total, and the
+ *                 conservative update never above a plain Count-Min on
+ *                 the same rows, with at most 80 % of its mean error.
+ *   HyperLogLog   estimates within 3 standard errors (1.04 / sqrt(m)) at
+ *                 1e3, 1e5 and 1e6 distinct keys, unchanged by repeats.
+ *
+ * Exit codes: 0 pass, 1 mismatch, 2 usage error.
+ */
+
+#include "sketches.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using gr::ethernet::count_min;
+using gr::ethernet::hyperloglog;
+using gr::ethernet::sketch_key;
+using gr::ethernet::space_saving;
+
+namespace {
+
+const int EXIT_MISMATCH = 1;
+const int EXIT_USAGE = 2;
+
+const int KEY_COUNT = 100000;
+const int FRAME_COUNT = 1000000;
+const double ZIPF_EXPONENT = 1.1;
+const size_t TOP_K = 10;
+const size_t SS_CAPACITY = 8 * TOP_K; // as in traffic_stats_impl.cc
+const size_t CM_WIDTH = 2048;
+const size_t CM_DEPTH = 4;
+const int HLL_P = 12;
+
+sketch_key make_key(uint32_t i)
+{
+    sketch_key k;
+    k.b[0] = 10;
+    k.b[1] = i >> 16;
+    k.b[2] = i >> 8;
+    k.b[3] = i;
+    return k;
+}
+
+struct frame {
+    uint32_t key;
+    uint32_t len;
+};
+
+// Frames whose keys follow a Zipf law: key 0 is the most frequent.
+std::vector<frame> zipf_stream(std::mt19937& rng)
+{
+    std::vector<double> cdf(KEY_COUNT);
+    double sum = 0;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        sum += 1.0 / std::pow(i + 1, ZIPF_EXPONENT);
+        cdf[i] = sum;
+    }
+    std::uniform_real_distribution<double> u(0, sum);
+    std::vector<frame> frames(FRAME_COUNT);
+    for (frame& f : frames) {
+        f.key = std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+        f.len = 64 + rng() % (1518 - 64 + 1);
+    }
+    return frames;
+}
+
+bool fail(const std::string& what)
+{
+    std::cout << what << std::endl;
+    return false;
+}
+
+// Space-Saving over packets or bytes.
+bool check_space_saving(const std::vector<frame>& frames, bool by_bytes)
+{
+    std::string name = by_bytes ? "space_saving (bytes)" : "space_saving (packets)";
+    std::vector<uint64_t> exact(KEY_COUNT, 0);
+    uint64_t total = 0;
+    space_saving ss(SS_CAPACITY), clustered(SS_CAPACITY);
+    for (const frame& f : frames) {
+        uint64_t w = by_bytes ? f.len : 1;
+        sketch_key k = make_key(f.key);
+        uint64_t h = k.hash();
+        ss.add(k, h, w);
+        clustered.add(k, h % 4, w);
+        exact[f.key] += w;
+        total += w;
+    }
+    uint64_t bound = total / SS_CAPACITY;
+
+    std::vector<space_saving::item> all = ss.top(SS_CAPACITY);
+    std::unordered_map<uint32_t, const space_saving::item*> monitored;
+    for (const auto& it : all) {
+        uint32_t key = (it.key.b[1] << 16) | (it.key.b[2] << 8) | it.key.b[3];
+        monitored[key] = &it;
+        if (it.count < exact[key] || it.count - it.error > exact[key]) {
+            return fail(name + ": key " + std::to_string(key) + " weight " +
+                        std::to_string(exact[key]) + " outside [" +
+                        std::to_string(it.count - it.error) + ", " + std::to_string(it.count) +
+                        "]");
+        }
+        if (it.error > bound) {
+            return fail(name + ": error " + std::to_string(it.error) + " above total/capacity");
+        }
+    }
+    if (all.size() != SS_CAPACITY) return fail(name + ": " + std::to_string(all.size()) + " keys");
+    for (uint32_t key = 0; key < (uint32_t)KEY_COUNT; key++) {
+        if (exact[key] > bound && !monitored.count(key)) {
+            return fail(name + ": heavy key " + std::to_string(key) + " not monitored");
+        }
+    }
+
+    std::vector<uint64_t> sorted(exact);
+    std::sort(sorted.rbegin(), sorted.rend());
+    uint64_t kth = sorted[TOP_K - 1];
+    std::vector<space_saving::item> top = ss.top(TOP_K);
+    for (const auto& it : top) {
+        uint32_t key = (it.key.b[1] << 16) | (it.key.b[2] << 8) | it.key.b[3];
+        if (exact[key] + bound < kth) {
+            return fail(name + ": top key " + std::to_string(key) + " weight " +
+                        std::to_string(exact[key]) + ", true top " + std::to_string(TOP_K) +
+                        " start at " + std::to_string(kth));
+        }
+    }
+
+    std::vector<space_saving::item> other = clustered.top(SS_CAPACITY);
+    for (size_t i = 0; i < all.size(); i++) {
+        if (!(other[i].key == all[i].key) || other[i].count != all[i].count ||
+            other[i].error != all[i].error) {
+            return fail(name + ": clustered hashes change item " + std::to_string(i));
+        }
+    }
+
+    // A cleared summary starts over
+    ss.clear();
+    ss.add(make_key(1), make_key(1).hash(), 5);
+    top = ss.top(TOP_K);
+    if (top.size() != 1 || top[0].count != 5 || top[0].error != 0) {
+        return fail(name + ": clear() kept items");
+    }
+    return true;
+}
+
+// Count-Min without the conservative update, on the rows of count_min.
+class plain_count_min
+{
+public:
+    plain_count_min() : d_counters(CM_WIDTH * CM_DEPTH, 0) {}
+
+    void add(uint64_t hash, uint64_t w)
+    {
+        for (size_t i = 0; i < CM_DEPTH; i++) d_counters[i * CM_WIDTH + cell(hash, i)] += w;
+    }
+
+    uint64_t estimate(uint64_t hash) const
+    {
+        uint64_t min = UINT64_MAX;
+        for (size_t i = 0; i < CM_DEPTH; i++) {
+            min = std::min(min, d_counters[i * CM_WIDTH + cell(hash, i)]);
+        }
+        return min;
+    }
+
+private:
+    std::vector<uint64_t> d_counters;
+
+    static size_t cell(uint64_t hash, size_t i)
+    {
+        uint32_t h1 = hash, h2 = (hash >> 32) | 1;
+        return (h1 + i * h2) % CM_WIDTH;
+    }
+};
+
+bool check_count_min(const std::vector<frame>& frames)
+{
+    std::vector<uint64_t> exact(KEY_COUNT, 0);
+    uint64_t total = 0;
+    count_min cm(CM_WIDTH, CM_DEPTH);
+    plain_count_min plain;
+    for (const frame& f : frames) {
+        uint64_t h = make_key(f.key).hash();
+        uint64_t before = cm.estimate(h);
+        cm.add(h, f.len);
+        plain.add(h, f.len);
+        if (cm.estimate(h) != before + f.len) {
+            return fail("count_min: add of " + std::to_string(f.len) + " moved the estimate from " +
+                        std::to_string(before) + " to " + std::to_string(cm.estimate(h)));
+        }
+        exact[f.key] += f.len;
+        total += f.len;
+    }
+
+    double bound = std::exp(1.0) / CM_WIDTH * total;
+    int over = 0;
+    double error = 0, plain_error = 0;
+    for (int key = 0; key < KEY_COUNT; key++) {
+        uint64_t h = make_key(key).hash();
+        uint64_t est = cm.estimate(h);
+        if (est < exact[key]) return fail("count_min: key " + std::to_string(key) + " undercounted");
+        if (est - exact[key] > bound) over++;
+        if (est > plain.estimate(h)) {
+            return fail("count_min: key " + std::to_string(key) + " above a plain Count-Min");
+        }
+        error += est - exact[key];
+        plain_error += plain.estimate(h) - exact[key];
+    }
+    if (error > 0.8 * plain_error) {
+        return fail("count_min: mean error " + std::to_string(error / KEY_COUNT) +
+                    ", plain Count-Min " + std::to_string(plain_error / KEY_COUNT));
+    }
+    if (over > KEY_COUNT * std::exp(-(double)CM_DEPTH)) {
+        return fail("count_min: " + std::to_string(over) + " keys off by more than e/width");
+    }
+    cm.clear();
+    if (cm.estimate(make_key(0).hash()) != 0) return fail("count_min: clear() kept counts");
+    return true;
+}
+
+bool check_hyperloglog(std::mt19937& rng)
+{
+    double sigma = 1.04 / std::sqrt(double(1 << HLL_P));
+    for (uint32_t n : { 1000u, 100000u, 1000000u }) {
+        hyperloglog hll(HLL_P);
+        uint32_t base = rng();
+        for (uint32_t i = 0; i < n; i++) {
+            sketch_key k = make_key(i);
+            k.b[4] = base;
+            k.b[5] = base >> 8;
+            hll.add(k.hash());
+        }
+        uint64_t est = hll.estimate();
+        double rel = ((double)est - n) / n;
+        if (std::fabs(rel) > 3 * sigma) {
+            return fail("hyperloglog: " + std::to_string(est) + " for " + std::to_string(n) +
+                        " keys, " + std::to_string(rel / sigma) + " standard errors");
+        }
+        // Repeats do not count
+        for (uint32_t i = 0; i < std::min(n, 1000u); i++) {
+            sketch_key k = make_key(i);
+            k.b[4] = base;
+            k.b[5] = base >> 8;
+            hll.add(k.hash());
+        }
+        if (hll.estimate() != est) return fail("hyperloglog: repeated keys changed the estimate");
+        std::cout << "hyperloglog: " << n << " keys, estimate " << est << " ("
+                  << rel / sigma << " standard errors)" << std::endl;
+    }
+    hyperloglog empty(HLL_P);
+    if (empty.estimate() != 0) return fail("hyperloglog: empty estimate not 0");
+    return true;
+}
+
+int usage(const char* prog)
+{
+    std::cerr << "usage: " << prog << " [--seed N]" << std::endl;
+    return EXIT_USAGE;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<frame> frames = zipf_stream(rng);
+    bool ok = check_space_saving(frames, false) && check_space_saving(frames, true) &&
+              check_count_min(frames) && check_hyperloglog(rng);
+    if (ok) std::cout << "sketches ok" << std::endl;
+    return ok ? 0 : EXIT_MISMATCH;
+}